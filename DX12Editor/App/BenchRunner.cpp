@@ -0,0 +1,247 @@
+#include "BenchRunner.h"
+#include "InputSession.h"
+#include <windows.h>
+#include <psapi.h>
+#include <dxgi1_6.h>
+#include <wrl/client.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "../Core/CameraPath.h"
+#include "../Core/DXDevice.h"
+#include "../Core/DXRenderer.h"
+#include "../Core/FrameStats.h"
+#include "../Core/Profiler.h"
+
+namespace {
+    constexpr uint32_t kCollectEvery = 256; // frames per Profiler::Collect (well inside the ring)
+
+    std::string Narrow(const std::wstring& w)
+    {
+        const int n = WideCharToMultiByte(CP_UTF8, 0, w.c_str(), int(w.size()), nullptr, 0, nullptr, nullptr);
+        std::string s(size_t(n), '\0');
+        WideCharToMultiByte(CP_UTF8, 0, w.c_str(), int(w.size()), s.data(), n, nullptr, nullptr);
+        return s;
+    }
+
+    std::string JsonEscape(const std::string& in)
+    {
+        std::string out;
+        for (char c : in)
+        {
+            if (c == '"' || c == '\\') out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) out += c;
+        }
+        return out;
+    }
+
+    // First "key": number in 'text' (our own reports only, no general JSON parser needed).
+    bool FindNumber(const std::string& text, const char* key, double& out)
+    {
+        const std::string needle = std::string("\"") + key + "\":";
+        const size_t pos = text.find(needle);
+        if (pos == std::string::npos) return false;
+        return std::sscanf(text.c_str() + pos + needle.size(), "%lf", &out) == 1;
+    }
+
+    bool ReadText(const std::string& path, std::string& out)
+    {
+        FILE* f = nullptr;
+        fopen_s(&f, path.c_str(), "rb");
+        if (!f) return false;
+        char buf[4096];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+        std::fclose(f);
+        return true;
+    }
+}
+
+int BenchRunner::Run(DXRenderer& renderer, const DXDevice& device, const BenchOptions& options,
+    const std::function<bool()>& pumpMessages)
+{
+    CameraPath path;
+    InputSession input;
+    uint32_t frameCount = options.frames;
+    if (!options.inputPath.empty())
+    {
+        if (!input.StartReplay(options.inputPath))
+        {
+            std::fprintf(stderr, "bench: cannot load input session '%s'\n", options.inputPath.c_str());
+            return 2;
+        }
+        frameCount = input.ReplayFrameCount(); // recorded dt per frame replaces fixedDelta
+    }
+    else if (!options.cameraPath.empty())
+    {
+        if (!path.Load(options.cameraPath.c_str()))
+        {
+            std::fprintf(stderr, "bench: cannot load camera path '%s'\n", options.cameraPath.c_str());
+            return 2;
+        }
+    }
+    else
+    {
+        path = CameraPath::MakeDefault(options.frames);
+    }
+
+    const bool replayInput = input.IsReplaying();
+    renderer.SetFixedDelta(options.fixedDelta);
+    renderer.SetExternalCameraControl(!replayInput);
+    // Recorded late events replay at the same point of the frame they were latched in.
+    struct LatchReset {
+        DXRenderer& renderer;
+        ~LatchReset() { renderer.SetLateLatchCallback(nullptr); } // 'input' dies with this scope
+    } latchReset{ renderer };
+    if (replayInput)
+        renderer.SetLateLatchCallback([&] { input.LateLatch(renderer); });
+
+    // Warmup: pipelines, first-use allocations, driver caches. Camera stays put.
+    for (uint32_t i = 0; i < options.warmupFrames; ++i)
+    {
+        if (!pumpMessages()) return 2;
+        PROFILE_FRAME();
+        renderer.WaitForFrameStart();
+        renderer.Render();
+    }
+
+    FrameStats frameCpu;
+    std::map<std::string, double> stageNs;
+    uint64_t draws = 0, droppedDraws = 0, triangles = 0, lines = 0;
+    double scaleSum = 0.0;
+    float  scaleMin = 1.0f;
+
+    std::vector<ProfileZone> zones;
+    uint64_t chunkBegin = Profiler::NowNs();
+    auto collectStages = [&](uint64_t chunkEnd)
+    {
+        zones.clear();
+        Profiler::Get().Collect(chunkBegin, chunkEnd, zones);
+        for (const ProfileZone& z : zones)
+            if (z.beginNs >= chunkBegin && z.endNs <= chunkEnd)
+                stageNs[z.name] += double(z.endNs - z.beginNs);
+        chunkBegin = chunkEnd;
+    };
+
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        if (!pumpMessages()) return 2;
+
+        PROFILE_FRAME();
+        renderer.WaitForFrameStart(); // before the frame's input, as on the render thread
+        if (replayInput) input.BeginFrame(renderer);
+        else             path.Apply(frame, *renderer.GetCamera());
+
+        const uint64_t t0 = Profiler::NowNs();
+        renderer.Render();
+        const uint64_t t1 = Profiler::NowNs();
+        if (replayInput) input.EndFrame(renderer);
+        frameCpu.AddSample(double(t1 - t0) / 1e6);
+
+        const DXRenderer::FrameCounters& c = renderer.GetFrameCounters();
+        draws += c.draws;
+        droppedDraws += c.droppedDraws;
+        triangles += c.triangles;
+        lines += c.lines;
+        scaleSum += renderer.RenderScale(); // scale the next frame will use; close enough for a mean
+        scaleMin = (std::min)(scaleMin, renderer.RenderScale());
+
+        if ((frame + 1) % kCollectEvery == 0 || frame + 1 == frameCount)
+            collectStages(t1);
+    }
+
+    renderer.SetExternalCameraControl(false);
+    renderer.SetFixedDelta(0.0);
+    renderer.SetUiCaptureOverride(-1);
+
+    // Memory at the end of the run.
+    PROCESS_MEMORY_COUNTERS pmc{};
+    pmc.cb = sizeof(pmc);
+    GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+
+    DXGI_QUERY_VIDEO_MEMORY_INFO vidmem{};
+    Microsoft::WRL::ComPtr<IDXGIAdapter3> adapter3;
+    if (device.GetAdapter() && SUCCEEDED(device.GetAdapter()->QueryInterface(IID_PPV_ARGS(&adapter3))))
+        adapter3->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &vidmem);
+
+    const double frames = double(frameCount ? frameCount : 1);
+    const DirectX::XMFLOAT3 camPos = renderer.GetCamera()->GetPosition();
+
+    // frame_cpu goes first so its p50/p95 are the first matches for baseline checks.
+    std::string report = "{\n  \"frame_cpu\": " + frameCpu.ToJson() + ",\n";
+
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+        "  \"version\": 1,\n  \"adapter\": \"%s\",\n  \"warp\": %s,\n  \"camera_path\": \"%s\",\n"
+        "  \"frames\": %u,\n  \"warmup_frames\": %u,\n  \"fixed_dt\": %.6f,\n",
+        JsonEscape(Narrow(device.AdapterDesc())).c_str(), device.IsWarp() ? "true" : "false",
+        JsonEscape(replayInput ? options.inputPath : path.Name()).c_str(), frameCount, options.warmupFrames, options.fixedDelta);
+    report += buf;
+
+    report += "  \"stages_ms\": {";
+    bool first = true;
+    for (const auto& [name, ns] : stageNs)
+    {
+        std::snprintf(buf, sizeof(buf), "%s\n    \"%s\": %.4f", first ? "" : ",", JsonEscape(name).c_str(), ns / 1e6 / frames);
+        report += buf;
+        first = false;
+    }
+    report += "\n  },\n";
+    report += "  \"input_latency\": " + renderer.GetLatency().ToJson() + ",\n";
+
+    std::snprintf(buf, sizeof(buf), "  \"render_scale\": { \"dynamic\": %s, \"mean\": %.4f, \"min\": %.4f },\n",
+        renderer.DynamicResolutionEnabled() ? "true" : "false", scaleSum / frames, scaleMin);
+    report += buf;
+
+    std::snprintf(buf, sizeof(buf),
+        "  \"draws_per_frame\": %.2f,\n  \"dropped_draws\": %llu,\n  \"triangles_per_frame\": %.2f,\n  \"lines_per_frame\": %.2f,\n"
+        "  \"memory\": { \"working_set_mb\": %.2f, \"peak_working_set_mb\": %.2f, \"gpu_local_mb\": %.2f },\n"
+        "  \"camera_final\": [%.5f, %.5f, %.5f]\n}\n",
+        double(draws) / frames, (unsigned long long)droppedDraws, double(triangles) / frames, double(lines) / frames,
+        double(pmc.WorkingSetSize) / (1024.0 * 1024.0), double(pmc.PeakWorkingSetSize) / (1024.0 * 1024.0),
+        double(vidmem.CurrentUsage) / (1024.0 * 1024.0),
+        camPos.x, camPos.y, camPos.z);
+    report += buf;
+
+    FILE* f = nullptr;
+    fopen_s(&f, options.reportPath.c_str(), "wb");
+    if (!f)
+    {
+        std::fprintf(stderr, "bench: cannot write '%s'\n", options.reportPath.c_str());
+        return 2;
+    }
+    std::fwrite(report.data(), 1, report.size(), f);
+    std::fclose(f);
+
+    if (!options.baselinePath.empty() && !CompareWithBaseline(report, options))
+        return 1;
+    return 0;
+}
+
+bool BenchRunner::CompareWithBaseline(const std::string& report, const BenchOptions& options)
+{
+    std::string baseline;
+    if (!ReadText(options.baselinePath, baseline))
+    {
+        std::fprintf(stderr, "bench: cannot read baseline '%s'\n", options.baselinePath.c_str());
+        return false;
+    }
+
+    bool ok = true;
+    for (const char* key : { "p50_ms", "p95_ms" })
+    {
+        double base = 0.0, now = 0.0;
+        if (!FindNumber(baseline, key, base) || !FindNumber(report, key, now))
+            continue;
+        if (base > 0.0 && now > base * (1.0 + options.tolerance))
+        {
+            std::fprintf(stderr, "bench: %s regressed %.3f -> %.3f ms (+%.1f%%)\n",
+                key, base, now, (now / base - 1.0) * 100.0);
+            ok = false;
+        }
+    }
+    return ok;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class DXDevice;
+class DXRenderer;
+
+// Deterministic benchmark: replays a camera path (or a recorded input session)
+// with a fixed timestep for a fixed number of frames and writes a JSON report.
+// Optionally compares the result against a baseline report and fails on
+// regression.
+struct BenchOptions {
+    std::string cameraPath;                  // empty = built-in flythrough
+    std::string inputPath;                   // recorded input session, replaces the camera path
+    std::string reportPath{ "bench_report.json" };
+    std::string baselinePath;                // empty = no regression check
+    uint32_t    frames{ 600 };
+    uint32_t    warmupFrames{ 30 };          // rendered but not measured
+    double      fixedDelta{ 1.0 / 60.0 };
+    double      tolerance{ 0.10 };           // allowed p50/p95 slowdown vs baseline
+};
+
+class BenchRunner {
+public:
+    // pumpMessages is called between frames; returning false aborts the run.
+    // Returns the process exit code: 0 ok, 1 regression, 2 setup/run error.
+    int Run(DXRenderer& renderer, const DXDevice& device, const BenchOptions& options,
+        const std::function<bool()>& pumpMessages);
+
+private:
+    static bool CompareWithBaseline(const std::string& report, const BenchOptions& options);
+};
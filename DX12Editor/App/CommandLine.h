@@ -0,0 +1,49 @@
+#pragma once
+#include <windows.h>
+#include <shellapi.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Minimal "--name value" / "--flag" command line access.
+class CommandLine {
+public:
+    CommandLine() {
+        int argc = 0;
+        if (LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc)) {
+            for (int i = 1; i < argc; ++i) m_args.emplace_back(argv[i]);
+            LocalFree(argv);
+        }
+    }
+
+    bool Has(const wchar_t* name) const {
+        for (const auto& a : m_args) if (a == name) return true;
+        return false;
+    }
+
+    // Value following 'name', or 'fallback' when absent.
+    std::wstring Value(const wchar_t* name, const std::wstring& fallback = L"") const {
+        for (size_t i = 0; i + 1 < m_args.size(); ++i)
+            if (m_args[i] == name) return m_args[i + 1];
+        return fallback;
+    }
+
+    // Narrow (ASCII/UTF-8 paths) variant for the C file APIs used by the tools.
+    std::string ValueUtf8(const wchar_t* name, const std::string& fallback = "") const {
+        if (!Has(name)) return fallback;
+        const std::wstring w = Value(name);
+        if (w.empty()) return fallback;
+        const int n = WideCharToMultiByte(CP_UTF8, 0, w.c_str(), int(w.size()), nullptr, 0, nullptr, nullptr);
+        std::string s(size_t(n), '\0');
+        WideCharToMultiByte(CP_UTF8, 0, w.c_str(), int(w.size()), s.data(), n, nullptr, nullptr);
+        return s;
+    }
+
+    double Number(const wchar_t* name, double fallback) const {
+        const std::wstring v = Value(name);
+        return v.empty() ? fallback : std::wcstod(v.c_str(), nullptr);
+    }
+
+private:
+    std::vector<std::wstring> m_args;
+};
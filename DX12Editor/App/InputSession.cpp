@@ -0,0 +1,122 @@
+#include "InputSession.h"
+
+#include "../Core/DXRenderer.h"
+
+bool InputSession::StartRecording(const std::string& path)
+{
+    if (path.empty()) return false;
+    m_recordPath = path;
+    m_recording.Clear();
+    m_recordingOn = true;
+    return true;
+}
+
+bool InputSession::StartReplay(const std::string& path)
+{
+    if (!m_replay.Load(path.c_str()))
+        return false;
+    m_replay.Rewind();
+    m_replaying = true;
+    m_frame = 0;
+    return true;
+}
+
+void InputSession::Push(const InputEvent& e)
+{
+    if (!m_replaying)
+        m_pending.push_back(e);
+}
+
+void InputSession::BeginFrame(DXRenderer& renderer)
+{
+    m_frameEvents.clear();
+    m_replayLate.clear();
+
+    if (m_replaying)
+    {
+        // Events after the Latch marker are applied by LateLatch().
+        m_replay.Fetch(m_frame, m_frameEvents, m_replayLate);
+        if (m_replay.Finished() && m_frameEvents.empty())
+        {
+            // Session over: hand control back to real time and live ImGui state.
+            renderer.SetFixedDelta(0.0);
+            renderer.SetUiCaptureOverride(-1);
+            m_replaying = false;
+        }
+    }
+    else
+    {
+        m_frameEvents.swap(m_pending);
+    }
+
+    for (InputEvent& e : m_frameEvents)
+    {
+        if (e.type == InputEvent::Type::Frame)
+        {
+            // Recorded dt and UI capture make the simulation step identical.
+            renderer.SetFixedDelta(e.x);
+            renderer.SetUiCaptureOverride((e.flags & InputEvent::kUiCapturedMouse) ? 1 : 0);
+            continue;
+        }
+        Apply(renderer, e);
+    }
+}
+
+void InputSession::LateLatch(DXRenderer& renderer)
+{
+    m_frameEvents.clear();
+    if (m_replaying) m_frameEvents.swap(m_replayLate);
+    else             m_frameEvents.swap(m_pending);
+    if (m_frameEvents.empty()) return;
+
+    if (m_recordingOn)
+    {
+        InputEvent marker;
+        marker.type = InputEvent::Type::Latch;
+        marker.frame = m_frame;
+        marker.timeNs = InputEvent::Now();
+        m_recording.Append(marker);
+    }
+
+    for (InputEvent& e : m_frameEvents)
+        Apply(renderer, e);
+}
+
+void InputSession::Apply(DXRenderer& renderer, InputEvent& e)
+{
+    e.frame = m_frame;
+    if (m_replaying)
+    {
+        // Recorded timestamps belong to another run; for latency a replayed
+        // event arrives when it is fetched.
+        InputEvent live = e;
+        live.timeNs = InputEvent::Now();
+        renderer.HandleInput(live);
+    }
+    else
+    {
+        renderer.HandleInput(e);
+    }
+    if (m_recordingOn) m_recording.Append(e);
+}
+
+void InputSession::EndFrame(const DXRenderer& renderer)
+{
+    if (m_recordingOn)
+    {
+        InputEvent marker;
+        marker.type = InputEvent::Type::Frame;
+        marker.frame = m_frame;
+        marker.timeNs = InputEvent::Now();
+        marker.x = renderer.LastSimDelta();
+        marker.flags = renderer.LastUiCapture() ? InputEvent::kUiCapturedMouse : 0;
+        m_recording.Append(marker);
+    }
+    ++m_frame;
+}
+
+bool InputSession::Finish()
+{
+    if (!m_recordingOn) return true;
+    return m_recording.Save(m_recordPath.c_str());
+}
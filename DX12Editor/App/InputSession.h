@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Core/InputRecording.h"
+
+class DXRenderer;
+
+// Per-frame input routing between the platform layer and the renderer.
+// Live events are queued by Push() and applied at the start of the next
+// frame, or by LateLatch() just before the frame is submitted; with a
+// recording active they are also written out together with the frame's dt
+// (late ones after a Latch marker), and with a replay active the recorded
+// events replace live input at the same two points.
+class InputSession {
+public:
+    bool StartRecording(const std::string& path);
+    bool StartReplay(const std::string& path);
+
+    // Platform layer, same thread as BeginFrame/EndFrame.
+    void Push(const InputEvent& e);
+
+    void BeginFrame(DXRenderer& renderer);
+    void LateLatch(DXRenderer& renderer);
+    void EndFrame(const DXRenderer& renderer);
+
+    // Writes the recording (if any). Safe to call more than once.
+    bool Finish();
+
+    bool     IsReplaying() const noexcept { return m_replaying; }
+    bool     ReplayFinished() const noexcept { return m_replaying && m_replay.Finished(); }
+    uint32_t ReplayFrameCount() const noexcept { return m_replay.FrameCount(); }
+    uint32_t Frame() const noexcept { return m_frame; }
+
+private:
+    void Apply(DXRenderer& renderer, InputEvent& e);
+
+private:
+    std::vector<InputEvent> m_pending;  // live events for the next frame
+    std::vector<InputEvent> m_frameEvents;
+    std::vector<InputEvent> m_replayLate; // replay: this frame's events after its Latch marker
+
+    InputRecording m_recording;
+    InputRecording m_replay;
+    std::string    m_recordPath;
+    bool           m_recordingOn{ false };
+    bool           m_replaying{ false };
+    uint32_t       m_frame{ 0 };
+};
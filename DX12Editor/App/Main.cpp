@@ -3,16 +3,67 @@
 #include <windowsx.h> 
 #include "../Core/DXDevice.h"
 #include "../Core/DXRenderer.h"
-#include "../Core/FrameTimer.h"
+#include "../Core/Profiler.h"
+#include "BenchRunner.h"
+#include "CommandLine.h"
+#include "InputSession.h"
+#include "MicroBenchSuite.h"
+#include "RenderThread.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
 #include <sstream>
 
+// GUI subsystem: reuse the launching console (if any) for bench output.
+static void AttachParentConsole()
+{
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        FILE* f = nullptr;
+        freopen_s(&f, "CONOUT$", "w", stdout);
+        freopen_s(&f, "CONOUT$", "w", stderr);
+    }
+}
+
+// Messages the ImGui Win32 backend reacts to; everything else stays on this thread.
+static bool IsImGuiInputMessage(UINT msg)
+{
+    if (msg >= WM_MOUSEFIRST && msg <= WM_MOUSELAST) return true;
+    if (msg >= WM_KEYFIRST && msg <= WM_KEYLAST) return true;
+    switch (msg) {
+    case WM_SETCURSOR:
+    case WM_SETFOCUS:
+    case WM_KILLFOCUS:
+    case WM_MOUSELEAVE:
+    case WM_INPUTLANGCHANGE:
+    case WM_DEVICECHANGE:
+        return true;
+    default:
+        return false;
+    }
+}
+
 int WINAPI wWinMain(HINSTANCE, HINSTANCE, PWSTR, int)
 {
+    PROFILE_THREAD("Main");
+
+    const CommandLine cmd;
+    if (cmd.Has(L"--bench") || cmd.Has(L"--microbench"))
+        AttachParentConsole();
+
+    // CPU microbenchmarks need neither a window nor a device.
+    if (cmd.Has(L"--microbench")) {
+        MicroBench::Options opts;
+        opts.filter = cmd.ValueUtf8(L"--filter");
+        opts.samples = static_cast<uint32_t>(cmd.Number(L"--samples", opts.samples));
+        opts.minSampleMs = cmd.Number(L"--min-sample-ms", opts.minSampleMs);
+        return RunMicroBenchmarks(opts, cmd.ValueUtf8(L"--report", "microbench.json"));
+    }
+
     Window window(L"DX12 Editor", 1600, 900);
     if (!window.Create()) return -1;
 
     DXDevice dx;
-    if (!dx.Initialize(true)) {
+    if (!dx.Initialize(true, cmd.Has(L"--warp"))) {
         MessageBoxW(window.GetHWND(), L"DX12 device init failed", L"Error", MB_OK | MB_ICONERROR);
         return -2;
     }
@@ -28,28 +79,128 @@ int WINAPI wWinMain(HINSTANCE, HINSTANCE, PWSTR, int)
         renderer.Resize(w, h);
         });
 
-    // Win32 message callback: route input + ImGui to renderer
+    // --pacing uncapped | vsync | <target fps>   (default vsync)
+    if (cmd.Has(L"--pacing")) {
+        const std::string pacingArg = cmd.ValueUtf8(L"--pacing");
+        FramePacer::Config pacing;
+        if (pacingArg == "uncapped")   pacing.mode = FramePacer::Mode::Uncapped;
+        else if (pacingArg == "vsync") pacing.mode = FramePacer::Mode::VSync;
+        else {
+            pacing.mode = FramePacer::Mode::TargetFps;
+            pacing.targetFps = std::atof(pacingArg.c_str());
+        }
+        renderer.SetPacing(pacing);
+    }
+
+    // --dynres <frame budget ms>: dynamic resolution (also under --warp, where
+    // the scale directly cuts rasterization time on the CPU).
+    if (cmd.Has(L"--dynres"))
+        renderer.SetDynamicResolution(true, std::atof(cmd.ValueUtf8(L"--dynres", "16").c_str()));
+
+    // --scene <file.dxscene>: load a saved scene in place of the default quad.
+    if (cmd.Has(L"--scene") && !renderer.LoadScene(cmd.Value(L"--scene"))) {
+        MessageBoxW(window.GetHWND(), L"Cannot load scene file", L"Error", MB_OK | MB_ICONERROR);
+        return -5;
+    }
+
+    // Input: live, recorded (--record file) or replayed (--replay file)
+    InputSession input;
+    if (cmd.Has(L"--record"))
+        input.StartRecording(cmd.ValueUtf8(L"--record"));
+    if (cmd.Has(L"--replay") && !cmd.Has(L"--bench") && !input.StartReplay(cmd.ValueUtf8(L"--replay"))) {
+        MessageBoxW(window.GetHWND(), L"Cannot load input replay", L"Error", MB_OK | MB_ICONERROR);
+        return -4;
+    }
+
+    // Headless-style benchmark: fixed camera path, fixed dt, JSON report, exit code.
+    if (cmd.Has(L"--bench")) {
+        BenchOptions opts;
+        opts.cameraPath = cmd.ValueUtf8(L"--camera-path");
+        opts.reportPath = cmd.ValueUtf8(L"--report", opts.reportPath);
+        opts.baselinePath = cmd.ValueUtf8(L"--baseline");
+        opts.frames = static_cast<uint32_t>(cmd.Number(L"--frames", opts.frames));
+        opts.warmupFrames = static_cast<uint32_t>(cmd.Number(L"--warmup", opts.warmupFrames));
+        opts.fixedDelta = cmd.Number(L"--fixed-dt", opts.fixedDelta);
+        opts.tolerance = cmd.Number(L"--tolerance", opts.tolerance);
+
+        auto pump = [] {
+            MSG m{};
+            while (PeekMessage(&m, nullptr, 0, 0, PM_REMOVE)) {
+                if (m.message == WM_QUIT) return false;
+                TranslateMessage(&m);
+                DispatchMessage(&m);
+            }
+            return true;
+        };
+        opts.inputPath = cmd.ValueUtf8(L"--replay");
+        return BenchRunner().Run(renderer, dx, opts, pump);
+    }
+
+    // Put adapter name in the title once
+    std::wstringstream base;
+    base << L"DX12 Editor    Adapter: " << dx.AdapterDesc();
+    SetWindowTextW(window.GetHWND(), base.str().c_str());
+
+    // FPS/ms in title (sampled by the renderer's timer every ~0.5s, posted by the render thread)
+    std::wstringstream title;
+    auto UpdateTitle = [&](double fps) {
+        const double ms = (fps > 0.0) ? (1000.0 / fps) : 0.0;
+        title.str(L"");
+        title.clear();
+        title << base.str()
+            << L"  |  FPS: " << std::fixed << std::setprecision(0) << fps
+            << L"  (" << std::setprecision(2) << ms << L" ms)";
+        SetWindowTextW(window.GetHWND(), title.str().c_str());
+    };
+
+    RenderThread renderThread;
+
+    // Win32 message callback: this thread only translates and forwards,
+    // ImGui and the camera consume everything on the render thread.
     window.SetMessageCallback([&](HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) -> LRESULT
         {
-            // 1) Let ImGui process the message first
-            if (DXRenderer::ImGui_ImplWin32_WndProcHandler(hWnd, msg, wParam, lParam))
-                return 1; // ImGui consumed the message
+            // 1) Raw messages ImGui cares about (mouse, keyboard, focus)
+            if (IsImGuiInputMessage(msg))
+                renderThread.PostUiMessage(hWnd, msg, wParam, lParam);
 
-            // 2) Camera input handling (we only update state here)
             switch (msg)
             {
+            case RenderThread::kFpsMessage:
+                UpdateTitle(renderThread.Fps());
+                return 1;
+
+            case WM_CLOSE:
+                // The swap chain belongs to this window: keep it until the render
+                // thread has finished its frame. Joining here could deadlock (a
+                // frame in flight may wait on this thread), so only ask it to
+                // stop; it posts kStoppedMessage when done.
+                renderThread.RequestStop();
+                return 1;
+
+            case RenderThread::kStoppedMessage:
+                DestroyWindow(hWnd);
+                return 1;
+
+            case WM_SETCURSOR:
+                // ImGui picks the cursor on the render thread (forwarded above);
+                // DefWindowProc would reset it to the class arrow on every move.
+                if (LOWORD(lParam) == HTCLIENT)
+                    return 1;
+                break;
+
+            // Camera input: translate to platform-neutral events, applied next frame
             case WM_RBUTTONDOWN:
-                renderer.OnRightMouseDown();
+                renderThread.PostInput(InputEvent::Button(MouseButton::Right, true));
                 break;
             case WM_RBUTTONUP:
-                renderer.OnRightMouseUp();
+                renderThread.PostInput(InputEvent::Button(MouseButton::Right, false));
                 break;
 
             case WM_LBUTTONDOWN:
-                renderer.OnLeftMouseDown();
+                renderThread.PostInput(InputEvent::Button(MouseButton::Left, true));
                 break;
             case WM_LBUTTONUP:
-                renderer.OnLeftMouseUp();
+                renderThread.PostInput(InputEvent::Button(MouseButton::Left, false));
                 break;
 
             case WM_MOUSEMOVE:
@@ -66,7 +217,7 @@ int WINAPI wWinMain(HINSTANCE, HINSTANCE, PWSTR, int)
                 lastX = x;
                 lastY = y;
 
-                renderer.OnMouseMove(dx, dy);
+                renderThread.PostInput(InputEvent::MouseMove(dx, dy));
                 break;
             }
 
@@ -74,54 +225,41 @@ int WINAPI wWinMain(HINSTANCE, HINSTANCE, PWSTR, int)
             {
                 int delta = GET_WHEEL_DELTA_WPARAM(wParam); // usually +/-120 per notch
                 float ticks = static_cast<float>(delta) / 120.0f;
-                renderer.OnMouseWheel(ticks);
+                renderThread.PostInput(InputEvent::MouseWheel(ticks));
                 break;
             }
 
             case WM_KEYDOWN:
-                renderer.OnKeyDown(static_cast<UINT>(wParam));
+                renderThread.PostInput(InputEvent::Key(static_cast<uint16_t>(wParam), true));
                 break;
 
             case WM_KEYUP:
-                renderer.OnKeyUp(static_cast<UINT>(wParam));
+                renderThread.PostInput(InputEvent::Key(static_cast<uint16_t>(wParam), false));
                 break;
             }
 
             // Returning 0 means "not fully handled, let Window do its thing"
             return 0;
         });
-    // Put adapter name in the title once
-    std::wstringstream base;
-    base << L"DX12 Editor    Adapter: " << dx.AdapterDesc();
-    SetWindowTextW(window.GetHWND(), base.str().c_str());
 
-    // FPS/ms in title
-    FrameTimer timer;
-    double fps = 0.0;
-    std::wstringstream title;
+    // Idle editor renders on demand only; --continuous for profiling sessions.
+    renderer.SetContinuousRedraw(cmd.Has(L"--continuous"));
+
+    // From here on the renderer is owned by the render thread.
+    window.SetResizeCallback([&](UINT w, UINT h) {
+        renderThread.PostResize(w, h);
+        });
+    renderThread.Start(renderer, input, window.GetHWND());
 
+    // Blocking pump: an idle window costs nothing here, and modal drag/resize
+    // loops no longer stall frames.
     MSG msg{};
-    while (msg.message != WM_QUIT) {
-        if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-        }
-        else {
-            timer.Tick();
-            renderer.Render();
-
-            // Update window title every ~0.5s
-            if (timer.SampleFps(0.5, fps)) {
-                const double ms = (fps > 0.0) ? (1000.0 / fps) : 0.0;
-                title.str(L"");
-                title.clear();
-                title << base.str()
-                    << L"  |  FPS: " << std::fixed << std::setprecision(0) << fps
-                    << L"  (" << std::setprecision(2) << ms << L" ms)";
-                SetWindowTextW(window.GetHWND(), title.str().c_str());
-            }
-        }
+    while (GetMessage(&msg, nullptr, 0, 0) > 0) {
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
     }
+    renderThread.Stop();
+    input.Finish();
     return 0;
 }
 
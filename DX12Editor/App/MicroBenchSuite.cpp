@@ -0,0 +1,602 @@
+#include "MicroBenchSuite.h"
+#include <DirectXCollision.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Camera.h"
+#include "../Core/DescriptorAllocator.h"
+#include "../Core/FramePacer.h"
+#include "../Core/FrameStats.h"
+#include "../Core/InputEvents.h"
+#include "../Core/JobSystem.h"
+#include "../Core/MeshGen.h"
+#include "../Core/Profiler.h"
+#include "../Core/RadixSort.h"
+#include "../Core/RenderProxy.h"
+#include "../Core/SpscQueue.h"
+#include "../Core/TexelGen.h"
+#include "../Math/MathBatch.h"
+#include "../Scene/World.h"
+
+using namespace DirectX;
+
+namespace {
+    bool g_spscOrderBroken = false;
+
+    constexpr uint32_t kWorldEntities = 1000000;
+    constexpr uint32_t kHierarchyTrees = 1000; // x 1000 entities each
+
+    // Shared worker pool for the job-system variants.
+    JobSystem* BenchJobs()
+    {
+        static JobSystem jobs;
+        static const bool ready = jobs.Initialize();
+        return ready ? &jobs : nullptr;
+    }
+
+    void AddCameraBenchmarks(MicroBench& mb)
+    {
+        // Rotate() is a thin wrapper around RecalculateVectors().
+        mb.Add("Camera/Rotate", [](uint64_t n) {
+            Camera cam;
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                cam.Rotate(1.0f, (i & 1) ? 0.5f : -0.5f);
+                MicroBench::DoNotOptimize(cam);
+            }
+        });
+        mb.Add("Camera/Update (free-fly)", [](uint64_t n) {
+            Camera cam;
+            cam.SetMovement(true, false, false, true, false, false, false);
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                cam.Update(1.0f / 60.0f);
+                MicroBench::DoNotOptimize(cam);
+            }
+        });
+        mb.Add("Camera/GetViewMatrix", [](uint64_t n) {
+            Camera cam;
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                XMMATRIX v = cam.GetViewMatrix();
+                MicroBench::DoNotOptimize(v);
+            }
+        });
+        mb.Add("Camera/GetProjectionMatrix", [](uint64_t n) {
+            Camera cam;
+            cam.SetProjection(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                XMMATRIX p = cam.GetProjectionMatrix();
+                MicroBench::DoNotOptimize(p);
+            }
+        });
+    }
+
+    void AddGeometryBenchmarks(MicroBench& mb)
+    {
+        // Same parameters as DXRenderer::CreateGridVB / CreateCheckerTextureSRV.
+        mb.Add("MeshGen/BuildGridVertices", [](uint64_t n) {
+            std::vector<MeshGen::Vertex> verts;
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                MeshGen::GridCounts c = MeshGen::BuildGridVertices(20, 0.5f, verts);
+                MicroBench::DoNotOptimize(c);
+                MicroBench::DoNotOptimize(verts.data());
+            }
+        });
+        mb.Add("MeshGen/BuildQuadVertices", [](uint64_t n) {
+            MeshGen::Vertex verts[MeshGen::kQuadVertexCount];
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                MeshGen::BuildQuadVertices(1.0f, verts);
+                MicroBench::DoNotOptimize(verts);
+            }
+        });
+        mb.Add("TexelGen/FillChecker 256x256", [](uint64_t n) {
+            std::vector<uint32_t> pixels(256 * 256);
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                TexelGen::FillChecker(pixels.data(), 256, 256, 32, 40, 220);
+                MicroBench::DoNotOptimize(pixels.data());
+            }
+        });
+    }
+
+    void AddFrameBenchmarks(MicroBench& mb)
+    {
+        mb.Add("RadixSort64/64K draw keys", [](uint64_t n) {
+            constexpr size_t kCount = 64 * 1024;
+            std::mt19937_64 rng(1234);
+            std::vector<uint64_t> src(kCount), keys(kCount), tmpKeys(kCount);
+            std::vector<uint32_t> values(kCount), tmpValues(kCount);
+            for (uint64_t& k : src) k = rng() & 0x0FFFFFFFFFFFFFFFull;
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                keys = src;
+                for (uint32_t j = 0; j < kCount; ++j) values[j] = j;
+                RadixSort64(keys.data(), values.data(), tmpKeys.data(), tmpValues.data(), kCount);
+                MicroBench::DoNotOptimize(keys.data());
+            }
+        });
+        // Large scene: 1M keys, serial and split across the worker pool.
+        for (bool parallel : { false, true })
+        {
+            mb.Add(parallel ? "RadixSort64/1M draw keys, job system" : "RadixSort64/1M draw keys, serial", [parallel](uint64_t n) {
+                constexpr size_t kCount = 1024 * 1024;
+                static std::vector<uint64_t> src, keys(kCount), tmpKeys(kCount);
+                static std::vector<uint32_t> values(kCount), tmpValues(kCount);
+                if (src.empty())
+                {
+                    std::mt19937_64 rng(1234);
+                    src.resize(kCount);
+                    for (uint64_t& k : src) k = rng() & 0x0FFFFFFFFFFFFFFFull;
+                }
+                JobSystem* jobs = parallel ? BenchJobs() : nullptr;
+                for (uint64_t i = 0; i < n; ++i)
+                {
+                    keys = src;
+                    for (uint32_t j = 0; j < kCount; ++j) values[j] = j;
+                    RadixSort64(keys.data(), values.data(), tmpKeys.data(), tmpValues.data(), kCount, jobs);
+                    MicroBench::DoNotOptimize(keys.data());
+                }
+            });
+        }
+        // Paced frame at 240 FPS: the median should sit on 4.167 ms and the
+        // MAD shows how precisely the sleep/spin wait hits its deadlines.
+        mb.Add("FramePacer/240 fps frame", [](uint64_t n) {
+            static FramePacer pacer; // keeps its cadence and sleep estimate across samples
+            pacer.SetConfig({ FramePacer::Mode::TargetFps, 240.0 });
+            for (uint64_t i = 0; i < n; ++i)
+                pacer.WaitForNextFrame();
+        });
+        // Free + allocate of one bindless slot with a few others live
+        // (Tools/DescriptorTool.cpp runs the multi-threaded variant).
+        mb.Add("DescriptorAllocator/Free + Allocate", [](uint64_t n) {
+            static DescriptorAllocator heap;
+            static const bool ready = heap.Initialize(1024);
+            uint32_t ring[8];
+            for (uint32_t& r : ring) r = heap.Allocate();
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                uint32_t& slot = ring[i & 7];
+                heap.Free(slot);
+                slot = heap.Allocate();
+                MicroBench::DoNotOptimize(slot);
+            }
+            for (uint32_t r : ring) heap.Free(r);
+            MicroBench::DoNotOptimize(ready);
+        });
+        // One recorded zone (open + close); the budget is < 20 ns so zones can
+        // stay in per-entity loops, and a run over it fails. Two timestamp
+        // reads are most of it: where rdtsc traps (some VMs) they alone cost
+        // more than the budget. The paused variant is the early-out only.
+        mb.Add("Profiler/PROFILE_SCOPE", [](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                PROFILE_SCOPE("MicroBench zone");
+            }
+        }, 20.0);
+        mb.Add("Profiler/PROFILE_SCOPE, paused", [](uint64_t n) {
+            Profiler::Get().SetPaused(true);
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                PROFILE_SCOPE("MicroBench zone");
+            }
+            Profiler::Get().SetPaused(false);
+        });
+        mb.Add("FrameStats/Summarize", [](uint64_t n) {
+            FrameStats stats;
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<double> ms(10.0, 20.0);
+            for (uint32_t i = 0; i < FrameStats::kWindow; ++i) stats.AddSample(ms(rng));
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                FrameStats::Summary s = stats.Summarize();
+                MicroBench::DoNotOptimize(s);
+            }
+        });
+    }
+
+    // Snapshot cost for a large scene while the previous snapshot is still held
+    // (as the render thread would). 'moved' proxies in one contiguous run get a
+    // new transform each frame, so copy-on-write only clones the chunks they hit.
+    void AddSnapshotBenchmark(MicroBench& mb, const char* name, uint32_t moved)
+    {
+        mb.Add(name, [moved](uint64_t n) {
+            constexpr uint32_t kProxies = 100000;
+            RenderScene scene;
+            XMFLOAT4X4 world;
+            XMStoreFloat4x4(&world, XMMatrixIdentity());
+            ProxyDraw draw{};
+            draw.flags = ProxyDraw::kVisible;
+            for (uint32_t i = 0; i < kProxies; ++i) scene.Add(draw, world);
+            scene.Publish();
+
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                std::shared_ptr<const RenderSnapshot> inFlight = scene.Acquire();
+                world._41 = float(i);
+                const uint32_t first = uint32_t((i * moved) % kProxies);
+                for (uint32_t k = 0; k < moved; ++k)
+                    scene.SetTransform((first + k) % kProxies, world);
+                scene.Publish();
+                MicroBench::DoNotOptimize(inFlight);
+            }
+        });
+    }
+
+    void AddSceneBenchmarks(MicroBench& mb)
+    {
+        AddSnapshotBenchmark(mb, "RenderScene/Publish 100k, all moved", 100000);
+        AddSnapshotBenchmark(mb, "RenderScene/Publish 100k, 1% moved", 1000);
+        AddSnapshotBenchmark(mb, "RenderScene/Publish 100k, static", 0);
+    }
+
+    // Entity store at 1M entities, each with a transform.
+    World& BenchWorld()
+    {
+        static World world = [] {
+            World w;
+            w.Reserve(kWorldEntities);
+            for (uint32_t i = 0; i < kWorldEntities; ++i)
+                w.SetTransform(w.Create(), Transform{});
+            return w;
+        }();
+        return world;
+    }
+
+    // One system pass: move every entity up a bit, then rebuild the world matrices.
+    void MoveAndUpdate(World& world, JobSystem* jobs)
+    {
+        TransformStore& transforms = world.Transforms();
+        transforms.ForEachChunk(jobs, [&transforms](uint32_t begin, uint32_t end) {
+            float* y = transforms.Column(TransformStore::PosY);
+            for (uint32_t i = begin; i < end; ++i) y[i] += 0.001f;
+            transforms.MarkDirty(begin, end);
+        });
+        world.UpdateTransforms(jobs);
+    }
+
+    void AddWorldBenchmarks(MicroBench& mb)
+    {
+        mb.Add("World/Create 1M", [](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                World world;
+                world.Reserve(kWorldEntities);
+                for (uint32_t e = 0; e < kWorldEntities; ++e)
+                    world.SetTransform(world.Create(), Transform{});
+                MicroBench::DoNotOptimize(world.AliveCount());
+            }
+        });
+        // Random destroy order: every removal swaps a far slot into the hole.
+        mb.Add("World/Create + destroy 1M, random order", [](uint64_t n) {
+            std::vector<Entity> handles(kWorldEntities);
+            std::mt19937 rng(7);
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                World world;
+                world.Reserve(kWorldEntities);
+                for (Entity& e : handles)
+                {
+                    e = world.Create();
+                    world.SetTransform(e, Transform{});
+                }
+                std::shuffle(handles.begin(), handles.end(), rng);
+                for (const Entity& e : handles) world.Destroy(e);
+                MicroBench::DoNotOptimize(world.AliveCount());
+            }
+        });
+        mb.Add("World/Iterate 1M transforms, serial", [](uint64_t n) {
+            World& world = BenchWorld();
+            for (uint64_t i = 0; i < n; ++i)
+                MoveAndUpdate(world, nullptr);
+        });
+        mb.Add("World/Iterate 1M transforms, job system", [](uint64_t n) {
+            World& world = BenchWorld();
+            for (uint64_t i = 0; i < n; ++i)
+                MoveAndUpdate(world, BenchJobs());
+        });
+    }
+
+    // 1M entities in kHierarchyTrees trees of 1000: wide = a root with 999
+    // children (2 levels), deep = a chain 1000 levels down.
+    World BuildHierarchy(bool deep)
+    {
+        World w;
+        w.Reserve(kWorldEntities);
+        Transform t;
+        t.position = { 0.0f, 0.01f, 0.0f };
+        for (uint32_t tree = 0; tree < kHierarchyTrees; ++tree)
+        {
+            const Entity root = w.Create();
+            w.SetTransform(root, t);
+            Entity parent = root;
+            for (uint32_t k = 1; k < kWorldEntities / kHierarchyTrees; ++k)
+            {
+                const Entity e = w.Create();
+                w.SetTransform(e, t);
+                w.SetParent(e, parent);
+                if (deep) parent = e;
+            }
+        }
+        w.UpdateTransforms(nullptr); // sorts by depth once
+        return w;
+    }
+
+    // Moves the first 'movedRoots' roots (slots [0, kHierarchyTrees) after the
+    // depth sort), then updates: only those trees are recomputed.
+    void AddHierarchyBenchmark(MicroBench& mb, const char* name, bool deep, uint32_t movedRoots, bool parallel)
+    {
+        mb.Add(name, [deep, movedRoots, parallel](uint64_t n) {
+            static World wide = BuildHierarchy(false);
+            static World chains = BuildHierarchy(true);
+            World& world = deep ? chains : wide;
+            TransformStore& transforms = world.Transforms();
+            JobSystem* jobs = parallel ? BenchJobs() : nullptr;
+            for (uint64_t i = 0; i < n; ++i)
+            {
+                float* x = transforms.Column(TransformStore::PosX);
+                for (uint32_t r = 0; r < movedRoots; ++r) x[r] += 0.001f;
+                transforms.MarkDirty(0, movedRoots);
+                world.UpdateTransforms(jobs);
+                transforms.ClearWorldChanged();
+            }
+        });
+    }
+
+    void AddHierarchyBenchmarks(MicroBench& mb)
+    {
+        AddHierarchyBenchmark(mb, "Hierarchy/Wide 1M (1k roots x 999 children), all moved, serial", false, kHierarchyTrees, false);
+        AddHierarchyBenchmark(mb, "Hierarchy/Wide 1M (1k roots x 999 children), all moved, job system", false, kHierarchyTrees, true);
+        AddHierarchyBenchmark(mb, "Hierarchy/Wide 1M (1k roots x 999 children), 1 root moved", false, 1, true);
+        AddHierarchyBenchmark(mb, "Hierarchy/Deep 1M (1k chains x 1000 levels), all moved, serial", true, kHierarchyTrees, false);
+        AddHierarchyBenchmark(mb, "Hierarchy/Deep 1M (1k chains x 1000 levels), all moved, job system", true, kHierarchyTrees, true);
+    }
+
+    // Same data in both layouts: AoS DirectXMath types for the per-element
+    // baseline, SoA columns for the batch math.
+    struct MathBenchData {
+        static constexpr size_t kCount = 4096;
+
+        std::vector<XMFLOAT3> points, pointsOut;
+        std::vector<XMFLOAT4X4> matrices, matricesOut;
+        std::vector<BoundingBox> boxes, boxesOut;
+        std::vector<float> radii;
+        std::vector<float> columns[3 + 16 + 3];     // x y z, matrix elements, extents
+        std::vector<float> outColumns[3 + 16 + 3];
+        std::vector<uint8_t> visible;
+        XMFLOAT4X4 viewProj;
+        XMFLOAT4 planes[6];
+
+        Math::SoaFloat3 Points() { return { columns[0].data(), columns[1].data(), columns[2].data() }; }
+        Math::SoaFloat3 PointsOut() { return { outColumns[0].data(), outColumns[1].data(), outColumns[2].data() }; }
+        Math::SoaMat4 Matrices(std::vector<float>* cols)
+        {
+            Math::SoaMat4 m;
+            for (int k = 0; k < 16; ++k) m.m[k] = cols[3 + k].data();
+            return m;
+        }
+        Math::SoaAabb Boxes(std::vector<float>* cols)
+        {
+            return { { cols[0].data(), cols[1].data(), cols[2].data() },
+                     { cols[19].data(), cols[20].data(), cols[21].data() } };
+        }
+        Math::Mat4 ViewProj() const
+        {
+            Math::Mat4 m;
+            std::memcpy(&m, &viewProj, sizeof(m));
+            return m;
+        }
+    };
+
+    MathBenchData& BenchMathData()
+    {
+        static MathBenchData data = [] {
+            MathBenchData d;
+            const size_t n = MathBenchData::kCount;
+            std::mt19937 rng(11);
+            std::uniform_real_distribution<float> pos(-50.0f, 50.0f), unit(-1.0f, 1.0f), size(0.1f, 2.0f);
+
+            d.points.resize(n); d.pointsOut.resize(n);
+            d.matrices.resize(n); d.matricesOut.resize(n);
+            d.boxes.resize(n); d.boxesOut.resize(n);
+            d.radii.resize(n); d.visible.resize(n);
+            for (std::vector<float>& c : d.columns) c.resize(n);
+            for (std::vector<float>& c : d.outColumns) c.resize(n);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                const XMFLOAT3 p{ pos(rng), pos(rng), pos(rng) };
+                const XMFLOAT3 e{ size(rng), size(rng), size(rng) };
+                const XMVECTOR axis = XMVector3Normalize(XMVectorSet(unit(rng), unit(rng), unit(rng) + 2.0f, 0.0f));
+                const XMMATRIX world = XMMatrixRotationAxis(axis, unit(rng) * XM_PI) * XMMatrixTranslation(p.x, p.y, p.z);
+
+                d.points[i] = p;
+                XMStoreFloat4x4(&d.matrices[i], world);
+                d.boxes[i] = BoundingBox(p, e);
+                d.radii[i] = e.x;
+                d.columns[0][i] = p.x; d.columns[1][i] = p.y; d.columns[2][i] = p.z;
+                for (int k = 0; k < 16; ++k) d.columns[3 + k][i] = d.matrices[i].m[k / 4][k % 4];
+                d.columns[19][i] = e.x; d.columns[20][i] = e.y; d.columns[21][i] = e.z;
+            }
+
+            const XMMATRIX view = XMMatrixLookAtRH(XMVectorSet(0.0f, 20.0f, 80.0f, 1.0f), XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            const XMMATRIX proj = XMMatrixPerspectiveFovRH(XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+            XMStoreFloat4x4(&d.viewProj, view * proj);
+
+            // Frustum planes of the view-projection (rows combined, normals inward).
+            const XMFLOAT4X4& m = d.viewProj;
+            const XMVECTOR c0 = XMVectorSet(m._11, m._21, m._31, m._41);
+            const XMVECTOR c1 = XMVectorSet(m._12, m._22, m._32, m._42);
+            const XMVECTOR c2 = XMVectorSet(m._13, m._23, m._33, m._43);
+            const XMVECTOR c3 = XMVectorSet(m._14, m._24, m._34, m._44);
+            const XMVECTOR planes[6] = { c3 + c0, c3 - c0, c3 + c1, c3 - c1, c2, c3 - c2 };
+            for (int p = 0; p < 6; ++p) XMStoreFloat4(&d.planes[p], XMPlaneNormalize(planes[p]));
+            return d;
+        }();
+        return data;
+    }
+
+    // Per-element DirectXMath vs. the batch SoA math (backend in the name).
+    void AddMathBenchmarks(MicroBench& mb)
+    {
+        static const std::string batch = std::string(", batch ") + Math::SimdBackendName();
+        constexpr size_t n = MathBenchData::kCount;
+
+        mb.Add("Math/Transform 4096 points, DirectXMath", [](uint64_t iters) {
+            MathBenchData& d = BenchMathData();
+            const XMMATRIX m = XMLoadFloat4x4(&d.matrices[0]);
+            for (uint64_t it = 0; it < iters; ++it)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    XMStoreFloat3(&d.pointsOut[i], XMVector3Transform(XMLoadFloat3(&d.points[i]), m));
+                MicroBench::DoNotOptimize(d.pointsOut.data());
+            }
+        });
+        mb.Add(("Math/Transform 4096 points" + batch).c_str(), [](uint64_t iters) {
+            MathBenchData& d = BenchMathData();
+            Math::Mat4 m;
+            std::memcpy(&m, &d.matrices[0], sizeof(m));
+            for (uint64_t it = 0; it < iters; ++it)
+            {
+                Math::TransformPoints(m, d.Points(), d.PointsOut(), n);
+                MicroBench::DoNotOptimize(d.outColumns[0].data());
+            }
+        });
+
+        mb.Add("Math/World * ViewProj x4096, DirectXMath", [](uint64_t iters) {
+            MathBenchData& d = BenchMathData();
+            const XMMATRIX vp = XMLoadFloat4x4(&d.viewProj);
+            for (uint64_t it = 0; it < iters; ++it)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    XMStoreFloat4x4(&d.matricesOut[i], XMLoadFloat4x4(&d.matrices[i]) * vp);
+                MicroBench::DoNotOptimize(d.matricesOut.data());
+            }
+        });
+        mb.Add(("Math/World * ViewProj x4096" + batch).c_str(), [](uint64_t iters) {
+            MathBenchData& d = BenchMathData();
+            const Math::Mat4 vp = d.ViewProj();
+            for (uint64_t it = 0; it < iters; ++it)
+            {
+                Math::MultiplyMatrices(d.Matrices(d.columns), vp, d.Matrices(d.outColumns), n);
+                MicroBench::DoNotOptimize(d.outColumns[3].data());
+            }
+        });
+
+        mb.Add("Math/Frustum-cull 4096 spheres, DirectXMath", [](uint64_t iters) {
+            MathBenchData& d = BenchMathData();
+            XMVECTOR planes[6];
+            for (int p = 0; p < 6; ++p) planes[p] = XMLoadFloat4(&d.planes[p]);
+            for (uint64_t it = 0; it < iters; ++it)
+            {
+                size_t count = 0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const XMVECTOR c = XMLoadFloat3(&d.points[i]);
+                    const XMVECTOR negR = XMVectorReplicate(-d.radii[i]);
+                    bool outside = false;
+                    for (int p = 0; p < 6; ++p)
+                        outside |= XMVector4Less(XMPlaneDotCoord(planes[p], c), negR);
+                    d.visible[i] = outside ? 0 : 1;
+                    count += d.visible[i];
+                }
+                MicroBench::DoNotOptimize(count);
+            }
+        });
+        mb.Add(("Math/Frustum-cull 4096 spheres" + batch).c_str(), [](uint64_t iters) {
+            MathBenchData& d = BenchMathData();
+            Math::Plane planes[6];
+            std::memcpy(planes, d.planes, sizeof(planes));
+            for (uint64_t it = 0; it < iters; ++it)
+            {
+                size_t count = Math::CullSpheres(planes, 6, d.Points(), d.radii.data(), d.visible.data(), n);
+                MicroBench::DoNotOptimize(count);
+            }
+        });
+
+        mb.Add("Math/Transform 4096 AABBs, DirectXMath", [](uint64_t iters) {
+            MathBenchData& d = BenchMathData();
+            for (uint64_t it = 0; it < iters; ++it)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    d.boxes[i].Transform(d.boxesOut[i], XMLoadFloat4x4(&d.matrices[i]));
+                MicroBench::DoNotOptimize(d.boxesOut.data());
+            }
+        });
+        mb.Add(("Math/Transform 4096 AABBs" + batch).c_str(), [](uint64_t iters) {
+            MathBenchData& d = BenchMathData();
+            for (uint64_t it = 0; it < iters; ++it)
+            {
+                Math::TransformAabbs(d.Matrices(d.columns), d.Boxes(d.columns), d.Boxes(d.outColumns), n);
+                MicroBench::DoNotOptimize(d.outColumns[19].data());
+            }
+        });
+    }
+
+    // Message thread -> render thread channel under load. Also a stress test:
+    // every event carries a sequence number and the consumer checks the order.
+    void AddThreadingBenchmarks(MicroBench& mb)
+    {
+        mb.Add("SpscQueue/InputEvent 2 threads", [](uint64_t n) {
+            static SpscQueue<InputEvent, 4096> queue; // too big for the stack
+            std::thread producer([n] {
+                InputEvent e = InputEvent::MouseMove(1.0f, -1.0f);
+                for (uint64_t i = 0; i < n; ++i)
+                {
+                    e.timeNs = i;
+                    while (!queue.TryPush(e))
+                        std::this_thread::yield(); // full: let the consumer run (matters on 1 core)
+                }
+            });
+            InputEvent e;
+            for (uint64_t i = 0; i < n; )
+            {
+                if (!queue.TryPop(e)) { std::this_thread::yield(); continue; }
+                if (e.timeNs != i) g_spscOrderBroken = true;
+                ++i;
+            }
+            producer.join();
+        });
+    }
+}
+
+int RunMicroBenchmarks(const MicroBench::Options& options, const std::string& jsonPath)
+{
+    MicroBench mb;
+    AddCameraBenchmarks(mb);
+    AddGeometryBenchmarks(mb);
+    AddFrameBenchmarks(mb);
+    AddSceneBenchmarks(mb);
+    AddWorldBenchmarks(mb);
+    AddHierarchyBenchmarks(mb);
+    AddMathBenchmarks(mb);
+    AddThreadingBenchmarks(mb);
+
+    mb.Run(options);
+    if (!jsonPath.empty() && !mb.WriteJson(jsonPath.c_str()))
+    {
+        std::fprintf(stderr, "microbench: cannot write '%s'\n", jsonPath.c_str());
+        return 2;
+    }
+    if (g_spscOrderBroken)
+    {
+        std::fprintf(stderr, "microbench: SpscQueue delivered events out of order\n");
+        return 1;
+    }
+    int overBudget = 0;
+    for (const MicroBench::Result& r : mb.Results())
+    {
+        if (!r.OverBudget()) continue;
+        std::fprintf(stderr, "microbench: %s over budget: %.2f ns > %.2f ns\n", r.name.c_str(), r.medianNs, r.budgetNs);
+        ++overBudget;
+    }
+    return overBudget ? 1 : 0;
+}
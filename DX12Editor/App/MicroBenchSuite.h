@@ -0,0 +1,9 @@
+#pragma once
+#include <string>
+
+#include "../Core/MicroBench.h"
+
+// Registers the CPU hot paths (camera, mesh/texel generation, draw sorting,
+// frame statistics) and runs them. Returns a process exit code: 1 when a
+// self-check fails or a benchmark is over its budget.
+int RunMicroBenchmarks(const MicroBench::Options& options, const std::string& jsonPath);
@@ -0,0 +1,166 @@
+#include "RenderThread.h"
+
+#include "InputSession.h"
+#include "../Core/DXRenderer.h"
+#include "../Core/Profiler.h"
+#include <chrono>
+
+RenderThread::~RenderThread()
+{
+    Stop();
+    if (m_wake) CloseHandle(m_wake);
+}
+
+bool RenderThread::Start(DXRenderer& renderer, InputSession& input, HWND hwnd)
+{
+    if (m_thread.joinable()) return false;
+
+    m_renderer = &renderer;
+    m_input = &input;
+    m_hwnd = hwnd;
+    m_messageThreadId = GetCurrentThreadId();
+    m_quit.store(false, std::memory_order_relaxed);
+    if (!m_wake) m_wake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!m_wake) return false;
+
+    // Input that arrived while the frame was being recorded still makes it in.
+    renderer.SetLateLatchCallback([this] {
+        DrainInput();
+        m_input->LateLatch(*m_renderer);
+    });
+    m_thread = std::thread([this] { Run(); });
+    return true;
+}
+
+void RenderThread::RequestStop() noexcept
+{
+    m_quit.store(true, std::memory_order_release);
+    Wake();
+}
+
+void RenderThread::Stop()
+{
+    if (!m_thread.joinable()) return;
+    RequestStop();
+    m_thread.join();
+    m_renderer->SetLateLatchCallback(nullptr);
+}
+
+void RenderThread::PostInput(const InputEvent& e) noexcept
+{
+    if (!m_inputQueue.TryPush(e))
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    Wake();
+}
+
+void RenderThread::PostUiMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept
+{
+    if (!m_uiQueue.TryPush({ hwnd, msg, wParam, lParam }))
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    Wake();
+}
+
+void RenderThread::PostResize(UINT width, UINT height) noexcept
+{
+    // Minimized windows report 0x0: keep the buffers, stop rendering.
+    const bool minimized = (width == 0 || height == 0);
+    m_minimized.store(minimized, std::memory_order_release);
+    if (!minimized)
+        m_resize.store((uint64_t(width) << 32) | height, std::memory_order_release);
+    Wake();
+}
+
+void RenderThread::DrainUi() noexcept
+{
+    UiMessage m;
+    while (m_uiQueue.TryPop(m))
+        DXRenderer::ImGui_ImplWin32_WndProcHandler(m.hwnd, m.msg, m.wParam, m.lParam);
+}
+
+bool RenderThread::DrainInput() noexcept
+{
+    bool any = false;
+    InputEvent e;
+    while (m_inputQueue.TryPop(e))
+    {
+        m_input->Push(e);
+        any = true;
+    }
+    return any;
+}
+
+void RenderThread::Run()
+{
+    PROFILE_THREAD("Render");
+
+    // Share keyboard / mouse state with the window thread, so ImGui's
+    // GetKeyState / cursor queries see the same input as the message pump.
+    AttachThreadInput(GetCurrentThreadId(), m_messageThreadId, TRUE);
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point nextIdleFrame = Clock::now();
+    bool idle = false;
+
+    double shownFps = -1.0;
+    while (!m_quit.load(std::memory_order_acquire))
+    {
+        if (const uint64_t size = m_resize.exchange(0, std::memory_order_acq_rel))
+            m_renderer->Resize(UINT(size >> 32), UINT(size & 0xFFFFFFFFu));
+
+        // Queued input only decides whether to render here; it is consumed
+        // after the pacing wait below so it is as fresh as possible.
+        const bool dirty = m_uiQueue.SizeApprox() != 0 || m_inputQueue.SizeApprox() != 0;
+
+        // ---- On-demand redraw: sleep until something changes or the idle frame is due ----
+        DWORD waitMs = 0;
+        if (m_minimized.load(std::memory_order_acquire))
+        {
+            DrainUi(); // keep the queues from overflowing while nothing renders
+            DrainInput();
+            waitMs = INFINITE; // PostResize wakes us when restored
+        }
+        else if (!dirty && !m_input->IsReplaying() && !m_renderer->NeedsRedraw())
+        {
+            const double idleHz = m_renderer->IdleRedrawHz();
+            const Clock::time_point now = Clock::now();
+            if (idleHz <= 0.0)
+                waitMs = INFINITE;
+            else if (now < nextIdleFrame)
+                waitMs = DWORD(std::chrono::duration_cast<std::chrono::milliseconds>(nextIdleFrame - now).count()) + 1;
+        }
+        if (waitMs != 0)
+        {
+            idle = true;
+            WaitForSingleObject(m_wake, waitMs);
+            continue;
+        }
+        if (idle)
+        {
+            m_renderer->ResumeFromIdle();
+            idle = false;
+        }
+        if (m_renderer->IdleRedrawHz() > 0.0)
+            nextIdleFrame = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(1.0 / m_renderer->IdleRedrawHz()));
+
+        PROFILE_FRAME();
+        m_renderer->WaitForFrameStart();
+        DrainUi();
+        DrainInput();
+        m_input->BeginFrame(*m_renderer);
+        m_renderer->Render();
+        m_input->EndFrame(*m_renderer);
+
+        // Title text is set by the window thread; only notify it.
+        const double fps = m_renderer->GetFps();
+        if (fps != shownFps)
+        {
+            shownFps = fps;
+            m_fps.store(fps, std::memory_order_relaxed);
+            PostMessageW(m_hwnd, kFpsMessage, 0, 0);
+        }
+    }
+
+    AttachThreadInput(GetCurrentThreadId(), m_messageThreadId, FALSE);
+    PostMessageW(m_hwnd, kStoppedMessage, 0, 0);
+}
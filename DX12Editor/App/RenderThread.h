@@ -0,0 +1,75 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "../Core/InputEvents.h"
+#include "../Core/SpscQueue.h"
+
+class DXRenderer;
+class InputSession;
+
+// Runs simulation + rendering on its own thread so the OS message pump
+// (window drags, resizes, mouse-move floods) never delays a frame.
+// The message thread talks to it only through non-blocking channels:
+//   - input events       -> SPSC queue, applied at the start of the next frame
+//   - raw UI messages    -> SPSC queue, fed to ImGui on the render thread
+//   - resize             -> latest-wins mailbox (older sizes are irrelevant)
+// and gets FPS back through an atomic plus a posted notification message.
+// Unless the renderer wants continuous frames, the thread sleeps on a wake
+// event while nothing changed, and never renders while minimized.
+class RenderThread {
+public:
+    static constexpr UINT kFpsMessage = WM_APP + 1;     // posted to the window when FPS changes
+    static constexpr UINT kStoppedMessage = WM_APP + 2; // posted once Run() has left its loop
+
+    RenderThread() = default;
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    bool Start(DXRenderer& renderer, InputSession& input, HWND hwnd);
+    void RequestStop() noexcept; // non-blocking: safe inside the window procedure
+    void Stop();                 // RequestStop + join: after the message loop only
+
+    // ---- Message thread side: never block ----
+    void PostInput(const InputEvent& e) noexcept;
+    void PostUiMessage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
+    void PostResize(UINT width, UINT height) noexcept;
+
+    double   Fps() const noexcept { return m_fps.load(std::memory_order_relaxed); }
+    uint64_t DroppedMessages() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct UiMessage {
+        HWND   hwnd;
+        UINT   msg;
+        WPARAM wParam;
+        LPARAM lParam;
+    };
+
+    void Run();
+    void DrainUi() noexcept;
+    bool DrainInput() noexcept;
+    void Wake() noexcept { if (m_wake) SetEvent(m_wake); }
+
+private:
+    DXRenderer*   m_renderer{ nullptr };
+    InputSession* m_input{ nullptr };
+    HWND          m_hwnd{ nullptr };
+    DWORD         m_messageThreadId{ 0 };
+
+    std::thread       m_thread;
+    std::atomic<bool> m_quit{ false };
+
+    SpscQueue<InputEvent, 4096> m_inputQueue;
+    SpscQueue<UiMessage, 4096>  m_uiQueue;
+    std::atomic<uint64_t>       m_resize{ 0 }; // w << 32 | h, 0 = nothing pending
+    std::atomic<bool>           m_minimized{ false };
+    HANDLE                      m_wake{ nullptr }; // auto-reset, set by every Post*
+
+    std::atomic<double>   m_fps{ 0.0 };
+    std::atomic<uint64_t> m_dropped{ 0 };
+};
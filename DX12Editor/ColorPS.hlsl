@@ -1,17 +1,34 @@
-Texture2D gTex : register(t0);
+// Permutations (see ColorPermutation in Core/ShaderPermutation.h); each
+// combination is compiled to its own ColorPS_<key>.cso.
+//   SAMPLER_MODE        0..3: linear/wrap, point/wrap, linear/clamp, point/clamp
+//   VERTEX_COLOR_BLEND  0/1: tint the texture with the vertex color
+#ifndef SAMPLER_MODE
+#define SAMPLER_MODE 0
+#endif
+#ifndef VERTEX_COLOR_BLEND
+#define VERTEX_COLOR_BLEND 1
+#endif
 
-// Four individual static samplers (matched with root signature s0..s3).
-SamplerState gSamplerLinearWrap : register(s0);
-SamplerState gSamplerPointWrap : register(s1);
-SamplerState gSamplerLinearClamp : register(s2);
-SamplerState gSamplerPointClamp : register(s3);
+// Whole global descriptor heap, indexed with gTextureIndex (bindless).
+Texture2D gTextures[] : register(t0);
+
+// Static samplers (matched with root signature s0..s3); the variant picks one.
+#if SAMPLER_MODE == 0
+SamplerState gSampler : register(s0); // linear / wrap
+#elif SAMPLER_MODE == 1
+SamplerState gSampler : register(s1); // point / wrap
+#elif SAMPLER_MODE == 2
+SamplerState gSampler : register(s2); // linear / clamp
+#else
+SamplerState gSampler : register(s3); // point / clamp
+#endif
 
 // Constant buffer shared with C++.
 cbuffer CbMvp : register(b0)
 {
     float4x4 gMVP; // Not used in PS, but layout must match C++ side.
-    uint gSamplerIndex; // Which sampler to use (0..3).
-    float3 _padding; // Padding for 16-byte alignment.
+    uint gTextureIndex; // Bindless SRV index into the global heap.
+    uint3 _padding; // Padding for 16-byte alignment.
 };
 
 struct PSInput
@@ -23,27 +40,12 @@ struct PSInput
 
 float4 main(PSInput i) : SV_Target
 {
-    uint idx = gSamplerIndex;
-
-    float4 tex;
-
-    // Select the correct sampler based on index.
-    if (idx == 0)
-    {
-        tex = gTex.Sample(gSamplerLinearWrap, i.uv);
-    }
-    else if (idx == 1)
-    {
-        tex = gTex.Sample(gSamplerPointWrap, i.uv);
-    }
-    else if (idx == 2)
-    {
-        tex = gTex.Sample(gSamplerLinearClamp, i.uv);
-    }
-    else
-    {
-        tex = gTex.Sample(gSamplerPointClamp, i.uv);
-    }
+    Texture2D gTex = gTextures[gTextureIndex];
+    float4 tex = gTex.Sample(gSampler, i.uv);
 
+#if VERTEX_COLOR_BLEND
     return lerp(tex, float4(i.color, 1.0f), 0.25f);
+#else
+    return tex;
+#endif
 }
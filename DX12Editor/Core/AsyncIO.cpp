@@ -0,0 +1,394 @@
+#include "AsyncIO.h"
+#include "IoBackend.h"
+#include <algorithm>
+#include <cstdio>
+
+struct AsyncIO::Pending {
+    RequestId id{ kInvalidRequest };
+    Request   request;
+    Result    result;
+
+    IoFile   file{ kInvalidIoFile };
+    uint8_t* dst{ nullptr };     // request.buffer or result.data
+    uint64_t next{ 0 };          // next file offset to issue
+    uint64_t end{ 0 };
+    uint32_t inFlight{ 0 };
+    bool     queued{ true };     // in m_queued (under m_mutex)
+    bool     failed{ false };
+    std::atomic<bool> cancelled{ false };
+};
+
+namespace {
+    std::FILE* OpenRead(const std::filesystem::path& path) noexcept
+    {
+#if defined(_WIN32)
+        std::FILE* f = nullptr;
+        _wfopen_s(&f, path.c_str(), L"rb");
+        return f;
+#else
+        return std::fopen(path.c_str(), "rb");
+#endif
+    }
+}
+
+// ====================================================
+// Lifetime
+// ====================================================
+AsyncIO::AsyncIO() noexcept = default;
+
+AsyncIO::~AsyncIO()
+{
+    Shutdown();
+}
+
+bool AsyncIO::Initialize(Backend backend, uint32_t queueDepth) noexcept
+{
+    if (IsRunning()) return false;
+    m_queueDepth = std::clamp(queueDepth, 1u, 1024u);
+
+    if (backend != Backend::ThreadPool) m_backend = CreateNativeIoBackend(m_queueDepth);
+    if (!m_backend && backend != Backend::Native)
+        m_backend = CreateThreadPoolIoBackend((std::min)(m_queueDepth, 64u)); // one blocking read per worker
+    if (!m_backend) return false;
+
+    m_ops.clear();
+    m_freeOps.clear();
+    for (uint32_t i = 0; i < m_queueDepth; ++i)
+    {
+        m_ops.push_back(std::make_unique<IoOp>());
+        m_freeOps.push_back(m_ops.back().get());
+    }
+    m_inFlight = 0;
+    m_stop = false;
+    m_dispatcher = std::thread([this] { DispatcherLoop(); });
+    return true;
+}
+
+void AsyncIO::Shutdown() noexcept
+{
+    if (!IsRunning()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        for (std::deque<Pending*>& queue : m_queued)
+        {
+            for (Pending* p : queue)
+            {
+                p->queued = false;
+                p->cancelled = true;
+                m_cancelledQueued.push_back(p);
+            }
+            queue.clear();
+        }
+    }
+    m_backend->Wake();
+    m_dispatcher.join();
+
+    m_backend.reset();
+    m_freeOps.clear();
+    m_ops.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_results.clear();
+}
+
+const char* AsyncIO::BackendName() const noexcept
+{
+    return m_backend ? m_backend->Name() : "none";
+}
+
+// ====================================================
+// Submission
+// ====================================================
+AsyncIO::RequestId AsyncIO::Submit(Request request)
+{
+    RequestId id = kInvalidRequest;
+    std::vector<Request> one;
+    one.push_back(std::move(request));
+    SubmitBatch(one, &id);
+    return id;
+}
+
+void AsyncIO::SubmitBatch(std::vector<Request>& requests, RequestId* ids)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < requests.size(); ++i)
+        {
+            if (m_stop || !IsRunning())
+            {
+                if (ids) ids[i] = kInvalidRequest;
+                continue;
+            }
+            Pending* p = new Pending();
+            p->id = m_nextId++;
+            p->request = std::move(requests[i]);
+            p->result.id = p->id;
+            m_live.emplace(p->id, p);
+            m_queued[size_t(p->request.priority)].push_back(p);
+            if (ids) ids[i] = p->id;
+        }
+    }
+    requests.clear();
+    if (m_backend) m_backend->Wake();
+}
+
+bool AsyncIO::Cancel(RequestId id)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_live.find(id);
+        if (it == m_live.end()) return false;
+        Pending* p = it->second;
+        p->cancelled = true;
+        if (p->queued)
+        {
+            std::deque<Pending*>& queue = m_queued[size_t(p->request.priority)];
+            queue.erase(std::find(queue.begin(), queue.end(), p));
+            p->queued = false;
+            m_cancelledQueued.push_back(p);
+        }
+    }
+    m_backend->Wake();
+    return true;
+}
+
+AsyncIO::Result AsyncIO::Wait(RequestId id)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [&] { return m_results.count(id) != 0 || m_live.count(id) == 0; });
+    auto it = m_results.find(id);
+    if (it == m_results.end())
+    {
+        Result unknown; // invalid id, already waited for, or completed through its callback
+        unknown.id = id;
+        return unknown;
+    }
+    Result result = std::move(it->second);
+    m_results.erase(it);
+    return result;
+}
+
+void AsyncIO::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this] { return m_live.empty(); });
+}
+
+bool AsyncIO::ReadFile(const std::filesystem::path& path, std::vector<uint8_t>& data, Priority priority)
+{
+    if (IsRunning())
+    {
+        Request request;
+        request.path = path;
+        request.priority = priority;
+        Result result = Wait(Submit(std::move(request)));
+        if (result.status != Status::Ok) return false;
+        data = std::move(result.data);
+        return true;
+    }
+
+    std::FILE* f = OpenRead(path);
+    if (!f) return false;
+    std::error_code ec;
+    const uintmax_t size = std::filesystem::file_size(path, ec);
+    data.resize(ec ? 0 : size_t(size));
+    const bool ok = !ec && std::fread(data.data(), 1, data.size(), f) == data.size();
+    std::fclose(f);
+    return ok;
+}
+
+AsyncIO::Stats AsyncIO::GetStats() const noexcept
+{
+    Stats s;
+    s.requests = m_statRequests.load(std::memory_order_relaxed);
+    s.failed = m_statFailed.load(std::memory_order_relaxed);
+    s.cancelled = m_statCancelled.load(std::memory_order_relaxed);
+    s.bytes = m_statBytes.load(std::memory_order_relaxed);
+    s.reads = m_statReads.load(std::memory_order_relaxed);
+    return s;
+}
+
+// ====================================================
+// Dispatcher thread
+// ====================================================
+void AsyncIO::DispatcherLoop()
+{
+    std::vector<Pending*> cancelled;
+    std::vector<IoOp*> batch;
+    std::vector<IoOp*> done;
+    batch.reserve(m_queueDepth);
+
+    for (;;)
+    {
+        bool stop = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            cancelled.swap(m_cancelledQueued);
+            stop = m_stop;
+        }
+        for (Pending* p : cancelled) Finish(p);
+        cancelled.clear();
+
+        // Cancelled while waiting for a free block: nothing left to land.
+        for (size_t i = 0; i < m_active.size();)
+        {
+            Pending* p = m_active[i];
+            if (p->cancelled && p->inFlight == 0)
+            {
+                m_active[i] = m_active.back();
+                m_active.pop_back();
+                Finish(p);
+            }
+            else ++i;
+        }
+
+        // Open up to queueDepth files at a time, then fill the device queue.
+        while (m_active.size() < m_queueDepth && Activate()) {}
+        batch.clear();
+        IssueBlocks(batch);
+        if (!batch.empty()) m_backend->Submit(batch.data(), batch.size());
+
+        if (stop && m_active.empty()) break; // Shutdown emptied the queues
+
+        done.clear();
+        m_backend->Reap(done, true);
+        for (IoOp* op : done) OnReadDone(op);
+    }
+}
+
+// Takes the most urgent queued request and opens it. False if none is queued.
+bool AsyncIO::Activate()
+{
+    Pending* p = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (std::deque<Pending*>& queue : m_queued)
+        {
+            if (queue.empty()) continue;
+            p = queue.front();
+            queue.pop_front();
+            p->queued = false;
+            break;
+        }
+    }
+    if (!p) return false;
+
+    const Request& r = p->request;
+    uint64_t fileSize = 0;
+    p->file = m_backend->Open(r.path, &fileSize);
+    if (p->file == kInvalidIoFile || (r.buffer && r.size == kWholeFile))
+    {
+        p->failed = true;
+        Finish(p);
+        return true;
+    }
+
+    // Reads past the end are clamped to the file.
+    const uint64_t available = fileSize > r.offset ? fileSize - r.offset : 0;
+    const uint64_t size = (std::min)(r.size, available);
+    if (r.buffer) p->dst = r.buffer;
+    else
+    {
+        p->result.data.resize(size_t(size));
+        p->dst = p->result.data.data();
+    }
+    p->next = r.offset;
+    p->end = r.offset + size;
+
+    if (size == 0) Finish(p);
+    else           m_active.push_back(p);
+    return true;
+}
+
+// Cuts the next blocks of the active requests, most urgent first, until the
+// queue depth is reached.
+void AsyncIO::IssueBlocks(std::vector<IoOp*>& batch)
+{
+    for (uint32_t priority = 0; priority < 3; ++priority)
+    {
+        for (Pending* p : m_active)
+        {
+            if (uint32_t(p->request.priority) != priority) continue;
+            while (p->next < p->end && !p->failed && !p->cancelled && !m_freeOps.empty())
+            {
+                IoOp* op = m_freeOps.back();
+                m_freeOps.pop_back();
+                op->file = p->file;
+                op->offset = p->next;
+                op->dst = p->dst + (p->next - p->request.offset);
+                op->size = uint32_t((std::min)(p->end - p->next, uint64_t(kBlockSize)));
+                op->result = 0;
+                op->owner = p;
+                p->next += op->size;
+                ++p->inFlight;
+                ++m_inFlight;
+                batch.push_back(op);
+            }
+            if (m_freeOps.empty()) return;
+        }
+    }
+}
+
+void AsyncIO::OnReadDone(IoOp* op)
+{
+    Pending* p = static_cast<Pending*>(op->owner);
+    m_statReads.fetch_add(1, std::memory_order_relaxed);
+    --m_inFlight;
+    --p->inFlight;
+
+    if (op->result <= 0)
+    {
+        // Error, or end of file before the size seen at open: the file changed.
+        p->failed = true;
+    }
+    else
+    {
+        const uint32_t read = uint32_t(op->result);
+        p->result.bytes += read;
+        if (read < op->size && !p->cancelled && !p->failed)
+        {
+            // Short read: reissue the rest of the block.
+            op->offset += read;
+            op->dst += read;
+            op->size -= read;
+            ++p->inFlight;
+            ++m_inFlight;
+            m_backend->Submit(&op, 1);
+            return;
+        }
+    }
+    m_freeOps.push_back(op);
+
+    if (p->inFlight == 0 && (p->next >= p->end || p->failed || p->cancelled))
+    {
+        m_active.erase(std::find(m_active.begin(), m_active.end(), p));
+        Finish(p);
+    }
+}
+
+void AsyncIO::Finish(Pending* p)
+{
+    if (p->file != kInvalidIoFile) m_backend->Close(p->file);
+
+    Result& result = p->result;
+    result.status = p->cancelled ? Status::Cancelled : p->failed ? Status::Failed : Status::Ok;
+    if (result.status != Status::Ok)
+    {
+        result.bytes = 0;
+        result.data.clear();
+    }
+
+    m_statRequests.fetch_add(1, std::memory_order_relaxed);
+    m_statBytes.fetch_add(result.bytes, std::memory_order_relaxed);
+    if (result.status == Status::Failed)    m_statFailed.fetch_add(1, std::memory_order_relaxed);
+    if (result.status == Status::Cancelled) m_statCancelled.fetch_add(1, std::memory_order_relaxed);
+
+    if (p->request.onComplete) p->request.onComplete(result);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!p->request.onComplete) m_results.emplace(p->id, std::move(result));
+        m_live.erase(p->id);
+    }
+    m_doneCv.notify_all();
+    delete p;
+}
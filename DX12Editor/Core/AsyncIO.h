@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class IoBackend;
+struct IoOp;
+
+// Asynchronous file reads. Requests are queued by priority; one dispatcher
+// thread opens files, splits reads into blocks and keeps up to 'queueDepth'
+// blocks in flight on the backend, so many small files and a few large ones
+// both keep the device busy.
+//
+// Backends: io_uring (Linux), overlapped I/O on an I/O completion port
+// (Windows), or a portable thread pool doing positioned blocking reads, used
+// when the native one is unavailable or when asked for.
+//
+// Completion: a request with a callback gets it on the dispatcher thread
+// (keep it short: hand the data off, don't do work there). Requests without
+// one are collected with Wait().
+class AsyncIO {
+public:
+    enum class Backend : uint8_t { Auto, Native, ThreadPool };
+    enum class Priority : uint8_t { High, Normal, Low };
+    enum class Status : uint8_t { Ok, Failed, Cancelled };
+
+    using RequestId = uint64_t;
+    static constexpr RequestId kInvalidRequest = 0;
+    static constexpr uint64_t  kWholeFile = ~uint64_t(0);
+    static constexpr uint32_t  kBlockSize = 1u << 20; // largest single read
+
+    struct Result {
+        RequestId id{ kInvalidRequest };
+        Status    status{ Status::Failed };
+        uint64_t  bytes{ 0 };          // read into data / the caller's buffer
+        std::vector<uint8_t> data;     // when the request had no buffer
+    };
+    using Callback = std::function<void(Result& result)>;
+
+    struct Request {
+        std::filesystem::path path;
+        uint64_t offset{ 0 };
+        uint64_t size{ kWholeFile };   // kWholeFile: from offset to the end
+        uint8_t* buffer{ nullptr };    // optional destination, 'size' bytes (size required)
+        Priority priority{ Priority::Normal };
+        Callback onComplete;
+    };
+
+    struct Stats {
+        uint64_t requests{ 0 };
+        uint64_t failed{ 0 };
+        uint64_t cancelled{ 0 };
+        uint64_t bytes{ 0 };
+        uint64_t reads{ 0 };           // backend operations
+    };
+
+    AsyncIO() noexcept;
+    ~AsyncIO();
+
+    AsyncIO(const AsyncIO&) = delete;
+    AsyncIO& operator=(const AsyncIO&) = delete;
+
+    bool Initialize(Backend backend = Backend::Auto, uint32_t queueDepth = 32) noexcept;
+    // Cancels what is still queued, finishes what is in flight, joins.
+    void Shutdown() noexcept;
+    bool IsRunning() const noexcept { return m_dispatcher.joinable(); }
+    const char* BackendName() const noexcept;
+
+    RequestId Submit(Request request);
+    // Queues all requests under one lock and one wakeup; ids[i] (optional) per request.
+    void SubmitBatch(std::vector<Request>& requests, RequestId* ids = nullptr);
+
+    // Queued: removed and completed as Cancelled. In flight: no further blocks
+    // are issued and it completes as Cancelled once the issued ones land.
+    // False if the request already completed.
+    bool Cancel(RequestId id);
+
+    // Result of a request submitted without a callback (blocks until done).
+    Result Wait(RequestId id);
+    // Until every submitted request has completed.
+    void WaitIdle();
+
+    // Whole-file read through the service, blocking; reads directly when the
+    // service is not running.
+    bool ReadFile(const std::filesystem::path& path, std::vector<uint8_t>& data, Priority priority = Priority::High);
+
+    Stats GetStats() const noexcept;
+
+private:
+    struct Pending;
+
+    void DispatcherLoop();
+    bool Activate();
+    void IssueBlocks(std::vector<IoOp*>& batch);
+    void OnReadDone(IoOp* op);
+    void Finish(Pending* p);
+
+private:
+    std::unique_ptr<IoBackend> m_backend;
+    std::thread m_dispatcher;
+    uint32_t    m_queueDepth{ 32 };
+
+    // Shared with submitters, under m_mutex.
+    mutable std::mutex m_mutex;
+    std::condition_variable m_doneCv;
+    std::deque<Pending*> m_queued[3];        // by priority
+    std::vector<Pending*> m_cancelledQueued; // taken out of m_queued, to be completed
+    std::unordered_map<RequestId, Pending*> m_live;
+    std::unordered_map<RequestId, Result> m_results; // finished, no callback, not yet waited for
+    RequestId m_nextId{ 1 };
+    bool      m_stop{ false };
+
+    // Dispatcher thread only.
+    std::vector<Pending*> m_active;          // open, blocks left or in flight
+    std::vector<IoOp*>    m_freeOps;
+    std::vector<std::unique_ptr<IoOp>> m_ops;
+    uint32_t              m_inFlight{ 0 };
+
+    std::atomic<uint64_t> m_statRequests{ 0 };
+    std::atomic<uint64_t> m_statFailed{ 0 };
+    std::atomic<uint64_t> m_statCancelled{ 0 };
+    std::atomic<uint64_t> m_statBytes{ 0 };
+    std::atomic<uint64_t> m_statReads{ 0 };
+};
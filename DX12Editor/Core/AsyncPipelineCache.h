@@ -0,0 +1,237 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "JobSystem.h"
+#include "PipelineCache.h"
+
+using PipelineHandle = uint32_t;
+constexpr PipelineHandle kNoPipeline = 0xFFFFFFFFu;
+
+struct AsyncPipelineStats {
+    PipelineCacheStats lookups;   // memoryHits = requests for a key already known
+    uint32_t queued{ 0 };         // waiting for a compile slot
+    uint32_t compiling{ 0 };      // on a worker
+    uint64_t fallbacks{ 0 };      // Resolve() answered with the fallback
+    uint64_t skipped{ 0 };        // Resolve() had nothing to draw with
+    double   waitMs{ 0.0 };       // total request -> ready time of finished pipelines
+    double   maxWaitMs{ 0.0 };
+};
+
+// Compiles pipelines on the job system instead of the frame. Request()
+// returns a handle at once (the same one for a key already requested);
+// the build runs on a worker, at most 'maxInFlight' at a time so frame jobs
+// keep workers, and Update() - once per frame on the render thread -
+// publishes what finished. Until then Resolve() answers with a fallback
+// pipeline, or null to skip the draw.
+//
+// Handles, Resolve and Update belong to one thread; only the build
+// functions run elsewhere and must not touch the caller's state. Kept free
+// of D3D12 so the scheduling can be exercised with simulated compiles
+// (Tools/PipelineCacheTool.cpp).
+template <typename Pipeline>
+class AsyncPipelineCache {
+public:
+    using BuildFn = std::function<PipelineSource(Pipeline& out)>;
+
+    AsyncPipelineCache() noexcept = default;
+    AsyncPipelineCache(const AsyncPipelineCache&) = delete;
+    AsyncPipelineCache& operator=(const AsyncPipelineCache&) = delete;
+    ~AsyncPipelineCache() { Shutdown(); }
+
+    // jobs == nullptr builds inline in Request (synchronous, as before).
+    void Initialize(JobSystem* jobs, uint32_t maxInFlight) noexcept
+    {
+        m_jobs = jobs;
+        m_maxInFlight = maxInFlight ? maxInFlight : 1;
+    }
+
+    // Drops queued builds and waits for running ones.
+    void Shutdown()
+    {
+        m_queue.clear();
+        std::unique_lock<std::mutex> lock(m_doneMutex);
+        m_doneCv.wait(lock, [&] { return m_running == 0; });
+    }
+
+    PipelineHandle Request(const PipelineKey& key, BuildFn build)
+    {
+        ++m_stats.lookups.requests;
+        auto it = m_handles.find(key);
+        if (it != m_handles.end())
+        {
+            ++m_stats.lookups.memoryHits;
+            return it->second;
+        }
+
+        const PipelineHandle handle = PipelineHandle(m_slots.size());
+        m_slots.emplace_back();
+        m_slots.back().requested = Clock::now();
+        m_handles.emplace(key, handle);
+        m_queue.push_back({ handle, std::move(build) });
+        Pump();
+        if (!m_jobs) Update();
+        return handle;
+    }
+
+    // Publishes finished builds and starts queued ones. Returns how many
+    // pipelines became ready (or failed).
+    uint32_t Update()
+    {
+        std::vector<Done> done;
+        {
+            std::lock_guard<std::mutex> lock(m_doneMutex);
+            done.swap(m_done);
+        }
+        const auto now = Clock::now();
+        for (Done& d : done)
+        {
+            Slot& slot = m_slots[d.handle];
+            --m_inFlight;
+            switch (d.source)
+            {
+            case PipelineSource::Library: ++m_stats.lookups.libraryHits; m_stats.lookups.libraryMs += d.ms; break;
+            case PipelineSource::Created: ++m_stats.lookups.created;     m_stats.lookups.createMs += d.ms;  break;
+            case PipelineSource::Failed:  ++m_stats.lookups.failed; break;
+            }
+            slot.state = (d.source == PipelineSource::Failed) ? State::Failed : State::Ready;
+            slot.pipeline = std::move(d.pipeline);
+
+            const double wait = std::chrono::duration<double, std::milli>(now - slot.requested).count();
+            m_stats.waitMs += wait;
+            if (wait > m_stats.maxWaitMs) m_stats.maxWaitMs = wait;
+        }
+        Pump();
+        return uint32_t(done.size());
+    }
+
+    // Blocks until 'handle' is built; true if it is usable.
+    bool Wait(PipelineHandle handle)
+    {
+        if (handle >= m_slots.size()) return false;
+        while (m_slots[handle].state == State::Pending)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_doneMutex);
+                m_doneCv.wait(lock, [&] { return !m_done.empty(); });
+            }
+            Update();
+        }
+        return m_slots[handle].state == State::Ready;
+    }
+
+    // Blocks until nothing is queued or compiling.
+    void WaitIdle()
+    {
+        while (!Idle())
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_doneMutex);
+                m_doneCv.wait(lock, [&] { return !m_done.empty(); });
+            }
+            Update();
+        }
+    }
+
+    // The pipeline if it is ready, else the fallback if that is, else null.
+    const Pipeline* Resolve(PipelineHandle handle, PipelineHandle fallback = kNoPipeline)
+    {
+        if (Ready(handle)) return &m_slots[handle].pipeline;
+        if (Ready(fallback))
+        {
+            ++m_stats.fallbacks;
+            return &m_slots[fallback].pipeline;
+        }
+        ++m_stats.skipped;
+        return nullptr;
+    }
+
+    bool Ready(PipelineHandle handle) const noexcept
+    {
+        return handle < m_slots.size() && m_slots[handle].state == State::Ready;
+    }
+    bool Failed(PipelineHandle handle) const noexcept
+    {
+        return handle < m_slots.size() && m_slots[handle].state == State::Failed;
+    }
+    bool Idle() const noexcept { return m_queue.empty() && m_inFlight == 0; }
+
+    AsyncPipelineStats GetStats() const noexcept
+    {
+        AsyncPipelineStats s = m_stats;
+        s.queued = uint32_t(m_queue.size());
+        s.compiling = m_inFlight;
+        return s;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    enum class State : uint8_t { Pending, Ready, Failed };
+
+    struct Slot {
+        Pipeline pipeline{};
+        State    state{ State::Pending };
+        Clock::time_point requested;
+    };
+    struct Queued {
+        PipelineHandle handle;
+        BuildFn        build;
+    };
+    struct Done {
+        PipelineHandle handle;
+        PipelineSource source;
+        Pipeline       pipeline;
+        double         ms;
+    };
+
+    void Pump()
+    {
+        while (m_inFlight < m_maxInFlight && !m_queue.empty())
+        {
+            Queued q = std::move(m_queue.front());
+            m_queue.pop_front();
+            ++m_inFlight;
+            {
+                std::lock_guard<std::mutex> lock(m_doneMutex);
+                ++m_running;
+            }
+            auto job = [this, q = std::move(q)]() {
+                Pipeline pipeline{};
+                const auto t0 = Clock::now();
+                const PipelineSource source = q.build(pipeline);
+                const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+                {
+                    std::lock_guard<std::mutex> lock(m_doneMutex);
+                    m_done.push_back({ q.handle, source, std::move(pipeline), ms });
+                    --m_running;
+                    m_doneCv.notify_all(); // under the lock: Shutdown may destroy us right after
+                }
+            };
+            if (m_jobs) m_jobs->Submit(std::move(job), JobSystem::Priority::Background); // never run by a ParallelFor wait
+            else        job();
+        }
+    }
+
+private:
+    JobSystem* m_jobs{ nullptr };
+    uint32_t   m_maxInFlight{ 1 };
+
+    // Render thread only.
+    std::vector<Slot> m_slots;   // by handle
+    std::unordered_map<PipelineKey, PipelineHandle, DerivedDataCache::KeyHash> m_handles;
+    std::deque<Queued> m_queue;
+    uint32_t m_inFlight{ 0 };    // submitted, not yet published by Update
+    AsyncPipelineStats m_stats;
+
+    // Shared with the workers.
+    std::mutex m_doneMutex;
+    std::condition_variable m_doneCv;
+    std::vector<Done> m_done;
+    uint32_t m_running{ 0 };     // jobs not yet finished
+};
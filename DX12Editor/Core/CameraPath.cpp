@@ -0,0 +1,211 @@
+#include "CameraPath.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "Camera.h"
+
+namespace {
+    const char* kOpNames[] = { "focus", "orbit", "rotate", "zoom", "move" };
+
+    FILE* OpenFile(const char* path, const char* mode)
+    {
+        FILE* f = nullptr;
+#ifdef _WIN32
+        fopen_s(&f, path, mode);
+#else
+        f = std::fopen(path, mode);
+#endif
+        return f;
+    }
+}
+
+void CameraPath::Add(const CameraPathOp& op)
+{
+    // Keep ops sorted by frame; ops of the same frame stay in insertion order.
+    auto it = std::upper_bound(m_ops.begin(), m_ops.end(), op.frame,
+        [](uint32_t frame, const CameraPathOp& o) { return frame < o.frame; });
+    m_ops.insert(it, op);
+}
+
+bool CameraPath::Load(const char* path)
+{
+    FILE* f = OpenFile(path, "rb");
+    if (!f) return false;
+
+    m_ops.clear();
+    m_name = path;
+
+    char line[256];
+    while (std::fgets(line, sizeof(line), f))
+    {
+        if (char* hash = std::strchr(line, '#')) *hash = '\0';
+
+        unsigned frame = 0;
+        char op[16]{};
+        int consumed = 0;
+        if (std::sscanf(line, "%u %15s%n", &frame, op, &consumed) < 2)
+            continue; // blank / comment line
+
+        const char* rest = line + consumed;
+        CameraPathOp o{};
+        o.frame = frame;
+
+        if (!std::strcmp(op, "focus"))
+        {
+            o.type = CameraPathOp::Type::Focus;
+            if (std::sscanf(rest, "%f %f %f %f", &o.args[0], &o.args[1], &o.args[2], &o.args[3]) != 4) { std::fclose(f); return false; }
+        }
+        else if (!std::strcmp(op, "orbit"))
+        {
+            o.type = CameraPathOp::Type::Orbit;
+            unsigned enabled = 0;
+            if (std::sscanf(rest, "%u %f %f %f", &enabled, &o.args[0], &o.args[1], &o.args[2]) < 1) { std::fclose(f); return false; }
+            o.flags = enabled ? 1u : 0u;
+        }
+        else if (!std::strcmp(op, "rotate"))
+        {
+            o.type = CameraPathOp::Type::Rotate;
+            if (std::sscanf(rest, "%f %f", &o.args[0], &o.args[1]) != 2) { std::fclose(f); return false; }
+        }
+        else if (!std::strcmp(op, "zoom"))
+        {
+            o.type = CameraPathOp::Type::Zoom;
+            if (std::sscanf(rest, "%f", &o.args[0]) != 1) { std::fclose(f); return false; }
+        }
+        else if (!std::strcmp(op, "move"))
+        {
+            o.type = CameraPathOp::Type::Move;
+            unsigned b[7]{};
+            if (std::sscanf(rest, "%u %u %u %u %u %u %u", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5], &b[6]) != 7) { std::fclose(f); return false; }
+            for (uint32_t i = 0; i < 7; ++i)
+                if (b[i]) o.flags |= 1u << i;
+        }
+        else
+        {
+            std::fclose(f);
+            return false; // unknown op: refuse rather than replay a different path
+        }
+        Add(o);
+    }
+
+    std::fclose(f);
+    return true;
+}
+
+bool CameraPath::Save(const char* path) const
+{
+    FILE* f = OpenFile(path, "wb");
+    if (!f) return false;
+
+    std::fprintf(f, "# frame op args\n");
+    for (const CameraPathOp& o : m_ops)
+    {
+        std::fprintf(f, "%u %s", o.frame, kOpNames[uint32_t(o.type)]);
+        switch (o.type)
+        {
+        case CameraPathOp::Type::Focus:
+            std::fprintf(f, " %.6g %.6g %.6g %.6g", o.args[0], o.args[1], o.args[2], o.args[3]);
+            break;
+        case CameraPathOp::Type::Orbit:
+            std::fprintf(f, " %u %.6g %.6g %.6g", o.flags & 1u, o.args[0], o.args[1], o.args[2]);
+            break;
+        case CameraPathOp::Type::Rotate:
+            std::fprintf(f, " %.6g %.6g", o.args[0], o.args[1]);
+            break;
+        case CameraPathOp::Type::Zoom:
+            std::fprintf(f, " %.6g", o.args[0]);
+            break;
+        case CameraPathOp::Type::Move:
+            for (uint32_t i = 0; i < 7; ++i)
+                std::fprintf(f, " %u", (o.flags >> i) & 1u);
+            break;
+        }
+        std::fputc('\n', f);
+    }
+    return std::fclose(f) == 0;
+}
+
+CameraPath CameraPath::MakeDefault(uint32_t frames)
+{
+    CameraPath p;
+    if (frames == 0) return p;
+
+    const uint32_t third = std::max(frames / 3, 1u);
+
+    // 1) Orbit once around the origin.
+    CameraPathOp focus{};
+    focus.frame = 0;
+    focus.type = CameraPathOp::Type::Focus;
+    focus.args[3] = 10.0f;
+    p.Add(focus);
+
+    // Same mouse delta every frame, like a steady Alt+LMB drag.
+    for (uint32_t f = 0; f < third; ++f)
+    {
+        CameraPathOp rot{};
+        rot.frame = f;
+        rot.type = CameraPathOp::Type::Rotate;
+        rot.args[0] = 4.0f;
+        p.Add(rot);
+    }
+
+    // 2) Zoom in and back out over the second third.
+    for (uint32_t f = third; f < 2 * third && f < frames; ++f)
+    {
+        CameraPathOp zoom{};
+        zoom.frame = f;
+        zoom.type = CameraPathOp::Type::Zoom;
+        zoom.args[0] = (f - third < third / 2) ? 0.1f : -0.1f;
+        p.Add(zoom);
+    }
+
+    // 3) Leave orbit and fly forward / strafe for the rest.
+    CameraPathOp orbitOff{};
+    orbitOff.frame = 2 * third;
+    orbitOff.type = CameraPathOp::Type::Orbit;
+    p.Add(orbitOff);
+
+    CameraPathOp move{};
+    move.frame = 2 * third;
+    move.type = CameraPathOp::Type::Move;
+    move.flags = 1u << 0 | 1u << 3; // forward + right
+    p.Add(move);
+
+    CameraPathOp stop = move;
+    stop.frame = frames - 1;
+    stop.flags = 0;
+    p.Add(stop);
+
+    return p;
+}
+
+void CameraPath::Apply(uint32_t frame, Camera& camera) const
+{
+    auto first = std::lower_bound(m_ops.begin(), m_ops.end(), frame,
+        [](const CameraPathOp& o, uint32_t f) { return o.frame < f; });
+
+    for (auto it = first; it != m_ops.end() && it->frame == frame; ++it)
+    {
+        const CameraPathOp& o = *it;
+        switch (o.type)
+        {
+        case CameraPathOp::Type::Focus:
+            camera.Focus({ o.args[0], o.args[1], o.args[2] }, o.args[3]);
+            break;
+        case CameraPathOp::Type::Orbit:
+            camera.SetOrbitMode((o.flags & 1u) != 0, { o.args[0], o.args[1], o.args[2] });
+            break;
+        case CameraPathOp::Type::Rotate:
+            camera.Rotate(o.args[0], o.args[1]);
+            break;
+        case CameraPathOp::Type::Zoom:
+            camera.Zoom(o.args[0]);
+            break;
+        case CameraPathOp::Type::Move:
+            camera.SetMovement(o.flags & 1u, o.flags & 2u, o.flags & 4u, o.flags & 8u,
+                o.flags & 16u, o.flags & 32u, o.flags & 64u);
+            break;
+        }
+    }
+}
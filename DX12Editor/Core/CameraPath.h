@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Camera;
+
+// Recorded camera flythrough: a list of Camera calls keyed by frame number.
+// Replayed with a fixed timestep the same path gives the same camera on
+// every run, which keeps benchmark numbers comparable across commits.
+//
+// Text format, one op per line ('#' starts a comment):
+//   <frame> focus  x y z distance
+//   <frame> orbit  0|1 [x y z]
+//   <frame> rotate dx dy
+//   <frame> zoom   ticks
+//   <frame> move   fwd back left right up down fast   (0/1 each, held until changed)
+struct CameraPathOp {
+    enum class Type : uint8_t { Focus, Orbit, Rotate, Zoom, Move };
+
+    uint32_t frame{ 0 };
+    Type     type{ Type::Rotate };
+    float    args[4]{};
+    uint32_t flags{ 0 }; // Orbit: enabled; Move: bit mask (fwd = bit 0 ... fast = bit 6)
+};
+
+class CameraPath {
+public:
+    bool Load(const char* path);
+    bool Save(const char* path) const;
+
+    // Built-in flythrough used when no path file is given: orbit, zoom, fly.
+    static CameraPath MakeDefault(uint32_t frames);
+
+    void Add(const CameraPathOp& op);
+
+    // Applies every op recorded for 'frame' (before the renderer's Camera::Update).
+    void Apply(uint32_t frame, Camera& camera) const;
+
+    size_t   Size() const noexcept { return m_ops.size(); }
+    uint32_t LastFrame() const noexcept { return m_ops.empty() ? 0 : m_ops.back().frame; }
+    const std::string& Name() const noexcept { return m_name; }
+
+private:
+    std::vector<CameraPathOp> m_ops; // sorted by frame, stable
+    std::string m_name{ "default" };
+};
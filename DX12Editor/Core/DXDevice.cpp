@@ -3,7 +3,7 @@
 
 using Microsoft::WRL::ComPtr;
 
-bool DXDevice::Initialize(bool enableDebugLayer) noexcept {
+bool DXDevice::Initialize(bool enableDebugLayer, bool forceWarp) noexcept {
 #if _DEBUG
     if (enableDebugLayer) {
         ComPtr<ID3D12Debug> debug;
@@ -13,7 +13,7 @@ bool DXDevice::Initialize(bool enableDebugLayer) noexcept {
     }
 #endif
     if (!CreateFactory(enableDebugLayer)) return false;
-    if (!PickAdapter()) return false;
+    if (!PickAdapter(forceWarp)) return false;
     if (!CreateDevice()) return false;
     return true;
 }
@@ -26,9 +26,9 @@ bool DXDevice::CreateFactory(bool enableDebugLayer) noexcept {
     return SUCCEEDED(CreateDXGIFactory2(flags, IID_PPV_ARGS(&m_factory)));
 }
 
-bool DXDevice::PickAdapter() noexcept {
+bool DXDevice::PickAdapter(bool forceWarp) noexcept {
     ComPtr<IDXGIAdapter1> adapter;
-    for (UINT i = 0; m_factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; ++i) {
+    for (UINT i = 0; !forceWarp && m_factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; ++i) {
         DXGI_ADAPTER_DESC1 desc{};
         adapter->GetDesc1(&desc);
         if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) continue;
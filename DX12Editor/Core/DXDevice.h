@@ -12,7 +12,8 @@ public:
     DXDevice(const DXDevice&) = delete;
     DXDevice& operator=(const DXDevice&) = delete;
 
-    bool Initialize(bool enableDebugLayer) noexcept;
+    // forceWarp: skip hardware adapters and use the WARP software rasterizer.
+    bool Initialize(bool enableDebugLayer, bool forceWarp = false) noexcept;
 
     ID3D12Device* GetDevice()  const noexcept { return m_device.Get(); }
     IDXGIFactory6* GetFactory() const noexcept { return m_factory.Get(); }
@@ -22,7 +23,7 @@ public:
 
 private:
     bool CreateFactory(bool enableDebugLayer) noexcept;
-    bool PickAdapter() noexcept;
+    bool PickAdapter(bool forceWarp) noexcept;
     bool CreateDevice() noexcept;
 
 private:
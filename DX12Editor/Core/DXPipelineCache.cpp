@@ -0,0 +1,320 @@
+#include <windows.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <system_error>
+
+#include "DXPipelineCache.h"
+#include "DerivedDataCache.h"
+#include "JobSystem.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace {
+    // Bumped when the hashing below changes meaning.
+    constexpr uint32_t kKeyVersion = 1;
+
+    void AddShader(PipelineKeyBuilder& key, const D3D12_SHADER_BYTECODE& shader)
+    {
+        key.Add(shader.pShaderBytecode, shader.pShaderBytecode ? shader.BytecodeLength : 0);
+    }
+
+    void AddString(PipelineKeyBuilder& key, const char* text)
+    {
+        key.AddString(text ? text : "");
+    }
+
+    // A graphics pipeline description that owns what it points to, so the
+    // build can run after the caller's buffers are gone.
+    struct OwnedGraphicsPipelineDesc {
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC desc{};
+        std::vector<uint8_t> shaders[5];                  // VS, PS, DS, HS, GS
+        std::vector<D3D12_INPUT_ELEMENT_DESC> layout;
+        std::vector<std::string> semantics;
+
+        explicit OwnedGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& src)
+            : desc(src)
+        {
+            D3D12_SHADER_BYTECODE* stages[5] = { &desc.VS, &desc.PS, &desc.DS, &desc.HS, &desc.GS };
+            for (int i = 0; i < 5; ++i)
+            {
+                const uint8_t* code = static_cast<const uint8_t*>(stages[i]->pShaderBytecode);
+                if (code) shaders[i].assign(code, code + stages[i]->BytecodeLength);
+                *stages[i] = { shaders[i].empty() ? nullptr : shaders[i].data(), shaders[i].size() };
+            }
+
+            layout.assign(src.InputLayout.pInputElementDescs, src.InputLayout.pInputElementDescs + src.InputLayout.NumElements);
+            semantics.reserve(layout.size());
+            for (D3D12_INPUT_ELEMENT_DESC& e : layout)
+            {
+                semantics.emplace_back(e.SemanticName ? e.SemanticName : "");
+                e.SemanticName = semantics.back().c_str();
+            }
+            desc.InputLayout = { layout.empty() ? nullptr : layout.data(), UINT(layout.size()) };
+            desc.StreamOutput = {};
+            desc.CachedPSO = {};
+        }
+    };
+
+    bool ReadWholeFile(const std::filesystem::path& path, std::vector<uint8_t>& data)
+    {
+        std::FILE* f = nullptr;
+        if (_wfopen_s(&f, path.c_str(), L"rb") != 0 || !f) return false;
+        std::error_code ec;
+        data.resize(size_t(std::filesystem::file_size(path, ec)));
+        const bool ok = !ec && std::fread(data.data(), 1, data.size(), f) == data.size();
+        std::fclose(f);
+        return ok;
+    }
+}
+
+// ====================================================
+// Keys
+// ====================================================
+// Field by field: the state structs have padding, whose bytes are not part
+// of the description.
+PipelineKey DXPipelineCache::HashRootSignature(const D3D12_ROOT_SIGNATURE_DESC& desc) noexcept
+{
+    PipelineKeyBuilder key("d3d12-root-signature", kKeyVersion);
+    key.AddValue(desc.NumParameters).AddValue(desc.NumStaticSamplers).AddValue(desc.Flags);
+    for (UINT i = 0; i < desc.NumParameters; ++i)
+    {
+        const D3D12_ROOT_PARAMETER& p = desc.pParameters[i];
+        key.AddValue(p.ParameterType).AddValue(p.ShaderVisibility);
+        switch (p.ParameterType)
+        {
+        case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+            key.AddValue(p.DescriptorTable.NumDescriptorRanges);
+            for (UINT r = 0; r < p.DescriptorTable.NumDescriptorRanges; ++r)
+                key.AddValue(p.DescriptorTable.pDescriptorRanges[r]); // all 32-bit fields
+            break;
+        case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+            key.AddValue(p.Constants);
+            break;
+        default:
+            key.AddValue(p.Descriptor);
+            break;
+        }
+    }
+    for (UINT i = 0; i < desc.NumStaticSamplers; ++i)
+        key.AddValue(desc.pStaticSamplers[i]); // all 32-bit fields
+    return key.Finish();
+}
+
+PipelineKey DXPipelineCache::HashGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc,
+    const PipelineKey& rootSignature) noexcept
+{
+    PipelineKeyBuilder key("d3d12-graphics-pipeline", kKeyVersion);
+    key.AddValue(rootSignature);
+    AddShader(key, desc.VS);
+    AddShader(key, desc.PS);
+    AddShader(key, desc.DS);
+    AddShader(key, desc.HS);
+    AddShader(key, desc.GS);
+
+    const D3D12_STREAM_OUTPUT_DESC& so = desc.StreamOutput;
+    key.AddValue(so.NumEntries).AddValue(so.NumStrides).AddValue(so.RasterizedStream);
+    for (UINT i = 0; i < so.NumEntries; ++i)
+    {
+        const D3D12_SO_DECLARATION_ENTRY& e = so.pSODeclaration[i];
+        AddString(key, e.SemanticName);
+        key.AddValue(e.Stream).AddValue(e.SemanticIndex).AddValue(e.StartComponent)
+           .AddValue(e.ComponentCount).AddValue(e.OutputSlot);
+    }
+    for (UINT i = 0; i < so.NumStrides; ++i) key.AddValue(so.pBufferStrides[i]);
+
+    const D3D12_BLEND_DESC& blend = desc.BlendState;
+    key.AddValue(blend.AlphaToCoverageEnable).AddValue(blend.IndependentBlendEnable);
+    for (const D3D12_RENDER_TARGET_BLEND_DESC& rt : blend.RenderTarget)
+    {
+        key.AddValue(rt.BlendEnable).AddValue(rt.LogicOpEnable)
+           .AddValue(rt.SrcBlend).AddValue(rt.DestBlend).AddValue(rt.BlendOp)
+           .AddValue(rt.SrcBlendAlpha).AddValue(rt.DestBlendAlpha).AddValue(rt.BlendOpAlpha)
+           .AddValue(rt.LogicOp).AddValue(rt.RenderTargetWriteMask);
+    }
+    key.AddValue(desc.SampleMask);
+
+    const D3D12_RASTERIZER_DESC& r = desc.RasterizerState;
+    key.AddValue(r.FillMode).AddValue(r.CullMode).AddValue(r.FrontCounterClockwise)
+       .AddValue(r.DepthBias).AddValue(r.DepthBiasClamp).AddValue(r.SlopeScaledDepthBias)
+       .AddValue(r.DepthClipEnable).AddValue(r.MultisampleEnable).AddValue(r.AntialiasedLineEnable)
+       .AddValue(r.ForcedSampleCount).AddValue(r.ConservativeRaster);
+
+    const D3D12_DEPTH_STENCIL_DESC& ds = desc.DepthStencilState;
+    key.AddValue(ds.DepthEnable).AddValue(ds.DepthWriteMask).AddValue(ds.DepthFunc)
+       .AddValue(ds.StencilEnable).AddValue(ds.StencilReadMask).AddValue(ds.StencilWriteMask)
+       .AddValue(ds.FrontFace).AddValue(ds.BackFace); // four 32-bit enums each
+
+    key.AddValue(desc.InputLayout.NumElements);
+    for (UINT i = 0; i < desc.InputLayout.NumElements; ++i)
+    {
+        const D3D12_INPUT_ELEMENT_DESC& e = desc.InputLayout.pInputElementDescs[i];
+        AddString(key, e.SemanticName);
+        key.AddValue(e.SemanticIndex).AddValue(e.Format).AddValue(e.InputSlot)
+           .AddValue(e.AlignedByteOffset).AddValue(e.InputSlotClass).AddValue(e.InstanceDataStepRate);
+    }
+
+    key.AddValue(desc.IBStripCutValue).AddValue(desc.PrimitiveTopologyType).AddValue(desc.NumRenderTargets);
+    for (UINT i = 0; i < desc.NumRenderTargets; ++i) key.AddValue(desc.RTVFormats[i]);
+    key.AddValue(desc.DSVFormat).AddValue(desc.SampleDesc).AddValue(desc.NodeMask).AddValue(desc.Flags);
+    return key.Finish();
+}
+
+// ====================================================
+// Cache
+// ====================================================
+bool DXPipelineCache::Initialize(ID3D12Device* device, const std::filesystem::path& libraryPath, DerivedDataCache* blobs,
+    JobSystem* jobs, uint32_t maxCompiles) noexcept
+{
+    m_pipelines.Initialize(jobs, maxCompiles);
+    m_device = device;
+    m_blobs = blobs;
+    m_jobs = jobs;
+    m_libraryPath = libraryPath;
+
+    // No ID3D12Device1 (very old runtime): still dedupes, just doesn't persist pipelines.
+    if (FAILED(device->QueryInterface(IID_PPV_ARGS(&m_device1)))) return true;
+
+    if (ReadWholeFile(libraryPath, m_libraryData) && !m_libraryData.empty() &&
+        SUCCEEDED(m_device1->CreatePipelineLibrary(m_libraryData.data(), m_libraryData.size(), IID_PPV_ARGS(&m_library))))
+        return true;
+
+    // Missing, corrupt, or from another adapter / driver (D3D12_ERROR_ADAPTER_NOT_FOUND,
+    // D3D12_ERROR_DRIVER_VERSION_MISMATCH): start an empty library, replaced on Save().
+    m_libraryData.clear();
+    m_library.Reset();
+    if (FAILED(m_device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&m_library))))
+        m_library.Reset(); // e.g. not supported by the driver: compile every launch
+    m_libraryDirty = m_library != nullptr;
+    return true;
+}
+
+bool DXPipelineCache::GetRootSignature(const D3D12_ROOT_SIGNATURE_DESC& desc, ComPtr<ID3D12RootSignature>& out) noexcept
+{
+    const PipelineKey key = HashRootSignature(desc);
+    const bool ok = m_rootSignatures.Get(key, out, [&](ComPtr<ID3D12RootSignature>& created) {
+        std::vector<uint8_t> blob;
+        if (m_blobs && m_blobs->Get(key, blob) &&
+            SUCCEEDED(m_device->CreateRootSignature(0, blob.data(), blob.size(), IID_PPV_ARGS(&created))))
+            return PipelineSource::Library;
+
+        ComPtr<ID3DBlob> serialized, err;
+        if (FAILED(D3D12SerializeRootSignature(&desc, D3D_ROOT_SIGNATURE_VERSION_1, &serialized, &err)))
+        {
+            if (err) OutputDebugStringA((const char*)err->GetBufferPointer());
+            return PipelineSource::Failed;
+        }
+        if (FAILED(m_device->CreateRootSignature(0, serialized->GetBufferPointer(), serialized->GetBufferSize(),
+            IID_PPV_ARGS(&created))))
+            return PipelineSource::Failed;
+        if (m_blobs) m_blobs->Put(key, serialized->GetBufferPointer(), serialized->GetBufferSize());
+        return PipelineSource::Created;
+    });
+    if (ok) m_rootSignatureKeys[out.Get()] = key;
+    return ok;
+}
+
+PipelineHandle DXPipelineCache::RequestGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+    auto rs = m_rootSignatureKeys.find(desc.pRootSignature);
+    if (rs == m_rootSignatureKeys.end()) return kNoPipeline;
+
+    const PipelineKey key = HashGraphicsPipeline(desc, rs->second);
+    auto owned = std::make_shared<const OwnedGraphicsPipelineDesc>(desc);
+    return m_pipelines.Request(key, [this, key, owned](ComPtr<ID3D12PipelineState>& created) {
+        // Runs on a worker: device creation and the library are free-threaded;
+        // nothing else of this object is touched.
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC& d = owned->desc;
+        const std::string narrow = key.ToString();
+        const std::wstring name(narrow.begin(), narrow.end());
+
+        // E_INVALIDARG when the name is not in the library (or its description differs).
+        if (m_library && SUCCEEDED(m_library->LoadGraphicsPipeline(name.c_str(), &d, IID_PPV_ARGS(&created))))
+            return PipelineSource::Library;
+
+        if (FAILED(m_device->CreateGraphicsPipelineState(&d, IID_PPV_ARGS(&created))))
+            return PipelineSource::Failed;
+        if (m_library && SUCCEEDED(m_library->StorePipeline(name.c_str(), created.Get())))
+            m_libraryDirty = true;
+        return PipelineSource::Created;
+    });
+}
+
+DXPipelineCache::~DXPipelineCache()
+{
+    m_pipelines.Shutdown();
+    Save();
+}
+
+void DXPipelineCache::Update()
+{
+    m_pipelines.Update();
+    if (!m_library || !m_libraryDirty || !m_pipelines.Idle()) return;
+
+    const Clock::time_point now = Clock::now();
+    if (now < m_nextSave) return;
+    {
+        std::lock_guard<std::mutex> lock(m_saveMutex);
+        if (m_saving) return;
+        m_saving = m_jobs != nullptr;
+    }
+    m_nextSave = now + kSaveInterval;
+    if (!m_jobs)
+    {
+        WriteLibrary();
+        return;
+    }
+
+    // Serializing and writing a large library takes milliseconds: not on the frame.
+    m_jobs->Submit([this] {
+        WriteLibrary();
+        std::lock_guard<std::mutex> lock(m_saveMutex);
+        m_saving = false;
+        m_saveCv.notify_all(); // under the lock: the destructor may run right after
+    }, JobSystem::Priority::Background);
+}
+
+void DXPipelineCache::WaitForSave()
+{
+    std::unique_lock<std::mutex> lock(m_saveMutex);
+    m_saveCv.wait(lock, [&] { return !m_saving; });
+}
+
+bool DXPipelineCache::Save() noexcept
+{
+    WaitForSave();
+    return WriteLibrary();
+}
+
+// Any thread: the library is free-threaded. The dirty flag is cleared first,
+// so a pipeline stored while this serializes marks it dirty again; a failed
+// write sets it back for the next attempt.
+bool DXPipelineCache::WriteLibrary() noexcept
+{
+    if (!m_library || !m_libraryDirty.exchange(false)) return true;
+    auto fail = [&] {
+        m_libraryDirty = true;
+        return false;
+    };
+
+    std::vector<uint8_t> data(m_library->GetSerializedSize());
+    // A store between the two calls makes the buffer too small: fails, retried later.
+    if (FAILED(m_library->Serialize(data.data(), data.size()))) return fail();
+
+    // The runtime may still read m_libraryData, so write a new file and swap it in.
+    std::filesystem::path tmp = m_libraryPath;
+    tmp += L".tmp";
+    std::FILE* f = nullptr;
+    if (_wfopen_s(&f, tmp.c_str(), L"wb") != 0 || !f) return fail();
+    bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+    ok = (std::fclose(f) == 0) && ok;
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmp, m_libraryPath, ec);
+    if (!ok || ec)
+    {
+        std::filesystem::remove(tmp, ec);
+        return fail();
+    }
+    return true;
+}
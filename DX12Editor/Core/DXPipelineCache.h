@@ -0,0 +1,104 @@
+#pragma once
+#include <wrl.h>
+#include <d3d12.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AsyncPipelineCache.h"
+
+class DerivedDataCache;
+class JobSystem;
+
+// D3D12 side of the pipeline cache. Root signatures and graphics pipelines
+// are looked up by the hash of their full description; identical requests
+// share one object. Graphics pipelines are built on the job system (see
+// AsyncPipelineCache): callers get a handle and draw with a fallback, or
+// skip, until Update() publishes the real one.
+//
+// Persistence: compiled pipelines go into an ID3D12PipelineLibrary that is
+// serialized to 'libraryPath' and handed back to the driver on the next
+// launch, so warm starts load pipelines instead of compiling them. Update()
+// writes it on a background job after a batch of builds, at most every
+// kSaveInterval (which is also the back-off after a failed write); the
+// destructor writes what is left.
+// A library from another adapter or driver version is rejected by the
+// runtime and started over. Serialized root signatures go to the
+// derived-data cache.
+class DXPipelineCache {
+public:
+    DXPipelineCache() noexcept = default;
+    ~DXPipelineCache();
+    DXPipelineCache(const DXPipelineCache&) = delete;
+    DXPipelineCache& operator=(const DXPipelineCache&) = delete;
+
+    // 'blobs' is optional (root signatures are then serialized every launch);
+    // without 'jobs' pipelines are built inline in RequestGraphicsPipeline.
+    bool Initialize(ID3D12Device* device, const std::filesystem::path& libraryPath, DerivedDataCache* blobs,
+        JobSystem* jobs, uint32_t maxCompiles) noexcept;
+
+    bool GetRootSignature(const D3D12_ROOT_SIGNATURE_DESC& desc,
+        Microsoft::WRL::ComPtr<ID3D12RootSignature>& out) noexcept;
+
+    // Queues a build (or returns the handle of an identical request). The
+    // description and everything it points to is copied; stream output is
+    // not supported. desc.pRootSignature must come from GetRootSignature
+    // (its key is part of the pipeline's).
+    PipelineHandle RequestGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+    // Once per frame: publishes finished builds, starts queued ones, and
+    // starts a background save once nothing is building.
+    void Update();
+
+    // Blocks until the pipeline is built (e.g. the fallback, at startup).
+    bool Wait(PipelineHandle handle) { return m_pipelines.Wait(handle); }
+
+    // The pipeline if ready, else the fallback if ready, else null (skip).
+    ID3D12PipelineState* Resolve(PipelineHandle handle, PipelineHandle fallback = kNoPipeline)
+    {
+        const Microsoft::WRL::ComPtr<ID3D12PipelineState>* p = m_pipelines.Resolve(handle, fallback);
+        return p ? p->Get() : nullptr;
+    }
+
+    // Writes the library now if pipelines were added since the last save;
+    // waits for a background save first.
+    bool Save() noexcept;
+
+    bool HasLibrary() const noexcept { return m_library != nullptr; }
+    const PipelineCacheStats& RootSignatureStats() const noexcept { return m_rootSignatures.GetStats(); }
+    AsyncPipelineStats PipelineStats() const noexcept { return m_pipelines.GetStats(); }
+
+    static PipelineKey HashRootSignature(const D3D12_ROOT_SIGNATURE_DESC& desc) noexcept;
+    static PipelineKey HashGraphicsPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc,
+        const PipelineKey& rootSignature) noexcept;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr Clock::duration kSaveInterval = std::chrono::seconds(30);
+
+    bool WriteLibrary() noexcept;
+    void WaitForSave();
+
+    Microsoft::WRL::ComPtr<ID3D12Device>          m_device;
+    Microsoft::WRL::ComPtr<ID3D12Device1>         m_device1;  // pipeline libraries need it
+    Microsoft::WRL::ComPtr<ID3D12PipelineLibrary> m_library;
+    std::vector<uint8_t>  m_libraryData;   // must outlive m_library: the runtime reads from it
+    std::filesystem::path m_libraryPath;
+    std::atomic<bool>     m_libraryDirty{ false };
+    DerivedDataCache*     m_blobs{ nullptr };
+    JobSystem*            m_jobs{ nullptr };
+
+    Clock::time_point       m_nextSave{};     // no background save before this
+    std::mutex              m_saveMutex;
+    std::condition_variable m_saveCv;
+    bool                    m_saving{ false }; // background save running
+
+    PipelineCache<Microsoft::WRL::ComPtr<ID3D12RootSignature>> m_rootSignatures;
+    AsyncPipelineCache<Microsoft::WRL::ComPtr<ID3D12PipelineState>> m_pipelines;
+    std::unordered_map<ID3D12RootSignature*, PipelineKey> m_rootSignatureKeys;
+};
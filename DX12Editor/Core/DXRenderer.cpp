@@ -1,12 +1,17 @@
 #include <windows.h>
+#include <algorithm>
 #include <filesystem>
 #include <cassert>
+#include <cstddef>
 #include <cstdio>
 #include <cstring>
 #include <vector>
 
 #include "DXRenderer.h"
 #include "DXDevice.h"
+#include "Profiler.h"
+#include "TexelGen.h"
+#include "../Scene/SceneIO.h"
 #include <d3dx12.h> 
 
 // ImGui Headers
@@ -20,6 +25,31 @@ using namespace DirectX;
 // External declaration for ImGui's Win32 message handler
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
+namespace {
+    constexpr float kClearColor[4] = { 0.08f, 0.10f, 0.20f, 1.0f };
+
+    // Data files ship next to the executable.
+    std::filesystem::path ExeDirectory()
+    {
+        wchar_t exe[MAX_PATH];
+        GetModuleFileNameW(nullptr, exe, MAX_PATH);
+        return std::filesystem::path(exe).parent_path();
+    }
+
+    // Between two simulation steps: translation/scale lerp, rotation slerp.
+    XMMATRIX InterpolateTransform(const XMFLOAT4X4& from, const XMFLOAT4X4& to, float t) noexcept
+    {
+        XMVECTOR s0, r0, t0, s1, r1, t1;
+        if (!XMMatrixDecompose(&s0, &r0, &t0, XMLoadFloat4x4(&from)) ||
+            !XMMatrixDecompose(&s1, &r1, &t1, XMLoadFloat4x4(&to)))
+            return XMLoadFloat4x4(&to); // degenerate (zero scale): no interpolation
+
+        return XMMatrixAffineTransformation(
+            XMVectorLerp(s0, s1, t), XMVectorZero(),
+            XMQuaternionSlerp(r0, r1, t), XMVectorLerp(t0, t1, t));
+    }
+}
+
 // ========================================================
 // IMGUI WNDPROC HANDLER
 // ========================================================
@@ -75,13 +105,8 @@ void DXRenderer::OnKeyDown(UINT key)
     if (key == 'Q') m_keyQ = true;
     if (key == 'E') m_keyE = true;
 
-    // Focus key (F): focus on origin for now
-    if (key == 'F')
-    {
-        DirectX::XMFLOAT3 target = { 0.0f, 0.0f, 0.0f };
-        float distance = 5.0f;
-        m_camera.Focus(target, distance);
-    }
+    // Focus key (F): applied in UpdateCamera
+    if (key == 'F') m_focusRequested = true;
 }
 
 void DXRenderer::OnKeyUp(UINT key)
@@ -97,12 +122,41 @@ void DXRenderer::OnKeyUp(UINT key)
     if (key == 'E') m_keyE = false;
 }
 
+void DXRenderer::HandleInput(const InputEvent& e) noexcept
+{
+    m_latency.OnInputApplied(e.timeNs, Profiler::NowNs());
+    RequestRedraw();
+
+    switch (e.type)
+    {
+    case InputEvent::Type::MouseMove:  OnMouseMove(e.x, e.y); break;
+    case InputEvent::Type::MouseWheel: OnMouseWheel(e.x); break;
+    case InputEvent::Type::ButtonDown:
+        if (e.button == uint8_t(MouseButton::Left))  OnLeftMouseDown();
+        if (e.button == uint8_t(MouseButton::Right)) OnRightMouseDown();
+        break;
+    case InputEvent::Type::ButtonUp:
+        if (e.button == uint8_t(MouseButton::Left))  OnLeftMouseUp();
+        if (e.button == uint8_t(MouseButton::Right)) OnRightMouseUp();
+        break;
+    case InputEvent::Type::KeyDown: OnKeyDown(e.key); break;
+    case InputEvent::Type::KeyUp:   OnKeyUp(e.key); break;
+    case InputEvent::Type::Frame:
+    case InputEvent::Type::Latch:   break; // consumed by the input session
+    }
+}
+
 // --------------------------------------------------------
 // Destructor (Cleanup)
 // --------------------------------------------------------
 DXRenderer::~DXRenderer() noexcept {
     WaitForGpu();
     if (m_fenceEvent) CloseHandle(m_fenceEvent);
+    if (m_frameLatencyWaitable) CloseHandle(m_frameLatencyWaitable);
+
+    // Variants drawn with this run (plus earlier runs' counts, loaded at startup).
+    if (m_colorVariants.LoadedCount() > 0)
+        m_colorVariants.SaveUsage(ExeDirectory() / L"ShaderUsage.txt");
 
     ImGui_ImplDX12_Shutdown();
     ImGui_ImplWin32_Shutdown();
@@ -125,6 +179,14 @@ bool DXRenderer::Initialize(HWND hwnd, DXDevice* device, UINT width, UINT height
     m_camera.SetProjection(XM_PIDIV4, aspect, 0.1f, 1000.0f);
 
     // Basic GPU Objects
+    if (!m_jobs.Initialize()) return false;
+    if (!m_io.Initialize()) return false;
+    RequestShaderBinaries();
+    m_derivedData.Open(ExeDirectory() / L"DerivedData", 256ull << 20); // without it everything is rebuilt
+    // Half the workers at most, so frame jobs still find some.
+    const unsigned workers = (m_jobs.ThreadCount() > 1) ? m_jobs.ThreadCount() - 1 : 0;
+    m_pipelines.Initialize(m_device->GetDevice(), ExeDirectory() / L"PipelineCache.bin", &m_derivedData,
+        &m_jobs, (std::max)(1u, workers / 2));
     if (!CreateCommandQueue()) return false;
     if (!CreateSwapChain(hwnd, width, height)) return false;
     if (!CreateRTVDescriptorHeap()) return false;
@@ -151,7 +213,7 @@ bool DXRenderer::Initialize(HWND hwnd, DXDevice* device, UINT width, UINT height
         0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence))))
         return false;
 
-    m_fenceValue = 1;
+    m_fenceValue = 0; // last value signalled; every signal is ++m_fenceValue
     m_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
     if (!m_fenceEvent) return false;
 
@@ -162,12 +224,14 @@ bool DXRenderer::Initialize(HWND hwnd, DXDevice* device, UINT width, UINT height
     m_scissor = { 0, 0, int(width), int(height) };
 
     // Pipeline and sources
+    if (!CreateSrvHeap()) return false;
     if (!CreateRootSignature()) return false;
     if (!CreatePipelineState()) return false;
-    if (!CreateConstantBuffer()) return false;
+    if (!CreateConstantBuffer(kInitialCbSlots)) return false;
     if (!CreateTriangleVB()) return false;      
     if (!CreateGridVB()) return false;
     if (!CreateCheckerTextureSRV()) return false;
+    if (!CreateSceneTarget()) return false;
 
     
     {
@@ -176,16 +240,49 @@ bool DXRenderer::Initialize(HWND hwnd, DXDevice* device, UINT width, UINT height
             return false;
     }
 
+    // Scene entities: grid + axis lines (world XZ plane, identity transform)
+    // and the quad. Quad is defined in XY (-0.5..0.5): scale and rotate to the XZ plane.
+    {
+        ProxyDraw lines{};
+        lines.pipeline = kPipelineLines;
+        lines.mesh = kMeshGrid;
+        lines.material = ColorPermutation::kDefault;
+        lines.flags = ProxyDraw::kVisible | ProxyDraw::kEditorOnly;
+
+        m_gridEntity = m_world.Create();
+        m_world.SetTransform(m_gridEntity, Transform{});
+        lines.firstVertex = 0;
+        lines.vertexCount = m_gridVertexCount;
+        m_world.SetRenderable(m_gridEntity, lines);
+
+        m_axisEntity = m_world.Create();
+        m_world.SetTransform(m_axisEntity, Transform{});
+        lines.firstVertex = m_gridVertexCount;
+        lines.vertexCount = m_axisVertexCount;
+        m_world.SetRenderable(m_axisEntity, lines);
+
+        Transform quadTransform;
+        XMStoreFloat4(&quadTransform.rotation, XMQuaternionRotationRollPitchYaw(-XM_PIDIV2, 0.0f, 0.0f));
+        quadTransform.scale = { 5.0f, 5.0f, 1.0f };
+
+        ProxyDraw quad{};
+        quad.pipeline = kPipelineTriangles;
+        quad.mesh = kMeshQuad;
+        quad.material = ColorPermutation::Key(m_samplerType, m_vertexColorBlend);
+        quad.vertexCount = 6;
+        quad.flags = ProxyDraw::kVisible;
+
+        m_quadEntity = m_world.Create();
+        m_world.SetTransform(m_quadEntity, quadTransform);
+        m_world.SetRenderable(m_quadEntity, quad);
+
+        m_world.UpdateTransforms(&m_jobs);
+        m_world.SyncRenderScene(m_scene, true);
+    }
+
     // ====================================================
     // IMGUI INTEGRATION
     // ====================================================
-    D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
-    heapDesc.NumDescriptors = 1;
-    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-
-    if (FAILED(m_device->GetDevice()->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_imguiSrvHeap))))
-        return false;
 
     // 1) ImGui context + style
     IMGUI_CHECKVERSION();
@@ -196,15 +293,19 @@ bool DXRenderer::Initialize(HWND hwnd, DXDevice* device, UINT width, UINT height
     // 2) Platform backend (Win32)
     ImGui_ImplWin32_Init(m_hwnd);
 
-    // 3) Renderer backend (DX12)
-    ImGui_ImplDX12_Init(
-        m_device->GetDevice(),
-        kBufferCount,
-        m_backbufferFormat,
-        m_imguiSrvHeap.Get(),
-        m_imguiSrvHeap->GetCPUDescriptorHandleForHeapStart(),
-        m_imguiSrvHeap->GetGPUDescriptorHandleForHeapStart()
-    );
+    // 3) Renderer backend (DX12), SRVs come from the global heap
+    ImGui_ImplDX12_InitInfo initInfo;
+    initInfo.Device = m_device->GetDevice();
+    initInfo.CommandQueue = m_commandQueue.Get();
+    initInfo.NumFramesInFlight = kBufferCount;
+    initInfo.RTVFormat = m_backbufferFormat;
+    initInfo.DSVFormat = m_depthFormat;
+    initInfo.UserData = this;
+    initInfo.SrvDescriptorHeap = m_srvHeap.Get();
+    initInfo.SrvDescriptorAllocFn = &DXRenderer::ImGuiSrvAlloc;
+    initInfo.SrvDescriptorFreeFn = &DXRenderer::ImGuiSrvFree;
+    if (!ImGui_ImplDX12_Init(&initInfo))
+        return false;
 
     io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
 
@@ -215,19 +316,341 @@ bool DXRenderer::Initialize(HWND hwnd, DXDevice* device, UINT width, UINT height
 // --------------------------------------------------------
 // Frame rendering
 // --------------------------------------------------------
+void DXRenderer::WaitForFrameStart() noexcept
+{
+    PROFILE_SCOPE("Frame pacing");
+    if (m_frameLatencyWaitable)
+        WaitForSingleObjectEx(m_frameLatencyWaitable, 1000, TRUE);
+    m_pacer.WaitForNextFrame();
+    m_frameBeginNs = Profiler::NowNs(); // frame cost for dynamic resolution starts here
+}
+
 void DXRenderer::Render() noexcept
 {
+    PROFILE_SCOPE("Render");
+
+    const uint64_t frameBeginNs = m_frameBeginNs ? m_frameBeginNs : Profiler::NowNs();
+    m_frameBeginNs = 0;
+
     // =========================
     // Time
     // =========================
     m_timer.Tick();
-    float dt = static_cast<float>(m_timer.Delta());
-    if (dt > 0.1f) dt = 0.1f;
+    m_timer.SampleFps(0.5, m_fps);
+    // Input sessions record dt as float: step from the same value live and in replay.
+    const float dt = static_cast<float>(m_fixedDelta > 0.0 ? m_fixedDelta : m_timer.Delta());
+    m_lastSimDelta = dt;
+    const uint32_t steps = m_sim.Advance(double(dt)); // catch-up limit replaces the old 0.1 s clamp
+
+    UpdateCamera();
+    Simulate(steps);
+
+    // Pipelines that finished compiling since the last frame are used from
+    // this one; ColorPS variants that finished loading get theirs requested.
+    m_pipelines.Update();
+    m_colorVariants.Update();
+
+    // =========================
+    // CMD LIST RESET
+    // =========================
+    if (FAILED(m_cmdAlloc->Reset())) return;
+    if (FAILED(m_cmdList->Reset(m_cmdAlloc.Get(), m_pipelines.Resolve(m_fallbackPipelines[kPipelineTriangles])))) return;
+    // The last frame that used this slot's transient descriptors waited on its fence.
+    m_descriptors.BeginFrame(m_frameIndex);
+
+    // =========================
+    // IMGUI NEW FRAME
+    // =========================
+    BuildUi();
+
+    // Everything below reads only the snapshot of this frame's simulation.
+    PublishScene();
+
+    // =========================
+    // BACKBUFFER SETUP
+    // =========================
+    const UINT bb = m_swapChain->GetCurrentBackBufferIndex();
+    ID3D12Resource* backBuffer = m_renderTargets[bb].Get();
+
+    D3D12_RESOURCE_STATES beforeState =
+        m_firstFrame ? D3D12_RESOURCE_STATE_COMMON
+        : D3D12_RESOURCE_STATE_PRESENT;
+
+    auto toRT = CD3DX12_RESOURCE_BARRIER::Transition(
+        backBuffer, beforeState, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    m_cmdList->ResourceBarrier(1, &toRT);
+
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvStart =
+        m_rtvHeap->GetCPUDescriptorHandleForHeapStart();
+    D3D12_CPU_DESCRIPTOR_HANDLE rtv{
+        rtvStart.ptr + SIZE_T(bb) * SIZE_T(m_rtvDescriptorSize)
+    };
+    D3D12_CPU_DESCRIPTOR_HANDLE dsv =
+        m_dsvHeap->GetCPUDescriptorHandleForHeapStart();
+
+    // Scaled frames draw the scene into the top-left part of the offscreen
+    // target; it is upscaled into the back buffer before the UI.
+    ID3D12PipelineState* upscalePso = m_pipelines.Resolve(m_upscalePipeline);
+    const bool scaled = m_renderScale < 1.0f && upscalePso && m_sceneColor;
+    D3D12_VIEWPORT sceneViewport = m_viewport;
+    D3D12_RECT     sceneScissor = m_scissor;
+    D3D12_CPU_DESCRIPTOR_HANDLE sceneRtv = rtv;
+    if (scaled)
+    {
+        const UINT sceneW = (std::max)(1u, UINT(float(m_width) * m_renderScale + 0.5f));
+        const UINT sceneH = (std::max)(1u, UINT(float(m_height) * m_renderScale + 0.5f));
+        sceneViewport.Width = float(sceneW);
+        sceneViewport.Height = float(sceneH);
+        sceneScissor = { 0, 0, int(sceneW), int(sceneH) };
+        sceneRtv.ptr = rtvStart.ptr + SIZE_T(kBufferCount) * SIZE_T(m_rtvDescriptorSize);
+
+        auto sceneToRT = CD3DX12_RESOURCE_BARRIER::Transition(
+            m_sceneColor.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        m_cmdList->ResourceBarrier(1, &sceneToRT);
+    }
+
+    m_cmdList->OMSetRenderTargets(1, &sceneRtv, FALSE, &dsv);
+    m_cmdList->ClearRenderTargetView(sceneRtv, kClearColor, 1, &sceneScissor);
+    m_cmdList->ClearDepthStencilView(
+        dsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 1, &sceneScissor);
+
+    // =========================
+    // SCENE RENDER
+    // =========================
+
+    // One global heap for the whole frame (scene + ImGui).
+    ID3D12DescriptorHeap* heaps[] = { m_srvHeap.Get() };
+    m_cmdList->SetDescriptorHeaps(1, heaps);
+
+    m_cmdList->RSSetViewports(1, &sceneViewport);
+    m_cmdList->RSSetScissorRects(1, &sceneScissor);
+    m_cmdList->SetGraphicsRootSignature(m_rootSig.Get());
+
+    // Root parameter 1 = whole heap as a bindless SRV array (indexed by textureIndex)
+    m_cmdList->SetGraphicsRootDescriptorTable(1, SrvGpu(0));
+
+    // ---------- 1) COLLECT DRAWS ----------
+    m_counters = {};
+    CollectDraws();
+
+    // ---------- 2) SORT + EXECUTE ----------
+    // Only state that differs from the previous draw is set again.
+    {
+        PROFILE_SCOPE("Sort draws");
+        m_drawList.Sort(&m_jobs);
+    }
+
+    const D3D12_GPU_VIRTUAL_ADDRESS cbFrameBase =
+        m_cbUpload->GetGPUVirtualAddress() + UINT64(m_frameIndex) * m_cbSlotsPerFrame * m_cbSize;
+
+    uint32_t boundPipeline = UINT32_MAX;
+    uint32_t boundMaterial = UINT32_MAX;
+    uint32_t boundMesh = UINT32_MAX;
+    bool skipPipeline = false;
+    for (size_t i = 0; i < m_drawList.Size(); ++i)
+    {
+        const DrawItem& d = m_drawList.Sorted(i);
+
+        // The material picks the ColorPS permutation, so it is part of the PSO.
+        if (d.pipeline != boundPipeline || d.material != boundMaterial)
+        {
+            // A pipeline still compiling draws with the default permutation
+            // of its pipeline id; without that too its draws are skipped.
+            ID3D12PipelineState* pso = nullptr;
+            if (d.pipeline < kPipelineCount)
+                pso = m_pipelines.Resolve(ColorPipeline(d.pipeline, d.material), m_fallbackPipelines[d.pipeline]);
+            skipPipeline = (pso == nullptr);
+            if (pso) m_cmdList->SetPipelineState(pso);
+            if (d.pipeline != boundPipeline)
+            {
+                const bool lines = (d.pipeline == kPipelineLines);
+                m_cmdList->IASetPrimitiveTopology(lines ? D3D_PRIMITIVE_TOPOLOGY_LINELIST : D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            }
+            boundPipeline = d.pipeline;
+            boundMaterial = d.material;
+        }
+        if (skipPipeline)
+            continue;
+        if (d.pipeline == kPipelineTriangles) // lines always draw the default variant
+            m_colorVariants.NoteDraws(d.material);
+        if (d.mesh != boundMesh)
+        {
+            m_cmdList->IASetVertexBuffers(0, 1, (d.mesh == kMeshGrid) ? &m_gridVbView : &m_vbView);
+            boundMesh = d.mesh;
+        }
+
+        // Root parameter 0 = per-draw CBV slot
+        m_cmdList->SetGraphicsRootConstantBufferView(0, cbFrameBase + UINT64(d.constantSlot) * m_cbSize);
+        m_cmdList->DrawInstanced(d.vertexCount, 1, d.firstVertex, 0);
+
+        ++m_counters.draws;
+        if (d.pipeline == kPipelineLines) m_counters.lines += d.vertexCount / 2;
+        else                              m_counters.triangles += d.vertexCount / 3;
+    }
+
+    // =========================
+    // UPSCALE
+    // =========================
+    if (scaled)
+    {
+        PROFILE_SCOPE("Upscale");
+        auto sceneToSrv = CD3DX12_RESOURCE_BARRIER::Transition(
+            m_sceneColor.Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        m_cmdList->ResourceBarrier(1, &sceneToSrv);
+
+        m_cmdList->OMSetRenderTargets(1, &rtv, FALSE, &dsv);
+        m_cmdList->RSSetViewports(1, &m_viewport);
+        m_cmdList->RSSetScissorRects(1, &m_scissor);
+
+        CbUpscale cb{};
+        cb.uvScale[0] = sceneViewport.Width / float(m_width);
+        cb.uvScale[1] = sceneViewport.Height / float(m_height);
+        cb.uvMax[0] = (sceneViewport.Width - 0.5f) / float(m_width);
+        cb.uvMax[1] = (sceneViewport.Height - 0.5f) / float(m_height);
+        cb.textureIndex = m_descriptors.AllocateTransient();
+        if (cb.textureIndex != DescriptorAllocator::kInvalidIndex)
+        {
+            D3D12_SHADER_RESOURCE_VIEW_DESC srv{};
+            srv.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            srv.Format = m_backbufferFormat;
+            srv.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            srv.Texture2D.MipLevels = 1;
+            m_device->GetDevice()->CreateShaderResourceView(m_sceneColor.Get(), &srv, SrvCpu(cb.textureIndex));
+        }
+        else
+        {
+            cb.textureIndex = m_overflowSrvIndex; // null view: black rather than a stale slot
+        }
+        std::memcpy(m_cbMapped + (SIZE_T(m_frameIndex) * m_cbSlotsPerFrame + UpscaleSlot()) * m_cbSize, &cb, sizeof(CbUpscale));
+
+        m_cmdList->SetPipelineState(upscalePso);
+        m_cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        m_cmdList->SetGraphicsRootConstantBufferView(0, cbFrameBase + UINT64(UpscaleSlot()) * m_cbSize);
+        m_cmdList->DrawInstanced(3, 1, 0, 0); // fullscreen triangle
+    }
 
     // =========================
-    // CAMERA INPUT
+    // IMGUI DRAW
+    // =========================
+    {
+        PROFILE_SCOPE("ImGui record");
+        ImGui::Render();
+        ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), m_cmdList.Get());
+    }
+
+    // =========================
+    // PRESENT
     // =========================
-    if (!IsImGuiCapturingMouse())
+    auto toPresent = CD3DX12_RESOURCE_BARRIER::Transition(
+        backBuffer,
+        D3D12_RESOURCE_STATE_RENDER_TARGET,
+        D3D12_RESOURCE_STATE_PRESENT);
+    m_cmdList->ResourceBarrier(1, &toPresent);
+
+    // =========================
+    // LATE LATCH
+    // =========================
+    // The GPU has not seen this frame's constants yet: re-sample input and
+    // rewrite the view-projection as late as possible.
+    m_lateSampleNs = m_earlySampleNs;
+    if (m_lateLatch)
+    {
+        PROFILE_SCOPE("Late latch");
+        if (m_lateLatchCallback) m_lateLatchCallback();
+        m_lateSampleNs = Profiler::NowNs();
+        LateLatchCamera();
+        m_latency.Mark(LatencyTracker::Camera, Profiler::NowNs());
+        RewriteViewProjection();
+    }
+
+    {
+        PROFILE_SCOPE("Submit + Present");
+        m_cmdList->Close();
+        ID3D12CommandList* lists[] = { m_cmdList.Get() };
+        m_commandQueue->ExecuteCommandLists(1, lists);
+
+        const uint64_t submitNs = Profiler::NowNs();
+        m_earlyToSubmit.AddSample(double(submitNs - m_earlySampleNs) / 1e6);
+        m_lateToSubmit.AddSample(double(submitNs - m_lateSampleNs) / 1e6);
+        m_latency.Mark(LatencyTracker::Submit, submitNs);
+
+        // Sync interval 0 may tear (windowed flip model) when the system allows it.
+        const UINT syncInterval = m_pacer.SyncInterval();
+        const UINT presentFlags = (syncInterval == 0 && m_tearingSupported) ? DXGI_PRESENT_ALLOW_TEARING : 0;
+        m_swapChain->Present(syncInterval, presentFlags);
+        m_firstFrame = false;
+        m_latency.Mark(LatencyTracker::Present, Profiler::NowNs());
+        m_latency.EndFrame();
+    }
+
+    {
+        PROFILE_SCOPE("GPU wait");
+        // Same convention as WaitForGpu: a fresh value, so a wait earlier in
+        // the frame (constant buffer growth) cannot leave this one satisfied.
+        const UINT64 fenceToWait = ++m_fenceValue;
+        m_commandQueue->Signal(m_fence.Get(), fenceToWait);
+        if (m_fence->GetCompletedValue() < fenceToWait)
+        {
+            m_fence->SetEventOnCompletion(fenceToWait, m_fenceEvent);
+            WaitForSingleObject(m_fenceEvent, INFINITE);
+        }
+    }
+
+    // This frame's cost picks the next frame's scale.
+    const double frameCostMs = double(Profiler::NowNs() - frameBeginNs) / 1e6;
+    m_renderScale = m_dynResEnabled ? m_dynRes.Update(frameCostMs) : 1.0f;
+
+    m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
+    if (m_redrawFrames > 0) --m_redrawFrames;
+}
+
+void DXRenderer::SetDynamicResolution(bool enabled, double targetMs) noexcept
+{
+    DynamicResolution::Config config = m_dynRes.GetConfig();
+    config.targetMs = targetMs;
+    m_dynRes.SetConfig(config);
+    m_dynRes.Reset();
+    m_dynResEnabled = enabled;
+    m_renderScale = 1.0f;
+}
+
+bool DXRenderer::NeedsRedraw() const noexcept
+{
+    if (m_continuousRedraw || m_redrawFrames > 0) return true;
+
+    // Camera still flying, or the interpolated eye has not caught up yet.
+    const bool moveKeys = m_keyW || m_keyA || m_keyS || m_keyD || m_keyQ || m_keyE;
+    if ((moveKeys && m_isRightMouseDown) || m_focusRequested || m_wheelTicks != 0.0f) return true;
+    if (m_camStepDelta.x != 0.0f || m_camStepDelta.y != 0.0f || m_camStepDelta.z != 0.0f) return true;
+
+    if (m_scene.HasPendingChanges()) return true;
+
+    // Widgets being dragged / edited (text cursor blinks).
+    if (ImGui::GetCurrentContext() && (ImGui::IsAnyItemActive() || ImGui::GetIO().WantTextInput)) return true;
+
+    return false;
+}
+
+
+
+
+// --------------------------------------------------------
+// Frame stages
+// --------------------------------------------------------
+void DXRenderer::UpdateCamera() noexcept
+{
+    PROFILE_SCOPE("Camera input");
+    m_earlySampleNs = Profiler::NowNs();
+    m_latency.Mark(LatencyTracker::Camera, m_earlySampleNs);
+
+    // Camera driven from outside (benchmark path): only the simulation steps move it.
+    if (m_externalCamera)
+        return;
+
+    const bool uiCapture = (m_uiCaptureOverride >= 0) ? (m_uiCaptureOverride != 0) : IsImGuiCapturingMouse();
+    m_lastUiCapture = uiCapture;
+
+    if (!uiCapture)
     {
         // Mouse wheel zoom
         if (m_wheelTicks != 0.0f)
@@ -278,49 +701,89 @@ void DXRenderer::Render() noexcept
     // =========================
     // FOCUS KEY (F) - SNAP TO QUAD / ORIGIN
     // =========================
+    if (m_focusRequested)
     {
-        // Edge-detect F key press using Win32 async state.
-        static bool s_wasFDown = false;
-        SHORT state = GetAsyncKeyState('F');
-        bool isFDown = (state & 0x8000) != 0;
+        // Focus on origin (quad center) at a fixed distance.
+        DirectX::XMFLOAT3 focusTarget{ 0.0f, 0.0f, 0.0f };
+        float focusDistance = 10.0f; // Tunable: how far from the quad we end up.
 
-        if (isFDown && !s_wasFDown)
-        {
-            // Focus on origin (quad center) at a fixed distance.
-            DirectX::XMFLOAT3 focusTarget{ 0.0f, 0.0f, 0.0f };
-            float focusDistance = 10.0f; // Tunable: how far from the quad we end up.
+        m_camera.Focus(focusTarget, focusDistance);
+        m_focusRequested = false;
+    }
 
-            m_camera.Focus(focusTarget, focusDistance);
-        }
+    m_mouseDeltaX = 0.0f;
+    m_mouseDeltaY = 0.0f;
+}
 
-        s_wasFDown = isFDown;
+void DXRenderer::Simulate(uint32_t steps) noexcept
+{
+    PROFILE_SCOPE("Simulate");
+
+    const float stepDt = static_cast<float>(m_sim.StepSeconds());
+    for (uint32_t i = 0; i < steps; ++i)
+    {
+        const XMFLOAT3 before = m_camera.GetPosition();
+        m_camera.Update(stepDt);
+        const XMFLOAT3 after = m_camera.GetPosition();
+        m_camStepDelta = { after.x - before.x, after.y - before.y, after.z - before.z };
+
+        m_world.UpdateTransforms(&m_jobs);
+        m_world.SyncRenderScene(m_scene);
+        m_scene.EndSimStep();
     }
+}
+
+XMMATRIX DXRenderer::InterpolatedViewMatrix() const noexcept
+{
+    // Eye between the last two steps: cur - (1 - alpha) * lastStepDelta. Look
+    // direction is input-driven (not simulated) and is always the latest.
+    const float back = 1.0f - m_sim.Alpha();
+    return XMMatrixTranslation(back * m_camStepDelta.x, back * m_camStepDelta.y, back * m_camStepDelta.z) *
+        m_camera.GetViewMatrix();
+}
 
+void DXRenderer::LateLatchCamera() noexcept
+{
+    if (m_externalCamera || m_lastUiCapture) return;
+    if (m_mouseDeltaX == 0.0f && m_mouseDeltaY == 0.0f) return;
+
+    // Only continue a look/orbit that UpdateCamera already started this frame;
+    // mode changes wait for the next frame.
+    const bool orbit = m_isLeftMouseDown && m_isAltDown;
+    if (orbit != m_camera.IsOrbitMode()) return;
+    if (!orbit && !m_isRightMouseDown) return;
+
+    m_camera.Rotate(m_mouseDeltaX, m_mouseDeltaY);
     m_mouseDeltaX = 0.0f;
     m_mouseDeltaY = 0.0f;
+}
 
-    m_camera.Update(dt);
+void DXRenderer::RewriteViewProjection() noexcept
+{
+    if (!m_cbMapped) return;
 
-    // =========================
-    // CMD LIST RESET
-    // =========================
-    if (FAILED(m_cmdAlloc->Reset())) return;
-    if (FAILED(m_cmdList->Reset(m_cmdAlloc.Get(), m_pso.Get()))) return;
+    const XMMATRIX VP = InterpolatedViewMatrix() * m_camera.GetProjectionMatrix();
+    uint8_t* frameBase = m_cbMapped + SIZE_T(m_frameIndex) * m_cbSlotsPerFrame * m_cbSize;
+    for (UINT slot = 0; slot < m_cbSlotCount; ++slot)
+    {
+        XMFLOAT4X4 mvp;
+        XMStoreFloat4x4(&mvp, XMMatrixTranspose(XMLoadFloat4x4(&m_slotWorld[slot]) * VP));
+        std::memcpy(frameBase + SIZE_T(slot) * m_cbSize + offsetof(CbMvp, mvp), &mvp, sizeof(mvp));
+    }
+}
+
+void DXRenderer::BuildUi() noexcept
+{
+    PROFILE_SCOPE("ImGui build");
 
-    // =========================
-    // IMGUI NEW FRAME
-    // =========================
     ImGui_ImplDX12_NewFrame();
     ImGui_ImplWin32_NewFrame();
     ImGui::NewFrame();
 
     // Info window
     {
-        double fps = 0.0;
-        m_timer.SampleFps(0.5, fps);
-
         ImGui::Begin("Info");
-        ImGui::Text("FPS: %.2f", fps);
+        ImGui::Text("FPS: %.2f", m_fps);
 
         auto camPos = m_camera.GetPosition();
         ImGui::Text("Camera Pos: %.2f %.2f %.2f",
@@ -329,6 +792,71 @@ void DXRenderer::Render() noexcept
         ImGui::Separator();
         ImGui::Checkbox("Show grid", &m_showGrid);
         ImGui::Checkbox("Show axis", &m_showAxis);
+        ImGui::Checkbox("Profiler", &m_showProfiler);
+        ImGui::Checkbox("Late-latch camera", &m_lateLatch);
+        {
+            FramePacer::Config pacing = m_pacer.GetConfig();
+            const char* modes[] = { "Uncapped", "VSync", "Target FPS" };
+            int mode = static_cast<int>(pacing.mode);
+            bool changed = ImGui::Combo("Present", &mode, modes, IM_ARRAYSIZE(modes));
+            if (pacing.mode == FramePacer::Mode::TargetFps)
+            {
+                float fps = static_cast<float>(pacing.targetFps);
+                if (ImGui::SliderFloat("Target FPS", &fps, 10.0f, 500.0f, "%.0f"))
+                {
+                    pacing.targetFps = fps;
+                    changed = true;
+                }
+                const FrameStats::Summary wake = m_pacer.WakeError().Summarize();
+                ImGui::Text("Wake error p50 %.3f  p99 %.3f ms (sleep est. %.2f ms)",
+                    wake.p50Ms, wake.p99Ms, m_pacer.SleepEstimateMs());
+            }
+            if (changed)
+            {
+                pacing.mode = static_cast<FramePacer::Mode>(mode);
+                m_pacer.SetConfig(pacing);
+            }
+            ImGui::Text("Tearing: %s", m_tearingSupported ? "supported" : "not supported");
+        }
+        if (ImGui::Checkbox("Dynamic resolution", &m_dynResEnabled))
+            m_dynRes.Reset();
+        if (m_dynResEnabled)
+        {
+            DynamicResolution::Config dynRes = m_dynRes.GetConfig();
+            float budget = static_cast<float>(dynRes.targetMs);
+            if (ImGui::SliderFloat("Frame budget (ms)", &budget, 2.0f, 50.0f, "%.1f"))
+            {
+                dynRes.targetMs = budget;
+                m_dynRes.SetConfig(dynRes);
+            }
+            ImGui::Text("Scale %.2f (%ux%u)  cost %.2f ms",
+                m_renderScale, UINT(float(m_width) * m_renderScale + 0.5f), UINT(float(m_height) * m_renderScale + 0.5f),
+                m_dynRes.FilteredMs());
+        }
+        ImGui::Checkbox("Render continuously", &m_continuousRedraw);
+        if (!m_continuousRedraw)
+        {
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(80.0f);
+            ImGui::SliderFloat("Idle Hz", &m_idleRedrawHz, 0.0f, 30.0f, "%.0f");
+        }
+        {
+            FixedStepScheduler::Config sim = m_sim.GetConfig();
+            float hz = static_cast<float>(sim.hz);
+            if (ImGui::SliderFloat("Simulation Hz", &hz, 10.0f, 240.0f, "%.0f"))
+            {
+                sim.hz = hz;
+                m_sim.SetConfig(sim);
+            }
+            ImGui::Text("Steps: %llu  dropped %.1f ms  alpha %.2f",
+                (unsigned long long)m_sim.TotalSteps(), double(m_sim.DroppedNs()) / 1e6, m_sim.Alpha());
+        }
+        {
+            const FrameStats::Summary late = m_lateToSubmit.Summarize();
+            const FrameStats::Summary early = m_earlyToSubmit.Summarize();
+            ImGui::Text("Input sample -> submit p50/p95: %.2f / %.2f ms (early %.2f / %.2f)",
+                late.p50Ms, late.p95Ms, early.p50Ms, early.p95Ms);
+        }
 
         // --- Sampler UI ---
         ImGui::Separator();
@@ -351,179 +879,348 @@ void DXRenderer::Render() noexcept
             if (samplerIndex < 0) samplerIndex = 0;
             if (samplerIndex > 3) samplerIndex = 3;
 
-            m_samplerType = static_cast<SamplerType>(samplerIndex);
+            m_samplerType = static_cast<ColorPermutation::Sampler>(samplerIndex);
         }
+        ImGui::Checkbox("Vertex color blend", &m_vertexColorBlend);
 
-        ImGui::End();
-    }
+        // Each sampler / blend combination is its own ColorPS variant.
+        const ShaderVariantCache::Stats& vs = m_colorVariants.GetStats();
+        ImGui::Text("Shader variants: %zu / %u loaded, %zu used, %llu missing",
+            m_colorVariants.LoadedCount(), ColorPermutation::Space().VariantCount(),
+            m_colorVariants.UsedVariants().size(), (unsigned long long)vs.loadFailures);
 
-    // =========================
-    // BACKBUFFER SETUP
-    // =========================
-    const UINT bb = m_swapChain->GetCurrentBackBufferIndex();
-    ID3D12Resource* backBuffer = m_renderTargets[bb].Get();
+        // Checker texture straight from its bindless slot.
+        ImGui::Image(ImTextureRef(static_cast<ImTextureID>(SrvGpu(m_texSrvIndex).ptr)), ImVec2(64.0f, 64.0f));
 
-    D3D12_RESOURCE_STATES beforeState =
-        m_firstFrame ? D3D12_RESOURCE_STATE_COMMON
-        : D3D12_RESOURCE_STATE_PRESENT;
+        ImGui::Separator();
+        ImGui::Text("Descriptors: %u / %u (tier %d), rejected frees: %u",
+            m_descriptors.InUse(), m_descriptors.PersistentCount(), int(m_resourceBindingTier), m_descriptors.RejectedFrees());
+        ImGui::Text("Transient descriptors: %u / %u this frame",
+            m_descriptors.TransientInUse(), m_descriptors.TransientPerFrame());
+
+        const DrawList::Stats& ds = m_drawList.GetStats();
+        ImGui::Text("Draws: %u  PSO: %u  VB: %u  Material: %u",
+            ds.draws, ds.pipelineChanges, ds.meshChanges, ds.materialChanges);
+        ImGui::Text("Draw sort: %.3f ms", ds.sortMs);
+        ImGui::Text("Constant slots: %u / %u per frame", m_cbSlotCount, m_cbSlotsPerFrame);
+        if (m_counters.droppedDraws)
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "Dropped draws: %u (no constant slot)", m_counters.droppedDraws);
+
+        ImGui::Text("Entities: %u (%u renderable)", m_world.AliveCount(), m_world.Renderables().Size());
+        if (ImGui::Button("Save scene"))
+            SaveScene(ExeDirectory() / L"scene.dxscene");
+        ImGui::SameLine();
+        if (ImGui::Button("Load scene"))
+            LoadScene(ExeDirectory() / L"scene.dxscene");
+        if (!m_sceneStatus.empty())
+        {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(m_sceneStatus.c_str());
+        }
+        const DerivedDataCache::Stats dds = m_derivedData.GetStats();
+        ImGui::Text("Derived data: %llu hits, %llu misses, %zu entries (%.1f MB)",
+            (unsigned long long)dds.hits, (unsigned long long)dds.misses,
+            m_derivedData.EntryCount(), m_derivedData.SizeBytes() / 1048576.0);
+        const AsyncPipelineStats pas = m_pipelines.PipelineStats();
+        const PipelineCacheStats& pcs = pas.lookups;
+        ImGui::Text("Pipelines: %llu requests, %.0f%% without compile (%llu library, %llu compiled, %.1f ms)",
+            (unsigned long long)pcs.requests, pcs.HitRate() * 100.0,
+            (unsigned long long)pcs.libraryHits, (unsigned long long)pcs.created, pcs.libraryMs + pcs.createMs);
+        ImGui::Text("  %u queued, %u compiling, %llu failed; %llu fallback, %llu skipped; max wait %.1f ms",
+            pas.queued, pas.compiling, (unsigned long long)pcs.failed,
+            (unsigned long long)pas.fallbacks, (unsigned long long)pas.skipped, pas.maxWaitMs);
+        const RenderScene::PublishStats& ps = m_scene.LastPublish();
+        ImGui::Text("Snapshot: %u proxies, %u changed, %u chunks copied, %.3f ms",
+            ps.proxies, ps.changed, ps.chunksCopied, ps.publishMs);
+
+        // --- Input latency ---
+        if (ImGui::CollapsingHeader("Input latency"))
+        {
+            for (uint32_t s = 0; s < LatencyTracker::kStageCount; ++s)
+            {
+                const auto stage = static_cast<LatencyTracker::Stage>(s);
+                const FrameStats::Summary sum = m_latency.Stats(stage).Summarize();
+                ImGui::Text("%-18s p50 %6.2f  p95 %6.2f  p99 %6.2f ms  (%u frames)",
+                    LatencyTracker::StageName(stage), sum.p50Ms, sum.p95Ms, sum.p99Ms, sum.count);
+            }
+        }
 
-    auto toRT = CD3DX12_RESOURCE_BARRIER::Transition(
-        backBuffer, beforeState, D3D12_RESOURCE_STATE_RENDER_TARGET);
-    m_cmdList->ResourceBarrier(1, &toRT);
+        // --- Frame times ---
+        if (ImGui::CollapsingHeader("Frame times", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            const FrameStats& fs = m_timer.Stats();
+            const FrameStats::Summary s = fs.Summarize();
+            ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs);
+            ImGui::Text("Hitches: %llu (last %.2f ms)", (unsigned long long)s.hitches, fs.LastHitchMs());
+
+            // Min/max band per pixel column, so single-frame spikes stay visible.
+            const float graphW = (std::max)(ImGui::GetContentRegionAvail().x, 64.0f);
+            const float graphH = 60.0f;
+            std::vector<float> mins, maxs;
+            fs.Decimate(uint32_t(graphW), mins, maxs);
+
+            const ImVec2 p0 = ImGui::GetCursorScreenPos();
+            ImGui::Dummy(ImVec2(graphW, graphH));
+            ImDrawList* dl = ImGui::GetWindowDrawList();
+            dl->AddRectFilled(p0, ImVec2(p0.x + graphW, p0.y + graphH), IM_COL32(20, 20, 20, 255));
+
+            const float scaleMs = (std::max)(float(s.maxMs), 1.0f);
+            auto toY = [&](float ms) { return p0.y + graphH - graphH * (std::min)(ms / scaleMs, 1.0f); };
+            const float colW = mins.empty() ? 1.0f : graphW / float(mins.size());
+            for (size_t i = 0; i < mins.size(); ++i)
+            {
+                const float x = p0.x + colW * float(i);
+                const ImU32 col = (maxs[i] > float(s.p99Ms)) ? IM_COL32(230, 80, 60, 255) : IM_COL32(90, 200, 90, 255);
+                dl->AddRectFilled(ImVec2(x, toY(maxs[i])), ImVec2(x + (std::max)(colW, 1.0f), toY(mins[i]) + 1.0f), col);
+            }
+            // p95 reference line
+            const float yP95 = toY(float(s.p95Ms));
+            dl->AddLine(ImVec2(p0.x, yP95), ImVec2(p0.x + graphW, yP95), IM_COL32(255, 255, 0, 120));
+
+            if (ImGui::Button("Export CSV"))
+                fs.WriteCsv("frame_times.csv");
+            ImGui::SameLine();
+            if (ImGui::Button("Export JSON"))
+                fs.WriteJson("frame_times.json");
+        }
 
-    D3D12_CPU_DESCRIPTOR_HANDLE rtvStart =
-        m_rtvHeap->GetCPUDescriptorHandleForHeapStart();
-    D3D12_CPU_DESCRIPTOR_HANDLE rtv{
-        rtvStart.ptr + SIZE_T(bb) * SIZE_T(m_rtvDescriptorSize)
-    };
-    D3D12_CPU_DESCRIPTOR_HANDLE dsv =
-        m_dsvHeap->GetCPUDescriptorHandleForHeapStart();
+        ImGui::End();
+    }
 
-    const float clearColor[4] = { 0.08f, 0.10f, 0.20f, 1.0f };
-    m_cmdList->OMSetRenderTargets(1, &rtv, FALSE, &dsv);
-    m_cmdList->ClearRenderTargetView(rtv, clearColor, 0, nullptr);
-    m_cmdList->ClearDepthStencilView(
-        dsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+    if (m_showProfiler)
+        Profiler::Get().DrawWindow(&m_showProfiler);
+}
 
-    // =========================
-    // SCENE RENDER
-    // =========================
+// --------------------------------------------------------
+// Scene files
+// --------------------------------------------------------
+namespace {
+    // Names of the renderer's mesh ids (kMeshQuad, kMeshGrid) and material
+    // ids (= ColorPS permutation key), as scene files reference them. The
+    // vertex color tinted ones keep the names from before permutations.
+    SceneAssetNames RendererAssetNames()
+    {
+        SceneAssetNames names;
+        names.meshes = { "builtin/quad", "builtin/grid" };
+        names.materials = {
+            "sampler/linear_wrap/untinted", "sampler/point_wrap/untinted",
+            "sampler/linear_clamp/untinted", "sampler/point_clamp/untinted",
+            "sampler/linear_wrap", "sampler/point_wrap", "sampler/linear_clamp", "sampler/point_clamp" };
+        return names;
+    }
+}
 
-    // CBV+SRV heap (0: CBV, 1: SRV).
-    ID3D12DescriptorHeap* sceneHeaps[] = { m_cbvHeap.Get() };
-    m_cmdList->SetDescriptorHeaps(1, sceneHeaps);
+bool DXRenderer::SaveScene(const std::filesystem::path& path, bool incremental) noexcept
+{
+    PROFILE_SCOPE("Save scene");
+
+    const uint64_t t0 = Profiler::NowNs();
+    SceneSaveStats stats;
+    std::string error;
+    const bool ok = ::SaveScene(m_world, RendererAssetNames(), path,
+        incremental ? SceneSaveMode::Incremental : SceneSaveMode::Full, &stats, &error);
+
+    char text[160];
+    if (ok)
+        std::snprintf(text, sizeof(text), "Saved: %u chunks written, %u unchanged, %.2f ms",
+            stats.chunksWritten, stats.chunksSkipped, double(Profiler::NowNs() - t0) / 1e6);
+    else
+        std::snprintf(text, sizeof(text), "Save failed: %s", error.c_str());
+    m_sceneStatus = text;
+    return ok;
+}
 
-    m_cmdList->RSSetViewports(1, &m_viewport);
-    m_cmdList->RSSetScissorRects(1, &m_scissor);
-    m_cmdList->SetGraphicsRootSignature(m_rootSig.Get());
+bool DXRenderer::LoadScene(const std::filesystem::path& path) noexcept
+{
+    PROFILE_SCOPE("Load scene");
 
-    D3D12_GPU_DESCRIPTOR_HANDLE gpuStart =
-        m_cbvHeap->GetGPUDescriptorHandleForHeapStart();
+    const uint64_t t0 = Profiler::NowNs();
 
-    // Root parameter 0 = CBV
-    m_cmdList->SetGraphicsRootDescriptorTable(0, gpuStart);
+    // The current scene entities: everything but the editor furniture.
+    // Destroyed only once the new scene has loaded.
+    std::vector<Entity> previous;
+    auto collect = [&](uint32_t index) {
+        const Entity e = m_world.Handle(index);
+        if (e != m_gridEntity && e != m_axisEntity) previous.push_back(e);
+    };
+    const TransformStore& transforms = m_world.Transforms();
+    for (uint32_t i = 0; i < transforms.Size(); ++i) collect(transforms.Entities()[i]);
+    for (uint32_t i = 0; i < m_world.Renderables().Size(); ++i)
+        if (!transforms.Has(m_world.Renderables().Entities()[i])) collect(m_world.Renderables().Entities()[i]);
+
+    std::vector<Entity> loaded;
+    std::string error;
+    if (!::LoadScene(path, RendererAssetNames(), m_world, &loaded, &error))
+    {
+        m_sceneStatus = "Load failed: " + error;
+        return false;
+    }
+    for (const Entity& e : previous) m_world.Destroy(e);
 
-    // Root parameter 1 = SRV (checker texture)
-    UINT inc = m_device->GetDevice()->GetDescriptorHandleIncrementSize(
-        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-    D3D12_GPU_DESCRIPTOR_HANDLE gpuSrv{ gpuStart.ptr + SIZE_T(inc) };
-    m_cmdList->SetGraphicsRootDescriptorTable(1, gpuSrv);
+    m_quadEntity = Entity{};
+    for (const Entity& e : loaded)
+    {
+        const Renderable* r = m_world.GetRenderable(e);
+        if (r && r->draw.mesh == kMeshQuad) { m_quadEntity = e; break; }
+    }
 
-    using namespace DirectX;
-    XMMATRIX V = m_camera.GetViewMatrix();
-    XMMATRIX P = m_camera.GetProjectionMatrix();
+    char text[160];
+    std::snprintf(text, sizeof(text), "Loaded %zu entities in %.2f ms", loaded.size(), double(Profiler::NowNs() - t0) / 1e6);
+    m_sceneStatus = text;
+    RequestRedraw();
+    return true;
+}
 
-    // ---------- 1) GRID + AXIS (world XZ plane, M = I) ----------
+void DXRenderer::PublishScene() noexcept
+{
+    PROFILE_SCOPE("Publish snapshot");
+
+    // UI edits are simulation state too: fold them into the entities
+    // (SetRenderable ignores unchanged draws).
+    auto setVisible = [this](Entity e, bool visible) {
+        ProxyDraw draw = m_world.GetRenderable(e)->draw;
+        draw.flags = visible ? (draw.flags | ProxyDraw::kVisible) : (draw.flags & ~uint32_t(ProxyDraw::kVisible));
+        m_world.SetRenderable(e, draw);
+    };
+    setVisible(m_gridEntity, m_showGrid && m_gridVertexCount > 0);
+    setVisible(m_axisEntity, m_showAxis && m_axisVertexCount > 0);
+
+    if (const Renderable* r = m_world.GetRenderable(m_quadEntity)) // a loaded scene may have no quad
     {
-        XMMATRIX M = XMMatrixIdentity();
-        XMMATRIX MVP = M * V * P;
-        XMMATRIX MVPt = XMMatrixTranspose(MVP);
+        ProxyDraw quad = r->draw;
+        quad.material = ColorPermutation::Key(m_samplerType, m_vertexColorBlend);
+        m_world.SetRenderable(m_quadEntity, quad);
+    }
 
-        if (m_cbMapped)
-        {
-            CbMvp cb{};
-            XMStoreFloat4x4(&cb.mvp, MVPt);
-            cb.samplerIndex = 0; // Not used for lines, safe default.
-            std::memcpy(m_cbMapped, &cb, sizeof(CbMvp));
-        }
+    // Whatever moved since the last step was edited outside the simulation
+    // (UI, gizmo, load): drawn where it is now, not interpolated towards it.
+    m_world.UpdateTransforms(&m_jobs);
+    m_world.SyncRenderScene(m_scene, true);
 
-        m_cmdList->SetPipelineState(m_psoLines.Get());
-        m_cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
-        m_cmdList->IASetVertexBuffers(0, 1, &m_gridVbView);
+    const float alpha = m_sim.Alpha();
+    const XMFLOAT3 eye = m_camera.GetPosition();
+    const float back = 1.0f - alpha;
 
-        if (m_showGrid && m_gridVertexCount > 0)
-        {
-            m_cmdList->DrawInstanced(m_gridVertexCount, 1, 0, 0);
-        }
+    RenderView view;
+    XMStoreFloat4x4(&view.view, InterpolatedViewMatrix());
+    XMStoreFloat4x4(&view.proj, m_camera.GetProjectionMatrix());
+    view.position = { eye.x - back * m_camStepDelta.x, eye.y - back * m_camStepDelta.y, eye.z - back * m_camStepDelta.z };
+    m_scene.SetView(view);
 
-        if (m_showAxis && m_axisVertexCount > 0)
+    m_scene.Publish(alpha);
+    m_snapshot = m_scene.Acquire();
+}
+
+void DXRenderer::CollectDraws() noexcept
+{
+    PROFILE_SCOPE("Collect draws");
+
+    using namespace DirectX;
+    const RenderSnapshot& snap = *m_snapshot;
+    const XMMATRIX V = XMLoadFloat4x4(&snap.view.view);
+    const XMMATRIX P = XMLoadFloat4x4(&snap.view.proj);
+
+    m_drawList.Clear();
+    m_cbSlotCount = 0;
+
+    // Every proxy may need a slot, plus the upscale slot. Growing waits for
+    // the GPU (frames in flight still read the old buffer); it only happens
+    // when the scene outgrows every size seen so far. A size that failed is
+    // not tried again (the draws past the old size are dropped) until the
+    // scene needs a larger one.
+    const UINT needed = UINT(snap.ProxyCount()) + 1;
+    if (needed > m_cbSlotsPerFrame)
+    {
+        UINT slots = m_cbSlotsPerFrame;
+        while (slots < needed) slots *= 2;
+        if (slots > m_cbFailedSlots)
         {
-            m_cmdList->DrawInstanced(m_axisVertexCount, 1, m_gridVertexCount, 0);
+            WaitForGpu();
+            if (!CreateConstantBuffer(slots))
+            {
+                m_cbFailedSlots = slots;
+                OutputDebugStringA("DXRenderer: constant buffer growth failed, dropping draws\n");
+            }
         }
     }
 
-    // ---------- 2) TEXTURED QUAD (ground plane, XZ) ----------
+    // Writes one per-draw constant slot of this frame's slice, returns its index.
+    auto pushConstants = [&](const XMMATRIX& M) -> UINT
     {
-        // Quad is defined in XY (-0.5..0.5). Scale and rotate to XZ plane.
-        XMMATRIX M =
-            XMMatrixScaling(5.0f, 5.0f, 1.0f) *
-            XMMatrixRotationX(-XM_PIDIV2);
-
-        XMMATRIX MVP = M * V * P;
-        XMMATRIX MVPt = XMMatrixTranspose(MVP);
-
-        if (m_cbMapped)
+        if (!m_cbMapped || m_cbSlotCount >= UpscaleSlot())
         {
-            CbMvp cb{};
-            XMStoreFloat4x4(&cb.mvp, MVPt);
-            cb.samplerIndex = static_cast<UINT>(m_samplerType);
-            std::memcpy(m_cbMapped, &cb, sizeof(CbMvp));
+            ++m_counters.droppedDraws;
+            return UINT_MAX;
         }
 
-        m_cmdList->SetPipelineState(m_pso.Get());
-        m_cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        m_cmdList->IASetVertexBuffers(0, 1, &m_vbView);
-        m_cmdList->DrawInstanced(6, 1, 0, 0);
-    }
-
-    // =========================
-    // IMGUI DRAW
-    // =========================
-    ImGui::Render();
-
-    ID3D12DescriptorHeap* imguiHeaps[] = { m_imguiSrvHeap.Get() };
-    m_cmdList->SetDescriptorHeaps(1, imguiHeaps);
-    ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), m_cmdList.Get());
-
-    // =========================
-    // PRESENT
-    // =========================
-    auto toPresent = CD3DX12_RESOURCE_BARRIER::Transition(
-        backBuffer,
-        D3D12_RESOURCE_STATE_RENDER_TARGET,
-        D3D12_RESOURCE_STATE_PRESENT);
-    m_cmdList->ResourceBarrier(1, &toPresent);
-
-    m_cmdList->Close();
-    ID3D12CommandList* lists[] = { m_cmdList.Get() };
-    m_commandQueue->ExecuteCommandLists(1, lists);
+        const UINT slot = m_cbSlotCount++;
+        XMStoreFloat4x4(&m_slotWorld[slot], M);
+        CbMvp cb{};
+        XMStoreFloat4x4(&cb.mvp, XMMatrixTranspose(M * V * P));
+        cb.textureIndex = m_texSrvIndex;
+        std::memcpy(m_cbMapped + (SIZE_T(m_frameIndex) * m_cbSlotsPerFrame + slot) * m_cbSize, &cb, sizeof(CbMvp));
+        return slot;
+    };
 
-    m_swapChain->Present(1, 0);
-    m_firstFrame = false;
+    // View-space distance of a world-space point, for the depth bucket of the key.
+    auto viewDepth = [&](const XMMATRIX& M) -> uint32_t
+    {
+        XMVECTOR c = XMVector3Transform(XMVectorZero(), M * V);
+        return DrawKey::QuantizeDepth(-XMVectorGetZ(c), 0.1f, 1000.0f); // RH: camera looks down -Z
+    };
 
-    const UINT64 fenceToWait = m_fenceValue++;
-    m_commandQueue->Signal(m_fence.Get(), fenceToWait);
-    if (m_fence->GetCompletedValue() < fenceToWait)
+    // Scene proxies.
+    for (ProxyId id = 0; id < snap.ProxyCount(); ++id)
     {
-        m_fence->SetEventOnCompletion(fenceToWait, m_fenceEvent);
-        WaitForSingleObject(m_fenceEvent, INFINITE);
+        const ProxyDraw& p = snap.draws[id];
+        if (!p.Visible()) continue;
+
+        const XMMATRIX M = snap.Moved(id)
+            ? InterpolateTransform(snap.prevTransforms[id], snap.transforms[id], snap.alpha)
+            : XMLoadFloat4x4(&snap.transforms[id]);
+
+        DrawItem d{};
+        d.pipeline = p.pipeline;
+        d.mesh = p.mesh;
+        d.material = p.material;
+        d.firstVertex = p.firstVertex;
+        d.vertexCount = p.vertexCount;
+        d.constantSlot = pushConstants(M);
+        const DrawKey::Pass pass = (p.pipeline == kPipelineLines) ? DrawKey::Pass::Lines : DrawKey::Pass::Opaque;
+        d.sortKey = DrawKey::Make(pass, d.pipeline, d.material, d.mesh, viewDepth(M));
+        if (d.constantSlot != UINT_MAX)
+            m_drawList.Add(d);
     }
-
-    m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
 }
 
 
-
-
 // --------------------------------------------------------
 // Resize
 // --------------------------------------------------------
 void DXRenderer::Resize(UINT width, UINT height) noexcept {
     if (!m_swapChain || width == 0 || height == 0) return;
+    RequestRedraw();
 
     WaitForGpu();
 
     for (auto& rt : m_renderTargets) rt.Reset();
     m_depth.Reset();
+    m_sceneColor.Reset();
 
     m_width = width;
     m_height = height;
 
-    m_swapChain->ResizeBuffers(kBufferCount, width, height, m_backbufferFormat, 0);
+    m_swapChain->ResizeBuffers(kBufferCount, width, height, m_backbufferFormat, m_swapChainFlags);
     m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
 
     CreateRenderTargets();
     CreateDepthResources();
+    if (!CreateSceneTarget())
+    {
+        // Keep running at full resolution; Render only scales with a target.
+        m_sceneColor.Reset();
+        OutputDebugStringA("DXRenderer: scene target creation failed on resize, dynamic resolution off\n");
+    }
 
     m_viewport = { 0.0f, 0.0f, float(width), float(height), 0.0f, 1.0f };
     m_scissor = { 0, 0, int(width), int(height) };
@@ -555,13 +1252,29 @@ bool DXRenderer::CreateSwapChain(HWND hwnd, UINT width, UINT height) noexcept {
     sc.Scaling = DXGI_SCALING_STRETCH;
     sc.AlphaMode = DXGI_ALPHA_MODE_IGNORE;
 
+    // Tearing needs OS + driver support; ask before requesting it.
+    BOOL allowTearing = FALSE;
+    if (SUCCEEDED(m_device->GetFactory()->CheckFeatureSupport(
+        DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing))))
+        m_tearingSupported = (allowTearing == TRUE);
+
+    m_swapChainFlags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+    if (m_tearingSupported) m_swapChainFlags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+    sc.Flags = m_swapChainFlags;
+
     ComPtr<IDXGISwapChain1> sc1;
     if (FAILED(m_device->GetFactory()->CreateSwapChainForHwnd(
         m_commandQueue.Get(), hwnd, &sc, nullptr, nullptr, &sc1)))
         return false;
 
     m_device->GetFactory()->MakeWindowAssociation(hwnd, DXGI_MWA_NO_ALT_ENTER);
-    sc1.As(&m_swapChain);
+    if (FAILED(sc1.As(&m_swapChain)))
+        return false;
+
+    // At most one frame queued ahead of the display.
+    m_swapChain->SetMaximumFrameLatency(1);
+    m_frameLatencyWaitable = m_swapChain->GetFrameLatencyWaitableObject();
+
     m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
     return true;
 }
@@ -569,7 +1282,7 @@ bool DXRenderer::CreateSwapChain(HWND hwnd, UINT width, UINT height) noexcept {
 bool DXRenderer::CreateRTVDescriptorHeap() noexcept {
     D3D12_DESCRIPTOR_HEAP_DESC desc{};
     desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-    desc.NumDescriptors = kBufferCount;
+    desc.NumDescriptors = kBufferCount + 1; // back buffers + offscreen scene target
     desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
     if (FAILED(m_device->GetDevice()->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&m_rtvHeap)))) return false;
     m_rtvDescriptorSize = m_device->GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
@@ -611,12 +1324,15 @@ bool DXRenderer::CreateDepthResources() noexcept {
         &heap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_DEPTH_WRITE, &clear, IID_PPV_ARGS(&m_depth))))
         return false;
 
-    D3D12_DESCRIPTOR_HEAP_DESC dh{};
-    dh.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
-    dh.NumDescriptors = 1;
-    dh.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    // DSV heap survives resizes, only the view is rewritten.
+    if (!m_dsvHeap) {
+        D3D12_DESCRIPTOR_HEAP_DESC dh{};
+        dh.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+        dh.NumDescriptors = 1;
+        dh.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 
-    if (FAILED(m_device->GetDevice()->CreateDescriptorHeap(&dh, IID_PPV_ARGS(&m_dsvHeap)))) return false;
+        if (FAILED(m_device->GetDevice()->CreateDescriptorHeap(&dh, IID_PPV_ARGS(&m_dsvHeap)))) return false;
+    }
 
     D3D12_DEPTH_STENCIL_VIEW_DESC dsv{};
     dsv.Format = m_depthFormat;
@@ -627,36 +1343,47 @@ bool DXRenderer::CreateDepthResources() noexcept {
     return true;
 }
 
+bool DXRenderer::CreateSceneTarget() noexcept {
+    D3D12_HEAP_PROPERTIES heap{ D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(
+        m_backbufferFormat, m_width, m_height, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+
+    D3D12_CLEAR_VALUE clear{};
+    clear.Format = m_backbufferFormat;
+    std::memcpy(clear.Color, kClearColor, sizeof(kClearColor));
+
+    if (FAILED(m_device->GetDevice()->CreateCommittedResource(
+        &heap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, &clear, IID_PPV_ARGS(&m_sceneColor))))
+        return false;
+
+    D3D12_CPU_DESCRIPTOR_HANDLE rtv = m_rtvHeap->GetCPUDescriptorHandleForHeapStart();
+    rtv.ptr += SIZE_T(kBufferCount) * SIZE_T(m_rtvDescriptorSize);
+    m_device->GetDevice()->CreateRenderTargetView(m_sceneColor.Get(), nullptr, rtv);
+
+    return true;
+}
+
 bool DXRenderer::CreateRootSignature() noexcept
 {
     // =========================
-    // 1) Descriptor ranges (CBV + SRV)
+    // 1) Root parameters (CBV + SRV table)
     // =========================
 
-    // CBV range for b0 (constant buffer with MVP + samplerIndex).
-    D3D12_DESCRIPTOR_RANGE rngCBV{};
-    rngCBV.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
-    rngCBV.NumDescriptors = 1;
-    rngCBV.BaseShaderRegister = 0; // b0
-    rngCBV.RegisterSpace = 0;
-    rngCBV.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
-
-    D3D12_ROOT_DESCRIPTOR_TABLE tblCBV{};
-    tblCBV.NumDescriptorRanges = 1;
-    tblCBV.pDescriptorRanges = &rngCBV;
-
+    // Root CBV for b0 (per-draw constants: MVP + textureIndex).
     D3D12_ROOT_PARAMETER paramCBV{};
-    paramCBV.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-    paramCBV.DescriptorTable = tblCBV;
+    paramCBV.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    paramCBV.Descriptor.ShaderRegister = 0; // b0
+    paramCBV.Descriptor.RegisterSpace = 0;
     paramCBV.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL; // VS + PS can read CBV
 
-    // SRV range for t0 (checker texture).
+    // SRV range t0..tN covering the whole global heap (bindless texture array);
+    // CreateSrvHeap sized the heap to what the binding tier allows in one table.
     D3D12_DESCRIPTOR_RANGE rngSRV{};
     rngSRV.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-    rngSRV.NumDescriptors = 1;
+    rngSRV.NumDescriptors = m_descriptors.Capacity();
     rngSRV.BaseShaderRegister = 0; // t0
     rngSRV.RegisterSpace = 0;
-    rngSRV.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+    rngSRV.OffsetInDescriptorsFromTableStart = 0;
 
     D3D12_ROOT_DESCRIPTOR_TABLE tblSRV{};
     tblSRV.NumDescriptorRanges = 1;
@@ -719,57 +1446,69 @@ bool DXRenderer::CreateRootSignature() noexcept
     rs.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
 
     // =========================
-    // 4) Serialize + create
+    // 4) Serialize + create (serialized blob cached on disk)
     // =========================
 
-    ComPtr<ID3DBlob> blob, err;
-    HRESULT hr = D3D12SerializeRootSignature(
-        &rs,
-        D3D_ROOT_SIGNATURE_VERSION_1,
-        &blob,
-        &err
-    );
+    return m_pipelines.GetRootSignature(rs, m_rootSig);
+}
+
+
+void DXRenderer::RequestShaderBinaries() noexcept
+{
+    const std::string files[kShaderCount] = {
+        "ColorVS.cso", ColorPermutation::Space().VariantName(ColorPermutation::kDefault) + ".cso",
+        "UpscaleVS.cso", "UpscalePS.cso" };
+    const std::filesystem::path exeDir = ExeDirectory();
 
-    if (FAILED(hr))
+    bool packed = m_assets.Open(exeDir / L"Assets.pack");
+    for (uint32_t i = 0; packed && i < kShaderCount; ++i)
     {
-        if (err)
-        {
-            // Print error from root signature serialization.
-            OutputDebugStringA((const char*)err->GetBufferPointer());
-        }
-        return false;
+        m_shaderEntries[i] = m_assets.Find("Shaders/" + files[i]);
+        packed = m_shaderEntries[i] != nullptr;
     }
+    if (packed) return;
+    std::fill(std::begin(m_shaderEntries), std::end(m_shaderEntries), nullptr);
 
-    hr = m_device->GetDevice()->CreateRootSignature(
-        0,
-        blob->GetBufferPointer(),
-        blob->GetBufferSize(),
-        IID_PPV_ARGS(&m_rootSig)
-    );
-
-    return SUCCEEDED(hr);
+    std::vector<AsyncIO::Request> requests(kShaderCount);
+    for (uint32_t i = 0; i < kShaderCount; ++i)
+    {
+        requests[i].path = exeDir / L"Shaders" / files[i];
+        requests[i].priority = AsyncIO::Priority::High;
+    }
+    m_io.SubmitBatch(requests, m_shaderReads);
 }
 
-
-bool DXRenderer::CreatePipelineState() noexcept
+// A ColorPS variant outside the startup batch, loaded off the render thread:
+// from the pack on a background job (the decode is the work), else the
+// loose file through m_io. Both hand the result to m_colorVariants, which
+// publishes it at the start of the next frame.
+void DXRenderer::RequestShaderVariant(uint32_t permutation, const std::string& variant)
 {
-    auto shaderPath = [](const wchar_t* file) -> std::wstring {
-        wchar_t exe[MAX_PATH];
-        GetModuleFileNameW(nullptr, exe, MAX_PATH);
-        std::filesystem::path p(exe);
-        p = p.parent_path() / L"Shaders" / file;
-        return p.wstring();
-        };
-
-    std::vector<uint8_t> vs;
-    std::vector<uint8_t> ps;
+    const std::string file = variant + ".cso";
+    if (m_assets.IsOpen())
+    {
+        if (const PackFormat::PackEntry* entry = m_assets.Find("Shaders/" + file))
+        {
+            m_jobs.Submit([this, permutation, entry] {
+                std::vector<uint8_t> code;
+                const bool ok = m_assets.Read(*entry, code);
+                m_colorVariants.Complete(permutation, ok, std::move(code));
+            }, JobSystem::Priority::Background);
+            return;
+        }
+    }
 
-    if (!LoadFileBinary(shaderPath(L"ColorVS.cso").c_str(), vs))
-        return false;
-    if (!LoadFileBinary(shaderPath(L"ColorPS.cso").c_str(), ps))
-        return false;
+    AsyncIO::Request request;
+    request.path = ExeDirectory() / L"Shaders" / file;
+    request.onComplete = [this, permutation](AsyncIO::Result& result) {
+        m_colorVariants.Complete(permutation, result.status == AsyncIO::Status::Ok, std::move(result.data));
+    };
+    m_io.Submit(std::move(request));
+}
 
-    D3D12_INPUT_ELEMENT_DESC layout[] =
+D3D12_GRAPHICS_PIPELINE_STATE_DESC DXRenderer::ColorPipelineDesc(uint32_t pipeline, const std::vector<uint8_t>& ps) const noexcept
+{
+    static const D3D12_INPUT_ELEMENT_DESC layout[] =
     {
         { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,
           D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
@@ -778,6 +1517,7 @@ bool DXRenderer::CreatePipelineState() noexcept
         { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 24,
           D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
     };
+    const std::vector<uint8_t>& vs = m_shaderCode[kShaderColorVS];
 
     D3D12_GRAPHICS_PIPELINE_STATE_DESC pso{};
     pso.pRootSignature = m_rootSig.Get();
@@ -793,18 +1533,82 @@ bool DXRenderer::CreatePipelineState() noexcept
     pso.DSVFormat = m_depthFormat;
     pso.SampleDesc = { 1, 0 };
     pso.SampleMask = UINT_MAX;
+    pso.PrimitiveTopologyType = (pipeline == kPipelineLines)
+        ? D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE : D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    return pso;
+}
 
-    // PSO for triangles
-    pso.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    HRESULT hrTri = m_device->GetDevice()->CreateGraphicsPipelineState(
-        &pso, IID_PPV_ARGS(&m_pso));
-
-    // PSO for lines
-    pso.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
-    HRESULT hrLine = m_device->GetDevice()->CreateGraphicsPipelineState(
-        &pso, IID_PPV_ARGS(&m_psoLines));
+// Handle of the pipeline for draws of 'pipeline' with ColorPS variant
+// 'permutation', requested once the variant's binary is loaded (the first
+// use starts the load); kNoPipeline while it loads or if the variant has no
+// binary. Either way its draws use the fallback.
+PipelineHandle DXRenderer::ColorPipeline(uint32_t pipeline, uint32_t permutation)
+{
+    const uint32_t id = (pipeline << 16) | permutation;
+    auto it = m_colorPipelines.find(id);
+    if (it != m_colorPipelines.end())
+        return it->second;
+    if (m_colorVariants.IsLoading(permutation))
+        return kNoPipeline;
+
+    PipelineHandle handle = kNoPipeline;
+    if (const std::vector<uint8_t>* ps = m_colorVariants.Get(permutation))
+        handle = m_pipelines.RequestGraphicsPipeline(ColorPipelineDesc(pipeline, *ps));
+    else if (m_colorVariants.IsLoading(permutation))
+        return kNoPipeline; // load just started: asked again next frame
+    m_colorPipelines.emplace(id, handle);
+    return handle;
+}
 
-    return SUCCEEDED(hrTri) && SUCCEEDED(hrLine);
+bool DXRenderer::CreatePipelineState() noexcept
+{
+    std::vector<uint8_t>* shaders = m_shaderCode;
+    bool loaded = true;
+    if (m_shaderEntries[0])
+    {
+        uint8_t* dsts[kShaderCount];
+        for (uint32_t i = 0; i < kShaderCount; ++i)
+        {
+            shaders[i].resize(size_t(m_shaderEntries[i]->size));
+            dsts[i] = shaders[i].data();
+        }
+        loaded = m_assets.ReadMany(m_shaderEntries, dsts, kShaderCount, &m_jobs);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < kShaderCount; ++i)
+        {
+            AsyncIO::Result result = m_io.Wait(m_shaderReads[i]);
+            loaded &= result.status == AsyncIO::Status::Ok;
+            shaders[i] = std::move(result.data);
+        }
+    }
+    if (!loaded)
+        return false;
+    m_colorVariants.Insert(ColorPermutation::kDefault, std::move(shaders[kShaderColorPS]));
+    m_colorVariants.LoadUsage(ExeDirectory() / L"ShaderUsage.txt");
+
+    // Default permutation: the fallbacks. The triangle one is needed before
+    // the first frame.
+    m_fallbackPipelines[kPipelineTriangles] = ColorPipeline(kPipelineTriangles, ColorPermutation::kDefault);
+    m_fallbackPipelines[kPipelineLines] = ColorPipeline(kPipelineLines, ColorPermutation::kDefault);
+
+    // PSO for the dynamic resolution upscale: fullscreen triangle generated
+    // from SV_VertexID (no vertex buffer), no depth test.
+    const std::vector<uint8_t>& upscaleVs = shaders[kShaderUpscaleVS];
+    const std::vector<uint8_t>& upscalePs = shaders[kShaderUpscalePS];
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC pso = ColorPipelineDesc(kPipelineTriangles, upscalePs);
+    pso.VS = { upscaleVs.data(), (UINT)upscaleVs.size() };
+    pso.InputLayout = { nullptr, 0 };
+    pso.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+    pso.DepthStencilState.DepthEnable = FALSE;
+    pso.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+    m_upscalePipeline = m_pipelines.RequestGraphicsPipeline(pso);
+
+    // The others finish on the workers while startup goes on; Update()
+    // publishes them and saves the library (on a job) once they are all built.
+    return m_pipelines.Wait(m_fallbackPipelines[kPipelineTriangles]);
 }
 
 bool DXRenderer::CreateTriangleVB() noexcept {
@@ -843,47 +1647,9 @@ bool DXRenderer::CreateGridVB() noexcept
     constexpr float kSpacing = 0.5f;
 
     std::vector<Vertex> verts;
-    verts.reserve((kHalfLines * 2 + 1) * 4 + 6);
-
-    using DirectX::XMFLOAT2;
-    using DirectX::XMFLOAT3;
-
-    const XMFLOAT3 gridColor = { 0.25f, 0.25f, 0.25f };
-
-    // Grid lines on XZ plane (y = 0)
-    for (int i = -kHalfLines; i <= kHalfLines; ++i)
-    {
-        float x = float(i) * kSpacing;
-        float z = float(i) * kSpacing;
-
-        // Lines parallel to X axis (vary X, fixed Z)
-        verts.push_back({ XMFLOAT3(-kHalfLines * kSpacing, 0.0f, z), gridColor, XMFLOAT2(0.0f, 0.0f) });
-        verts.push_back({ XMFLOAT3(kHalfLines * kSpacing, 0.0f, z), gridColor, XMFLOAT2(1.0f, 0.0f) });
-
-        // Lines parallel to Z axis (vary Z, fixed X)
-        verts.push_back({ XMFLOAT3(x, 0.0f, -kHalfLines * kSpacing), gridColor, XMFLOAT2(0.0f, 0.0f) });
-        verts.push_back({ XMFLOAT3(x, 0.0f,  kHalfLines * kSpacing), gridColor, XMFLOAT2(1.0f, 0.0f) });
-    }
-
-    m_gridVertexCount = static_cast<UINT>(verts.size());
-
-    const XMFLOAT3 xColor = { 1.0f, 0.0f, 0.0f };
-    const XMFLOAT3 yColor = { 0.0f, 1.0f, 0.0f };
-    const XMFLOAT3 zColor = { 0.0f, 0.0f, 1.0f };
-
-    // X axis
-    verts.push_back({ XMFLOAT3(-kHalfLines * kSpacing, 0.0f, 0.0f), xColor, XMFLOAT2(0.0f, 0.0f) });
-    verts.push_back({ XMFLOAT3(kHalfLines * kSpacing, 0.0f, 0.0f), xColor, XMFLOAT2(1.0f, 0.0f) });
-
-    // Z axis
-    verts.push_back({ XMFLOAT3(0.0f, 0.0f, -kHalfLines * kSpacing), zColor, XMFLOAT2(0.0f, 0.0f) });
-    verts.push_back({ XMFLOAT3(0.0f, 0.0f,  kHalfLines * kSpacing), zColor, XMFLOAT2(1.0f, 0.0f) });
-
-    // Y axis
-    verts.push_back({ XMFLOAT3(0.0f, -kHalfLines * kSpacing, 0.0f), yColor, XMFLOAT2(0.0f, 0.0f) });
-    verts.push_back({ XMFLOAT3(0.0f,  kHalfLines * kSpacing, 0.0f), yColor, XMFLOAT2(0.0f, 1.0f) });
-
-    m_axisVertexCount = static_cast<UINT>(verts.size()) - m_gridVertexCount;
+    const MeshGen::GridCounts counts = MeshGen::BuildGridVertices(kHalfLines, kSpacing, verts);
+    m_gridVertexCount = counts.gridVertices;
+    m_axisVertexCount = counts.axisVertices;
 
     const UINT vbSize = static_cast<UINT>(verts.size() * sizeof(Vertex));
 
@@ -913,48 +1679,72 @@ bool DXRenderer::CreateGridVB() noexcept
     return true;
 }
 
-bool DXRenderer::CreateConstantBuffer() noexcept {
+bool DXRenderer::CreateConstantBuffer(UINT slotsPerFrame) noexcept {
+    // slotsPerFrame slots per frame in flight, bound per draw as root CBVs.
+    // Replaces the current buffer only on success; the caller makes sure the
+    // GPU no longer reads it.
     m_cbSize = (sizeof(CbMvp) + 255) & ~255u;
     D3D12_HEAP_PROPERTIES heap{ D3D12_HEAP_TYPE_UPLOAD };
-    D3D12_RESOURCE_DESC buf = CD3DX12_RESOURCE_DESC::Buffer(m_cbSize);
+    D3D12_RESOURCE_DESC buf = CD3DX12_RESOURCE_DESC::Buffer(UINT64(m_cbSize) * slotsPerFrame * kBufferCount);
 
+    Microsoft::WRL::ComPtr<ID3D12Resource> upload;
     if (FAILED(m_device->GetDevice()->CreateCommittedResource(
-        &heap, D3D12_HEAP_FLAG_NONE, &buf, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&m_cbUpload))))
+        &heap, D3D12_HEAP_FLAG_NONE, &buf, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&upload))))
         return false;
 
-    if (FAILED(m_cbUpload->Map(0, nullptr, reinterpret_cast<void**>(&m_cbMapped)))) return false;
-
-    D3D12_DESCRIPTOR_HEAP_DESC h{};
-    h.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    h.NumDescriptors = 2; // CBV + SRV
-    h.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-
-    if (FAILED(m_device->GetDevice()->CreateDescriptorHeap(&h, IID_PPV_ARGS(&m_cbvHeap)))) return false;
-
-    D3D12_CONSTANT_BUFFER_VIEW_DESC cbv{};
-    cbv.BufferLocation = m_cbUpload->GetGPUVirtualAddress();
-    cbv.SizeInBytes = m_cbSize;
-    m_device->GetDevice()->CreateConstantBufferView(&cbv, m_cbvHeap->GetCPUDescriptorHandleForHeapStart());
+    uint8_t* mapped = nullptr;
+    if (FAILED(upload->Map(0, nullptr, reinterpret_cast<void**>(&mapped)))) return false;
 
+    m_cbUpload = std::move(upload);
+    m_cbMapped = mapped;
+    m_cbSlotsPerFrame = slotsPerFrame;
+    m_slotWorld.resize(slotsPerFrame);
     return true;
 }
 
 bool DXRenderer::CreateCheckerTextureSRV() noexcept {
     const UINT W = 256; const UINT H = 256;
-    std::vector<uint32_t> pixels(W * H);
-    for (UINT i = 0; i < W * H; ++i) {
-        bool c = (((i % W) / 32) ^ ((i / W) / 32)) & 1;
-        uint8_t v = c ? 220 : 40;
-        pixels[i] = 0xFF000000 | (v << 16) | (v << 8) | v;
+
+    // The texture with its full mip chain is derived data: generated once,
+    // then read back from the cache for as long as the parameters match.
+    struct CheckerParams { uint32_t width, height, cell; uint8_t dark, light, pad[2]; };
+    const CheckerParams params{ W, H, 32, 40, 220, {} };
+    const DerivedDataCache::Key key = DerivedDataCache::KeyBuilder("checker-mips", 1).AddValue(params).Finish();
+
+    std::vector<uint8_t> texels;
+    const bool built = m_derivedData.GetOrBuild(key, texels, [&](std::vector<uint8_t>& out) {
+        std::vector<uint32_t> pixels(size_t(params.width) * params.height);
+        TexelGen::FillChecker(pixels.data(), params.width, params.height, params.cell, params.dark, params.light);
+        std::vector<uint32_t> chain;
+        TexelGen::BuildMipChain(pixels.data(), params.width, params.height, chain);
+        out.resize(chain.size() * sizeof(uint32_t));
+        std::memcpy(out.data(), chain.data(), out.size());
+        return true;
+    });
+    if (!built) return false;
+
+    // Levels and their offsets follow from the size; a cached blob of any other size is not ours.
+    UINT16 mipLevels = 0;
+    D3D12_SUBRESOURCE_DATA subresources[16]{};
+    size_t offset = 0;
+    for (UINT w = W, h = H; mipLevels < 16; w = (std::max)(w / 2, 1u), h = (std::max)(h / 2, 1u))
+    {
+        D3D12_SUBRESOURCE_DATA& level = subresources[mipLevels++];
+        level.pData = texels.data() + offset;
+        level.RowPitch = LONG_PTR(w) * 4;
+        level.SlicePitch = level.RowPitch * h;
+        offset += size_t(level.SlicePitch);
+        if (w == 1 && h == 1) break;
     }
+    if (offset != texels.size()) return false;
 
     D3D12_HEAP_PROPERTIES defHeap{ D3D12_HEAP_TYPE_DEFAULT };
-    D3D12_RESOURCE_DESC tex = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, W, H);
+    D3D12_RESOURCE_DESC tex = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, W, H, 1, mipLevels);
     if (FAILED(m_device->GetDevice()->CreateCommittedResource(
         &defHeap, D3D12_HEAP_FLAG_NONE, &tex, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&m_tex))))
         return false;
 
-    const UINT64 uploadSize = GetRequiredIntermediateSize(m_tex.Get(), 0, 1);
+    const UINT64 uploadSize = GetRequiredIntermediateSize(m_tex.Get(), 0, mipLevels);
     D3D12_HEAP_PROPERTIES upHeap{ D3D12_HEAP_TYPE_UPLOAD };
     auto upDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadSize);
     ComPtr<ID3D12Resource> upload;
@@ -962,15 +1752,10 @@ bool DXRenderer::CreateCheckerTextureSRV() noexcept {
         &upHeap, D3D12_HEAP_FLAG_NONE, &upDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&upload))))
         return false;
 
-    D3D12_SUBRESOURCE_DATA s{};
-    s.pData = pixels.data();
-    s.RowPitch = W * 4;
-    s.SlicePitch = s.RowPitch * H;
-
     if (FAILED(m_cmdAlloc->Reset())) return false;
     if (FAILED(m_cmdList->Reset(m_cmdAlloc.Get(), nullptr))) return false;
 
-    UpdateSubresources(m_cmdList.Get(), m_tex.Get(), upload.Get(), 0, 0, 1, &s);
+    UpdateSubresources(m_cmdList.Get(), m_tex.Get(), upload.Get(), 0, 0, mipLevels, subresources);
     auto barrier = CD3DX12_RESOURCE_BARRIER::Transition(
         m_tex.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
     m_cmdList->ResourceBarrier(1, &barrier);
@@ -980,33 +1765,84 @@ bool DXRenderer::CreateCheckerTextureSRV() noexcept {
     m_commandQueue->ExecuteCommandLists(1, lists);
     WaitForGpu();
 
-    D3D12_CPU_DESCRIPTOR_HANDLE cpuStart = m_cbvHeap->GetCPUDescriptorHandleForHeapStart();
-    UINT inc2 = m_device->GetDevice()->GetDescriptorHandleIncrementSize(
-        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-    D3D12_CPU_DESCRIPTOR_HANDLE cpuSrv{ cpuStart.ptr + SIZE_T(inc2) };
+    m_texSrvIndex = m_descriptors.Allocate();
+    if (m_texSrvIndex == DescriptorAllocator::kInvalidIndex) return false;
 
     D3D12_SHADER_RESOURCE_VIEW_DESC srv{};
     srv.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     srv.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
     srv.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-    srv.Texture2D.MipLevels = 1;
-    m_device->GetDevice()->CreateShaderResourceView(m_tex.Get(), &srv, cpuSrv);
+    srv.Texture2D.MipLevels = mipLevels;
+    m_device->GetDevice()->CreateShaderResourceView(m_tex.Get(), &srv, SrvCpu(m_texSrvIndex));
     return true;
 }
 
-bool DXRenderer::LoadFileBinary(const wchar_t* path, std::vector<uint8_t>& data) noexcept {
-    FILE* f = nullptr;
-    _wfopen_s(&f, path, L"rb");
-    if (!f) return false;
-    fseek(f, 0, SEEK_END);
-    long sz = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    data.resize(sz);
-    if (sz > 0) fread(data.data(), 1, sz, f);
-    fclose(f);
+bool DXRenderer::CreateSrvHeap() noexcept {
+    // Tier 1 hardware caps an SRV descriptor table at 128 entries per stage,
+    // and the root signature maps the whole heap as one table.
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+    if (SUCCEEDED(m_device->GetDevice()->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))))
+        m_resourceBindingTier = options.ResourceBindingTier;
+    const uint32_t transient = kTransientSrvsPerFrame * kBufferCount;
+    const uint32_t capacity = m_resourceBindingTier == D3D12_RESOURCE_BINDING_TIER_1 ? kTier1SrvDescriptors : kSrvDescriptors;
+    if (!m_descriptors.Initialize(capacity - transient, kTransientSrvsPerFrame, kBufferCount))
+        return false;
+
+    D3D12_DESCRIPTOR_HEAP_DESC h{};
+    h.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    h.NumDescriptors = m_descriptors.Capacity();
+    h.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+
+    if (FAILED(m_device->GetDevice()->CreateDescriptorHeap(&h, IID_PPV_ARGS(&m_srvHeap)))) return false;
+    m_srvDescriptorSize = m_device->GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+    // Handed to ImGui when the heap is full: its allocator callback cannot fail.
+    m_overflowSrvIndex = m_descriptors.Allocate();
+    if (m_overflowSrvIndex == DescriptorAllocator::kInvalidIndex) return false;
+    D3D12_SHADER_RESOURCE_VIEW_DESC nullSrv{};
+    nullSrv.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    nullSrv.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    nullSrv.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    nullSrv.Texture2D.MipLevels = 1;
+    m_device->GetDevice()->CreateShaderResourceView(nullptr, &nullSrv, SrvCpu(m_overflowSrvIndex));
     return true;
 }
 
+D3D12_CPU_DESCRIPTOR_HANDLE DXRenderer::SrvCpu(uint32_t index) const noexcept {
+    D3D12_CPU_DESCRIPTOR_HANDLE h = m_srvHeap->GetCPUDescriptorHandleForHeapStart();
+    h.ptr += SIZE_T(index) * SIZE_T(m_srvDescriptorSize);
+    return h;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DXRenderer::SrvGpu(uint32_t index) const noexcept {
+    D3D12_GPU_DESCRIPTOR_HANDLE h = m_srvHeap->GetGPUDescriptorHandleForHeapStart();
+    h.ptr += UINT64(index) * UINT64(m_srvDescriptorSize);
+    return h;
+}
+
+void DXRenderer::ImGuiSrvAlloc(ImGui_ImplDX12_InitInfo* info, D3D12_CPU_DESCRIPTOR_HANDLE* outCpu, D3D12_GPU_DESCRIPTOR_HANDLE* outGpu) {
+    auto* self = static_cast<DXRenderer*>(info->UserData);
+    uint32_t index = self->m_descriptors.Allocate();
+    if (index == DescriptorAllocator::kInvalidIndex) {
+        // The texture shares the overflow slot (and shows whatever was written
+        // there last) instead of writing through an invalid handle.
+        OutputDebugStringA("DXRenderer: global SRV heap exhausted, ImGui texture uses the overflow slot\n");
+        index = self->m_overflowSrvIndex;
+    }
+    *outCpu = self->SrvCpu(index);
+    *outGpu = self->SrvGpu(index);
+}
+
+void DXRenderer::ImGuiSrvFree(ImGui_ImplDX12_InitInfo* info, D3D12_CPU_DESCRIPTOR_HANDLE cpu, D3D12_GPU_DESCRIPTOR_HANDLE) {
+    auto* self = static_cast<DXRenderer*>(info->UserData);
+    const SIZE_T start = self->m_srvHeap->GetCPUDescriptorHandleForHeapStart().ptr;
+    const uint32_t index = uint32_t((cpu.ptr - start) / self->m_srvDescriptorSize);
+    if (index == self->m_overflowSrvIndex) return; // shared, stays reserved
+    const bool freed = self->m_descriptors.Free(index);
+    assert(freed && "ImGui freed a descriptor it does not own");
+    (void)freed;
+}
+
 void DXRenderer::WaitForGpu() noexcept {
     if (!m_commandQueue || !m_fence) return;
     const UINT64 fenceToWait = ++m_fenceValue;
@@ -6,10 +6,30 @@
 #include <DirectXMath.h>
 #include <vector>
 #include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
 #include <windows.h>
+#include "AsyncIO.h"
 #include "FrameTimer.h"
+#include "FixedStepScheduler.h"
+#include "FramePacer.h"
+#include "DynamicResolution.h"
+#include "InputEvents.h"
+#include "LatencyTracker.h"
+#include "DerivedDataCache.h"
+#include "DXPipelineCache.h"
+#include "DescriptorAllocator.h"
+#include "DrawList.h"
+#include "JobSystem.h"
+#include "MeshGen.h"
+#include "PackFile.h"
+#include "RenderProxy.h"
+#include "ShaderPermutation.h"
 #include "DXMesh.h"
 #include "Camera.h"
+#include "../Scene/World.h"
 
 // ImGui Headers
 #include "imgui/imgui.h" 
@@ -33,12 +53,93 @@ public:
     // Access to camera (if needed)
     Camera* GetCamera() { return &m_camera; }
 
+    // FPS averaged over the last 0.5 s (single source for UI and window title).
+    double GetFps() const noexcept { return m_fps; }
+    const FrameStats& GetFrameStats() const noexcept { return m_timer.Stats(); }
+
+    // Benchmarks: simulate with a fixed dt (0 = real time) and drive the camera
+    // from outside instead of mouse/keyboard state.
+    void SetFixedDelta(double seconds) noexcept { m_fixedDelta = seconds; }
+    void SetExternalCameraControl(bool enabled) noexcept { m_externalCamera = enabled; }
+
+    // On-demand redraw: unless continuous, a frame is only needed when
+    // something changed (input, camera motion, scene edits, active UI); the
+    // platform layer renders at IdleRedrawHz() otherwise (0 = never).
+    void   SetContinuousRedraw(bool enabled) noexcept { m_continuousRedraw = enabled; }
+    bool   ContinuousRedraw() const noexcept { return m_continuousRedraw; }
+    double IdleRedrawHz() const noexcept { return m_idleRedrawHz; }
+    bool   NeedsRedraw() const noexcept;
+    void   RequestRedraw() noexcept { m_redrawFrames = kRedrawSettleFrames; }
+    void   ResumeFromIdle() noexcept { m_timer.Restart(); }
+
+    // Frame pacing / present mode (uncapped, vsync, target FPS).
+    // WaitForFrameStart blocks until the next frame may start (swap chain
+    // latency waitable, then the pacer); call it before the frame's input is
+    // sampled, since waiting after sampling only adds latency. Render() does
+    // not wait.
+    void WaitForFrameStart() noexcept;
+    void SetPacing(const FramePacer::Config& config) noexcept { m_pacer.SetConfig(config); }
+    const FramePacer& GetPacer() const noexcept { return m_pacer; }
+    bool TearingSupported() const noexcept { return m_tearingSupported; }
+
+    // Dynamic resolution: the scene renders into an offscreen target at
+    // RenderScale() x the window size and is upscaled into the back buffer
+    // (UI stays at full resolution). The scale follows the cost of each frame
+    // (pacing waits excluded) against targetMs.
+    void SetDynamicResolution(bool enabled, double targetMs) noexcept;
+    bool  DynamicResolutionEnabled() const noexcept { return m_dynResEnabled; }
+    const DynamicResolution& GetDynamicResolution() const noexcept { return m_dynRes; }
+    float RenderScale() const noexcept { return m_renderScale; }
+
+    // Simulation runs in fixed steps, independent of the render rate; what is
+    // drawn is interpolated between the last two steps.
+    void SetSimulationRate(double hz, uint32_t maxCatchUpSteps) noexcept { m_sim.SetConfig({ hz, maxCatchUpSteps }); }
+    const FixedStepScheduler& GetSimulation() const noexcept { return m_sim; }
+
+    // Scene files (.dxscene): every entity except the editor grid and axis.
+    // Loading replaces the current scene entities; the sampler selector then
+    // drives the first quad of the loaded scene.
+    bool SaveScene(const std::filesystem::path& path, bool incremental = true) noexcept;
+    bool LoadScene(const std::filesystem::path& path) noexcept;
+
+    // What the last Render() submitted.
+    struct FrameCounters {
+        uint32_t draws{ 0 };
+        uint64_t triangles{ 0 };
+        uint64_t lines{ 0 };
+        uint32_t droppedDraws{ 0 }; // no constant slot left (buffer growth failed)
+    };
+    const FrameCounters& GetFrameCounters() const noexcept { return m_counters; }
+
     // ImGui Win32 hook
     static LRESULT ImGui_ImplWin32_WndProcHandler(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
     // Let ImGui tell us when it wants to capture the mouse.
     static bool IsImGuiCapturingMouse() { return ImGui::GetIO().WantCaptureMouse; }
 
+    // Platform-neutral input (live or replayed); dispatches to the hooks below.
+    void HandleInput(const InputEvent& e) noexcept;
+
+    // Replay: force what ImGui mouse capture was when the session was recorded
+    // (-1 = use live ImGui state).
+    void SetUiCaptureOverride(int captured) noexcept { m_uiCaptureOverride = captured; }
+
+    // State the last frame simulated with (recorded into input sessions).
+    float LastSimDelta() const noexcept { return m_lastSimDelta; }
+    bool  LastUiCapture() const noexcept { return m_lastUiCapture; }
+
+    // Late latch: called right before submission to pull the freshest input
+    // (fed back through HandleInput). Mouse look is applied once more and the
+    // frame's view-projection rewritten into its constant slice.
+    void SetLateLatchCallback(std::function<void()> callback) { m_lateLatchCallback = std::move(callback); }
+
+    // Camera input sample -> ExecuteCommandLists (ms): early = UpdateCamera, late = latch.
+    const FrameStats& GetEarlySampleToSubmit() const noexcept { return m_earlyToSubmit; }
+    const FrameStats& GetLateSampleToSubmit() const noexcept { return m_lateToSubmit; }
+
+    // Event timestamp -> handler / camera / submit / present, per frame.
+    const LatencyTracker& GetLatency() const noexcept { return m_latency; }
+
     // Input hooks from Window / Win32
     void OnMouseMove(float dx, float dy);      // accumulate mouse delta
     void OnMouseWheel(float wheelTicks);       // mouse wheel ticks (usually +/-1 per notch)
@@ -56,25 +157,50 @@ private:
     bool CreateRenderTargets() noexcept;
     bool CreateRootSignature() noexcept;
     bool CreatePipelineState() noexcept;
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC ColorPipelineDesc(uint32_t pipeline, const std::vector<uint8_t>& ps) const noexcept;
+    PipelineHandle ColorPipeline(uint32_t pipeline, uint32_t permutation);
+    void RequestShaderVariant(uint32_t permutation, const std::string& variant);
     bool CreateTriangleVB() noexcept;
-    bool CreateConstantBuffer() noexcept;
+    bool CreateConstantBuffer(UINT slotsPerFrame) noexcept;
     bool CreateDepthResources() noexcept;
+    bool CreateSceneTarget() noexcept;
     bool CreateCheckerTextureSRV() noexcept;
     bool CreateGridVB() noexcept;
-    bool LoadFileBinary(const wchar_t* path, std::vector<uint8_t>& data) noexcept;
+    bool CreateSrvHeap() noexcept;
+    void UpdateCamera() noexcept;
+    void Simulate(uint32_t steps) noexcept;
+    DirectX::XMMATRIX InterpolatedViewMatrix() const noexcept;
+    void BuildUi() noexcept;
+    void PublishScene() noexcept;
+    void LateLatchCamera() noexcept;
+    void RewriteViewProjection() noexcept;
+    void CollectDraws() noexcept;
+    void RequestShaderBinaries() noexcept;
     void WaitForGpu() noexcept;
 
+    // Global shader-visible heap helpers (index -> handle)
+    D3D12_CPU_DESCRIPTOR_HANDLE SrvCpu(uint32_t index) const noexcept;
+    D3D12_GPU_DESCRIPTOR_HANDLE SrvGpu(uint32_t index) const noexcept;
+
+    // ImGui allocates its texture SRVs from the global heap through these.
+    static void ImGuiSrvAlloc(ImGui_ImplDX12_InitInfo* info, D3D12_CPU_DESCRIPTOR_HANDLE* outCpu, D3D12_GPU_DESCRIPTOR_HANDLE* outGpu);
+    static void ImGuiSrvFree(ImGui_ImplDX12_InitInfo* info, D3D12_CPU_DESCRIPTOR_HANDLE cpu, D3D12_GPU_DESCRIPTOR_HANDLE gpu);
+
 private:
-    struct Vertex {
-        DirectX::XMFLOAT3 position;
-        DirectX::XMFLOAT3 color;
-        DirectX::XMFLOAT2 uv;
+    using Vertex = MeshGen::Vertex;
+
+    struct alignas(256) CbUpscale
+    {
+        float uvScale[2];           // rendered part of the scene target, in UV
+        float uvMax[2];             // clamp half a texel inside it (no bleed from stale texels)
+        UINT  textureIndex;         // Bindless SRV index of the scene target.
+        UINT  _pad[3];
     };
 
     struct alignas(256) CbMvp
     {
         DirectX::XMFLOAT4X4 mvp;    // World-View-Projection matrix.
-        UINT samplerIndex;          // Which sampler to use in the pixel shader.
+        UINT textureIndex;          // Bindless SRV index into the global heap.
         UINT _pad[3];               // Padding to keep constant buffer 16-byte aligned.
     };
 
@@ -89,6 +215,11 @@ private:
     Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_cmdList;
 
     Microsoft::WRL::ComPtr<IDXGISwapChain4>      m_swapChain;
+    UINT   m_swapChainFlags{ 0 };
+    HANDLE m_frameLatencyWaitable{ nullptr }; // signalled when a new frame may start (latency 1)
+    bool   m_tearingSupported{ false };
+    FramePacer m_pacer;
+    uint64_t   m_frameBeginNs{ 0 }; // end of the last WaitForFrameStart, 0 = not waited
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
     UINT m_rtvDescriptorSize{ 0 };
     std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_renderTargets;
@@ -97,7 +228,25 @@ private:
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_dsvHeap;
     DXGI_FORMAT m_depthFormat = DXGI_FORMAT_D32_FLOAT;
 
-    ComPtr<ID3D12DescriptorHeap> m_imguiSrvHeap;
+    // Offscreen scene colour (window size; a scaled frame uses its top-left part).
+    // Rests in PIXEL_SHADER_RESOURCE; its RTV follows the back buffer RTVs.
+    // Its SRV is transient, written each upscaled frame, so no view outlives
+    // the texture a resize replaces.
+    Microsoft::WRL::ComPtr<ID3D12Resource> m_sceneColor;
+    DynamicResolution m_dynRes;
+    bool  m_dynResEnabled{ false };
+    float m_renderScale{ 1.0f };
+
+    // One shader-visible CBV/SRV/UAV heap shared by the scene and ImGui:
+    // persistent slots, then kTransientSrvsPerFrame per frame in flight.
+    static constexpr uint32_t kSrvDescriptors = 1024;
+    static constexpr uint32_t kTier1SrvDescriptors = 128; // SRV table limit on binding tier 1
+    static constexpr uint32_t kTransientSrvsPerFrame = 16;
+    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_srvHeap;
+    UINT m_srvDescriptorSize{ 0 };
+    D3D12_RESOURCE_BINDING_TIER m_resourceBindingTier{ D3D12_RESOURCE_BINDING_TIER_1 };
+    uint32_t m_overflowSrvIndex{ DescriptorAllocator::kInvalidIndex };
+    DescriptorAllocator m_descriptors;
 
     Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
     HANDLE  m_fenceEvent{ nullptr };
@@ -106,8 +255,62 @@ private:
     bool    m_firstFrame{ true };
 
     Microsoft::WRL::ComPtr<ID3D12RootSignature> m_rootSig;
-    Microsoft::WRL::ComPtr<ID3D12PipelineState> m_pso;
-    Microsoft::WRL::ComPtr<ID3D12PipelineState> m_psoLines;
+
+    // Ids used in draw sort keys (DrawList is API-neutral).
+    enum : uint32_t { kPipelineTriangles = 0, kPipelineLines = 1, kPipelineCount };
+
+    // Pipelines of m_pipelines by draw pipeline id and ColorPS permutation
+    // (the draw's material id), requested when first drawn with. Until one
+    // is built its draws use the default permutation of their pipeline id;
+    // the triangle one is built at startup, line draws are skipped until
+    // theirs is ready.
+    std::unordered_map<uint32_t, PipelineHandle> m_colorPipelines; // (pipeline << 16) | permutation
+    PipelineHandle m_fallbackPipelines[kPipelineCount]{ kNoPipeline, kNoPipeline };
+    PipelineHandle m_upscalePipeline{ kNoPipeline }; // full resolution until ready
+    enum : uint32_t { kMeshQuad = 0, kMeshGrid = 1 };
+
+    DrawList  m_drawList;
+    JobSystem m_jobs;
+
+    // File reads off the render thread. The shader binaries come from
+    // Assets.pack next to the executable when it has them (built with
+    // packtool), else from the loose files, requested as one batch at the
+    // start of Initialize and collected by CreatePipelineState, so they load
+    // while the device objects are created. ColorPS here is its default
+    // permutation; the other variants load in the background when first
+    // drawn with.
+    enum : uint32_t { kShaderColorVS, kShaderColorPS, kShaderUpscaleVS, kShaderUpscalePS, kShaderCount };
+    AsyncIO            m_io;
+    PackReader         m_assets;
+    const PackFormat::PackEntry* m_shaderEntries[kShaderCount]{};
+    AsyncIO::RequestId m_shaderReads[kShaderCount]{};
+    std::vector<uint8_t> m_shaderCode[kShaderCount]; // kept for pipelines requested later
+
+    // ColorPS variant binaries; usage is kept across runs in ShaderUsage.txt
+    // (shadervariants turns it into the list of variants to build). Declared
+    // after m_jobs, m_io and m_assets: its destructor waits for the loads
+    // still running on them.
+    ShaderVariantCache m_colorVariants{ ColorPermutation::Space(), ShaderVariantCache::RequestFn(
+        [this](uint32_t permutation, const std::string& variant) { RequestShaderVariant(permutation, variant); }) };
+
+    // Processed asset data (e.g. the checker texture's mip chain), keyed by
+    // its inputs, so warm starts skip the processing.
+    DerivedDataCache m_derivedData;
+
+    // Root signatures and pipeline states, deduplicated by description,
+    // built on m_jobs and persisted in a pipeline library (warm starts skip
+    // driver compiles).
+    DXPipelineCache m_pipelines;
+
+    // Editor scene: entities in m_world, mirrored into m_scene by the
+    // simulation; recording only reads the snapshot it acquired.
+    World       m_world;
+    Entity      m_gridEntity;
+    Entity      m_axisEntity;
+    Entity      m_quadEntity;
+    std::string m_sceneStatus; // result of the last scene save / load, for the UI
+    RenderScene m_scene;
+    std::shared_ptr<const RenderSnapshot> m_snapshot;
 
     Microsoft::WRL::ComPtr<ID3D12Resource> m_vertexBuffer;
     D3D12_VERTEX_BUFFER_VIEW m_vbView{};
@@ -118,13 +321,43 @@ private:
     UINT m_axisVertexCount{ 0 }; // number of vertices for axis lines
 
     Microsoft::WRL::ComPtr<ID3D12Resource>       m_cbUpload;
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_cbvHeap;
-    UINT     m_cbSize{ 0 };
+    static constexpr UINT kInitialCbSlots = 256; // per frame; doubled when a scene needs more
+    UINT     m_cbSize{ 0 }; // one aligned CbMvp slot
+    UINT     m_cbSlotsPerFrame{ 0 };
+    UINT     m_cbFailedSlots{ 0 }; // largest size whose growth failed; not retried
     uint8_t* m_cbMapped{ nullptr };
+    UINT     m_cbSlotCount{ 0 }; // slots written this frame
+    std::vector<DirectX::XMFLOAT4X4> m_slotWorld; // world matrix behind each slot, for the late rewrite
+    UINT UpscaleSlot() const noexcept { return m_cbSlotsPerFrame - 1; } // reserved, never a draw slot
 
     Microsoft::WRL::ComPtr<ID3D12Resource> m_tex;
+    uint32_t m_texSrvIndex{ DescriptorAllocator::kInvalidIndex };
 
     FrameTimer m_timer;
+    FixedStepScheduler m_sim;
+    DirectX::XMFLOAT3  m_camStepDelta{ 0.0f, 0.0f, 0.0f }; // camera movement of the last step
+    double m_fps{ 0.0 };
+    double m_fixedDelta{ 0.0 };
+    bool   m_externalCamera{ false };
+    int    m_uiCaptureOverride{ -1 };
+    float  m_lastSimDelta{ 0.0f };
+    bool   m_lastUiCapture{ false };
+    FrameCounters m_counters;
+
+    // On-demand redraw. ImGui needs a few frames after input for hover/click state to settle.
+    static constexpr uint32_t kRedrawSettleFrames = 3;
+    bool     m_continuousRedraw{ false };
+    float    m_idleRedrawHz{ 2.0f };
+    uint32_t m_redrawFrames{ kRedrawSettleFrames };
+
+    // Late latch (see SetLateLatchCallback); draws are still sorted with the snapshot camera.
+    std::function<void()> m_lateLatchCallback;
+    bool       m_lateLatch{ true };
+    uint64_t   m_earlySampleNs{ 0 };
+    uint64_t   m_lateSampleNs{ 0 };
+    FrameStats m_earlyToSubmit;
+    FrameStats m_lateToSubmit;
+    LatencyTracker m_latency;
     float m_time{ 0.0f };
 
     D3D12_VIEWPORT m_viewport{};
@@ -143,18 +376,11 @@ private:
     // Editor flags
     bool m_showGrid{ true }; // ImGui toggle: show/hide grid
     bool m_showAxis{ true }; // ImGui toggle: show/hide axis
+    bool m_showProfiler{ false }; // ImGui toggle: profiler timeline window
 
-    // Simple sampler type enum for UI (must match HLSL side).
-    enum class SamplerType
-    {
-        LinearWrap = 0,
-        PointWrap = 1,
-        LinearClamp = 2,
-        PointClamp = 3
-    };
-
-    // Current sampler selection shown in ImGui.
-    SamplerType m_samplerType = SamplerType::LinearWrap;
+    // Quad material (ColorPS permutation) selected in ImGui.
+    ColorPermutation::Sampler m_samplerType = ColorPermutation::Sampler::LinearWrap;
+    bool m_vertexColorBlend{ true };
 
 
     
@@ -175,4 +401,5 @@ private:
     float m_mouseDeltaX{ 0.0f };
     float m_mouseDeltaY{ 0.0f };
     float m_wheelTicks{ 0.0f };
+    bool  m_focusRequested{ false }; // F pressed since the last camera update
 };
@@ -0,0 +1,323 @@
+#include "DerivedDataCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <system_error>
+
+#include "Hash.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr uint32_t kEntryMagic = 0x31434444u; // "DDC1"
+    constexpr uint32_t kEntryVersion = 1;
+    constexpr uint64_t kSecondSeed = 0x9E3779B97F4A7C15ull;
+    constexpr const char* kEntryExtension = ".ddc";
+
+    // Leftovers of writers that died between write and rename.
+    constexpr auto kStaleTempAge = std::chrono::minutes(10);
+
+    struct EntryHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t size;            // payload bytes
+        uint64_t contentHash;     // Hash64 of the payload
+        uint64_t keyLo;
+        uint64_t keyHi;
+    };
+    static_assert(sizeof(EntryHeader) == 40, "EntryHeader layout");
+
+    std::FILE* OpenFile(const fs::path& path, const char* mode)
+    {
+#if defined(_WIN32)
+        wchar_t wmode[8] = {};
+        for (size_t i = 0; mode[i] && i < 7; ++i) wmode[i] = wchar_t(mode[i]);
+        std::FILE* f = nullptr;
+        return (_wfopen_s(&f, path.c_str(), wmode) == 0) ? f : nullptr;
+#else
+        return std::fopen(path.c_str(), mode);
+#endif
+    }
+
+    bool ParseKey(const std::string& name, DerivedDataCache::Key& key)
+    {
+        if (name.size() != 32 || name.find_first_not_of("0123456789abcdef") != std::string::npos) return false;
+        key.hi = std::strtoull(name.substr(0, 16).c_str(), nullptr, 16);
+        key.lo = std::strtoull(name.substr(16).c_str(), nullptr, 16);
+        return true;
+    }
+}
+
+// ====================================================
+// Keys
+// ====================================================
+std::string DerivedDataCache::Key::ToString() const
+{
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016" PRIx64 "%016" PRIx64, hi, lo);
+    return text;
+}
+
+DerivedDataCache::KeyBuilder::KeyBuilder(std::string_view tool, uint32_t toolVersion)
+{
+    AddString(tool);
+    AddValue(toolVersion);
+}
+
+DerivedDataCache::KeyBuilder& DerivedDataCache::KeyBuilder::Add(const void* data, size_t size)
+{
+    const uint64_t digest[3] = { uint64_t(size), Hash64(data, size), Hash64(data, size, kSecondSeed) };
+    m_bytes.append(reinterpret_cast<const char*>(digest), sizeof(digest));
+    return *this;
+}
+
+DerivedDataCache::KeyBuilder& DerivedDataCache::KeyBuilder::AddString(std::string_view text)
+{
+    AddValue(uint64_t(text.size())); // length prefix: ("ab","c") != ("a","bc")
+    m_bytes.append(text.data(), text.size());
+    return *this;
+}
+
+DerivedDataCache::Key DerivedDataCache::KeyBuilder::Finish() const noexcept
+{
+    Key key;
+    key.lo = Hash64(m_bytes.data(), m_bytes.size());
+    key.hi = Hash64(m_bytes.data(), m_bytes.size(), kSecondSeed);
+    return key;
+}
+
+// ====================================================
+// Cache
+// ====================================================
+bool DerivedDataCache::Open(const fs::path& root, uint64_t maxBytes)
+{
+    std::error_code ec;
+    fs::create_directories(root, ec);
+    if (!fs::is_directory(root, ec)) return false;
+
+    // Index what previous runs (or other processes) left, oldest use first.
+    struct Found { Key key; uint64_t size; fs::file_time_type time; };
+    std::vector<Found> found;
+    const auto now = fs::file_time_type::clock::now();
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec))
+    {
+        if (!it->is_regular_file(ec)) continue;
+        const fs::path& path = it->path();
+        const fs::file_time_type time = it->last_write_time(ec);
+        if (path.extension() == ".tmp")
+        {
+            if (now - time > kStaleTempAge) fs::remove(path, ec);
+            continue;
+        }
+        Key key;
+        if (path.extension() != kEntryExtension || !ParseKey(path.stem().string(), key)) continue;
+        found.push_back({ key, uint64_t(it->file_size(ec)), time });
+    }
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.time < b.time; });
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_root = root;
+        m_maxBytes = maxBytes;
+        m_writerTag = (uint64_t(std::random_device{}()) << 32) ^ std::random_device{}() ^ uint64_t(uintptr_t(this));
+        m_entries.clear();
+        m_totalBytes = 0;
+        m_clock = 0;
+        for (const Found& f : found) Touch(f.key, f.size);
+    }
+    Trim(maxBytes);
+    return true;
+}
+
+fs::path DerivedDataCache::PathOf(const Key& key) const
+{
+    const std::string name = key.ToString();
+    return m_root / name.substr(0, 2) / (name + kEntryExtension); // 256-way fan-out
+}
+
+// Under m_mutex.
+void DerivedDataCache::Touch(const Key& key, uint64_t size)
+{
+    Entry& e = m_entries[key];
+    m_totalBytes += size - e.size;
+    e.size = size;
+    e.lastUse = ++m_clock;
+}
+
+// Under m_mutex.
+void DerivedDataCache::Forget(const Key& key)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return;
+    m_totalBytes -= it->second.size;
+    m_entries.erase(it);
+}
+
+bool DerivedDataCache::Get(const Key& key, std::vector<uint8_t>& data)
+{
+    if (!IsOpen())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.misses;
+        return false;
+    }
+
+    // Always look on disk: another process may have added the entry.
+    const fs::path path = PathOf(key);
+    std::FILE* f = OpenFile(path, "rb");
+    if (!f)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Forget(key); // evicted by another process
+        ++m_stats.misses;
+        return false;
+    }
+
+    EntryHeader h{};
+    bool ok = std::fread(&h, sizeof(h), 1, f) == 1 && h.magic == kEntryMagic && h.version == kEntryVersion &&
+              h.keyLo == key.lo && h.keyHi == key.hi;
+    if (ok)
+    {
+        data.resize(size_t(h.size));
+        ok = std::fread(data.data(), 1, data.size(), f) == data.size() && std::fgetc(f) == EOF &&
+             Hash64(data.data(), data.size()) == h.contentHash;
+    }
+    std::fclose(f);
+
+    std::error_code ec;
+    if (!ok)
+    {
+        data.clear();
+        fs::remove(path, ec);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Forget(key);
+        ++m_stats.corrupt;
+        ++m_stats.misses;
+        return false;
+    }
+
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec); // recency for the next run's index
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Touch(key, sizeof(h) + h.size);
+    ++m_stats.hits;
+    m_stats.bytesRead += h.size;
+    return true;
+}
+
+bool DerivedDataCache::Put(const Key& key, const void* data, size_t size)
+{
+    if (!IsOpen()) return false;
+
+    const fs::path path = PathOf(key);
+    fs::path tmp = path;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        char suffix[48];
+        std::snprintf(suffix, sizeof(suffix), ".%016" PRIx64 "-%" PRIu64 ".tmp", m_writerTag, ++m_tempCounter);
+        tmp += suffix;
+    }
+
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+
+    EntryHeader h{};
+    h.magic = kEntryMagic;
+    h.version = kEntryVersion;
+    h.size = size;
+    h.contentHash = Hash64(data, size);
+    h.keyLo = key.lo;
+    h.keyHi = key.hi;
+
+    std::FILE* f = OpenFile(tmp, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 && (size == 0 || std::fwrite(data, 1, size, f) == size);
+    ok = (std::fclose(f) == 0) && ok;
+    if (ok) fs::rename(tmp, path, ec); // atomic replace; readers see the old file or the new one
+    if (!ok || ec)
+    {
+        fs::remove(tmp, ec);
+        // Losing the rename to another writer is fine: same key, same bytes.
+        if (!fs::exists(path, ec)) return false;
+    }
+
+    bool overBudget = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Touch(key, sizeof(h) + size);
+        ++m_stats.writes;
+        m_stats.bytesWritten += size;
+        overBudget = m_totalBytes > m_maxBytes;
+    }
+    if (overBudget) Trim(m_maxBytes - m_maxBytes / 10); // some headroom, so not every Put trims
+    return true;
+}
+
+bool DerivedDataCache::GetOrBuild(const Key& key, std::vector<uint8_t>& data, const BuildFn& build)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_buildCv.wait(lock, [&] { return m_building.count(key) == 0; });
+        m_building.insert(key);
+    }
+
+    bool ok = Get(key, data);
+    if (!ok)
+    {
+        data.clear();
+        ok = build(data);
+        if (ok) Put(key, data.data(), data.size());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_building.erase(key);
+    }
+    m_buildCv.notify_all();
+    return ok;
+}
+
+void DerivedDataCache::Trim(uint64_t maxBytes)
+{
+    std::vector<fs::path> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_totalBytes <= maxBytes) return;
+
+        std::vector<std::pair<uint64_t, Key>> byAge;
+        byAge.reserve(m_entries.size());
+        for (const auto& [key, entry] : m_entries) byAge.emplace_back(entry.lastUse, key);
+        std::sort(byAge.begin(), byAge.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        for (const auto& [lastUse, key] : byAge)
+        {
+            if (m_totalBytes <= maxBytes) break;
+            victims.push_back(PathOf(key));
+            Forget(key);
+            ++m_stats.evictions;
+        }
+    }
+    std::error_code ec;
+    for (const fs::path& path : victims) fs::remove(path, ec); // may already be gone (other process)
+}
+
+uint64_t DerivedDataCache::SizeBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_totalBytes;
+}
+
+size_t DerivedDataCache::EntryCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+DerivedDataCache::Stats DerivedDataCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
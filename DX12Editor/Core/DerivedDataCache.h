@@ -0,0 +1,119 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Content-addressed cache of derived data (processed meshes, mip chains,
+// compressed textures, ...) on local disk. An entry's key hashes everything
+// its bytes depend on - source bytes, processing parameters, tool name and
+// version - so a lookup either returns exactly what the tool would produce
+// or misses; nothing is ever invalidated, stale entries just stop being
+// asked for and age out.
+//
+// Size-bounded with least-recently-used eviction; the recency of an entry is
+// its file's modification time, refreshed on every hit, so it survives
+// restarts. Safe to use from several threads and several processes on one
+// directory: entries are written to a temporary file and renamed into place,
+// readers check a content hash and treat anything torn or corrupt as a miss.
+class DerivedDataCache {
+public:
+    struct Key {
+        uint64_t lo{ 0 };
+        uint64_t hi{ 0 };
+
+        bool operator==(const Key& o) const noexcept { return lo == o.lo && hi == o.hi; }
+        std::string ToString() const; // 32 hex digits, the file name
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const noexcept { return size_t(k.lo ^ (k.hi * 0x9E3779B97F4A7C15ull)); }
+    };
+
+    // Accumulates what an entry depends on. Large inputs (source files) are
+    // reduced to their 128-bit hash on Add; small ones (parameters) are
+    // taken as is.
+    class KeyBuilder {
+    public:
+        KeyBuilder(std::string_view tool, uint32_t toolVersion);
+
+        KeyBuilder& Add(const void* data, size_t size);
+        KeyBuilder& AddString(std::string_view text);
+        template <typename T>
+        KeyBuilder& AddValue(const T& value) // plain data without padding
+        {
+            m_bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+            return *this;
+        }
+
+        Key Finish() const noexcept;
+
+    private:
+        std::string m_bytes;
+    };
+
+    struct Stats {
+        uint64_t hits{ 0 };
+        uint64_t misses{ 0 };
+        uint64_t writes{ 0 };
+        uint64_t evictions{ 0 };
+        uint64_t corrupt{ 0 };     // entries found damaged and dropped
+        uint64_t bytesRead{ 0 };
+        uint64_t bytesWritten{ 0 };
+    };
+
+    using BuildFn = std::function<bool(std::vector<uint8_t>& out)>;
+
+    DerivedDataCache() noexcept = default;
+    DerivedDataCache(const DerivedDataCache&) = delete;
+    DerivedDataCache& operator=(const DerivedDataCache&) = delete;
+
+    // Uses (creates) 'root' and indexes what is there. Without a successful
+    // Open every lookup misses and nothing is stored.
+    bool Open(const std::filesystem::path& root, uint64_t maxBytes);
+    bool IsOpen() const noexcept { return !m_root.empty(); }
+
+    bool Get(const Key& key, std::vector<uint8_t>& data);
+    bool Put(const Key& key, const void* data, size_t size);
+
+    // Get, or run 'build' and Put its output. Concurrent calls for one key
+    // in this process build once; the others wait and read the result.
+    bool GetOrBuild(const Key& key, std::vector<uint8_t>& data, const BuildFn& build);
+
+    // Evicts least recently used entries until at most 'maxBytes' remain.
+    void Trim(uint64_t maxBytes);
+
+    uint64_t SizeBytes() const;
+    size_t   EntryCount() const;
+    Stats    GetStats() const;
+
+private:
+    struct Entry {
+        uint64_t size{ 0 };        // file bytes
+        uint64_t lastUse{ 0 };     // m_clock tick
+    };
+
+    std::filesystem::path PathOf(const Key& key) const;
+    void Touch(const Key& key, uint64_t size);
+    void Forget(const Key& key);
+
+private:
+    std::filesystem::path m_root;
+    uint64_t m_maxBytes{ 0 };
+    uint64_t m_writerTag{ 0 };     // makes temporary file names unique per cache instance
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_buildCv;
+    std::unordered_map<Key, Entry, KeyHash> m_entries;
+    std::unordered_set<Key, KeyHash> m_building;
+    uint64_t m_totalBytes{ 0 };
+    uint64_t m_clock{ 0 };
+    uint64_t m_tempCounter{ 0 };
+    Stats    m_stats;
+};
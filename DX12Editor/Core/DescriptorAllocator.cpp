@@ -0,0 +1,96 @@
+#include "DescriptorAllocator.h"
+
+bool DescriptorAllocator::Initialize(uint32_t persistentCount, uint32_t transientPerFrame, uint32_t frameCount) noexcept
+{
+    if (persistentCount == 0 || frameCount == 0 ||
+        uint64_t(persistentCount) + uint64_t(transientPerFrame) * frameCount >= kInvalidIndex)
+        return false;
+
+    m_next.reset(new (std::nothrow) std::atomic<uint32_t>[persistentCount]);
+    m_allocated.reset(new (std::nothrow) std::atomic<uint8_t>[persistentCount]);
+    if (!m_next || !m_allocated)
+        return false;
+    m_persistentCount = persistentCount;
+
+    // Chain every slot: 0 -> 1 -> ... -> N-1 -> invalid
+    for (uint32_t i = 0; i < persistentCount; ++i)
+    {
+        m_next[i].store(i + 1 < persistentCount ? i + 1 : kInvalidIndex, std::memory_order_relaxed);
+        m_allocated[i].store(0, std::memory_order_relaxed);
+    }
+
+    m_head.store(Pack(0, 0), std::memory_order_release);
+    m_inUse.store(0, std::memory_order_relaxed);
+    m_rejectedFrees.store(0, std::memory_order_relaxed);
+
+    m_transientPerFrame = transientPerFrame;
+    m_frameCount = frameCount;
+    m_transientBase = persistentCount;
+    m_transientOffset.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+uint32_t DescriptorAllocator::Allocate() noexcept
+{
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    for (;;)
+    {
+        const uint32_t index = uint32_t(head);
+        if (index == kInvalidIndex)
+            return kInvalidIndex; // heap exhausted
+
+        const uint32_t next = m_next[index].load(std::memory_order_relaxed);
+        const uint64_t newHead = Pack(uint32_t(head >> 32) + 1, next);
+
+        // The tag bump makes a stale 'next' (popped and pushed back meanwhile) fail the CAS.
+        if (m_head.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            m_allocated[index].store(1, std::memory_order_relaxed);
+            m_inUse.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+    }
+}
+
+bool DescriptorAllocator::Free(uint32_t index) noexcept
+{
+    // Only the caller that flips the flag 1 -> 0 may push the slot back.
+    if (index >= m_persistentCount || m_allocated[index].exchange(0, std::memory_order_relaxed) == 0)
+    {
+        m_rejectedFrees.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        m_next[index].store(uint32_t(head), std::memory_order_relaxed);
+        const uint64_t newHead = Pack(uint32_t(head >> 32) + 1, index);
+        if (m_head.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed))
+            break;
+    }
+    m_inUse.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void DescriptorAllocator::BeginFrame(uint32_t frameSlot) noexcept
+{
+    m_transientBase = m_persistentCount + (frameSlot % m_frameCount) * m_transientPerFrame;
+    m_transientOffset.store(0, std::memory_order_relaxed);
+}
+
+uint32_t DescriptorAllocator::AllocateTransient(uint32_t count) noexcept
+{
+    if (count == 0 || count > m_transientPerFrame)
+        return kInvalidIndex;
+    const uint32_t offset = m_transientOffset.fetch_add(count, std::memory_order_relaxed);
+    if (offset > m_transientPerFrame - count)
+        return kInvalidIndex; // this frame's region is full
+    return m_transientBase + offset;
+}
+
+uint32_t DescriptorAllocator::TransientInUse() const noexcept
+{
+    const uint32_t offset = m_transientOffset.load(std::memory_order_relaxed);
+    return offset < m_transientPerFrame ? offset : m_transientPerFrame;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Index allocator for one global shader-visible descriptor heap.
+// Has no D3D dependency, so it can be exercised without a device.
+//
+// Heap layout:
+//   [0, persistentCount)                        persistent descriptors (lock-free free list)
+//   [persistentCount, + transientPerFrame * F)  transient descriptors, one linear region
+//                                               per frame in flight
+//
+// Indices returned here are the "bindless" indices the shaders use directly.
+class DescriptorAllocator {
+public:
+    static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    DescriptorAllocator() noexcept = default;
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    bool Initialize(uint32_t persistentCount, uint32_t transientPerFrame = 0, uint32_t frameCount = 1) noexcept;
+
+    // Persistent descriptors. Safe to call from any thread. Allocate returns kInvalidIndex when the
+    // heap is exhausted; Free rejects (returns false for) out-of-range indices
+    // and slots that are not currently allocated, so a double free cannot
+    // hand the same descriptor out twice.
+    uint32_t Allocate() noexcept;
+    bool     Free(uint32_t index) noexcept;
+
+    // Transient descriptors (views rewritten every frame): valid until the
+    // same frame slot is begun again, which the caller does only after that
+    // frame's fence. AllocateTransient returns the first of 'count'
+    // contiguous indices, kInvalidIndex when the frame's region is full;
+    // it may be called from any thread between BeginFrame calls.
+    void     BeginFrame(uint32_t frameSlot) noexcept;
+    uint32_t AllocateTransient(uint32_t count = 1) noexcept;
+
+    uint32_t Capacity()          const noexcept { return m_persistentCount + m_transientPerFrame * m_frameCount; }
+    uint32_t PersistentCount()   const noexcept { return m_persistentCount; }
+    uint32_t TransientPerFrame() const noexcept { return m_transientPerFrame; }
+    uint32_t InUse()             const noexcept { return m_inUse.load(std::memory_order_relaxed); }
+    uint32_t TransientInUse()    const noexcept;
+    uint32_t RejectedFrees()     const noexcept { return m_rejectedFrees.load(std::memory_order_relaxed); }
+
+private:
+    // Head of the free list: high 32 bits = ABA tag, low 32 bits = index.
+    static uint64_t Pack(uint32_t tag, uint32_t index) noexcept { return (uint64_t(tag) << 32) | index; }
+
+private:
+    uint32_t m_persistentCount{ 0 };
+    uint32_t m_transientPerFrame{ 0 };
+    uint32_t m_frameCount{ 1 };
+
+    std::unique_ptr<std::atomic<uint32_t>[]> m_next;      // free-list links, one per slot
+    std::unique_ptr<std::atomic<uint8_t>[]>  m_allocated; // 1 while the slot is handed out
+    std::atomic<uint64_t> m_head{ Pack(0, kInvalidIndex) };
+    std::atomic<uint32_t> m_inUse{ 0 };
+    std::atomic<uint32_t> m_rejectedFrees{ 0 };
+
+    uint32_t              m_transientBase{ 0 };   // first index of the current frame's region
+    std::atomic<uint32_t> m_transientOffset{ 0 }; // bump pointer inside it (may run past the end)
+};
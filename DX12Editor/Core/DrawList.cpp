@@ -0,0 +1,52 @@
+#include "DrawList.h"
+#include "RadixSort.h"
+#include <algorithm>
+#include <chrono>
+
+uint32_t DrawKey::QuantizeDepth(float viewDepth, float nearZ, float farZ) noexcept
+{
+    if (farZ <= nearZ) return 0;
+    float t = (viewDepth - nearZ) / (farZ - nearZ);
+    t = std::clamp(t, 0.0f, 1.0f);
+    return uint32_t(t * float(0xFFFFFF));
+}
+
+void DrawList::Sort(JobSystem* jobs)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+
+    const size_t n = m_items.size();
+    m_keys.resize(n);
+    m_tmpKeys.resize(n);
+    m_order.resize(n);
+    m_tmpOrder.resize(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        m_keys[i] = m_items[i].sortKey;
+        m_order[i] = uint32_t(i);
+    }
+
+    RadixSort64(m_keys.data(), m_order.data(), m_tmpKeys.data(), m_tmpOrder.data(), n, jobs);
+
+    const auto t1 = std::chrono::steady_clock::now();
+
+    // Count the state changes the sorted order will cause (first draw sets everything).
+    Stats s{};
+    s.draws = uint32_t(n);
+    s.sortMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    for (size_t i = 0; i < n; ++i)
+    {
+        const DrawItem& cur = m_items[m_order[i]];
+        if (i == 0)
+        {
+            s.pipelineChanges = s.meshChanges = s.materialChanges = 1;
+            continue;
+        }
+        const DrawItem& prev = m_items[m_order[i - 1]];
+        if (cur.pipeline != prev.pipeline) ++s.pipelineChanges;
+        if (cur.mesh != prev.mesh)         ++s.meshChanges;
+        if (cur.material != prev.material) ++s.materialChanges;
+    }
+    m_stats = s;
+}
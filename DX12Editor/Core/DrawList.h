@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// Packed 64-bit draw sort key. Most significant field first, so sorting the
+// keys groups draws by pass, then pipeline, then material, then mesh.
+//
+//   63..60  pass      (4 bits)
+//   59..52  pipeline  (8 bits)
+//   51..40  material  (12 bits, sampler/texture selection)
+//   39..24  mesh      (16 bits, vertex buffer)
+//   23..0   depth     (24 bits, quantized view depth)
+struct DrawKey {
+    // Lines first: the grid was drawn before the opaque geometry when the
+    // order was hard-coded, and the quad's depth test relies on that where
+    // the two are coplanar.
+    enum class Pass : uint32_t { Lines = 0, Opaque = 1, Transparent = 2 };
+
+    static uint64_t Make(Pass pass, uint32_t pipeline, uint32_t material, uint32_t mesh, uint32_t depth) noexcept
+    {
+        return (uint64_t(uint32_t(pass) & 0xF) << 60) |
+            (uint64_t(pipeline & 0xFF) << 52) |
+            (uint64_t(material & 0xFFF) << 40) |
+            (uint64_t(mesh & 0xFFFF) << 24) |
+            uint64_t(depth & 0xFFFFFF);
+    }
+
+    // Maps view depth in [nearZ, farZ] to 24 bits (front to back).
+    static uint32_t QuantizeDepth(float viewDepth, float nearZ, float farZ) noexcept;
+
+    static uint32_t PipelineOf(uint64_t key) noexcept { return uint32_t(key >> 52) & 0xFF; }
+    static uint32_t MaterialOf(uint64_t key) noexcept { return uint32_t(key >> 40) & 0xFFF; }
+    static uint32_t MeshOf(uint64_t key)     noexcept { return uint32_t(key >> 24) & 0xFFFF; }
+};
+
+// One draw in API-neutral form; the renderer maps the ids to its own objects.
+struct DrawItem {
+    uint64_t sortKey{ 0 };
+    uint32_t pipeline{ 0 };
+    uint32_t mesh{ 0 };
+    uint32_t material{ 0 };
+    uint32_t firstVertex{ 0 };
+    uint32_t vertexCount{ 0 };
+    uint32_t constantSlot{ 0 }; // per-draw constant buffer slot
+};
+
+// Per-frame draw collection: Add() in any order, Sort(), then walk Sorted().
+class DrawList {
+public:
+    struct Stats {
+        uint32_t draws{ 0 };
+        uint32_t pipelineChanges{ 0 };
+        uint32_t meshChanges{ 0 };
+        uint32_t materialChanges{ 0 };
+        double   sortMs{ 0.0 };
+    };
+
+    void Clear() noexcept { m_items.clear(); m_order.clear(); }
+    void Add(const DrawItem& item) { m_items.push_back(item); }
+
+    // Orders draws by key and fills Stats with the resulting state-change counts.
+    void Sort(JobSystem* jobs = nullptr);
+
+    size_t Size() const noexcept { return m_items.size(); }
+    const DrawItem& Sorted(size_t i) const noexcept { return m_items[m_order[i]]; }
+    const Stats& GetStats() const noexcept { return m_stats; }
+
+private:
+    std::vector<DrawItem> m_items;
+    std::vector<uint32_t> m_order;
+
+    // Scratch kept between frames to avoid reallocations.
+    std::vector<uint64_t> m_keys, m_tmpKeys;
+    std::vector<uint32_t> m_tmpOrder;
+
+    Stats m_stats;
+};
@@ -0,0 +1,72 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+
+void DynamicResolution::SetConfig(const Config& config) noexcept
+{
+    m_config = config;
+    if (!(m_config.targetMs > 0.0)) m_config.targetMs = 16.0;
+    m_config.maxScale = std::clamp(m_config.maxScale, 0.1f, 1.0f);
+    m_config.minScale = std::clamp(m_config.minScale, 0.1f, m_config.maxScale);
+    m_config.smoothing = std::clamp(m_config.smoothing, 0.01, 1.0);
+    m_config.headroom = std::clamp(m_config.headroom, 0.0, 0.9);
+    m_scale = std::clamp(m_scale, m_config.minScale, m_config.maxScale);
+}
+
+float DynamicResolution::Update(double frameMs) noexcept
+{
+    if (!(frameMs > 0.0)) return m_scale;
+
+    m_recentMs[m_recentCount++ % 3] = frameMs;
+    double sample = frameMs;
+    if (m_recentCount >= 3)
+    {
+        const double a = m_recentMs[0], b = m_recentMs[1], c = m_recentMs[2];
+        sample = (std::max)((std::min)(a, b), (std::min)((std::max)(a, b), c)); // median
+    }
+
+    m_filteredMs = (m_recentCount > 1)
+        ? m_filteredMs + m_config.smoothing * (sample - m_filteredMs)
+        : sample;
+
+    // Relative error: > 0 = time to spare, < 0 = over budget.
+    double error = (m_config.targetMs - m_filteredMs) / m_config.targetMs;
+
+    // Hysteresis band [target * (1 - headroom), target * (1 - margin)]: hold
+    // the scale and drop the history, so leaving the band starts from a clean
+    // slate. The margin keeps the settled cost under the budget: steering to
+    // the budget itself leaves every other noisy frame over it.
+    const double margin = m_config.headroom * 0.25;
+    if (error >= margin && error <= m_config.headroom)
+    {
+        m_error1 = m_error2 = 0.0;
+        return m_scale;
+    }
+    // Outside the band, steer toward its nearer edge.
+    error -= (error > m_config.headroom) ? m_config.headroom : margin;
+
+    // Incremental (velocity) PID: the output is a scale delta, so clamping
+    // the scale is all the anti-windup it needs.
+    double delta = m_config.kp * (error - m_error1)
+                 + m_config.ki * error
+                 + m_config.kd * (error - 2.0 * m_error1 + m_error2);
+    m_error2 = m_error1;
+    m_error1 = error;
+
+    delta = std::clamp(delta, -double(m_config.maxStep), double(m_config.maxStep));
+    const float next = std::clamp(m_scale + float(delta), m_config.minScale, m_config.maxScale);
+    if (next != m_scale)
+    {
+        m_scale = next;
+        ++m_adjustments;
+    }
+    return m_scale;
+}
+
+void DynamicResolution::Reset() noexcept
+{
+    m_scale = m_config.maxScale;
+    m_recentCount = 0;
+    m_filteredMs = 0.0;
+    m_error1 = m_error2 = 0.0;
+    m_adjustments = 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+
+// Dynamic resolution: picks the internal render scale (applied to both axes)
+// from measured frame cost so that frames stay inside a time budget.
+//
+// Each frame feeds the cost of the frame just rendered. The cost is smoothed
+// (median of the last three frames, so a lone hitch is ignored, then an EMA),
+// compared with the budget as a relative error and fed to an incremental PID
+// whose output moves the scale. Hysteresis: the scale holds while the cost is
+// between targetMs * (1 - headroom) and a small margin under the budget, only
+// drops above that and only rises below it, so a frame sitting near the budget
+// does not flip-flop between sizes and noisy frames settle under the budget.
+//
+// No D3D dependency: feed synthetic frame-time traces to test it.
+class DynamicResolution {
+public:
+    struct Config {
+        double targetMs{ 16.0 };     // frame budget
+        float  minScale{ 0.5f };
+        float  maxScale{ 1.0f };
+        double headroom{ 0.10 };     // rise only below targetMs * (1 - headroom)
+        double smoothing{ 0.25 };    // EMA weight of the newest frame
+        double kp{ 0.10 };           // per unit of relative error change
+        double ki{ 0.04 };           // per unit of relative error, per frame
+        double kd{ 0.0 };
+        float  maxStep{ 0.05f };     // largest scale change per frame
+    };
+
+    DynamicResolution() noexcept { SetConfig(Config{}); }
+
+    void SetConfig(const Config& config) noexcept;
+    const Config& GetConfig() const noexcept { return m_config; }
+
+    // Cost of the frame rendered at Scale(), returns the scale for the next one.
+    float Update(double frameMs) noexcept;
+
+    float  Scale() const noexcept { return m_scale; }
+    double FilteredMs() const noexcept { return m_filteredMs; }
+
+    // Scale changes so far (for judging stability on a trace).
+    uint64_t Adjustments() const noexcept { return m_adjustments; }
+
+    // Back to full scale, forget history (resize, scene switch).
+    void Reset() noexcept;
+
+private:
+    Config   m_config;
+    float    m_scale{ 1.0f };
+    double   m_recentMs[3]{};
+    uint32_t m_recentCount{ 0 };
+    double   m_filteredMs{ 0.0 };
+    double   m_error1{ 0.0 }; // error of the previous update
+    double   m_error2{ 0.0 }; // and the one before
+    uint64_t m_adjustments{ 0 };
+};
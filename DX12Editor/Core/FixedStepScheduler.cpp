@@ -0,0 +1,44 @@
+#include "FixedStepScheduler.h"
+#include <cmath>
+
+void FixedStepScheduler::SetConfig(const Config& config) noexcept
+{
+    m_config = config;
+    if (!(m_config.hz > 0.0)) m_config.hz = 120.0;
+    if (m_config.maxCatchUpSteps == 0) m_config.maxCatchUpSteps = 1;
+
+    m_stepNs = uint64_t(std::llround(1e9 / m_config.hz));
+    if (m_stepNs == 0) m_stepNs = 1;
+    if (m_accumulatorNs >= m_stepNs) m_accumulatorNs %= m_stepNs;
+}
+
+uint32_t FixedStepScheduler::AdvanceNs(uint64_t elapsedNs) noexcept
+{
+    m_accumulatorNs += elapsedNs;
+
+    uint64_t steps = m_accumulatorNs / m_stepNs;
+    m_accumulatorNs -= steps * m_stepNs;
+
+    if (steps > m_config.maxCatchUpSteps)
+    {
+        // Too far behind (breakpoint, hitch): run the allowed steps and let
+        // the simulation fall behind real time instead of stalling frames.
+        m_droppedNs += (steps - m_config.maxCatchUpSteps) * m_stepNs;
+        steps = m_config.maxCatchUpSteps;
+    }
+
+    m_totalSteps += steps;
+    return uint32_t(steps);
+}
+
+uint32_t FixedStepScheduler::Advance(double elapsedSec) noexcept
+{
+    return AdvanceNs(elapsedSec > 0.0 ? uint64_t(std::llround(elapsedSec * 1e9)) : uint64_t(0));
+}
+
+void FixedStepScheduler::Reset() noexcept
+{
+    m_accumulatorNs = 0;
+    m_totalSteps = 0;
+    m_droppedNs = 0;
+}
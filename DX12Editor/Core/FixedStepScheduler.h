@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+// Fixed-timestep simulation clock. Each rendered frame feeds the elapsed
+// time; the scheduler answers how many whole simulation steps to run and how
+// far into the next step the frame is (Alpha, for interpolating what is drawn).
+//
+// Time is accumulated in integer nanoseconds, so the same sequence of frame
+// deltas (a fake clock, a fixed --bench dt, a replayed session) always gives
+// the same sequence of step counts on every machine.
+class FixedStepScheduler {
+public:
+    struct Config {
+        double   hz{ 120.0 };            // simulation rate
+        uint32_t maxCatchUpSteps{ 8 };   // per frame; time beyond that is dropped (spiral of death guard)
+    };
+
+    FixedStepScheduler() noexcept { SetConfig(Config{}); }
+
+    void SetConfig(const Config& config) noexcept;
+    const Config& GetConfig() const noexcept { return m_config; }
+
+    // Adds one frame of elapsed time, returns the number of steps to run now.
+    uint32_t AdvanceNs(uint64_t elapsedNs) noexcept;
+    uint32_t Advance(double elapsedSec) noexcept;
+
+    // Time left over after the steps, as a fraction of a step in [0, 1).
+    float Alpha() const noexcept { return float(double(m_accumulatorNs) / double(m_stepNs)); }
+
+    double   StepSeconds() const noexcept { return double(m_stepNs) / 1e9; }
+    uint64_t StepNs() const noexcept { return m_stepNs; }
+    uint64_t TotalSteps() const noexcept { return m_totalSteps; }
+    uint64_t DroppedNs() const noexcept { return m_droppedNs; }   // discarded by the catch-up limit
+
+    void Reset() noexcept;
+
+private:
+    Config   m_config;
+    uint64_t m_stepNs{ 0 };
+    uint64_t m_accumulatorNs{ 0 };
+    uint64_t m_totalSteps{ 0 };
+    uint64_t m_droppedNs{ 0 };
+};
@@ -0,0 +1,117 @@
+#include "FramePacer.h"
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#define FRAME_PACER_PAUSE() _mm_pause()
+#else
+#define FRAME_PACER_PAUSE() std::this_thread::yield()
+#endif
+
+namespace {
+    constexpr double kSliceMs = 1.0;
+}
+
+FramePacer::FramePacer() noexcept
+{
+#ifdef _WIN32
+    // Sub-millisecond sleeps without raising the global timer resolution (Win10 1803+).
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+}
+
+FramePacer::~FramePacer() noexcept
+{
+#ifdef _WIN32
+    if (m_timer) CloseHandle(static_cast<HANDLE>(m_timer));
+#endif
+}
+
+void FramePacer::SetConfig(const Config& config) noexcept
+{
+    m_config = config;
+    if (!(m_config.targetFps > 1.0)) m_config.targetFps = 1.0;
+    m_hasDeadline = false; // restart the cadence
+}
+
+void FramePacer::SleepSlice() noexcept
+{
+#ifdef _WIN32
+    if (m_timer)
+    {
+        LARGE_INTEGER due;
+        due.QuadPart = -LONGLONG(kSliceMs * 10000.0); // relative, 100 ns units
+        if (SetWaitableTimerEx(static_cast<HANDLE>(m_timer), &due, 0, nullptr, nullptr, nullptr, 0))
+        {
+            WaitForSingleObject(static_cast<HANDLE>(m_timer), INFINITE);
+            return;
+        }
+    }
+#endif
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(kSliceMs));
+}
+
+void FramePacer::SleepUntil(Clock::time_point deadline) noexcept
+{
+    using Ms = std::chrono::duration<double, std::milli>;
+
+    Clock::time_point now = Clock::now();
+    while (Ms(deadline - now).count() > m_estimateMs)
+    {
+        SleepSlice();
+        const Clock::time_point after = Clock::now();
+        const double observed = Ms(after - now).count();
+        now = after;
+
+        // Estimate = mean + 1 stddev of what a slice really takes.
+        ++m_sleepCount;
+        const double delta = observed - m_meanMs;
+        m_meanMs += delta / double(m_sleepCount);
+        m_m2 += delta * (observed - m_meanMs);
+        m_estimateMs = m_meanMs + std::sqrt(m_m2 / double(m_sleepCount - 1));
+    }
+
+    while (Clock::now() < deadline)
+        FRAME_PACER_PAUSE();
+}
+
+void FramePacer::WaitForNextFrame() noexcept
+{
+    if (m_config.mode != Mode::TargetFps)
+    {
+        m_hasDeadline = false;
+        return;
+    }
+
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / m_config.targetFps));
+    const Clock::time_point now = Clock::now();
+
+    if (!m_hasDeadline)
+    {
+        m_deadline = now + period;
+        m_hasDeadline = true;
+        return; // first frame starts right away
+    }
+
+    // Missed by more than a frame (hitch, breakpoint): restart the cadence
+    // instead of running a burst of catch-up frames.
+    if (now > m_deadline + period)
+    {
+        m_deadline = now + period;
+        return;
+    }
+
+    SleepUntil(m_deadline);
+    const Clock::time_point woke = Clock::now();
+    m_wakeError.AddSample(std::chrono::duration<double, std::milli>(woke - m_deadline).count());
+    m_deadline += period;
+}
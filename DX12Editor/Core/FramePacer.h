@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#include "FrameStats.h"
+
+// Frame pacing: how often frames start and how they are presented.
+//   Uncapped  - present immediately (tearing where the swap chain allows it)
+//   VSync     - Present(1): the display paces the loop
+//   TargetFps - present immediately, frame starts are paced to 1/targetFps
+//               by a hybrid sleep/spin wait
+//
+// The wait is portable: it sleeps in short slices while the remaining time is
+// above the observed sleep overshoot (mean + stddev, learned online), then
+// spins the rest. The error against each deadline is kept for inspection.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Mode : uint32_t { Uncapped = 0, VSync = 1, TargetFps = 2 };
+
+    struct Config {
+        Mode   mode{ Mode::VSync };
+        double targetFps{ 60.0 };
+    };
+
+    FramePacer() noexcept;
+    ~FramePacer() noexcept;
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    void SetConfig(const Config& config) noexcept;
+    const Config& GetConfig() const noexcept { return m_config; }
+
+    uint32_t SyncInterval() const noexcept { return m_config.mode == Mode::VSync ? 1u : 0u; }
+
+    // Call once per frame before the frame starts. Blocks in TargetFps mode,
+    // returns at once otherwise.
+    void WaitForNextFrame() noexcept;
+
+    // Hybrid sleep/spin until 'deadline'.
+    void SleepUntil(Clock::time_point deadline) noexcept;
+
+    // How late WaitForNextFrame woke up vs. its deadline (ms).
+    const FrameStats& WakeError() const noexcept { return m_wakeError; }
+    double SleepEstimateMs() const noexcept { return m_estimateMs; }
+
+private:
+    void SleepSlice() noexcept;
+
+private:
+    Config m_config;
+    Clock::time_point m_deadline{};
+    bool   m_hasDeadline{ false };
+
+    // Online mean / variance of one sleep slice (Welford).
+    double   m_estimateMs{ 1.5 };
+    double   m_meanMs{ 1.0 };
+    double   m_m2{ 0.0 };
+    uint64_t m_sleepCount{ 1 };
+
+    void* m_timer{ nullptr }; // Win32 high-resolution waitable timer, if available
+
+    FrameStats m_wakeError;
+};
@@ -0,0 +1,191 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+    constexpr double kAvgWeight = 0.05;   // EMA weight of the newest frame
+    constexpr uint32_t kWarmupFrames = 30; // no hitch detection before the average settles
+
+    FILE* OpenForWrite(const char* path)
+    {
+        FILE* f = nullptr;
+#ifdef _WIN32
+        fopen_s(&f, path, "wb");
+#else
+        f = std::fopen(path, "wb");
+#endif
+        return f;
+    }
+}
+
+void FrameStats::AddSample(double ms) noexcept
+{
+    if (!(ms >= 0.0)) ms = 0.0; // also rejects NaN
+
+    m_window[m_head] = float(ms);
+    m_head = (m_head + 1) % kWindow;
+    if (m_count < kWindow) ++m_count;
+    ++m_total;
+
+    ++m_histogram[BucketOf(ms)];
+
+    if (m_total > kWarmupFrames && ms > m_hitchFactor * m_avgMs)
+    {
+        ++m_hitches;
+        m_lastHitchMs = ms;
+    }
+    m_avgMs = (m_total == 1) ? ms : m_avgMs + (ms - m_avgMs) * kAvgWeight;
+}
+
+void FrameStats::Reset() noexcept
+{
+    // Clears the samples; the configured hitch factor is a setting, not data.
+    const double hitchFactor = m_hitchFactor;
+    *this = FrameStats{};
+    m_hitchFactor = hitchFactor;
+}
+
+uint32_t FrameStats::BucketOf(double ms) noexcept
+{
+    // Log2 octave of the value in microseconds, split into kSubBuckets linear steps.
+    const double us = ms * 1000.0;
+    if (us < 1.0) return 0;
+
+    int exp = 0;
+    const double mant = std::frexp(us, &exp); // us = mant * 2^exp, mant in [0.5, 1)
+    const uint32_t octave = uint32_t(exp - 1);
+    if (octave >= kOctaves) return kBuckets - 1;
+
+    const uint32_t sub = std::min(uint32_t((mant - 0.5) * 2.0 * kSubBuckets), kSubBuckets - 1);
+    return octave * kSubBuckets + sub;
+}
+
+double FrameStats::BucketLowerMs(uint32_t bucket) noexcept
+{
+    const uint32_t octave = bucket / kSubBuckets;
+    const uint32_t sub = bucket % kSubBuckets;
+    const double us = std::ldexp(1.0 + double(sub) / kSubBuckets, int(octave));
+    return us / 1000.0;
+}
+
+void FrameStats::CopyWindow(std::vector<float>& out) const
+{
+    out.resize(m_count);
+    const uint32_t start = (m_head + kWindow - m_count) % kWindow;
+    for (uint32_t i = 0; i < m_count; ++i)
+        out[i] = m_window[(start + i) % kWindow];
+}
+
+double FrameStats::Percentile(double p) const
+{
+    if (m_count == 0) return 0.0;
+
+    std::vector<float> v;
+    CopyWindow(v);
+    // Nearest rank, same definition as Summarize().
+    const size_t k = std::clamp<size_t>(size_t(std::ceil(p / 100.0 * double(v.size()))), 1, v.size()) - 1;
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+FrameStats::Summary FrameStats::Summarize() const
+{
+    Summary s{};
+    s.count = m_count;
+    s.hitches = m_hitches;
+    if (m_count == 0) return s;
+
+    std::vector<float> v;
+    CopyWindow(v);
+    std::sort(v.begin(), v.end());
+
+    // Nearest-rank percentile on the sorted window.
+    auto rank = [&](double p) {
+        const size_t k = size_t(std::ceil(p / 100.0 * double(v.size())));
+        return double(v[std::clamp<size_t>(k, 1, v.size()) - 1]);
+    };
+
+    double sum = 0.0;
+    for (float x : v) sum += x;
+
+    s.minMs = v.front();
+    s.maxMs = v.back();
+    s.meanMs = sum / double(v.size());
+    s.p50Ms = rank(50.0);
+    s.p95Ms = rank(95.0);
+    s.p99Ms = rank(99.0);
+    return s;
+}
+
+void FrameStats::Decimate(uint32_t columns, std::vector<float>& outMin, std::vector<float>& outMax) const
+{
+    outMin.clear();
+    outMax.clear();
+    if (m_count == 0 || columns == 0) return;
+
+    std::vector<float> v;
+    CopyWindow(v);
+
+    columns = std::min(columns, m_count);
+    outMin.resize(columns);
+    outMax.resize(columns);
+    for (uint32_t c = 0; c < columns; ++c)
+    {
+        const size_t b = size_t(c) * v.size() / columns;
+        const size_t e = size_t(c + 1) * v.size() / columns;
+        const auto mm = std::minmax_element(v.begin() + b, v.begin() + e);
+        outMin[c] = *mm.first;
+        outMax[c] = *mm.second;
+    }
+}
+
+std::string FrameStats::ToJson() const
+{
+    const Summary s = Summarize();
+
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+        "{\"frames\":%llu,\"window\":%u,\"min_ms\":%.4f,\"mean_ms\":%.4f,\"p50_ms\":%.4f,"
+        "\"p95_ms\":%.4f,\"p99_ms\":%.4f,\"max_ms\":%.4f,\"hitches\":%llu,\"histogram\":[",
+        (unsigned long long)m_total, s.count, s.minMs, s.meanMs, s.p50Ms,
+        s.p95Ms, s.p99Ms, s.maxMs, (unsigned long long)s.hitches);
+
+    std::string json = buf;
+    bool first = true;
+    for (uint32_t i = 0; i < kBuckets; ++i)
+    {
+        if (!m_histogram[i]) continue;
+        std::snprintf(buf, sizeof(buf), "%s[%.4f,%llu]", first ? "" : ",",
+            BucketLowerMs(i), (unsigned long long)m_histogram[i]);
+        json += buf;
+        first = false;
+    }
+    json += "]}";
+    return json;
+}
+
+bool FrameStats::WriteJson(const char* path) const
+{
+    FILE* f = OpenForWrite(path);
+    if (!f) return false;
+    const std::string json = ToJson();
+    std::fwrite(json.data(), 1, json.size(), f);
+    std::fputc('\n', f);
+    return std::fclose(f) == 0;
+}
+
+bool FrameStats::WriteCsv(const char* path) const
+{
+    FILE* f = OpenForWrite(path);
+    if (!f) return false;
+
+    std::vector<float> v;
+    CopyWindow(v);
+
+    std::fprintf(f, "frame,ms\n");
+    const uint64_t firstFrame = m_total - v.size();
+    for (size_t i = 0; i < v.size(); ++i)
+        std::fprintf(f, "%llu,%.4f\n", (unsigned long long)(firstFrame + i), v[i]);
+    return std::fclose(f) == 0;
+}
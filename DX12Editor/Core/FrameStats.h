@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Frame-time statistics: rolling window for percentiles/graphs, plus an
+// HDR-style log histogram over the whole session. Pure CPU code, usable
+// headlessly (benchmarks feed samples and assert on the percentiles).
+class FrameStats {
+public:
+    static constexpr uint32_t kWindow = 1024;          // frames kept for percentiles / graph
+    static constexpr uint32_t kSubBuckets = 8;         // per power of two (~12% resolution)
+    static constexpr uint32_t kOctaves = 25;           // 1 us .. ~33 s
+    static constexpr uint32_t kBuckets = kSubBuckets * kOctaves;
+
+    struct Summary {
+        uint32_t count{ 0 };
+        double minMs{ 0.0 };
+        double maxMs{ 0.0 };
+        double meanMs{ 0.0 };
+        double p50Ms{ 0.0 };
+        double p95Ms{ 0.0 };
+        double p99Ms{ 0.0 };
+        uint64_t hitches{ 0 };
+    };
+
+    void AddSample(double ms) noexcept;
+    void Reset() noexcept;
+
+    // Percentiles over the rolling window (p in [0, 100]).
+    Summary Summarize() const;
+    double  Percentile(double p) const;
+
+    // A hitch is a frame longer than the hitch factor (default 2) x the
+    // running average. The factor survives Reset().
+    void     SetHitchFactor(double factor) noexcept { m_hitchFactor = factor; }
+    uint64_t HitchCount() const noexcept { return m_hitches; }
+    double   LastHitchMs() const noexcept { return m_lastHitchMs; }
+
+    // Session histogram
+    const uint64_t* Histogram() const noexcept { return m_histogram; }
+    static uint32_t BucketOf(double ms) noexcept;
+    static double   BucketLowerMs(uint32_t bucket) noexcept;
+
+    // Min/max per column over the window, oldest first (for a compact graph).
+    void Decimate(uint32_t columns, std::vector<float>& outMin, std::vector<float>& outMax) const;
+
+    // Window samples oldest first.
+    void CopyWindow(std::vector<float>& out) const;
+
+    uint64_t TotalFrames() const noexcept { return m_total; }
+
+    std::string ToJson() const;
+    bool WriteCsv(const char* path) const;
+    bool WriteJson(const char* path) const;
+
+private:
+    float    m_window[kWindow]{};
+    uint32_t m_head{ 0 };   // next write slot
+    uint32_t m_count{ 0 };  // valid samples in window
+    uint64_t m_total{ 0 };
+
+    uint64_t m_histogram[kBuckets]{};
+
+    double   m_avgMs{ 0.0 }; // exponential moving average
+    double   m_hitchFactor{ 2.0 };
+    uint64_t m_hitches{ 0 };
+    double   m_lastHitchMs{ 0.0 };
+};
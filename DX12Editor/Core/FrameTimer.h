@@ -1,24 +1,44 @@
 #pragma once
-#include <windows.h>
-#include <iomanip>
-#include <sstream>
+#include <chrono>
 
-// Simple frame timer for FPS and dt
+#include "FrameStats.h"
+
+// Simple frame timer for FPS and dt, with frame-time statistics.
+// steady_clock is QPC on MSVC and CLOCK_MONOTONIC on Linux.
 class FrameTimer {
 public:
-    FrameTimer() {
-        LARGE_INTEGER f; QueryPerformanceFrequency(&f);
-        m_freq = double(f.QuadPart);
-        QueryPerformanceCounter(&m_prev);
-    }
+    using Clock = std::chrono::steady_clock;
+
+    FrameTimer() : m_prev(Clock::now()) {}
+
     void Tick() {
-        LARGE_INTEGER now; QueryPerformanceCounter(&now);
-        m_dt = double(now.QuadPart - m_prev.QuadPart) / m_freq;
+        const Clock::time_point now = Clock::now();
+        if (m_restarted) {
+            // First frame after an idle gap: the gap is not a frame time.
+            m_dt = 0.0;
+            m_restarted = false;
+        }
+        else {
+            Advance(std::chrono::duration<double>(now - m_prev).count());
+        }
         m_prev = now;
+    }
 
+    // Rendering paused (on-demand redraw): the next Tick() reports dt = 0
+    // and adds no sample.
+    void Restart() {
+        m_prev = Clock::now();
+        m_restarted = true;
+    }
+
+    // Feeds an externally measured delta (headless runs, fixed-step benchmarks).
+    void Advance(double dtSec) {
+        m_dt = dtSec;
         m_accumTime += m_dt;
         m_accumFrames++;
+        m_stats.AddSample(m_dt * 1000.0);
     }
+
     double Delta() const { return m_dt; }
 
     // Sampling FPS every 'intervalSec'. Returns true when a new sample is ready.
@@ -31,12 +51,15 @@ public:
         }
         return false;
     }
+
+    FrameStats& Stats() { return m_stats; }
+    const FrameStats& Stats() const { return m_stats; }
+
 private:
-    LARGE_INTEGER m_prev{};
-    double m_freq{ 1.0 };
+    Clock::time_point m_prev;
+    bool   m_restarted{ false };
     double m_dt{ 0.0 };
     double m_accumTime{ 0.0 };
     int    m_accumFrames{ 0 };
+    FrameStats m_stats;
 };
-
-
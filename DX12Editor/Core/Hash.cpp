@@ -0,0 +1,80 @@
+#include "Hash.h"
+#include <cstring>
+
+namespace {
+    constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+    inline uint64_t Rotl(uint64_t x, int r) noexcept { return (x << r) | (x >> (64 - r)); }
+
+    inline uint64_t Read64(const uint8_t* p) noexcept { uint64_t v; std::memcpy(&v, p, 8); return v; }
+    inline uint32_t Read32(const uint8_t* p) noexcept { uint32_t v; std::memcpy(&v, p, 4); return v; }
+
+    inline uint64_t Round(uint64_t acc, uint64_t input) noexcept
+    {
+        acc += input * kPrime2;
+        return Rotl(acc, 31) * kPrime1;
+    }
+
+    inline uint64_t Merge(uint64_t acc, uint64_t lane) noexcept
+    {
+        acc ^= Round(0, lane);
+        return acc * kPrime1 + kPrime4;
+    }
+}
+
+// Little-endian reads (all supported targets are little-endian).
+uint64_t Hash64(const void* data, size_t size, uint64_t seed) noexcept
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* const end = p + size;
+    uint64_t h;
+
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        const uint8_t* const limit = end - 32;
+        do
+        {
+            v1 = Round(v1, Read64(p));      p += 8;
+            v2 = Round(v2, Read64(p));      p += 8;
+            v3 = Round(v3, Read64(p));      p += 8;
+            v4 = Round(v4, Read64(p));      p += 8;
+        } while (p <= limit);
+
+        h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+        h = Merge(h, v1);
+        h = Merge(h, v2);
+        h = Merge(h, v3);
+        h = Merge(h, v4);
+    }
+    else
+    {
+        h = seed + kPrime5;
+    }
+
+    h += uint64_t(size);
+
+    for (; p + 8 <= end; p += 8)
+        h = Rotl(h ^ Round(0, Read64(p)), 27) * kPrime1 + kPrime4;
+    if (p + 4 <= end)
+    {
+        h = Rotl(h ^ (uint64_t(Read32(p)) * kPrime1), 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+        h = Rotl(h ^ (uint64_t(*p) * kPrime5), 11) * kPrime1;
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
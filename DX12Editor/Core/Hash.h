@@ -0,0 +1,8 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Fast non-cryptographic 64-bit hash (the XXH64 algorithm): for change
+// detection and content keys, several GB/s on large buffers. Not for
+// anything adversarial.
+uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0) noexcept;
@@ -0,0 +1,51 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Platform-neutral input event. The platform layer (App/Main.cpp for Win32)
+// translates OS messages into these; the renderer only ever sees events, so a
+// recorded stream replays exactly like a live session.
+//
+// Key codes use the Win32 virtual-key numbering ('A'..'Z' are ASCII, the
+// modifiers below), which other platforms map onto.
+namespace InputKey {
+    constexpr uint16_t Shift = 0x10;
+    constexpr uint16_t Alt = 0x12;
+}
+
+enum class MouseButton : uint8_t { Left = 0, Right = 1, Middle = 2 };
+
+struct InputEvent {
+    enum class Type : uint8_t {
+        MouseMove,   // x, y = relative delta in pixels
+        MouseWheel,  // x = wheel ticks (+/-1 per notch)
+        ButtonDown,  // button
+        ButtonUp,    // button
+        KeyDown,     // key
+        KeyUp,       // key
+        Frame,       // end of a frame's input: x = simulation dt (s), flags = FrameFlags
+        Latch,       // following events of the frame were applied late, just before submit
+    };
+
+    enum FrameFlags : uint8_t { kUiCapturedMouse = 1 };
+
+    Type     type{ Type::MouseMove };
+    uint8_t  button{ 0 };
+    uint8_t  flags{ 0 };
+    uint16_t key{ 0 };
+    float    x{ 0.0f };
+    float    y{ 0.0f };
+    uint64_t timeNs{ 0 };   // steady clock, when the OS delivered the event
+    uint32_t frame{ 0 };    // frame the event was applied in
+
+    static uint64_t Now() noexcept
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static InputEvent MouseMove(float dx, float dy) noexcept { InputEvent e; e.type = Type::MouseMove; e.x = dx; e.y = dy; e.timeNs = Now(); return e; }
+    static InputEvent MouseWheel(float ticks) noexcept { InputEvent e; e.type = Type::MouseWheel; e.x = ticks; e.timeNs = Now(); return e; }
+    static InputEvent Button(MouseButton b, bool down) noexcept { InputEvent e; e.type = down ? Type::ButtonDown : Type::ButtonUp; e.button = uint8_t(b); e.timeNs = Now(); return e; }
+    static InputEvent Key(uint16_t key, bool down) noexcept { InputEvent e; e.type = down ? Type::KeyDown : Type::KeyUp; e.key = key; e.timeNs = Now(); return e; }
+};
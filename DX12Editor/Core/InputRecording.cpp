@@ -0,0 +1,175 @@
+#include "InputRecording.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    constexpr char     kMagic[4] = { 'D', 'X', 'E', 'I' };
+    constexpr uint16_t kVersion = 2; // 2: Latch events
+
+    void PutVarint(std::vector<uint8_t>& out, uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back(uint8_t(v) | 0x80);
+            v >>= 7;
+        }
+        out.push_back(uint8_t(v));
+    }
+
+    template <typename T>
+    void PutRaw(std::vector<uint8_t>& out, const T& v)
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&v);
+        out.insert(out.end(), p, p + sizeof(T));
+    }
+
+    struct Reader {
+        const uint8_t* p;
+        const uint8_t* end;
+
+        bool Varint(uint64_t& v)
+        {
+            v = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (p >= end) return false;
+                const uint8_t b = *p++;
+                v |= uint64_t(b & 0x7F) << shift;
+                if (!(b & 0x80)) return true;
+            }
+            return false;
+        }
+
+        template <typename T>
+        bool Raw(T& v)
+        {
+            if (size_t(end - p) < sizeof(T)) return false;
+            std::memcpy(&v, p, sizeof(T));
+            p += sizeof(T);
+            return true;
+        }
+    };
+}
+
+bool InputRecording::Save(const char* path) const
+{
+    std::vector<uint8_t> buf;
+    buf.reserve(16 + m_events.size() * 8);
+    buf.insert(buf.end(), kMagic, kMagic + 4);
+    PutRaw(buf, kVersion);
+    PutRaw(buf, uint16_t(0));
+    const uint64_t firstTime = m_events.empty() ? 0 : m_events.front().timeNs;
+    PutRaw(buf, firstTime);
+
+    uint32_t prevFrame = 0;
+    uint64_t prevTime = firstTime;
+    for (const InputEvent& e : m_events)
+    {
+        PutVarint(buf, e.frame - prevFrame);
+        buf.push_back(uint8_t(e.type));
+        // Timestamps are monotonic per session; clamp in case of a clock hiccup.
+        PutVarint(buf, e.timeNs >= prevTime ? e.timeNs - prevTime : 0);
+        prevFrame = e.frame;
+        prevTime = (e.timeNs >= prevTime) ? e.timeNs : prevTime;
+
+        switch (e.type)
+        {
+        case InputEvent::Type::MouseMove:  PutRaw(buf, e.x); PutRaw(buf, e.y); break;
+        case InputEvent::Type::MouseWheel: PutRaw(buf, e.x); break;
+        case InputEvent::Type::ButtonDown:
+        case InputEvent::Type::ButtonUp:   buf.push_back(e.button); break;
+        case InputEvent::Type::KeyDown:
+        case InputEvent::Type::KeyUp:      PutVarint(buf, e.key); break;
+        case InputEvent::Type::Frame:      PutRaw(buf, e.x); buf.push_back(e.flags); break;
+        case InputEvent::Type::Latch:      break;
+        }
+    }
+
+    FILE* f = nullptr;
+#ifdef _WIN32
+    fopen_s(&f, path, "wb");
+#else
+    f = std::fopen(path, "wb");
+#endif
+    if (!f) return false;
+    const bool ok = std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    return (std::fclose(f) == 0) && ok;
+}
+
+bool InputRecording::Load(const char* path)
+{
+    FILE* f = nullptr;
+#ifdef _WIN32
+    fopen_s(&f, path, "rb");
+#else
+    f = std::fopen(path, "rb");
+#endif
+    if (!f) return false;
+
+    std::vector<uint8_t> buf;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+        buf.insert(buf.end(), chunk, chunk + n);
+    std::fclose(f);
+
+    Clear();
+
+    Reader r{ buf.data(), buf.data() + buf.size() };
+    char magic[4];
+    uint16_t version = 0, reserved = 0;
+    uint64_t time = 0;
+    if (!r.Raw(magic) || std::memcmp(magic, kMagic, 4) != 0) return false;
+    if (!r.Raw(version) || version == 0 || version > kVersion) return false;
+    if (!r.Raw(reserved) || !r.Raw(time)) return false;
+
+    // Version 1 had no Latch events.
+    const InputEvent::Type lastType = version >= 2 ? InputEvent::Type::Latch : InputEvent::Type::Frame;
+    uint32_t frame = 0;
+    while (r.p < r.end)
+    {
+        InputEvent e;
+        uint64_t frameDelta = 0, timeDelta = 0;
+        uint8_t type = 0;
+        if (!r.Varint(frameDelta) || !r.Raw(type) || !r.Varint(timeDelta)) return false;
+        if (type > uint8_t(lastType)) return false;
+
+        frame += uint32_t(frameDelta);
+        time += timeDelta;
+        e.frame = frame;
+        e.timeNs = time;
+        e.type = InputEvent::Type(type);
+
+        bool ok = true;
+        uint64_t key = 0;
+        switch (e.type)
+        {
+        case InputEvent::Type::MouseMove:  ok = r.Raw(e.x) && r.Raw(e.y); break;
+        case InputEvent::Type::MouseWheel: ok = r.Raw(e.x); break;
+        case InputEvent::Type::ButtonDown:
+        case InputEvent::Type::ButtonUp:   ok = r.Raw(e.button); break;
+        case InputEvent::Type::KeyDown:
+        case InputEvent::Type::KeyUp:      ok = r.Varint(key); e.key = uint16_t(key); break;
+        case InputEvent::Type::Frame:      ok = r.Raw(e.x) && r.Raw(e.flags); break;
+        case InputEvent::Type::Latch:      break;
+        }
+        if (!ok) return false;
+        m_events.push_back(e);
+    }
+    return true;
+}
+
+void InputRecording::Fetch(uint32_t frame, std::vector<InputEvent>& early, std::vector<InputEvent>& late)
+{
+    // Skip anything older (a replay started late or a frame was dropped).
+    while (m_cursor < m_events.size() && m_events[m_cursor].frame < frame)
+        ++m_cursor;
+    bool latched = false;
+    for (; m_cursor < m_events.size() && m_events[m_cursor].frame == frame; ++m_cursor)
+    {
+        const InputEvent& e = m_events[m_cursor];
+        if (e.type == InputEvent::Type::Latch) latched = true;
+        else if (latched && e.type != InputEvent::Type::Frame) late.push_back(e);
+        else early.push_back(e);
+    }
+}
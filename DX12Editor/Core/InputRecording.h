@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "InputEvents.h"
+
+// A recorded input session: every event tagged with the frame it was applied
+// in, plus one Frame event per frame carrying that frame's simulation dt.
+// Replaying it with the same dt gives the same camera on every build.
+//
+// File layout (little endian):
+//   "DXEI" u16 version u16 reserved u64 firstTimeNs
+//   per event: varint frameDelta, u8 type, varint timeDeltaNs, payload
+//     MouseMove: f32 dx, f32 dy     MouseWheel: f32 ticks
+//     ButtonDown/Up: u8 button      KeyDown/Up: varint key
+//     Frame: f32 dt, u8 flags       Latch: no payload (version 2+)
+class InputRecording {
+public:
+    void Clear() noexcept { m_events.clear(); m_cursor = 0; }
+
+    // Events must arrive in non-decreasing frame order.
+    void Append(const InputEvent& e) { m_events.push_back(e); }
+
+    bool Save(const char* path) const;
+    bool Load(const char* path);
+
+    size_t Size() const noexcept { return m_events.size(); }
+    const InputEvent& operator[](size_t i) const noexcept { return m_events[i]; }
+    uint32_t FrameCount() const noexcept { return m_events.empty() ? 0 : m_events.back().frame + 1; }
+
+    // Replay cursor: appends the events of 'frame' (call with increasing
+    // frames). 'early' gets those applied at the start of the frame, 'late'
+    // those recorded after its Latch marker (applied just before submit).
+    // The Frame marker is recorded last but carries the frame's dt and UI
+    // capture, so it goes to 'early'; the Latch marker itself is dropped.
+    void Rewind() noexcept { m_cursor = 0; }
+    void Fetch(uint32_t frame, std::vector<InputEvent>& early, std::vector<InputEvent>& late);
+    bool Finished() const noexcept { return m_cursor >= m_events.size(); }
+
+private:
+    std::vector<InputEvent> m_events;
+    size_t m_cursor{ 0 };
+};
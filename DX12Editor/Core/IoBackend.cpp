@@ -0,0 +1,452 @@
+#include "IoBackend.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    // ====================================================
+    // Blocking file access (thread pool backend)
+    // ====================================================
+#if defined(_WIN32)
+    IoFile OpenBlocking(const std::filesystem::path& path, uint64_t* size, DWORD flags) noexcept
+    {
+        HANDLE h = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (h == INVALID_HANDLE_VALUE) return kInvalidIoFile;
+        LARGE_INTEGER sz{};
+        if (!GetFileSizeEx(h, &sz))
+        {
+            CloseHandle(h);
+            return kInvalidIoFile;
+        }
+        *size = uint64_t(sz.QuadPart);
+        return reinterpret_cast<IoFile>(h);
+    }
+
+    void CloseBlocking(IoFile file) noexcept { CloseHandle(reinterpret_cast<HANDLE>(file)); }
+
+    int64_t ReadBlocking(IoFile file, uint64_t offset, uint8_t* dst, uint32_t size) noexcept
+    {
+        OVERLAPPED ov{}; // positioned read on a synchronous handle
+        ov.Offset = DWORD(offset);
+        ov.OffsetHigh = DWORD(offset >> 32);
+        DWORD read = 0;
+        if (::ReadFile(reinterpret_cast<HANDLE>(file), dst, size, &read, &ov)) return read;
+        const DWORD err = GetLastError();
+        return (err == ERROR_HANDLE_EOF) ? 0 : -int64_t(err);
+    }
+#else
+    IoFile OpenBlocking(const std::filesystem::path& path, uint64_t* size) noexcept
+    {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return kInvalidIoFile;
+        struct stat st{};
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            return kInvalidIoFile;
+        }
+        *size = uint64_t(st.st_size);
+        return fd;
+    }
+
+    void CloseBlocking(IoFile file) noexcept { close(int(file)); }
+
+    int64_t ReadBlocking(IoFile file, uint64_t offset, uint8_t* dst, uint32_t size) noexcept
+    {
+        for (;;)
+        {
+            const ssize_t n = pread(int(file), dst, size, off_t(offset));
+            if (n >= 0) return n;
+            if (errno != EINTR) return -int64_t(errno);
+        }
+    }
+#endif
+
+    class ThreadPoolBackend final : public IoBackend {
+    public:
+        explicit ThreadPoolBackend(uint32_t threads)
+        {
+            for (uint32_t i = 0; i < threads; ++i)
+                m_workers.emplace_back([this] { WorkerLoop(); });
+        }
+
+        ~ThreadPoolBackend() override
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_workCv.notify_all();
+            for (std::thread& t : m_workers) t.join();
+        }
+
+        const char* Name() const noexcept override { return "thread pool"; }
+
+        IoFile Open(const std::filesystem::path& path, uint64_t* size) noexcept override
+        {
+#if defined(_WIN32)
+            return OpenBlocking(path, size, FILE_FLAG_SEQUENTIAL_SCAN);
+#else
+            return OpenBlocking(path, size);
+#endif
+        }
+
+        void Close(IoFile file) noexcept override { CloseBlocking(file); }
+
+        void Submit(IoOp* const* ops, size_t count) noexcept override
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_work.insert(m_work.end(), ops, ops + count);
+            }
+            m_workCv.notify_all();
+        }
+
+        void Reap(std::vector<IoOp*>& done, bool wait) noexcept override
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (wait) m_doneCv.wait(lock, [this] { return !m_done.empty() || m_woken; });
+            done.insert(done.end(), m_done.begin(), m_done.end());
+            m_done.clear();
+            m_woken = false;
+        }
+
+        void Wake() noexcept override
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_woken = true;
+            }
+            m_doneCv.notify_one();
+        }
+
+    private:
+        void WorkerLoop()
+        {
+            for (;;)
+            {
+                IoOp* op = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_workCv.wait(lock, [this] { return m_stop || !m_work.empty(); });
+                    if (m_work.empty()) return; // stopping
+                    op = m_work.front();
+                    m_work.pop_front();
+                }
+                op->result = ReadBlocking(op->file, op->offset, op->dst, op->size);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_done.push_back(op);
+                }
+                m_doneCv.notify_one();
+            }
+        }
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        std::condition_variable m_workCv;
+        std::condition_variable m_doneCv;
+        std::deque<IoOp*> m_work;
+        std::vector<IoOp*> m_done;
+        bool m_woken{ false };
+        bool m_stop{ false };
+    };
+
+    // ====================================================
+    // io_uring (Linux 5.6+), raw syscalls, no liburing
+    // ====================================================
+#if defined(__linux__)
+    class UringBackend final : public IoBackend {
+    public:
+        ~UringBackend() override
+        {
+            if (m_sqes) munmap(m_sqes, m_sqesSize);
+            if (m_ring) munmap(m_ring, m_ringSize);
+            if (m_eventFd >= 0) close(m_eventFd);
+            if (m_ringFd >= 0) close(m_ringFd);
+        }
+
+        bool Init(uint32_t queueDepth) noexcept
+        {
+            io_uring_params p{};
+            m_ringFd = int(syscall(__NR_io_uring_setup, queueDepth + 1, &p)); // + the wake read
+            if (m_ringFd < 0) return false;
+            // Single ring mapping (5.4) and IORING_OP_READ at the current position (5.6).
+            if (!(p.features & IORING_FEAT_SINGLE_MMAP) || !(p.features & IORING_FEAT_RW_CUR_POS)) return false;
+
+            m_ringSize = (std::max)(p.sq_off.array + p.sq_entries * sizeof(uint32_t),
+                                    p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe));
+            m_ring = mmap(nullptr, m_ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+            if (m_ring == MAP_FAILED) { m_ring = nullptr; return false; }
+            m_sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+            void* sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED) return false;
+            m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+            uint8_t* ring = static_cast<uint8_t*>(m_ring);
+            m_sqHead = reinterpret_cast<uint32_t*>(ring + p.sq_off.head);
+            m_sqTail = reinterpret_cast<uint32_t*>(ring + p.sq_off.tail);
+            m_sqMask = *reinterpret_cast<uint32_t*>(ring + p.sq_off.ring_mask);
+            m_sqArray = reinterpret_cast<uint32_t*>(ring + p.sq_off.array);
+            m_sqEntries = p.sq_entries;
+            m_cqHead = reinterpret_cast<uint32_t*>(ring + p.cq_off.head);
+            m_cqTail = reinterpret_cast<uint32_t*>(ring + p.cq_off.tail);
+            m_cqMask = *reinterpret_cast<uint32_t*>(ring + p.cq_off.ring_mask);
+            m_cqes = reinterpret_cast<io_uring_cqe*>(ring + p.cq_off.cqes);
+
+            // Wake(): a read on this eventfd is always pending in the ring,
+            // so a blocking io_uring_enter returns when it is written.
+            m_eventFd = eventfd(0, EFD_CLOEXEC);
+            if (m_eventFd < 0) return false;
+            ArmWake();
+            Flush();
+            return true;
+        }
+
+        const char* Name() const noexcept override { return "io_uring"; }
+
+        IoFile Open(const std::filesystem::path& path, uint64_t* size) noexcept override { return OpenBlocking(path, size); }
+        void   Close(IoFile file) noexcept override { CloseBlocking(file); }
+
+        void Submit(IoOp* const* ops, size_t count) noexcept override
+        {
+            for (size_t i = 0; i < count; ++i)
+                Push(IORING_OP_READ, int(ops[i]->file), ops[i]->dst, ops[i]->size, ops[i]->offset, reinterpret_cast<uint64_t>(ops[i]));
+            Flush();
+        }
+
+        void Reap(std::vector<IoOp*>& done, bool wait) noexcept override
+        {
+            bool woken = Harvest(done);
+            if (wait && !woken && done.empty())
+            {
+                syscall(__NR_io_uring_enter, m_ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                Harvest(done);
+            }
+            if (!m_wakeArmed)
+            {
+                ArmWake();
+                Flush();
+            }
+        }
+
+        void Wake() noexcept override
+        {
+            const uint64_t one = 1;
+            [[maybe_unused]] const ssize_t n = write(m_eventFd, &one, sizeof(one));
+        }
+
+    private:
+        static constexpr uint64_t kWakeTag = 0;
+
+        void Push(uint8_t opcode, int fd, void* addr, uint32_t len, uint64_t offset, uint64_t userData) noexcept
+        {
+            uint32_t tail = *m_sqTail; // only this thread produces
+            if (tail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries)
+            {
+                Flush(); // full: let the kernel consume (AsyncIO never exceeds the depth)
+                tail = *m_sqTail;
+            }
+            const uint32_t index = tail & m_sqMask;
+            io_uring_sqe& sqe = m_sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = opcode;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<uint64_t>(addr);
+            sqe.len = len;
+            sqe.off = offset;
+            sqe.user_data = userData;
+            m_sqArray[index] = index;
+            __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+            ++m_unsubmitted;
+        }
+
+        void Flush() noexcept
+        {
+            while (m_unsubmitted > 0)
+            {
+                const long n = syscall(__NR_io_uring_enter, m_ringFd, m_unsubmitted, 0, 0, nullptr, 0);
+                if (n < 0)
+                {
+                    if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+                    return;
+                }
+                m_unsubmitted -= uint32_t(n);
+            }
+        }
+
+        void ArmWake() noexcept
+        {
+            Push(IORING_OP_READ, m_eventFd, &m_wakeValue, sizeof(m_wakeValue), ~uint64_t(0), kWakeTag);
+            m_wakeArmed = true;
+        }
+
+        // Returns true if the wake read completed.
+        bool Harvest(std::vector<IoOp*>& done) noexcept
+        {
+            bool woken = false;
+            uint32_t head = *m_cqHead;
+            const uint32_t tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+                if (cqe.user_data == kWakeTag)
+                {
+                    woken = true;
+                    m_wakeArmed = false;
+                    continue;
+                }
+                IoOp* op = reinterpret_cast<IoOp*>(cqe.user_data);
+                op->result = cqe.res;
+                done.push_back(op);
+            }
+            __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+            return woken;
+        }
+
+        int    m_ringFd{ -1 };
+        int    m_eventFd{ -1 };
+        void*  m_ring{ nullptr };
+        size_t m_ringSize{ 0 };
+        io_uring_sqe* m_sqes{ nullptr };
+        size_t m_sqesSize{ 0 };
+
+        uint32_t* m_sqHead{ nullptr };
+        uint32_t* m_sqTail{ nullptr };
+        uint32_t* m_sqArray{ nullptr };
+        uint32_t  m_sqMask{ 0 };
+        uint32_t  m_sqEntries{ 0 };
+        uint32_t* m_cqHead{ nullptr };
+        uint32_t* m_cqTail{ nullptr };
+        uint32_t  m_cqMask{ 0 };
+        io_uring_cqe* m_cqes{ nullptr };
+
+        uint32_t m_unsubmitted{ 0 };
+        uint64_t m_wakeValue{ 0 };
+        bool     m_wakeArmed{ false };
+    };
+#endif
+
+    // ====================================================
+    // Overlapped reads on an I/O completion port (Windows)
+    // ====================================================
+#if defined(_WIN32)
+    class IocpBackend final : public IoBackend {
+    public:
+        ~IocpBackend() override
+        {
+            if (m_port) CloseHandle(m_port);
+        }
+
+        bool Init() noexcept
+        {
+            m_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+            return m_port != nullptr;
+        }
+
+        const char* Name() const noexcept override { return "IOCP"; }
+
+        IoFile Open(const std::filesystem::path& path, uint64_t* size) noexcept override
+        {
+            const IoFile file = OpenBlocking(path, size, FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN);
+            if (file == kInvalidIoFile) return file;
+            if (!CreateIoCompletionPort(reinterpret_cast<HANDLE>(file), m_port, 0, 0))
+            {
+                CloseBlocking(file);
+                return kInvalidIoFile;
+            }
+            return file;
+        }
+
+        void Close(IoFile file) noexcept override { CloseBlocking(file); }
+
+        void Submit(IoOp* const* ops, size_t count) noexcept override
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                IoOp* op = ops[i];
+                op->overlapped = OVERLAPPED{};
+                op->overlapped.Offset = DWORD(op->offset);
+                op->overlapped.OffsetHigh = DWORD(op->offset >> 32);
+                // Completed synchronously or pending: either way a packet arrives.
+                if (::ReadFile(reinterpret_cast<HANDLE>(op->file), op->dst, op->size, nullptr, &op->overlapped))
+                    continue;
+                const DWORD err = GetLastError();
+                if (err == ERROR_IO_PENDING) continue;
+                op->result = (err == ERROR_HANDLE_EOF) ? 0 : -int64_t(err);
+                m_failed.push_back(op); // no packet for this one
+            }
+        }
+
+        void Reap(std::vector<IoOp*>& done, bool wait) noexcept override
+        {
+            if (!m_failed.empty())
+            {
+                done.insert(done.end(), m_failed.begin(), m_failed.end());
+                m_failed.clear();
+                wait = false;
+            }
+
+            OVERLAPPED_ENTRY entries[64];
+            ULONG count = 0;
+            if (!GetQueuedCompletionStatusEx(m_port, entries, 64, &count, wait ? INFINITE : 0, FALSE))
+                return;
+            for (ULONG i = 0; i < count; ++i)
+            {
+                if (!entries[i].lpOverlapped) continue; // Wake()
+                IoOp* op = reinterpret_cast<IoOp*>(entries[i].lpOverlapped);
+                DWORD bytes = 0;
+                if (GetOverlappedResult(reinterpret_cast<HANDLE>(op->file), &op->overlapped, &bytes, FALSE))
+                    op->result = bytes;
+                else
+                {
+                    const DWORD err = GetLastError();
+                    op->result = (err == ERROR_HANDLE_EOF) ? 0 : -int64_t(err);
+                }
+                done.push_back(op);
+            }
+        }
+
+        void Wake() noexcept override { PostQueuedCompletionStatus(m_port, 0, 0, nullptr); }
+
+    private:
+        HANDLE m_port{ nullptr };
+        std::vector<IoOp*> m_failed;
+    };
+#endif
+}
+
+std::unique_ptr<IoBackend> CreateNativeIoBackend(uint32_t queueDepth)
+{
+#if defined(__linux__)
+    auto backend = std::make_unique<UringBackend>();
+    if (backend->Init(queueDepth)) return backend;
+#elif defined(_WIN32)
+    (void)queueDepth;
+    auto backend = std::make_unique<IocpBackend>();
+    if (backend->Init()) return backend;
+#else
+    (void)queueDepth;
+#endif
+    return nullptr;
+}
+
+std::unique_ptr<IoBackend> CreateThreadPoolIoBackend(uint32_t threads)
+{
+    return std::make_unique<ThreadPoolBackend>((std::max)(threads, 1u));
+}
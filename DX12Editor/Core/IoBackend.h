@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+// Platform layer under AsyncIO: opens files and runs positioned reads
+// asynchronously. Only the AsyncIO dispatcher thread calls it, except Wake().
+
+using IoFile = intptr_t;
+constexpr IoFile kInvalidIoFile = -1;
+
+// One read in flight. Owned by AsyncIO, recycled between reads.
+struct IoOp {
+#if defined(_WIN32)
+    OVERLAPPED overlapped{};  // first member: completion packets point at it
+#endif
+    IoFile   file{ kInvalidIoFile };
+    uint64_t offset{ 0 };
+    uint8_t* dst{ nullptr };
+    uint32_t size{ 0 };
+    int64_t  result{ 0 };     // bytes read (0 = end of file), < 0 = error
+    void*    owner{ nullptr };
+};
+
+class IoBackend {
+public:
+    virtual ~IoBackend() = default;
+
+    virtual const char* Name() const noexcept = 0;
+
+    virtual IoFile Open(const std::filesystem::path& path, uint64_t* size) noexcept = 0;
+    virtual void   Close(IoFile file) noexcept = 0;
+
+    // Starts the reads; each one comes back from Reap() exactly once.
+    virtual void Submit(IoOp* const* ops, size_t count) noexcept = 0;
+    // Appends finished reads to 'done'. With 'wait', blocks until at least
+    // one finished or Wake() was called.
+    virtual void Reap(std::vector<IoOp*>& done, bool wait) noexcept = 0;
+    // Thread-safe: ends a blocking Reap().
+    virtual void Wake() noexcept = 0;
+};
+
+// io_uring on Linux, I/O completion port on Windows; null if unavailable.
+std::unique_ptr<IoBackend> CreateNativeIoBackend(uint32_t queueDepth);
+// Blocking positioned reads on 'threads' workers; works everywhere.
+std::unique_ptr<IoBackend> CreateThreadPoolIoBackend(uint32_t threads);
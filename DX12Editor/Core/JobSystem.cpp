@@ -0,0 +1,134 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+JobSystem::~JobSystem()
+{
+    Shutdown();
+}
+
+bool JobSystem::Initialize(unsigned workerCount) noexcept
+{
+    Shutdown();
+
+    if (workerCount == 0)
+    {
+        const unsigned hw = std::thread::hardware_concurrency();
+        workerCount = (hw > 1) ? hw - 1 : 1;
+    }
+
+    m_stop = false;
+    try {
+        for (unsigned i = 0; i < workerCount; ++i)
+            m_workers.emplace_back([this] { WorkerLoop(); });
+    }
+    catch (...) {
+        Shutdown();
+        return false;
+    }
+    return true;
+}
+
+void JobSystem::Shutdown() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+
+    for (auto& t : m_workers)
+        if (t.joinable()) t.join();
+
+    m_workers.clear();
+    m_queue.clear();
+    m_background.clear();
+}
+
+void JobSystem::Submit(std::function<void()> task, Priority priority)
+{
+    if (m_workers.empty())
+    {
+        task(); // no pool -> run inline
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        (priority == Priority::Background ? m_background : m_queue).push_back(std::move(task));
+    }
+    m_cv.notify_one();
+}
+
+void JobSystem::ParallelFor(size_t count, size_t minBatch, const RangeFn& fn)
+{
+    if (count == 0)
+        return;
+
+    minBatch = std::max<size_t>(minBatch, 1);
+    const size_t maxBatches = size_t(ThreadCount()) * 4;
+    const size_t batchSize = std::max(minBatch, (count + maxBatches - 1) / maxBatches);
+    const size_t batchCount = (count + batchSize - 1) / batchSize;
+
+    if (batchCount == 1 || m_workers.empty())
+    {
+        fn(0, count);
+        return;
+    }
+
+    // Batches are claimed from a shared counter by helpers and by this thread.
+    std::atomic<size_t> nextBatch{ 0 };
+    std::atomic<size_t> helpersDone{ 0 };
+
+    auto work = [&]() {
+        for (;;)
+        {
+            const size_t b = nextBatch.fetch_add(1, std::memory_order_relaxed);
+            if (b >= batchCount) return;
+            const size_t begin = b * batchSize;
+            fn(begin, std::min(begin + batchSize, count));
+        }
+    };
+
+    const size_t helpers = std::min(batchCount - 1, m_workers.size());
+    for (size_t i = 0; i < helpers; ++i)
+        Submit([&]() { work(); helpersDone.fetch_add(1, std::memory_order_release); });
+
+    work();
+
+    // Helpers reference this stack frame, so wait until every one has exited.
+    // Run queued tasks meanwhile (possibly our own helpers) instead of idling.
+    while (helpersDone.load(std::memory_order_acquire) < helpers)
+    {
+        if (!RunOne())
+            std::this_thread::yield();
+    }
+}
+
+bool JobSystem::RunOne()
+{
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.empty()) return false;
+        task = std::move(m_queue.front());
+        m_queue.pop_front();
+    }
+    task();
+    return true;
+}
+
+void JobSystem::WorkerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || !m_queue.empty() || !m_background.empty(); });
+            if (m_stop && m_queue.empty() && m_background.empty()) return;
+            std::deque<std::function<void()>>& queue = m_queue.empty() ? m_background : m_queue;
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fixed-size worker pool.
+// ParallelFor splits a range into batches; the calling thread also takes batches
+// and returns only when the whole range is done.
+class JobSystem {
+public:
+    using RangeFn = std::function<void(size_t begin, size_t end)>;
+
+    // Background tasks (long, latency-tolerant work: PSO compiles) have their
+    // own queue. Only workers take them, and only when no normal task is
+    // waiting; a thread helping out in ParallelFor never does, so a frame
+    // cannot end up stalled behind a multi-millisecond compile.
+    enum class Priority { Normal, Background };
+
+    JobSystem() noexcept = default;
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // workerCount == 0 -> hardware_concurrency() - 1
+    bool Initialize(unsigned workerCount = 0) noexcept;
+    void Shutdown() noexcept;
+
+    // Fire-and-forget task.
+    void Submit(std::function<void()> task, Priority priority = Priority::Normal);
+
+    // Runs fn over [0, count) in batches of at least minBatch items.
+    void ParallelFor(size_t count, size_t minBatch, const RangeFn& fn);
+
+    // Worker threads + the calling thread.
+    unsigned ThreadCount() const noexcept { return unsigned(m_workers.size()) + 1; }
+
+private:
+    void WorkerLoop();
+    bool RunOne(); // normal tasks only
+
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_queue;
+    std::deque<std::function<void()>> m_background;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop{ false };
+};
@@ -0,0 +1,57 @@
+#include "LatencyTracker.h"
+
+void LatencyTracker::OnInputApplied(uint64_t eventNs, uint64_t nowNs) noexcept
+{
+    if (eventNs == 0) return;
+    if (m_oldestEventNs == 0 || eventNs < m_oldestEventNs)
+        m_oldestEventNs = eventNs;
+    Mark(Handler, nowNs);
+}
+
+void LatencyTracker::Mark(Stage stage, uint64_t nowNs) noexcept
+{
+    if (m_oldestEventNs != 0 && m_stageNs[stage] == 0)
+        m_stageNs[stage] = nowNs;
+}
+
+void LatencyTracker::EndFrame() noexcept
+{
+    if (m_oldestEventNs != 0)
+    {
+        for (uint32_t s = 0; s < kStageCount; ++s)
+        {
+            // A stage can be skipped (e.g. external camera): no sample then.
+            if (m_stageNs[s] >= m_oldestEventNs)
+                m_stats[s].AddSample(double(m_stageNs[s] - m_oldestEventNs) / 1e6);
+            m_stageNs[s] = 0;
+        }
+    }
+    m_oldestEventNs = 0;
+}
+
+const char* LatencyTracker::StageName(Stage stage) noexcept
+{
+    switch (stage)
+    {
+    case Handler: return "input_to_handler";
+    case Camera:  return "input_to_camera";
+    case Submit:  return "input_to_submit";
+    case Present: return "input_to_present";
+    default:      return "?";
+    }
+}
+
+std::string LatencyTracker::ToJson() const
+{
+    std::string json = "{";
+    for (uint32_t s = 0; s < kStageCount; ++s)
+    {
+        if (s) json += ",";
+        json += "\"";
+        json += StageName(Stage(s));
+        json += "\":";
+        json += m_stats[s].ToJson();
+    }
+    json += "}";
+    return json;
+}
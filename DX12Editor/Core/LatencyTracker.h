@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "FrameStats.h"
+
+// End-to-end input latency. Every input event carries the time it entered
+// the platform layer; per frame the oldest event applied in it is followed
+// through the pipeline stages below, and "event -> stage" is sampled into
+// one distribution per stage. Frames without input add no samples.
+class LatencyTracker {
+public:
+    enum Stage : uint32_t {
+        Handler,  // applied through DXRenderer::HandleInput (queue wait)
+        Camera,   // consumed by the camera update (or the late latch)
+        Submit,   // ExecuteCommandLists returned
+        Present,  // Present returned
+        kStageCount
+    };
+
+    // An event stamped 'eventNs' was applied now. eventNs == 0 = untracked.
+    void OnInputApplied(uint64_t eventNs, uint64_t nowNs) noexcept;
+
+    // First time a stage is reached after this frame's first input.
+    void Mark(Stage stage, uint64_t nowNs) noexcept;
+
+    // Closes the frame (after Present): adds the samples and starts over.
+    void EndFrame() noexcept;
+
+    const FrameStats& Stats(Stage stage) const noexcept { return m_stats[stage]; }
+    static const char* StageName(Stage stage) noexcept;
+
+    // {"input_to_handler": {...FrameStats...}, ...}
+    std::string ToJson() const;
+
+private:
+    uint64_t   m_oldestEventNs{ 0 };
+    uint64_t   m_stageNs[kStageCount]{};
+    FrameStats m_stats[kStageCount];
+};
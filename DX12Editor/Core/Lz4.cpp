@@ -0,0 +1,189 @@
+#include "Lz4.h"
+#include <cstring>
+
+namespace {
+    constexpr size_t   kMinMatch = 4;
+    constexpr size_t   kLastLiterals = 5;   // the block ends with at least this many literals
+    constexpr size_t   kMatchLimit = 12;    // no match starts in the last 12 bytes
+    constexpr size_t   kMaxOffset = 65535;
+    constexpr uint32_t kHashLog = 14;
+
+    uint32_t Read32(const uint8_t* p) noexcept
+    {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    uint32_t Hash4(uint32_t v) noexcept { return (v * 2654435761u) >> (32 - kHashLog); }
+
+    // 15 in the token nibble, then 255s and the remainder.
+    uint8_t* WriteLength(uint8_t* op, size_t length) noexcept
+    {
+        for (; length >= 255; length -= 255) *op++ = 255;
+        *op++ = uint8_t(length);
+        return op;
+    }
+
+    bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length) noexcept
+    {
+        for (;;)
+        {
+            if (ip >= end) return false;
+            const uint8_t b = *ip++;
+            length += b;
+            if (b != 255) return true;
+        }
+    }
+}
+
+size_t Lz4Compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) noexcept
+{
+    // Positions + 1 of the last 4-byte sequence per hash (0 = empty).
+    uint32_t table[1u << kHashLog] = {};
+
+    uint8_t* op = dst;
+    uint8_t* const opEnd = dst + capacity;
+    size_t anchor = 0;
+
+    auto emit = [&](size_t literals, size_t offset, size_t match) -> bool {
+        // Token + length bytes + literals + offset + match length bytes.
+        const size_t worst = 1 + literals / 255 + 1 + literals + 2 + match / 255 + 1;
+        if (size_t(opEnd - op) < worst) return false;
+
+        uint8_t* token = op++;
+        *token = uint8_t((literals < 15 ? literals : 15) << 4);
+        if (literals >= 15) op = WriteLength(op, literals - 15);
+        if (literals) std::memcpy(op, src + anchor, literals);
+        op += literals;
+        if (offset == 0) return true; // last sequence: literals only
+
+        *op++ = uint8_t(offset);
+        *op++ = uint8_t(offset >> 8);
+        match -= kMinMatch;
+        *token |= uint8_t(match < 15 ? match : 15);
+        if (match >= 15) op = WriteLength(op, match - 15);
+        return true;
+    };
+
+    if (size > kMatchLimit)
+    {
+        const size_t matchStartEnd = size - kMatchLimit;
+        const size_t matchEnd = size - kLastLiterals;
+        size_t ip = 0;
+        while (ip < matchStartEnd)
+        {
+            const uint32_t sequence = Read32(src + ip);
+            const uint32_t h = Hash4(sequence);
+            const size_t candidate = table[h];
+            table[h] = uint32_t(ip + 1);
+
+            if (candidate == 0 || ip - (candidate - 1) > kMaxOffset || Read32(src + candidate - 1) != sequence)
+            {
+                ip += 1 + ((ip - anchor) >> 6); // skip faster through data that doesn't match
+                continue;
+            }
+
+            size_t ref = candidate - 1;
+            size_t start = ip;
+            while (start > anchor && ref > 0 && src[start - 1] == src[ref - 1]) { --start; --ref; } // extend back
+            size_t end = ip + kMinMatch;
+            while (end < matchEnd && src[end] == src[ref + (end - start)]) ++end;
+
+            if (!emit(start - anchor, start - ref, end - start)) return 0;
+            anchor = ip = end;
+            if (ip - 2 < matchStartEnd) table[Hash4(Read32(src + ip - 2))] = uint32_t(ip - 2 + 1);
+        }
+    }
+
+    if (!emit(size - anchor, 0, 0)) return 0;
+    return size_t(op - dst);
+}
+
+bool Lz4Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) noexcept
+{
+    const uint8_t* ip = src;
+    const uint8_t* const ipEnd = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* const opEnd = dst + dstSize;
+
+    while (ip < ipEnd)
+    {
+        const uint8_t token = *ip++;
+
+        // Common case, far from both ends: short literals and a short,
+        // non-overlapping match, each moved with one fixed-size copy.
+        if (token < 0xF0 && (token & 15) != 15 && ipEnd - ip >= 32 && opEnd - op >= 40)
+        {
+            const size_t literals = token >> 4;
+            std::memcpy(op, ip, 16);
+            ip += literals;
+            op += literals;
+            const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+            const size_t match = (token & 15) + kMinMatch;
+            if (offset >= 8 && offset <= size_t(op - dst))
+            {
+                ip += 2;
+                const uint8_t* from = op - offset;
+                std::memcpy(op, from, 8);
+                std::memcpy(op + 8, from + 8, 8);
+                std::memcpy(op + 16, from + 16, 2);
+                op += match;
+                continue;
+            }
+            // Overlapping (or invalid) match.
+            ip += 2;
+            if (offset == 0 || offset > size_t(op - dst)) return false;
+            const uint8_t* from = op - offset;
+            for (size_t left = match; left > 0;)
+            {
+                const size_t n = left < size_t(op - from) ? left : size_t(op - from);
+                std::memcpy(op, from, n);
+                op += n;
+                left -= n;
+            }
+            continue;
+        }
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !ReadLength(ip, ipEnd, literals)) return false;
+        if (size_t(ipEnd - ip) < literals || size_t(opEnd - op) < literals) return false;
+        if (literals <= 16 && ipEnd - ip >= 16 && opEnd - op >= 16)
+            std::memcpy(op, ip, 16); // fixed-size copy; the extra bytes get overwritten
+        else if (literals)
+            std::memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == ipEnd) break; // last sequence has no match
+
+        if (ipEnd - ip < 2) return false;
+        const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > size_t(op - dst)) return false;
+
+        size_t match = token & 15;
+        if (match == 15 && !ReadLength(ip, ipEnd, match)) return false;
+        match += kMinMatch;
+        if (size_t(opEnd - op) < match) return false;
+
+        const uint8_t* from = op - offset;
+        if (offset >= 8 && size_t(opEnd - op) >= match + 8)
+        {
+            // 8-byte steps never overlap what they read; may write up to 7 bytes past the match.
+            uint8_t* const end = op + match;
+            for (; op < end; op += 8, from += 8) std::memcpy(op, from, 8);
+            op = end;
+            continue;
+        }
+        // Overlapping copies repeat the last 'offset' bytes; copying from a
+        // fixed source doubles the valid span each round.
+        while (match > 0)
+        {
+            const size_t n = match < size_t(op - from) ? match : size_t(op - from);
+            std::memcpy(op, from, n);
+            op += n;
+            match -= n;
+        }
+    }
+    return op == opEnd;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// LZ4 block format (no frame): byte-oriented LZ77, decoded at memory-copy
+// speed with no tables, so one core unpacks GB/s and independent blocks
+// decode in parallel. Streams are interchangeable with the reference LZ4
+// library's block API (LZ4_compress_default / LZ4_decompress_safe).
+
+// Worst-case compressed size of 'size' bytes.
+constexpr size_t Lz4CompressBound(size_t size) noexcept { return size + size / 255 + 16; }
+
+// Compresses src into dst; returns the compressed size, or 0 if it does not
+// fit in 'capacity' (pass Lz4CompressBound to always succeed, or the source
+// size to learn that the data doesn't compress).
+size_t Lz4Compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) noexcept;
+
+// Decodes exactly 'dstSize' bytes. Bounds-checked: false on corrupt input,
+// never reads or writes outside the two buffers.
+bool Lz4Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) noexcept;
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// Read-only memory mapping of a whole file (MapViewOfFile / mmap). Pages are
+// faulted in on first touch, so opening costs the same for any file size and
+// only what is read gets loaded. The view stays valid until Close(); while it
+// is open the file cannot be rewritten in place on Windows.
+class MappedFile {
+public:
+    MappedFile() noexcept = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const std::filesystem::path& path) noexcept;
+    void Close() noexcept;
+
+    bool           IsOpen() const noexcept { return m_data != nullptr; }
+    const uint8_t* Data() const noexcept { return m_data; }
+    size_t         Size() const noexcept { return m_size; }
+
+private:
+    const uint8_t* m_data{ nullptr };
+    size_t         m_size{ 0 };
+#if defined(_WIN32)
+    void*          m_mapping{ nullptr }; // HANDLE of the file mapping object
+#endif
+};
@@ -0,0 +1,65 @@
+#include "MeshGen.h"
+
+using namespace DirectX;
+
+namespace MeshGen {
+
+GridCounts BuildGridVertices(int halfLines, float spacing, std::vector<Vertex>& out)
+{
+    out.clear();
+    out.reserve(size_t(halfLines * 2 + 1) * 4 + 6);
+
+    const XMFLOAT3 gridColor = { 0.25f, 0.25f, 0.25f };
+    const float extent = float(halfLines) * spacing;
+
+    // Grid lines on XZ plane (y = 0)
+    for (int i = -halfLines; i <= halfLines; ++i)
+    {
+        const float x = float(i) * spacing;
+        const float z = float(i) * spacing;
+
+        // Lines parallel to X axis (vary X, fixed Z)
+        out.push_back({ XMFLOAT3(-extent, 0.0f, z), gridColor, XMFLOAT2(0.0f, 0.0f) });
+        out.push_back({ XMFLOAT3(extent, 0.0f, z), gridColor, XMFLOAT2(1.0f, 0.0f) });
+
+        // Lines parallel to Z axis (vary Z, fixed X)
+        out.push_back({ XMFLOAT3(x, 0.0f, -extent), gridColor, XMFLOAT2(0.0f, 0.0f) });
+        out.push_back({ XMFLOAT3(x, 0.0f,  extent), gridColor, XMFLOAT2(1.0f, 0.0f) });
+    }
+
+    GridCounts counts;
+    counts.gridVertices = static_cast<uint32_t>(out.size());
+
+    const XMFLOAT3 xColor = { 1.0f, 0.0f, 0.0f };
+    const XMFLOAT3 yColor = { 0.0f, 1.0f, 0.0f };
+    const XMFLOAT3 zColor = { 0.0f, 0.0f, 1.0f };
+
+    // X axis
+    out.push_back({ XMFLOAT3(-extent, 0.0f, 0.0f), xColor, XMFLOAT2(0.0f, 0.0f) });
+    out.push_back({ XMFLOAT3(extent, 0.0f, 0.0f), xColor, XMFLOAT2(1.0f, 0.0f) });
+
+    // Z axis
+    out.push_back({ XMFLOAT3(0.0f, 0.0f, -extent), zColor, XMFLOAT2(0.0f, 0.0f) });
+    out.push_back({ XMFLOAT3(0.0f, 0.0f,  extent), zColor, XMFLOAT2(1.0f, 0.0f) });
+
+    // Y axis
+    out.push_back({ XMFLOAT3(0.0f, -extent, 0.0f), yColor, XMFLOAT2(0.0f, 0.0f) });
+    out.push_back({ XMFLOAT3(0.0f,  extent, 0.0f), yColor, XMFLOAT2(0.0f, 1.0f) });
+
+    counts.axisVertices = static_cast<uint32_t>(out.size()) - counts.gridVertices;
+    return counts;
+}
+
+void BuildQuadVertices(float h, Vertex out[kQuadVertexCount]) noexcept
+{
+    //  position                   color                        uv
+    out[0] = { XMFLOAT3(-h,  h, 0.0f), XMFLOAT3(1.0f, 0.0f, 0.0f), XMFLOAT2(0.0f, 0.0f) }; // top-left
+    out[1] = { XMFLOAT3(h,  h, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT2(1.0f, 0.0f) }; // top-right
+    out[2] = { XMFLOAT3(-h, -h, 0.0f), XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT2(0.0f, 1.0f) }; // bottom-left
+
+    out[3] = { XMFLOAT3(-h, -h, 0.0f), XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT2(0.0f, 1.0f) }; // bottom-left
+    out[4] = { XMFLOAT3(h, -h, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f), XMFLOAT2(1.0f, 1.0f) }; // bottom-right
+    out[5] = { XMFLOAT3(h,  h, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT2(1.0f, 0.0f) }; // top-right
+}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CPU-side geometry generation used by the renderer and DXMesh. Kept free
+// of D3D12 so it can be benchmarked and checked without a device; texel data
+// lives in TexelGen.
+namespace MeshGen {
+
+    // Position / color / uv, the layout of ColorVS's input.
+    struct Vertex {
+        DirectX::XMFLOAT3 position;
+        DirectX::XMFLOAT3 color;
+        DirectX::XMFLOAT2 uv;
+    };
+
+    // Line list of the XZ grid followed by the X/Z/Y axis lines.
+    struct GridCounts {
+        uint32_t gridVertices{ 0 };
+        uint32_t axisVertices{ 0 };
+    };
+    GridCounts BuildGridVertices(int halfLines, float spacing, std::vector<Vertex>& out);
+
+    // Two triangles in the XY plane, centered at the origin, [-halfExtent, halfExtent].
+    static constexpr uint32_t kQuadVertexCount = 6;
+    void BuildQuadVertices(float halfExtent, Vertex out[kQuadVertexCount]) noexcept;
+}
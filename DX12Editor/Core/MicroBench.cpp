@@ -0,0 +1,230 @@
+#include "MicroBench.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedNs(Clock::time_point a, Clock::time_point b)
+    {
+        return double(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+    }
+
+    double Median(std::vector<double> v)
+    {
+        if (v.empty()) return 0.0;
+        const size_t mid = v.size() / 2;
+        std::nth_element(v.begin(), v.begin() + mid, v.end());
+        if (v.size() & 1) return v[mid];
+        const double hi = v[mid];
+        return 0.5 * (hi + *std::max_element(v.begin(), v.begin() + mid));
+    }
+
+#ifdef __linux__
+    // cycles / instructions / cache misses / branch misses as one counter group.
+    class PerfCounters {
+    public:
+        static constexpr int kCount = 4;
+
+        PerfCounters()
+        {
+            const uint64_t configs[kCount] = {
+                PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+            for (int i = 0; i < kCount; ++i)
+            {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = configs[i];
+                attr.disabled = (i == 0) ? 1 : 0; // the leader gates the group
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP;
+
+                m_fd[i] = int(syscall(SYS_perf_event_open, &attr, 0, -1, (i == 0) ? -1 : m_fd[0], 0));
+                if (m_fd[i] < 0) { Close(); return; } // no PMU access (container, paranoid level)
+            }
+        }
+        ~PerfCounters() { Close(); }
+
+        bool Valid() const noexcept { return m_fd[0] >= 0; }
+
+        void Start() noexcept
+        {
+            ioctl(m_fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(m_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+
+        bool Stop(uint64_t out[kCount]) noexcept
+        {
+            ioctl(m_fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            uint64_t buf[1 + kCount]{};
+            if (read(m_fd[0], buf, sizeof(buf)) != ssize_t(sizeof(buf)) || buf[0] != kCount)
+                return false;
+            for (int i = 0; i < kCount; ++i) out[i] = buf[1 + i];
+            return true;
+        }
+
+    private:
+        void Close() noexcept
+        {
+            for (int& fd : m_fd)
+            {
+                if (fd >= 0) close(fd);
+                fd = -1;
+            }
+        }
+
+        int m_fd[kCount]{ -1, -1, -1, -1 };
+    };
+#endif
+}
+
+void MicroBench::Add(const char* name, Body body, double budgetNs)
+{
+    m_entries.push_back({ name, std::move(body), budgetNs });
+}
+
+const std::vector<MicroBench::Result>& MicroBench::Run(const Options& options)
+{
+    m_results.clear();
+    const double minSampleNs = options.minSampleMs * 1e6;
+    const uint32_t samples = std::max(options.samples, 1u);
+
+#ifdef __linux__
+    PerfCounters perf;
+#endif
+
+    for (Entry& e : m_entries)
+    {
+        if (!options.filter.empty() && e.name.find(options.filter) == std::string::npos)
+            continue;
+
+        // Calibrate: grow the iteration count until one call lasts minSampleMs.
+        // This also warms caches and branch predictors.
+        uint64_t iterations = 1;
+        for (;;)
+        {
+            const auto t0 = Clock::now();
+            e.body(iterations);
+            const double ns = ElapsedNs(t0, Clock::now());
+            if (ns >= minSampleNs || iterations >= (1ull << 40)) break;
+            const double grow = (ns > 0.0) ? std::min(minSampleNs * 1.2 / ns, 10.0) : 10.0;
+            iterations = std::max(iterations + 1, uint64_t(double(iterations) * grow));
+        }
+
+        Result r;
+        r.name = e.name;
+        r.iterations = iterations;
+        r.samples = samples;
+        r.budgetNs = e.budgetNs;
+
+        std::vector<double> perIter(samples);
+        uint64_t counterSum[4]{};
+        bool counters = true;
+        for (uint32_t s = 0; s < samples; ++s)
+        {
+#ifdef __linux__
+            if (perf.Valid()) perf.Start();
+#endif
+            const auto t0 = Clock::now();
+            e.body(iterations);
+            const auto t1 = Clock::now();
+#ifdef __linux__
+            uint64_t c[4]{};
+            if (perf.Valid() && perf.Stop(c))
+                for (int i = 0; i < 4; ++i) counterSum[i] += c[i];
+            else
+                counters = false;
+#else
+            counters = false;
+#endif
+            perIter[s] = ElapsedNs(t0, t1) / double(iterations);
+        }
+
+        r.medianNs = Median(perIter);
+        std::vector<double> dev(samples);
+        for (uint32_t s = 0; s < samples; ++s) dev[s] = std::abs(perIter[s] - r.medianNs);
+        r.madNs = Median(dev);
+        r.minNs = *std::min_element(perIter.begin(), perIter.end());
+        double sum = 0.0;
+        for (double v : perIter) sum += v;
+        r.meanNs = sum / double(samples);
+
+        if (counters)
+        {
+            const double n = double(iterations) * double(samples);
+            r.hasCounters = true;
+            r.cycles = double(counterSum[0]) / n;
+            r.instructions = double(counterSum[1]) / n;
+            r.cacheMisses = double(counterSum[2]) / n;
+            r.branchMisses = double(counterSum[3]) / n;
+        }
+
+        std::printf("%-40s %12.2f ns  +/- %8.2f (MAD)  [%llu iters x %u]%s\n",
+            r.name.c_str(), r.medianNs, r.madNs, (unsigned long long)r.iterations, r.samples,
+            r.OverBudget() ? "  OVER BUDGET" : "");
+        m_results.push_back(std::move(r));
+    }
+    return m_results;
+}
+
+std::string MicroBench::ToJson() const
+{
+    std::string json = "{\"benchmarks\":[";
+    char buf[512];
+    for (size_t i = 0; i < m_results.size(); ++i)
+    {
+        const Result& r = m_results[i];
+        std::snprintf(buf, sizeof(buf),
+            "%s\n  {\"name\":\"%s\",\"iterations\":%llu,\"samples\":%u,\"median_ns\":%.3f,"
+            "\"mad_ns\":%.3f,\"min_ns\":%.3f,\"mean_ns\":%.3f",
+            i ? "," : "", r.name.c_str(), (unsigned long long)r.iterations, r.samples,
+            r.medianNs, r.madNs, r.minNs, r.meanNs);
+        json += buf;
+        if (r.budgetNs > 0.0)
+        {
+            std::snprintf(buf, sizeof(buf), ",\"budget_ns\":%.3f,\"over_budget\":%s",
+                r.budgetNs, r.OverBudget() ? "true" : "false");
+            json += buf;
+        }
+        if (r.hasCounters)
+        {
+            std::snprintf(buf, sizeof(buf),
+                ",\"cycles\":%.2f,\"instructions\":%.2f,\"ipc\":%.3f,\"cache_misses\":%.4f,\"branch_misses\":%.4f",
+                r.cycles, r.instructions, r.cycles > 0.0 ? r.instructions / r.cycles : 0.0,
+                r.cacheMisses, r.branchMisses);
+            json += buf;
+        }
+        json += "}";
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+bool MicroBench::WriteJson(const char* path) const
+{
+    FILE* f = nullptr;
+#ifdef _WIN32
+    fopen_s(&f, path, "wb");
+#else
+    f = std::fopen(path, "wb");
+#endif
+    if (!f) return false;
+    const std::string json = ToJson();
+    std::fwrite(json.data(), 1, json.size(), f);
+    return std::fclose(f) == 0;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Small microbenchmark harness.
+// Each benchmark body runs 'iterations' times per call; the harness picks the
+// iteration count so one sample lasts at least minSampleMs, takes 'samples'
+// samples and reports median and MAD per iteration (robust against outliers
+// from scheduling / frequency changes). On Linux, hardware counters are read
+// through perf_event_open when the kernel allows it. A benchmark may carry a
+// budget; a median above it is reported and flagged in the result.
+class MicroBench {
+public:
+    using Body = std::function<void(uint64_t iterations)>;
+
+    struct Options {
+        uint32_t    samples{ 31 };
+        double      minSampleMs{ 2.0 };
+        std::string filter; // substring match on the name, empty = all
+    };
+
+    struct Result {
+        std::string name;
+        uint64_t iterations{ 0 };   // per sample
+        uint32_t samples{ 0 };
+        double   medianNs{ 0.0 };   // per iteration
+        double   madNs{ 0.0 };      // median absolute deviation
+        double   minNs{ 0.0 };
+        double   meanNs{ 0.0 };
+        double   budgetNs{ 0.0 };   // 0 = none
+
+        bool OverBudget() const noexcept { return budgetNs > 0.0 && medianNs > budgetNs; }
+
+        bool     hasCounters{ false }; // per iteration, summed over all samples
+        double   cycles{ 0.0 };
+        double   instructions{ 0.0 };
+        double   cacheMisses{ 0.0 };
+        double   branchMisses{ 0.0 };
+    };
+
+    void Add(const char* name, Body body, double budgetNs = 0.0);
+
+    const std::vector<Result>& Run(const Options& options);
+    const std::vector<Result>& Results() const noexcept { return m_results; }
+
+    std::string ToJson() const;
+    bool WriteJson(const char* path) const;
+
+    // Keeps 'value' (and the work producing it) alive through the optimizer.
+    template <typename T>
+    static void DoNotOptimize(const T& value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        s_sink = reinterpret_cast<const volatile char*>(&value);
+#endif
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        Body body;
+        double budgetNs;
+    };
+
+    std::vector<Entry>  m_entries;
+    std::vector<Result> m_results;
+
+#if !defined(__GNUC__) && !defined(__clang__)
+    static inline const volatile char* volatile s_sink = nullptr;
+#endif
+};
@@ -0,0 +1,341 @@
+#include "PackFile.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+
+#include "Hash.h"
+#include "JobSystem.h"
+#include "Lz4.h"
+
+using namespace PackFormat;
+
+namespace {
+    bool Fail(std::string* error, std::string message)
+    {
+        if (error) *error = std::move(message);
+        return false;
+    }
+
+    std::FILE* OpenForWrite(const std::filesystem::path& path)
+    {
+#if defined(_WIN32)
+        std::FILE* f = nullptr;
+        return (_wfopen_s(&f, path.c_str(), L"wb") == 0) ? f : nullptr;
+#else
+        return std::fopen(path.c_str(), "wb");
+#endif
+    }
+
+    bool Write(std::FILE* f, const void* data, size_t size)
+    {
+        return size == 0 || std::fwrite(data, 1, size, f) == size;
+    }
+
+    bool NameLess(const PackEntry& a, std::string_view aName, const PackEntry& b, std::string_view bName) noexcept
+    {
+        return a.nameHash != b.nameHash ? a.nameHash < b.nameHash : aName < bName;
+    }
+
+    // Runs fn(i) for i in [0, count), across the job system when there is
+    // enough to split.
+    template <typename Fn>
+    void ForEach(JobSystem* jobs, size_t count, const Fn& fn)
+    {
+        if (!jobs || count < 2)
+        {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+        jobs->ParallelFor(count, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) fn(i);
+        });
+    }
+}
+
+// ====================================================
+// Reader
+// ====================================================
+bool PackReader::Open(const std::filesystem::path& path, std::string* error) noexcept
+{
+    Close();
+    if (!m_file.Open(path)) return Fail(error, "cannot open " + path.string());
+
+    const uint8_t* base = m_file.Data();
+    const uint64_t size = m_file.Size();
+    auto bad = [&](const char* what) {
+        Close();
+        return Fail(error, std::string("not a valid pack: ") + what);
+    };
+
+    if (size < sizeof(PackHeader)) return bad("too small");
+    const PackHeader* h = reinterpret_cast<const PackHeader*>(base);
+    if (h->magic != kMagic || h->version != kVersion || h->headerSize != sizeof(PackHeader)) return bad("header");
+    if (h->blockSize == 0 || h->fileSize > size) return bad("header");
+
+    const uint64_t tocSize = uint64_t(h->entryCount) * sizeof(PackEntry) + uint64_t(h->blockCount) * sizeof(PackBlock) + h->namesSize;
+    if (h->tocSize != tocSize || h->tocOffset < sizeof(PackHeader) || h->tocOffset > h->fileSize || h->fileSize - h->tocOffset < tocSize)
+        return bad("table of contents bounds");
+    if (h->tocOffset % alignof(PackEntry) != 0) return bad("table of contents alignment"); // entries are read in place
+    if (Hash64(base + h->tocOffset, size_t(tocSize)) != h->tocHash) return bad("table of contents hash");
+
+    const PackEntry* entries = reinterpret_cast<const PackEntry*>(base + h->tocOffset);
+    const PackBlock* blocks = reinterpret_cast<const PackBlock*>(entries + h->entryCount);
+    const char* names = reinterpret_cast<const char*>(blocks + h->blockCount);
+
+    // Everything Read() trusts later: block ranges, names, stored extents.
+    for (uint32_t i = 0; i < h->entryCount; ++i)
+    {
+        const PackEntry& e = entries[i];
+        if (uint64_t(e.nameOffset) + e.nameLength > h->namesSize) return bad("entry name");
+        if (e.blockCount != (e.size + h->blockSize - 1) / h->blockSize) return bad("entry block count");
+        if (uint64_t(e.firstBlock) + e.blockCount > h->blockCount) return bad("entry blocks");
+    }
+    for (uint32_t i = 0; i < h->blockCount; ++i)
+    {
+        const PackBlock& b = blocks[i];
+        if (b.offset < sizeof(PackHeader) || b.offset > h->tocOffset || h->tocOffset - b.offset < b.storedSize)
+            return bad("block extent");
+        if (b.encoding != PackBlock::kLz4 && b.encoding != PackBlock::kRaw) return bad("block encoding");
+    }
+
+    m_header = h;
+    m_entries = entries;
+    m_blocks = blocks;
+    m_names = names;
+    return true;
+}
+
+void PackReader::Close() noexcept
+{
+    m_file.Close();
+    m_header = nullptr;
+    m_entries = nullptr;
+    m_blocks = nullptr;
+    m_names = nullptr;
+}
+
+std::string_view PackReader::Name(const PackEntry& entry) const noexcept
+{
+    return std::string_view(m_names + entry.nameOffset, entry.nameLength);
+}
+
+const PackEntry* PackReader::Find(std::string_view name) const noexcept
+{
+    if (!IsOpen()) return nullptr;
+    PackEntry key{};
+    key.nameHash = Hash64(name.data(), name.size());
+
+    const PackEntry* end = m_entries + m_header->entryCount;
+    const PackEntry* it = std::lower_bound(m_entries, end, key, [&](const PackEntry& a, const PackEntry& b) {
+        return NameLess(a, Name(a), b, name);
+    });
+    return (it != end && it->nameHash == key.nameHash && Name(*it) == name) ? it : nullptr;
+}
+
+bool PackReader::DecodeBlock(const PackEntry& entry, uint32_t block, uint8_t* dst) const noexcept
+{
+    const PackBlock& b = m_blocks[entry.firstBlock + block];
+    const uint64_t begin = uint64_t(block) * m_header->blockSize;
+    const size_t rawSize = size_t((std::min)(entry.size - begin, uint64_t(m_header->blockSize)));
+    const uint8_t* src = m_file.Data() + b.offset;
+
+    if (b.encoding == PackBlock::kRaw)
+    {
+        if (b.storedSize != rawSize) return false;
+        std::memcpy(dst + begin, src, rawSize);
+        return true;
+    }
+    return Lz4Decompress(src, b.storedSize, dst + begin, rawSize);
+}
+
+bool PackReader::Read(const PackEntry& entry, uint8_t* dst, JobSystem* jobs) const
+{
+    const PackEntry* entries[] = { &entry };
+    return ReadMany(entries, &dst, 1, jobs);
+}
+
+bool PackReader::Read(const PackEntry& entry, std::vector<uint8_t>& data, JobSystem* jobs) const
+{
+    data.resize(size_t(entry.size));
+    return Read(entry, data.data(), jobs);
+}
+
+bool PackReader::ReadMany(const PackEntry* const* entries, uint8_t* const* dsts, size_t count, JobSystem* jobs) const
+{
+    // Flatten to (entry, block) pairs so each job item is one block.
+    std::vector<std::pair<uint32_t, uint32_t>> work;
+    for (size_t i = 0; i < count; ++i)
+        for (uint32_t b = 0; b < entries[i]->blockCount; ++b)
+            work.emplace_back(uint32_t(i), b);
+
+    std::atomic<bool> ok{ true };
+    ForEach(jobs, work.size(), [&](size_t i) {
+        const auto [entry, block] = work[i];
+        if (!DecodeBlock(*entries[entry], block, dsts[entry])) ok.store(false, std::memory_order_relaxed);
+    });
+    if (!ok.load()) return false;
+
+    // A raw block or a well-formed LZ4 stream decodes whatever bytes it holds;
+    // only the content hash catches a flipped byte.
+    ForEach(jobs, count, [&](size_t i) {
+        if (Hash64(dsts[i], size_t(entries[i]->size)) != entries[i]->contentHash)
+            ok.store(false, std::memory_order_relaxed);
+    });
+    return ok.load();
+}
+
+bool PackReader::Validate(JobSystem* jobs, std::string* error) const
+{
+    if (!IsOpen()) return Fail(error, "not open");
+    for (uint32_t i = 1; i < m_header->entryCount; ++i)
+        if (!NameLess(m_entries[i - 1], Name(m_entries[i - 1]), m_entries[i], Name(m_entries[i])))
+            return Fail(error, "entries not sorted or duplicate: " + std::string(Name(m_entries[i])));
+
+    std::vector<uint8_t> data;
+    for (uint32_t i = 0; i < m_header->entryCount; ++i)
+    {
+        const PackEntry& e = m_entries[i];
+        if (Hash64(Name(e).data(), e.nameLength) != e.nameHash)
+            return Fail(error, "name hash mismatch: " + std::string(Name(e)));
+        if (!Read(e, data, jobs))
+            return Fail(error, "corrupt block or content hash mismatch: " + std::string(Name(e)));
+    }
+    return true;
+}
+
+// ====================================================
+// Writer
+// ====================================================
+bool WritePackFile(const std::filesystem::path& path, const std::vector<PackSource>& sources,
+    const PackWriteOptions& options, JobSystem* jobs, PackWriteStats* stats, std::string* error)
+{
+    const uint32_t blockSize = options.blockSize;
+    if (blockSize == 0) return Fail(error, "block size must not be 0");
+
+    // Table of contents in name order.
+    std::vector<PackEntry> entries(sources.size());
+    std::vector<uint32_t> order(sources.size());
+    std::string names;
+    uint32_t blockCount = 0;
+    for (uint32_t i = 0; i < sources.size(); ++i)
+    {
+        const PackSource& s = sources[i];
+        PackEntry& e = entries[i];
+        e.nameHash = Hash64(s.name.data(), s.name.size());
+        e.size = s.data.size();
+        e.contentHash = Hash64(s.data.data(), s.data.size());
+        e.nameOffset = uint32_t(names.size());
+        e.nameLength = uint32_t(s.name.size());
+        e.blockCount = uint32_t((e.size + blockSize - 1) / blockSize);
+        names += s.name;
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return NameLess(entries[a], sources[a].name, entries[b], sources[b].name);
+    });
+    for (size_t i = 1; i < order.size(); ++i)
+        if (sources[order[i - 1]].name == sources[order[i]].name)
+            return Fail(error, "duplicate name: " + sources[order[i]].name);
+
+    std::vector<PackEntry> sorted;
+    sorted.reserve(entries.size());
+    for (uint32_t i : order)
+    {
+        sorted.push_back(entries[i]);
+        sorted.back().firstBlock = blockCount;
+        blockCount += sorted.back().blockCount;
+    }
+
+    // Compress every block independently (in parallel), keep raw when it doesn't shrink.
+    struct Work { uint32_t source; uint32_t block; };
+    std::vector<Work> work;
+    work.reserve(blockCount);
+    for (uint32_t i : order)
+        for (uint32_t b = 0; b < entries[i].blockCount; ++b)
+            work.push_back({ i, b });
+
+    std::vector<std::vector<uint8_t>> stored(blockCount);
+    std::vector<PackBlock> blocks(blockCount);
+    ForEach(jobs, work.size(), [&](size_t i) {
+        const std::vector<uint8_t>& data = sources[work[i].source].data;
+        const size_t begin = size_t(work[i].block) * blockSize;
+        const size_t size = (std::min)(data.size() - begin, size_t(blockSize));
+        const uint8_t* src = data.data() + begin;
+
+        std::vector<uint8_t>& out = stored[i];
+        size_t packed = 0;
+        if (options.compress)
+        {
+            out.resize(size);
+            packed = Lz4Compress(src, size, out.data(), size - size / 16); // must save >= 1/16
+        }
+        if (packed == 0) out.assign(src, src + size);
+        else             out.resize(packed);
+        blocks[i].storedSize = uint32_t(out.size());
+        blocks[i].encoding = packed ? PackBlock::kLz4 : PackBlock::kRaw;
+    });
+
+    PackHeader header{};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.headerSize = sizeof(PackHeader);
+    header.entryCount = uint32_t(sorted.size());
+    header.blockCount = blockCount;
+    header.blockSize = blockSize;
+    header.namesSize = uint32_t(names.size());
+
+    uint64_t offset = sizeof(PackHeader);
+    PackWriteStats s;
+    s.entries = header.entryCount;
+    s.blocks = blockCount;
+    for (uint32_t i = 0; i < blockCount; ++i)
+    {
+        blocks[i].offset = offset;
+        offset += blocks[i].storedSize;
+        s.storedBytes += blocks[i].storedSize;
+        s.rawBlocks += blocks[i].encoding == PackBlock::kRaw;
+    }
+    for (const PackSource& src : sources) s.rawBytes += src.data.size();
+
+    // Hash the table of contents as it will be laid out in the file.
+    // The table of contents is used in place: align it for its uint64_t fields.
+    const uint64_t padding = (kTocAlign - offset % kTocAlign) % kTocAlign;
+    offset += padding;
+
+    std::vector<uint8_t> toc(sorted.size() * sizeof(PackEntry) + blocks.size() * sizeof(PackBlock) + names.size());
+    uint8_t* t = toc.data();
+    if (!sorted.empty()) std::memcpy(t, sorted.data(), sorted.size() * sizeof(PackEntry));
+    t += sorted.size() * sizeof(PackEntry);
+    if (!blocks.empty()) std::memcpy(t, blocks.data(), blocks.size() * sizeof(PackBlock));
+    t += blocks.size() * sizeof(PackBlock);
+    if (!names.empty()) std::memcpy(t, names.data(), names.size());
+
+    header.tocOffset = offset;
+    header.tocSize = toc.size();
+    header.tocHash = Hash64(toc.data(), toc.size());
+    header.fileSize = offset + toc.size();
+
+    std::filesystem::path tmp = path;
+    tmp += ".tmp";
+    std::FILE* f = OpenForWrite(tmp);
+    if (!f) return Fail(error, "cannot create " + tmp.string());
+    bool ok = Write(f, &header, sizeof(header));
+    for (const std::vector<uint8_t>& b : stored) ok = ok && Write(f, b.data(), b.size());
+    const uint8_t zeros[kTocAlign] = {};
+    ok = ok && Write(f, zeros, size_t(padding)) && Write(f, toc.data(), toc.size());
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok)
+    {
+        std::error_code ec;
+        std::filesystem::remove(tmp, ec);
+        return Fail(error, "write failed: " + tmp.string());
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) return Fail(error, "cannot replace " + path.string() + ": " + ec.message());
+    if (stats) *stats = s;
+    return true;
+}
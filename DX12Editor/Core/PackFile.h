@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+#include "PackFormat.h"
+
+class JobSystem;
+
+// Read side of asset packs: maps the file, checks the table of contents,
+// finds entries by name and decompresses them, block-parallel on the job
+// system when given one. One open and one mapping replace a file open per
+// asset; the stored bytes are usually well under half of the loose files.
+class PackReader {
+public:
+    bool Open(const std::filesystem::path& path, std::string* error = nullptr) noexcept;
+    void Close() noexcept;
+    bool IsOpen() const noexcept { return m_header != nullptr; }
+
+    // Full check: name order and hashes, then every entry read (which
+    // compares the content hashes).
+    bool Validate(JobSystem* jobs = nullptr, std::string* error = nullptr) const;
+
+    const PackFormat::PackHeader& Header() const noexcept { return *m_header; }
+    uint32_t EntryCount() const noexcept { return m_header->entryCount; }
+    const PackFormat::PackEntry& Entry(uint32_t index) const noexcept { return m_entries[index]; }
+    const PackFormat::PackBlock& Block(uint32_t index) const noexcept { return m_blocks[index]; }
+    std::string_view Name(const PackFormat::PackEntry& entry) const noexcept;
+
+    // Entry by its '/'-separated name, null if absent.
+    const PackFormat::PackEntry* Find(std::string_view name) const noexcept;
+
+    // Decompresses 'entry' into dst (entry.size bytes). False on corrupt data,
+    // including a content hash that does not match.
+    bool Read(const PackFormat::PackEntry& entry, uint8_t* dst, JobSystem* jobs = nullptr) const;
+    bool Read(const PackFormat::PackEntry& entry, std::vector<uint8_t>& data, JobSystem* jobs = nullptr) const;
+
+    // Several entries at once, their blocks spread over the job system as one
+    // range: what startup loads use so small assets also run in parallel.
+    bool ReadMany(const PackFormat::PackEntry* const* entries, uint8_t* const* dsts, size_t count,
+        JobSystem* jobs = nullptr) const;
+
+private:
+    bool DecodeBlock(const PackFormat::PackEntry& entry, uint32_t block, uint8_t* dst) const noexcept;
+
+private:
+    MappedFile m_file;
+    const PackFormat::PackHeader* m_header{ nullptr };
+    const PackFormat::PackEntry*  m_entries{ nullptr };
+    const PackFormat::PackBlock*  m_blocks{ nullptr };
+    const char*                   m_names{ nullptr };
+};
+
+// One file to pack: its name inside the pack and its bytes.
+struct PackSource {
+    std::string          name;
+    std::vector<uint8_t> data;
+};
+
+struct PackWriteOptions {
+    uint32_t blockSize{ PackFormat::kDefaultBlockSize };
+    bool     compress{ true };
+};
+
+struct PackWriteStats {
+    uint32_t entries{ 0 };
+    uint32_t blocks{ 0 };
+    uint32_t rawBlocks{ 0 };      // stored uncompressed
+    uint64_t rawBytes{ 0 };
+    uint64_t storedBytes{ 0 };
+};
+
+// Writes a pack of 'sources' (names must be unique), compressing blocks on
+// the job system when given one. Writes a temporary file, then replaces 'path'.
+bool WritePackFile(const std::filesystem::path& path, const std::vector<PackSource>& sources,
+    const PackWriteOptions& options = {}, JobSystem* jobs = nullptr,
+    PackWriteStats* stats = nullptr, std::string* error = nullptr);
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+
+// On-disk layout of an asset pack (.pack). Little-endian plain structs, used
+// straight from a memory mapping like the scene format.
+//
+//   PackHeader                           at 0
+//   block payloads                       back to back
+//   zero padding                         to kTocAlign
+//   PackEntry[entryCount]                at tocOffset, sorted by (nameHash, name)
+//   PackBlock[blockCount]                after the entries
+//   names                                UTF-8, '/'-separated relative paths
+//
+// Every entry is cut into blocks of blockSize uncompressed bytes (the last
+// one shorter), each compressed on its own (LZ4 block format) or stored raw
+// when that does not pay. Blocks are independent, so one large entry or many
+// small ones decode in parallel. Lookups binary-search the name hashes.
+namespace PackFormat {
+
+    constexpr uint32_t kMagic = 0x4B505844u; // "DXPK"
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kDefaultBlockSize = 64 * 1024;
+    constexpr uint32_t kTocAlign = alignof(uint64_t); // entries and blocks are read in place
+
+    struct PackHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerSize;      // sizeof(PackHeader)
+        uint32_t entryCount;
+        uint32_t blockCount;
+        uint32_t blockSize;
+        uint32_t namesSize;
+        uint32_t reserved;
+        uint64_t tocOffset;       // entries, blocks, names; a multiple of kTocAlign
+        uint64_t tocSize;
+        uint64_t tocHash;         // Hash64 of the table of contents
+        uint64_t fileSize;
+    };
+    static_assert(sizeof(PackHeader) == 64, "PackHeader layout");
+
+    struct PackEntry {
+        uint64_t nameHash;        // Hash64 of the name
+        uint64_t size;            // uncompressed bytes
+        uint64_t contentHash;     // Hash64 of the uncompressed bytes
+        uint32_t nameOffset;      // into the names
+        uint32_t nameLength;
+        uint32_t firstBlock;
+        uint32_t blockCount;      // ceil(size / blockSize)
+    };
+    static_assert(sizeof(PackEntry) == 40, "PackEntry layout");
+
+    struct PackBlock {
+        enum : uint32_t { kLz4 = 0, kRaw = 1 };
+
+        uint64_t offset;          // file offset of the stored bytes
+        uint32_t storedSize;
+        uint32_t encoding;
+    };
+    static_assert(sizeof(PackBlock) == 16, "PackBlock layout");
+    static_assert(alignof(PackEntry) <= kTocAlign && alignof(PackBlock) <= kTocAlign &&
+        sizeof(PackEntry) % alignof(PackBlock) == 0, "blocks follow the entries aligned");
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "DerivedDataCache.h"
+
+// Keys are derived-data keys: a 128-bit hash of everything the pipeline
+// object is built from (shader bytecode, fixed-function state, formats,
+// root signature), so two identical descriptions share one object.
+using PipelineKey = DerivedDataCache::Key;
+using PipelineKeyBuilder = DerivedDataCache::KeyBuilder;
+
+// Where a pipeline came from on a miss.
+enum class PipelineSource : uint8_t {
+    Failed,
+    Library,   // loaded from the persistent library (no driver compile)
+    Created,   // compiled from scratch
+};
+
+struct PipelineCacheStats {
+    uint64_t requests{ 0 };
+    uint64_t memoryHits{ 0 };
+    uint64_t libraryHits{ 0 };
+    uint64_t created{ 0 };
+    uint64_t failed{ 0 };
+    double   libraryMs{ 0.0 };  // total time of library loads
+    double   createMs{ 0.0 };   // total time of compiles
+
+    // Requests served without compiling.
+    double HitRate() const noexcept
+    {
+        return requests ? double(memoryHits + libraryHits) / double(requests) : 0.0;
+    }
+};
+
+// API-neutral lookup layer: one pipeline object per key in memory; a miss
+// runs the build function, which loads from the backend's library or
+// compiles and reports which it did. Kept free of D3D12 so the hashing and
+// lookup can be exercised headlessly (Tools/PipelineCacheTool.cpp).
+template <typename Pipeline>
+class PipelineCache {
+public:
+    using BuildFn = std::function<PipelineSource(Pipeline& out)>;
+
+    bool Get(const PipelineKey& key, Pipeline& out, const BuildFn& build)
+    {
+        ++m_stats.requests;
+        auto it = m_pipelines.find(key);
+        if (it != m_pipelines.end())
+        {
+            ++m_stats.memoryHits;
+            out = it->second;
+            return true;
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        const PipelineSource source = build(out);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        switch (source)
+        {
+        case PipelineSource::Library: ++m_stats.libraryHits; m_stats.libraryMs += ms; break;
+        case PipelineSource::Created: ++m_stats.created;     m_stats.createMs += ms;  break;
+        case PipelineSource::Failed:  ++m_stats.failed;      return false;
+        }
+        m_pipelines.emplace(key, out);
+        return true;
+    }
+
+    bool Contains(const PipelineKey& key) const { return m_pipelines.count(key) != 0; }
+    size_t Size() const noexcept { return m_pipelines.size(); }
+    const PipelineCacheStats& GetStats() const noexcept { return m_stats; }
+
+    void Clear()
+    {
+        m_pipelines.clear();
+        m_stats = {};
+    }
+
+private:
+    std::unordered_map<PipelineKey, Pipeline, DerivedDataCache::KeyHash> m_pipelines;
+    PipelineCacheStats m_stats;
+};
@@ -0,0 +1,249 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "imgui/imgui.h"
+
+Profiler& Profiler::Get() noexcept
+{
+    static Profiler s_profiler;
+    return s_profiler;
+}
+
+uint64_t Profiler::NowNs() noexcept
+{
+    // steady_clock is QPC on MSVC and CLOCK_MONOTONIC on Linux.
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+Profiler::Profiler() noexcept
+{
+    m_originTicks = Ticks();
+    m_originNs = NowNs();
+}
+
+void Profiler::UpdateTickRate() const noexcept
+{
+#if defined(_M_X64) || defined(__x86_64__)
+    // Re-estimate the TSC rate from the time elapsed since startup (invariant TSC).
+    const uint64_t nowTicks = Ticks();
+    const uint64_t nowNs = NowNs();
+    if (nowTicks > m_originTicks && nowNs - m_originNs > 1000000)
+        m_nsPerTick.store(double(nowNs - m_originNs) / double(nowTicks - m_originTicks), std::memory_order_relaxed);
+#endif
+}
+
+uint64_t Profiler::TicksToNs(uint64_t ticks) const noexcept
+{
+#if defined(_M_X64) || defined(__x86_64__)
+    const double rate = m_nsPerTick.load(std::memory_order_relaxed);
+    return m_originNs + uint64_t(double(int64_t(ticks - m_originTicks)) * rate);
+#else
+    return ticks;
+#endif
+}
+
+Profiler::ThreadBuffer* Profiler::RegisterThread() noexcept
+{
+    auto buf = std::make_unique<ThreadBuffer>();
+    std::lock_guard<std::mutex> lock(m_threadsMutex);
+    buf->index = uint32_t(m_threads.size());
+    std::snprintf(buf->name, sizeof(buf->name), "Thread %u", buf->index);
+    t_current = buf.get();
+    m_threads.push_back(std::move(buf)); // buffers live as long as the profiler
+    return t_current;
+}
+
+void Profiler::SetThreadName(const char* name) noexcept
+{
+    ThreadBuffer* buf = ThisThread();
+    std::snprintf(buf->name, sizeof(buf->name), "%s", name);
+}
+
+void Profiler::BeginFrame() noexcept
+{
+    if (IsPaused())
+        return;
+
+    const uint64_t n = m_frameCount.load(std::memory_order_relaxed);
+    m_frameStarts[n % kFrameHistory] = Ticks();
+    m_frameCount.store(n + 1, std::memory_order_release);
+}
+
+void Profiler::GetFrames(std::vector<uint64_t>& outStarts) const
+{
+    outStarts.clear();
+    UpdateTickRate();
+    const uint64_t n = m_frameCount.load(std::memory_order_acquire);
+    const uint64_t first = (n > kFrameHistory) ? n - kFrameHistory : 0;
+    for (uint64_t i = first; i < n; ++i)
+        outStarts.push_back(TicksToNs(m_frameStarts[i % kFrameHistory]));
+}
+
+void Profiler::Collect(uint64_t fromNs, uint64_t toNs, std::vector<ProfileZone>& out) const
+{
+    UpdateTickRate();
+    std::lock_guard<std::mutex> lock(m_threadsMutex);
+    for (const auto& t : m_threads)
+    {
+        const uint64_t end = t->writePos.load(std::memory_order_acquire);
+        const uint64_t begin = (end > kZonesPerThread) ? end - kZonesPerThread : 0;
+
+        // Seqlock read: a slot counts only if it still holds ring position i,
+        // completely written, both before and after its fields were copied.
+        for (uint64_t i = begin; i < end; ++i)
+        {
+            const ZoneSlot& slot = t->zones[i & (kZonesPerThread - 1)];
+            const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq != 2 * i + 2)
+                continue;
+            ProfileZone z;
+            z.name = slot.name.load(std::memory_order_relaxed);
+            z.beginNs = slot.beginTicks.load(std::memory_order_relaxed);
+            z.endNs = slot.endTicks.load(std::memory_order_relaxed);
+            z.depth = slot.depth.load(std::memory_order_relaxed);
+            z.thread = t->index;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != seq)
+                continue; // overwritten while copying
+
+            z.beginNs = TicksToNs(z.beginNs);
+            z.endNs = TicksToNs(z.endNs);
+            if (z.endNs > fromNs && z.beginNs < toNs)
+                out.push_back(z);
+        }
+    }
+}
+
+bool Profiler::ExportChromeTrace(const char* path) const
+{
+    FILE* f = nullptr;
+#ifdef _WIN32
+    fopen_s(&f, path, "wb");
+#else
+    f = std::fopen(path, "wb");
+#endif
+    if (!f) return false;
+
+    std::vector<ProfileZone> zones;
+    Collect(0, UINT64_MAX, zones);
+    std::sort(zones.begin(), zones.end(),
+        [](const ProfileZone& a, const ProfileZone& b) { return a.beginNs < b.beginNs; });
+
+    const uint64_t origin = zones.empty() ? 0 : zones.front().beginNs;
+
+    std::fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        for (const auto& t : m_threads)
+        {
+            std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", t->index, t->name);
+            first = false;
+        }
+    }
+    // Complete events ("X"): ts/dur are microseconds with ns precision.
+    for (const ProfileZone& z : zones)
+    {
+        std::fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            first ? "" : ",\n", z.name, z.thread,
+            double(z.beginNs - origin) / 1000.0, double(z.endNs - z.beginNs) / 1000.0);
+        first = false;
+    }
+    std::fprintf(f, "\n]}\n");
+    return std::fclose(f) == 0;
+}
+
+void Profiler::DrawWindow(bool* open)
+{
+    if (!ImGui::Begin("Profiler", open))
+    {
+        ImGui::End();
+        return;
+    }
+
+    bool paused = IsPaused();
+    if (ImGui::Checkbox("Pause", &paused))
+        SetPaused(paused);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    ImGui::SliderInt("Frames", &m_viewFrames, 1, 32);
+    ImGui::SameLine();
+    if (ImGui::Button("Export trace"))
+        ExportChromeTrace("profile_trace.json");
+
+    // Window = last m_viewFrames complete frames.
+    std::vector<uint64_t> frames;
+    GetFrames(frames);
+    if (frames.size() < 2)
+    {
+        ImGui::TextUnformatted("Waiting for frames...");
+        ImGui::End();
+        return;
+    }
+
+    const size_t last = frames.size() - 1;
+    const size_t first = (last > size_t(m_viewFrames)) ? last - size_t(m_viewFrames) : 0;
+    const uint64_t t0 = frames[first];
+    const uint64_t t1 = frames[last];
+    const double spanNs = double(std::max<uint64_t>(t1 - t0, 1));
+
+    ImGui::Text("%zu frames, %.3f ms", last - first, spanNs / 1e6);
+
+    std::vector<ProfileZone> zones;
+    Collect(t0, t1, zones);
+
+    uint32_t maxThread = 0, maxDepth = 0;
+    for (const ProfileZone& z : zones)
+    {
+        maxThread = std::max(maxThread, z.thread);
+        maxDepth = std::max(maxDepth, z.depth);
+    }
+
+    // Flame graph: one lane per thread, one row per nesting depth.
+    const float rowH = ImGui::GetTextLineHeight() + 2.0f;
+    const float laneH = rowH * float(maxDepth + 1) + 6.0f;
+    const float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImDrawList* dl = ImGui::GetWindowDrawList();
+
+    ImGui::InvisibleButton("##timeline", ImVec2(width, laneH * float(maxThread + 1)));
+    const bool hovered = ImGui::IsItemHovered();
+    const ImVec2 mouse = ImGui::GetIO().MousePos;
+
+    auto toX = [&](uint64_t ns) {
+        const double t = (double(std::clamp(ns, t0, t1)) - double(t0)) / spanNs;
+        return origin.x + float(t) * width;
+    };
+
+    // Frame boundaries
+    for (size_t i = first; i <= last; ++i)
+    {
+        const float x = toX(frames[i]);
+        dl->AddLine(ImVec2(x, origin.y), ImVec2(x, origin.y + laneH * float(maxThread + 1)), IM_COL32(255, 255, 255, 60));
+    }
+
+    for (const ProfileZone& z : zones)
+    {
+        const float x0 = toX(z.beginNs);
+        const float x1 = std::max(toX(z.endNs), x0 + 1.0f);
+        const float y0 = origin.y + laneH * float(z.thread) + rowH * float(z.depth);
+        const float y1 = y0 + rowH - 1.0f;
+
+        // Stable colour per zone name.
+        const uint32_t h = uint32_t(reinterpret_cast<uintptr_t>(z.name) * 2654435761u);
+        const ImU32 col = IM_COL32(80 + (h & 0x7F), 80 + ((h >> 8) & 0x7F), 80 + ((h >> 16) & 0x7F), 255);
+
+        dl->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), col);
+        if (x1 - x0 > ImGui::CalcTextSize(z.name).x + 4.0f)
+            dl->AddText(ImVec2(x0 + 2.0f, y0), IM_COL32_BLACK, z.name);
+
+        if (hovered && mouse.x >= x0 && mouse.x < x1 && mouse.y >= y0 && mouse.y < y1)
+            ImGui::SetTooltip("%s\n%.3f ms", z.name, double(z.endNs - z.beginNs) / 1e6);
+    }
+
+    ImGui::End();
+}
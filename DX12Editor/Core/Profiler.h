@@ -0,0 +1,168 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Hierarchical CPU profiler.
+// Zones are recorded into one ring buffer per thread (single writer, lock-free),
+// frames are delimited by PROFILE_FRAME(). Build with DXE_PROFILER=0 to compile
+// every macro away. While paused, new zones are not recorded at all.
+#ifndef DXE_PROFILER
+#define DXE_PROFILER 1
+#endif
+
+// Rings store raw ticks; Collect() hands zones out in nanoseconds.
+struct ProfileZone {
+    const char* name;   // must be a string literal / static storage
+    uint64_t beginNs;
+    uint64_t endNs;
+    uint32_t depth;     // nesting level inside its thread
+    uint32_t thread;    // index of the recording thread
+};
+
+class Profiler {
+public:
+    static constexpr uint32_t kZonesPerThread = 1u << 15; // ring size, power of two
+    static constexpr uint32_t kFrameHistory = 256;
+
+    static Profiler& Get() noexcept;
+    static uint64_t NowNs() noexcept;
+
+    // Cheapest monotonic counter available: TSC on x64, steady_clock elsewhere.
+    static uint64_t Ticks() noexcept
+    {
+#if defined(_M_X64) || defined(__x86_64__)
+        return __rdtsc();
+#else
+        return NowNs();
+#endif
+    }
+    uint64_t TicksToNs(uint64_t ticks) const noexcept;
+
+    // One ring entry, guarded by a sequence number so Collect() never keeps
+    // a zone the writer was overwriting while it was copied: 'seq' is
+    // 2*pos+1 while ring position 'pos' is being written, 2*pos+2 once done.
+    struct ZoneSlot {
+        std::atomic<uint64_t> seq{ 0 };
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<uint64_t> beginTicks{ 0 };
+        std::atomic<uint64_t> endTicks{ 0 };
+        std::atomic<uint32_t> depth{ 0 };
+    };
+
+    // Per-thread ring; only the owning thread writes.
+    struct ThreadBuffer {
+        ZoneSlot zones[kZonesPerThread];
+        std::atomic<uint64_t> writePos{ 0 };
+        uint32_t depth{ 0 };
+        uint32_t index{ 0 };
+        char name[32]{};
+    };
+
+    ThreadBuffer* ThisThread() noexcept { return t_current ? t_current : RegisterThread(); }
+    void SetThreadName(const char* name) noexcept;
+
+    void BeginFrame() noexcept;
+
+    // Frame start timestamps, oldest first (up to kFrameHistory).
+    void GetFrames(std::vector<uint64_t>& outStarts) const;
+
+    // Copies every zone that overlaps [fromNs, toNs) out of all thread rings.
+    void Collect(uint64_t fromNs, uint64_t toNs, std::vector<ProfileZone>& out) const;
+
+    // Chrome trace / Perfetto JSON of the recorded history.
+    bool ExportChromeTrace(const char* path) const;
+
+    // ImGui timeline of the last 'frames' frames.
+    void DrawWindow(bool* open);
+
+    bool IsPaused() const noexcept { return m_paused.load(std::memory_order_relaxed); }
+    void SetPaused(bool paused) noexcept { m_paused.store(paused, std::memory_order_relaxed); }
+
+private:
+    Profiler() noexcept;
+    ThreadBuffer* RegisterThread() noexcept;
+    void UpdateTickRate() const noexcept;
+
+private:
+    static inline thread_local ThreadBuffer* t_current = nullptr;
+
+    // Tick -> ns mapping, refined against steady_clock as time passes.
+    uint64_t m_originTicks{ 0 };
+    uint64_t m_originNs{ 0 };
+    mutable std::atomic<double> m_nsPerTick{ 1.0 };
+
+    mutable std::mutex m_threadsMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+
+    uint64_t m_frameStarts[kFrameHistory]{};
+    std::atomic<uint64_t> m_frameCount{ 0 };
+
+    std::atomic<bool> m_paused{ false };
+    int m_viewFrames{ 4 };
+};
+
+// RAII zone: records [construction, destruction) on the calling thread.
+// A zone opened while the profiler is paused records nothing.
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) noexcept
+        : m_name(name)
+    {
+        Profiler& profiler = Profiler::Get();
+        if (profiler.IsPaused())
+            return;
+        m_buf = profiler.ThisThread();
+        m_depth = m_buf->depth++;
+        m_begin = Profiler::Ticks();
+    }
+    ~ProfileScope() noexcept
+    {
+        if (!m_buf)
+            return;
+        const uint64_t end = Profiler::Ticks();
+        const uint64_t pos = m_buf->writePos.load(std::memory_order_relaxed);
+        Profiler::ZoneSlot& slot = m_buf->zones[pos & (Profiler::kZonesPerThread - 1)];
+        slot.seq.store(2 * pos + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(m_name, std::memory_order_relaxed);
+        slot.beginTicks.store(m_begin, std::memory_order_relaxed);
+        slot.endTicks.store(end, std::memory_order_relaxed);
+        slot.depth.store(m_depth, std::memory_order_relaxed);
+        slot.seq.store(2 * pos + 2, std::memory_order_release);
+        m_buf->writePos.store(pos + 1, std::memory_order_release);
+        --m_buf->depth;
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler::ThreadBuffer* m_buf{ nullptr };
+    const char* m_name;
+    uint64_t m_begin{ 0 };
+    uint32_t m_depth{ 0 };
+};
+
+#define DXE_PROFILE_CONCAT_INNER(a, b) a##b
+#define DXE_PROFILE_CONCAT(a, b) DXE_PROFILE_CONCAT_INNER(a, b)
+
+#if DXE_PROFILER
+#define PROFILE_SCOPE(name)       ProfileScope DXE_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_FRAME()           Profiler::Get().BeginFrame()
+#define PROFILE_THREAD(name)      Profiler::Get().SetThreadName(name)
+#else
+#define PROFILE_SCOPE(name)       ((void)0)
+#define PROFILE_FRAME()           ((void)0)
+#define PROFILE_THREAD(name)      ((void)0)
+#endif
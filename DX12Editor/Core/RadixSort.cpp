@@ -0,0 +1,130 @@
+#include "RadixSort.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace {
+    constexpr unsigned kPasses = 8;
+    constexpr unsigned kBuckets = 256;
+    constexpr size_t   kMinChunk = 16 * 1024; // below this threads cost more than they save
+
+    using Histogram = uint32_t[kBuckets];
+
+    template <typename Fn>
+    void ForEachChunk(JobSystem* jobs, size_t chunks, Fn&& fn)
+    {
+        if (jobs && chunks > 1)
+            jobs->ParallelFor(chunks, 1, [&](size_t b, size_t e) { for (size_t c = b; c < e; ++c) fn(c); });
+        else
+            for (size_t c = 0; c < chunks; ++c) fn(c);
+    }
+}
+
+void RadixSort64(uint64_t* keys, uint32_t* values,
+    uint64_t* tmpKeys, uint32_t* tmpValues,
+    size_t count, JobSystem* jobs)
+{
+    if (count < 2)
+        return;
+
+    size_t chunks = 1;
+    if (jobs)
+        chunks = std::clamp<size_t>(count / kMinChunk, 1, jobs->ThreadCount());
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+
+    auto chunkRange = [&](size_t c) {
+        const size_t b = c * chunkSize;
+        return std::make_pair(b, std::min(b + chunkSize, count));
+    };
+
+    // One pre-pass gathers all 8 digit histograms to find passes we can skip.
+    std::vector<uint32_t> allHist(chunks * kPasses * kBuckets, 0u);
+    ForEachChunk(jobs, chunks, [&](size_t c) {
+        uint32_t* h = &allHist[c * kPasses * kBuckets];
+        auto [b, e] = chunkRange(c);
+        for (size_t i = b; i < e; ++i)
+        {
+            const uint64_t k = keys[i];
+            for (unsigned p = 0; p < kPasses; ++p)
+                ++h[p * kBuckets + ((k >> (p * 8)) & 0xFF)];
+        }
+    });
+
+    bool needPass[kPasses]{};
+    for (unsigned p = 0; p < kPasses; ++p)
+    {
+        const uint8_t firstDigit = uint8_t(keys[0] >> (p * 8));
+        uint32_t sameAsFirst = 0;
+        for (size_t c = 0; c < chunks; ++c)
+            sameAsFirst += allHist[(c * kPasses + p) * kBuckets + firstDigit];
+        needPass[p] = (sameAsFirst != count);
+    }
+
+    std::vector<Histogram> hist(chunks);
+    bool histFresh = true; // pre-pass histograms are valid until the first scatter
+
+    uint64_t* srcK = keys;    uint32_t* srcV = values;
+    uint64_t* dstK = tmpKeys; uint32_t* dstV = tmpValues;
+
+    for (unsigned p = 0; p < kPasses; ++p)
+    {
+        if (!needPass[p])
+            continue;
+
+        const unsigned shift = p * 8;
+
+        // 1) Per-chunk histogram of this digit
+        if (histFresh)
+        {
+            for (size_t c = 0; c < chunks; ++c)
+                std::copy_n(&allHist[(c * kPasses + p) * kBuckets], kBuckets, hist[c]);
+        }
+        else
+        {
+            ForEachChunk(jobs, chunks, [&](size_t c) {
+                uint32_t* h = hist[c];
+                std::fill_n(h, kBuckets, 0u);
+                auto [b, e] = chunkRange(c);
+                for (size_t i = b; i < e; ++i)
+                    ++h[(srcK[i] >> shift) & 0xFF];
+            });
+        }
+
+        // 2) Exclusive prefix sum: bucket-major, chunk-minor keeps the sort stable
+        uint32_t running = 0;
+        for (unsigned d = 0; d < kBuckets; ++d)
+        {
+            for (size_t c = 0; c < chunks; ++c)
+            {
+                const uint32_t n = hist[c][d];
+                hist[c][d] = running;
+                running += n;
+            }
+        }
+
+        // 3) Scatter
+        ForEachChunk(jobs, chunks, [&](size_t c) {
+            uint32_t* offs = hist[c];
+            auto [b, e] = chunkRange(c);
+            for (size_t i = b; i < e; ++i)
+            {
+                const uint64_t k = srcK[i];
+                const uint32_t o = offs[(k >> shift) & 0xFF]++;
+                dstK[o] = k;
+                dstV[o] = srcV[i];
+            }
+        });
+
+        std::swap(srcK, dstK);
+        std::swap(srcV, dstV);
+        histFresh = false;
+    }
+
+    // Odd number of executed passes leaves the result in the scratch buffers.
+    if (srcK != keys)
+    {
+        std::copy_n(srcK, count, keys);
+        std::copy_n(srcV, count, values);
+    }
+}
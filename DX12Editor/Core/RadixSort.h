@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class JobSystem;
+
+// Stable LSD radix sort of 64-bit keys (8 passes of 8 bits) with a 32-bit payload.
+// Passes whose byte is identical for every key are skipped, so sparse keys
+// (few pipelines/materials) cost far fewer than 8 passes.
+// Result ends up in keys/values; tmpKeys/tmpValues must hold 'count' elements.
+// With a JobSystem, histogram and scatter are split across its threads.
+void RadixSort64(uint64_t* keys, uint32_t* values,
+    uint64_t* tmpKeys, uint32_t* tmpValues,
+    size_t count, JobSystem* jobs = nullptr);
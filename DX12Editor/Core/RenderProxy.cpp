@@ -0,0 +1,141 @@
+#include "RenderProxy.h"
+#include <chrono>
+
+namespace {
+    using TransformArray = CowChunkedArray<DirectX::XMFLOAT4X4>;
+
+    // Overwrites view[id] with the current transform for every id (sorted),
+    // cloning each touched chunk once; snapshots holding the old chunks keep them.
+    void PatchView(TransformArray::View& view, const TransformArray& current, const std::vector<ProxyId>& ids)
+    {
+        std::shared_ptr<TransformArray::Chunk> chunk;
+        uint32_t chunkIndex = 0;
+        for (ProxyId id : ids)
+        {
+            if (id >= view.size) break;
+            const uint32_t c = id / TransformArray::kChunkSize;
+            if (!chunk || c != chunkIndex)
+            {
+                if (chunk) view.chunks[chunkIndex] = std::move(chunk);
+                chunk = std::make_shared<TransformArray::Chunk>(*view.chunks[c]);
+                chunkIndex = c;
+            }
+            (*chunk)[id % TransformArray::kChunkSize] = current.Get(id);
+        }
+        if (chunk) view.chunks[chunkIndex] = std::move(chunk);
+    }
+}
+
+ProxyId RenderScene::Add(const ProxyDraw& draw, const DirectX::XMFLOAT4X4& world)
+{
+    ProxyId id;
+    if (!m_freeIds.empty())
+    {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    }
+    else
+    {
+        id = m_draws.Size();
+        m_transforms.Resize(id + 1);
+        m_draws.Resize(id + 1);
+        m_changedFlag.push_back(0);
+    }
+    m_transforms.Edit(id) = world;
+    m_draws.Edit(id) = draw;
+    m_snapped.push_back(id); // a reused id must not interpolate from its previous owner
+    MarkChanged(id);
+    return id;
+}
+
+void RenderScene::Remove(ProxyId id)
+{
+    // Slot stays in the arrays as an invisible proxy until Add() reuses it.
+    m_draws.Edit(id).flags &= ~uint32_t(ProxyDraw::kVisible);
+    m_freeIds.push_back(id);
+    MarkChanged(id);
+}
+
+void RenderScene::SetTransform(ProxyId id, const DirectX::XMFLOAT4X4& world)
+{
+    m_transforms.Edit(id) = world;
+    MarkChanged(id);
+}
+
+void RenderScene::SnapTransform(ProxyId id, const DirectX::XMFLOAT4X4& world)
+{
+    SetTransform(id, world);
+    m_snapped.push_back(id);
+}
+
+void RenderScene::SetDraw(ProxyId id, const ProxyDraw& draw)
+{
+    m_draws.Edit(id) = draw;
+    MarkChanged(id);
+}
+
+void RenderScene::MarkChanged(ProxyId id)
+{
+    if (!m_changedFlag[id])
+    {
+        m_changedFlag[id] = 1;
+        m_changed.push_back(id);
+    }
+}
+
+void RenderScene::ApplySnaps()
+{
+    if (m_snapped.empty()) return;
+
+    // History = the current transform: no interpolation for these proxies.
+    std::sort(m_snapped.begin(), m_snapped.end());
+    m_snapped.erase(std::unique(m_snapped.begin(), m_snapped.end()), m_snapped.end());
+    PatchView(m_stepTransforms, m_transforms, m_snapped);
+    PatchView(m_prevTransforms, m_transforms, m_snapped);
+    m_snapped.clear();
+}
+
+void RenderScene::EndSimStep()
+{
+    ApplySnaps();
+    m_prevTransforms = std::move(m_stepTransforms);
+    m_stepTransforms = m_transforms.Freeze();
+}
+
+void RenderScene::Publish(float alpha)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+
+    ApplySnaps();
+
+    auto snap = std::make_shared<RenderSnapshot>();
+    snap->frame = ++m_frame;
+    snap->view = m_view;
+    snap->transforms = m_transforms.Freeze();
+    snap->prevTransforms = m_prevTransforms;
+    snap->alpha = alpha;
+    snap->draws = m_draws.Freeze();
+
+    for (ProxyId id : m_changed) m_changedFlag[id] = 0;
+    snap->changed.assign(m_changed.begin(), m_changed.end());
+    m_changed.clear();
+
+    m_stats.proxies = snap->ProxyCount();
+    m_stats.changed = uint32_t(snap->changed.size());
+    m_stats.chunksCopied = m_transforms.TakeChunksCopied() + m_draws.TakeChunksCopied();
+
+    std::shared_ptr<const RenderSnapshot> previous = std::move(snap);
+    {
+        std::lock_guard<std::mutex> lock(m_publishMutex);
+        m_published.swap(previous);
+    }
+    previous.reset(); // last reference may free chunks: do it outside the lock
+
+    m_stats.publishMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+std::shared_ptr<const RenderSnapshot> RenderScene::Acquire() const
+{
+    std::lock_guard<std::mutex> lock(m_publishMutex);
+    return m_published;
+}
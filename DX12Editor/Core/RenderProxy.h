@@ -0,0 +1,208 @@
+#pragma once
+#include <DirectXMath.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Render proxies: the renderer never reads live simulation state. Simulation
+// edits a RenderScene for frame N+1 while recording consumes an immutable
+// RenderSnapshot of frame N. Snapshots share unchanged data with the scene
+// (copy-on-write chunks), so publishing costs one pointer per chunk plus the
+// chunks that were actually edited, not a full copy of every object.
+
+// Array split into fixed-size chunks; Freeze() hands out a read-only view that
+// shares every chunk, and Edit() clones a chunk first only while some view
+// still references it (once every snapshot holding it is gone, it is written
+// in place again).
+template <typename T, uint32_t ChunkSize = 256>
+class CowChunkedArray {
+public:
+    using Chunk = std::array<T, ChunkSize>;
+    static constexpr uint32_t kChunkSize = ChunkSize;
+
+    struct View {
+        std::vector<std::shared_ptr<const Chunk>> chunks;
+        uint32_t size{ 0 };
+
+        const T& operator[](uint32_t i) const noexcept { return (*chunks[i / ChunkSize])[i % ChunkSize]; }
+
+        // Element i lives in the very same (unmodified) chunk in both views.
+        bool SharesChunk(const View& other, uint32_t i) const noexcept
+        {
+            return i < size && i < other.size && chunks[i / ChunkSize] == other.chunks[i / ChunkSize];
+        }
+    };
+
+    uint32_t Size() const noexcept { return m_size; }
+
+    void Resize(uint32_t size)
+    {
+        const uint32_t chunkCount = (size + ChunkSize - 1) / ChunkSize;
+        while (m_chunks.size() < chunkCount)
+            m_chunks.push_back(std::make_shared<Chunk>());
+        m_size = size;
+    }
+
+    const T& Get(uint32_t i) const noexcept { return (*m_chunks[i / ChunkSize])[i % ChunkSize]; }
+
+    // Writable element; clones its chunk if a published view still shares it.
+    // Views are only ever copied from this array on the writer's thread, so a
+    // use count of 1 cannot grow behind our back; it can only have dropped
+    // (a reader released its snapshot), and the fence orders that reader's
+    // last accesses before our writes.
+    T& Edit(uint32_t i)
+    {
+        const uint32_t c = i / ChunkSize;
+        if (m_chunks[c].use_count() > 1)
+        {
+            m_chunks[c] = std::make_shared<Chunk>(*m_chunks[c]);
+            ++m_chunksCopied;
+        }
+        else
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return (*m_chunks[c])[i % ChunkSize];
+    }
+
+    // Read-only view of the current contents, sharing every chunk.
+    View Freeze()
+    {
+        View v;
+        v.size = m_size;
+        v.chunks.assign(m_chunks.begin(), m_chunks.end());
+        return v;
+    }
+
+    // Chunks cloned since the last call (copy-on-write traffic).
+    uint32_t TakeChunksCopied() noexcept
+    {
+        const uint32_t n = m_chunksCopied;
+        m_chunksCopied = 0;
+        return n;
+    }
+
+private:
+    std::vector<std::shared_ptr<Chunk>> m_chunks;
+    uint32_t m_size{ 0 };
+    uint32_t m_chunksCopied{ 0 };
+};
+
+using ProxyId = uint32_t;
+
+// What to draw for one proxy, in the API-neutral ids DrawList uses.
+struct ProxyDraw {
+    enum : uint32_t {
+        kVisible = 1,
+        kEditorOnly = 2, // editor furniture (grid, axis): not saved with the scene
+    };
+
+    uint32_t pipeline{ 0 };
+    uint32_t mesh{ 0 };
+    uint32_t material{ 0 };
+    uint32_t firstVertex{ 0 };
+    uint32_t vertexCount{ 0 };
+    uint32_t flags{ 0 };
+
+    bool Visible() const noexcept { return (flags & kVisible) != 0; }
+};
+
+// Camera state the frame is rendered with.
+struct RenderView {
+    DirectX::XMFLOAT4X4 view{};
+    DirectX::XMFLOAT4X4 proj{};
+    DirectX::XMFLOAT3   position{ 0.0f, 0.0f, 0.0f };
+};
+
+struct RenderSnapshot {
+    uint64_t   frame{ 0 };
+    RenderView view;
+    CowChunkedArray<DirectX::XMFLOAT4X4>::View transforms; // world matrices
+    CowChunkedArray<DirectX::XMFLOAT4X4>::View prevTransforms; // one simulation step earlier (may be empty)
+    float alpha{ 1.0f }; // draw at lerp(prevTransforms, transforms, alpha)
+    CowChunkedArray<ProxyDraw>::View           draws;
+    std::vector<ProxyId> changed; // proxies added/edited/removed since frame - 1
+
+    uint32_t ProxyCount() const noexcept { return draws.size; }
+
+    // True when proxy 'id' changed during the last simulation step and needs
+    // interpolating. Untouched chunks are still shared, so most ids exit early.
+    bool Moved(ProxyId id) const noexcept
+    {
+        if (alpha >= 1.0f || id >= prevTransforms.size) return false;
+        if (transforms.SharesChunk(prevTransforms, id)) return false;
+        return std::memcmp(&transforms[id], &prevTransforms[id], sizeof(DirectX::XMFLOAT4X4)) != 0;
+    }
+
+    // False when the consumer skipped a snapshot: 'changed' is then incomplete
+    // and anything cached per proxy must be rebuilt from the full arrays.
+    bool ContinuesFrom(uint64_t previousFrame) const noexcept { return previousFrame + 1 == frame; }
+};
+
+// Simulation-side owner of all proxies. Single writer; Acquire() may be
+// called from any thread.
+class RenderScene {
+public:
+    struct PublishStats {
+        uint32_t proxies{ 0 };
+        uint32_t changed{ 0 };
+        uint32_t chunksCopied{ 0 };
+        double   publishMs{ 0.0 };
+    };
+
+    ProxyId Add(const ProxyDraw& draw, const DirectX::XMFLOAT4X4& world);
+    void Remove(ProxyId id);
+
+    void SetTransform(ProxyId id, const DirectX::XMFLOAT4X4& world);
+    // Same, for edits made outside a simulation step (gizmo, scene load):
+    // the proxy is drawn at 'world' right away instead of being interpolated
+    // towards it. Add() snaps as well.
+    void SnapTransform(ProxyId id, const DirectX::XMFLOAT4X4& world);
+    void SetDraw(ProxyId id, const ProxyDraw& draw);
+    void SetView(const RenderView& view) noexcept { m_view = view; }
+
+    // Call after each fixed simulation step: the transforms at that point
+    // become the 'previous' side of the next snapshots' interpolation.
+    void EndSimStep();
+
+    const DirectX::XMFLOAT4X4& Transform(ProxyId id) const noexcept { return m_transforms.Get(id); }
+    const ProxyDraw& Draw(ProxyId id) const noexcept { return m_draws.Get(id); }
+
+    // Edits since the last Publish() (on-demand redraw).
+    bool HasPendingChanges() const noexcept { return !m_changed.empty(); }
+
+    // Freezes the current state as the next snapshot (frame number + 1).
+    // alpha = how far the frame is between the last two simulation steps.
+    void Publish(float alpha = 1.0f);
+
+    // Latest published snapshot; stays valid for as long as the caller holds it.
+    std::shared_ptr<const RenderSnapshot> Acquire() const;
+
+    const PublishStats& LastPublish() const noexcept { return m_stats; }
+
+private:
+    void MarkChanged(ProxyId id);
+    void ApplySnaps();
+
+private:
+    CowChunkedArray<DirectX::XMFLOAT4X4> m_transforms;
+    CowChunkedArray<ProxyDraw>           m_draws;
+    CowChunkedArray<DirectX::XMFLOAT4X4>::View m_stepTransforms; // at the end of the last step
+    CowChunkedArray<DirectX::XMFLOAT4X4>::View m_prevTransforms; // at the end of the step before
+    RenderView m_view;
+
+    std::vector<ProxyId> m_freeIds;
+    std::vector<ProxyId> m_snapped; // to copy into the step history before it is next used
+    std::vector<ProxyId> m_changed;
+    std::vector<uint8_t> m_changedFlag; // per proxy, dedups m_changed
+    uint64_t m_frame{ 0 };
+    PublishStats m_stats;
+
+    mutable std::mutex m_publishMutex; // guards m_published (pointer swap only)
+    std::shared_ptr<const RenderSnapshot> m_published;
+};
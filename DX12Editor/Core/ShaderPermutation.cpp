@@ -0,0 +1,238 @@
+#include "ShaderPermutation.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <system_error>
+
+namespace {
+    std::FILE* OpenFile(const std::filesystem::path& path, const char* mode)
+    {
+#if defined(_WIN32)
+        wchar_t wmode[8] = {};
+        for (size_t i = 0; mode[i] && i < 7; ++i) wmode[i] = wchar_t(mode[i]);
+        std::FILE* f = nullptr;
+        return (_wfopen_s(&f, path.c_str(), wmode) == 0) ? f : nullptr;
+#else
+        return std::fopen(path.c_str(), mode);
+#endif
+    }
+}
+
+// ====================================================
+// Permutation space
+// ====================================================
+ShaderPermutationSpace::ShaderPermutationSpace(std::string_view shader, std::initializer_list<ShaderFeature> features)
+    : m_shader(shader), m_features(features)
+{
+    for (const ShaderFeature& f : m_features)
+        m_keyBits = (std::max)(m_keyBits, f.shift + f.bits);
+}
+
+uint32_t ShaderPermutationSpace::VariantCount() const noexcept
+{
+    uint32_t count = 1;
+    for (const ShaderFeature& f : m_features) count *= f.valueCount;
+    return count;
+}
+
+bool ShaderPermutationSpace::IsValid(uint32_t key) const noexcept
+{
+    uint32_t used = 0;
+    for (const ShaderFeature& f : m_features)
+    {
+        if (Value(key, f) >= f.valueCount) return false;
+        used |= f.Mask();
+    }
+    return (key & ~used) == 0;
+}
+
+std::vector<uint32_t> ShaderPermutationSpace::Keys() const
+{
+    std::vector<uint32_t> keys;
+    keys.reserve(VariantCount());
+    for (uint32_t key = 0; key < (1u << m_keyBits); ++key)
+        if (IsValid(key)) keys.push_back(key);
+    return keys;
+}
+
+std::vector<std::pair<std::string, uint32_t>> ShaderPermutationSpace::Defines(uint32_t key) const
+{
+    std::vector<std::pair<std::string, uint32_t>> defines;
+    for (const ShaderFeature& f : m_features)
+        defines.emplace_back(f.define, Value(key, f));
+    return defines;
+}
+
+std::string ShaderPermutationSpace::VariantName(uint32_t key) const
+{
+    char hex[16];
+    std::snprintf(hex, sizeof(hex), "_%02x", key);
+    return m_shader + hex;
+}
+
+bool ShaderPermutationSpace::ParseVariantName(std::string_view name, uint32_t& key) const noexcept
+{
+    if (name.size() < m_shader.size() + 3 || name.substr(0, m_shader.size()) != m_shader || name[m_shader.size()] != '_')
+        return false;
+    uint32_t value = 0;
+    for (char c : name.substr(m_shader.size() + 1))
+    {
+        const int digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+        if (digit < 0 || value > 0x0FFFFFFFu) return false;
+        value = value * 16 + uint32_t(digit);
+    }
+    if (!IsValid(value)) return false;
+    key = value;
+    return true;
+}
+
+// ====================================================
+// Variant cache
+// ====================================================
+ShaderVariantCache::ShaderVariantCache(const ShaderPermutationSpace& space, LoadFn load)
+    : m_space(space), m_load(std::move(load)),
+      m_requests(size_t(1) << space.KeyBits(), 0), m_draws(size_t(1) << space.KeyBits(), 0)
+{
+}
+
+ShaderVariantCache::ShaderVariantCache(const ShaderPermutationSpace& space, RequestFn request)
+    : m_space(space), m_request(std::move(request)),
+      m_requests(size_t(1) << space.KeyBits(), 0), m_draws(size_t(1) << space.KeyBits(), 0)
+{
+}
+
+ShaderVariantCache::~ShaderVariantCache()
+{
+    std::unique_lock<std::mutex> lock(m_doneMutex);
+    m_doneCv.wait(lock, [&] { return m_outstanding == 0; });
+}
+
+const std::vector<uint8_t>* ShaderVariantCache::Get(uint32_t key)
+{
+    ++m_stats.requests;
+    if (!m_space.IsValid(key)) return nullptr;
+    ++m_requests[key];
+
+    auto it = m_code.find(key);
+    if (it == m_code.end())
+    {
+        it = m_code.emplace(key, Variant{}).first;
+        ++m_stats.loads;
+        if (m_request)
+        {
+            it->second.loading = true;
+            {
+                std::lock_guard<std::mutex> lock(m_doneMutex);
+                ++m_outstanding;
+            }
+            m_request(key, m_space.VariantName(key)); // may complete inline
+            return nullptr;
+        }
+        it->second.loaded = m_load && m_load(m_space.VariantName(key), it->second.code) && !it->second.code.empty();
+        if (!it->second.loaded) ++m_stats.loadFailures;
+    }
+    return it->second.loaded ? &it->second.code : nullptr;
+}
+
+bool ShaderVariantCache::IsLoading(uint32_t key) const noexcept
+{
+    auto it = m_code.find(key);
+    return it != m_code.end() && it->second.loading;
+}
+
+void ShaderVariantCache::Complete(uint32_t key, bool ok, std::vector<uint8_t> code)
+{
+    std::lock_guard<std::mutex> lock(m_doneMutex);
+    m_done.push_back({ key, ok, std::move(code) });
+    --m_outstanding;
+    m_doneCv.notify_all(); // under the lock: the destructor may run right after
+}
+
+uint32_t ShaderVariantCache::Update()
+{
+    std::vector<Done> done;
+    {
+        std::lock_guard<std::mutex> lock(m_doneMutex);
+        done.swap(m_done);
+    }
+    for (Done& d : done)
+    {
+        Variant& v = m_code[d.key];
+        v.loading = false;
+        v.loaded = d.ok && !d.code.empty();
+        if (v.loaded) v.code = std::move(d.code);
+        else          ++m_stats.loadFailures;
+    }
+    return uint32_t(done.size());
+}
+
+void ShaderVariantCache::Insert(uint32_t key, std::vector<uint8_t> code)
+{
+    if (!m_space.IsValid(key) || code.empty()) return;
+    Variant& v = m_code[key];
+    v.code = std::move(code);
+    v.loaded = true;
+}
+
+size_t ShaderVariantCache::LoadedCount() const noexcept
+{
+    size_t count = 0;
+    for (const auto& [key, variant] : m_code) count += variant.loaded ? 1 : 0;
+    return count;
+}
+
+std::vector<ShaderVariantCache::Usage> ShaderVariantCache::UsedVariants() const
+{
+    std::vector<Usage> used;
+    for (uint32_t key = 0; key < m_requests.size(); ++key)
+        if (m_requests[key] || m_draws[key])
+            used.push_back({ key, m_requests[key], m_draws[key] });
+    return used;
+}
+
+bool ShaderVariantCache::LoadUsage(const std::filesystem::path& path)
+{
+    std::FILE* f = OpenFile(path, "r");
+    if (!f) return false;
+    char name[256];
+    unsigned long long requests = 0, draws = 0;
+    while (std::fscanf(f, "%255s %llu %llu", name, &requests, &draws) == 3)
+    {
+        uint32_t key = 0;
+        if (!m_space.ParseVariantName(name, key)) continue; // other shader, or a variant no longer built
+        m_requests[key] += requests;
+        m_draws[key] += draws;
+    }
+    std::fclose(f);
+    return true;
+}
+
+bool ShaderVariantCache::SaveUsage(const std::filesystem::path& path) const
+{
+    std::filesystem::path tmp = path;
+    tmp += ".tmp";
+    std::FILE* f = OpenFile(tmp, "w");
+    if (!f) return false;
+    for (const Usage& u : UsedVariants())
+        std::fprintf(f, "%s %llu %llu\n", m_space.VariantName(u.key).c_str(),
+            (unsigned long long)u.requests, (unsigned long long)u.draws);
+    bool ok = std::fclose(f) == 0;
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmp, path, ec);
+    if (!ok || ec)
+    {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+// ====================================================
+// ColorPS
+// ====================================================
+const ShaderPermutationSpace& ColorPermutation::Space()
+{
+    static const ShaderPermutationSpace space("ColorPS", { kSampler, kVertexColor });
+    return space;
+}
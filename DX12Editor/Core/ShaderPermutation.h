@@ -0,0 +1,183 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// One compile-time feature of a shader: a preprocessor define taking
+// 'valueCount' values, stored in 'bits' bits at 'shift' of the permutation key.
+struct ShaderFeature {
+    const char* define;
+    uint32_t    shift;
+    uint32_t    bits;
+    uint32_t    valueCount;
+
+    constexpr uint32_t Mask() const noexcept { return ((1u << bits) - 1u) << shift; }
+};
+
+// The variants of one shader. A permutation key packs one value per
+// feature; each valid key is one precompiled binary, <shader>_<key as 2+ hex
+// digits>.cso, built with the defines of Defines(key).
+class ShaderPermutationSpace {
+public:
+    ShaderPermutationSpace(std::string_view shader, std::initializer_list<ShaderFeature> features);
+
+    const std::string& Shader() const noexcept { return m_shader; }
+    const std::vector<ShaderFeature>& Features() const noexcept { return m_features; }
+
+    uint32_t KeyBits() const noexcept { return m_keyBits; }
+    uint32_t VariantCount() const noexcept;    // valid keys
+    bool     IsValid(uint32_t key) const noexcept;
+    uint32_t Value(uint32_t key, const ShaderFeature& feature) const noexcept
+    {
+        return (key & feature.Mask()) >> feature.shift;
+    }
+
+    // All valid keys, ascending.
+    std::vector<uint32_t> Keys() const;
+
+    std::vector<std::pair<std::string, uint32_t>> Defines(uint32_t key) const;
+    std::string VariantName(uint32_t key) const;   // without extension
+    bool ParseVariantName(std::string_view name, uint32_t& key) const noexcept;
+
+private:
+    std::string m_shader;
+    std::vector<ShaderFeature> m_features;
+    uint32_t m_keyBits{ 0 };
+};
+
+// Builds a permutation key one feature at a time; values out of range clamp
+// to the feature's last value.
+class PermutationKeyBuilder {
+public:
+    constexpr PermutationKeyBuilder& Set(const ShaderFeature& feature, uint32_t value) noexcept
+    {
+        if (value >= feature.valueCount) value = feature.valueCount - 1;
+        m_key = (m_key & ~feature.Mask()) | (value << feature.shift);
+        return *this;
+    }
+    constexpr uint32_t Finish() const noexcept { return m_key; }
+
+private:
+    uint32_t m_key{ 0 };
+};
+
+// Variant binaries of one shader, loaded on first use: blocking through a
+// LoadFn, or in the background through a RequestFn, in which case Get()
+// answers null until Update() has published the binary. Also counts how
+// often each variant is asked for and drawn with; SaveUsage() writes that
+// down so shipping builds compile (and pack) only variants that were used.
+// Single-threaded (render thread), except Complete().
+class ShaderVariantCache {
+public:
+    using LoadFn = std::function<bool(const std::string& variantName, std::vector<uint8_t>& code)>;
+    // Starts loading variant 'key' and returns at once; whoever finishes the
+    // load hands the bytes (or the failure) to Complete().
+    using RequestFn = std::function<void(uint32_t key, const std::string& variantName)>;
+
+    struct Stats {
+        uint64_t requests{ 0 };
+        uint64_t loads{ 0 };
+        uint64_t loadFailures{ 0 };
+    };
+    struct Usage {
+        uint32_t key{ 0 };
+        uint64_t requests{ 0 };
+        uint64_t draws{ 0 };
+    };
+
+    ShaderVariantCache(const ShaderPermutationSpace& space, LoadFn load);
+    ShaderVariantCache(const ShaderPermutationSpace& space, RequestFn request);
+    // Waits for loads still out: they complete into this object.
+    ~ShaderVariantCache();
+
+    ShaderVariantCache(const ShaderVariantCache&) = delete;
+    ShaderVariantCache& operator=(const ShaderVariantCache&) = delete;
+
+    // Bytecode of the variant, loaded on first request; null if the key is
+    // invalid, its binary cannot be loaded (not retried) or is still loading.
+    const std::vector<uint8_t>* Get(uint32_t key);
+
+    // A background load of 'key' was started and is not published yet.
+    bool IsLoading(uint32_t key) const noexcept;
+
+    // Result of a RequestFn load; any thread. Published by the next Update().
+    void Complete(uint32_t key, bool ok, std::vector<uint8_t> code);
+
+    // Publishes the loads completed since the last call (once per frame);
+    // returns how many.
+    uint32_t Update();
+
+    // Hands in a binary loaded elsewhere (e.g. prefetched with other files).
+    void Insert(uint32_t key, std::vector<uint8_t> code);
+
+    void NoteDraws(uint32_t key, uint64_t draws = 1) noexcept
+    {
+        if (key < m_draws.size()) m_draws[key] += draws;
+    }
+
+    const ShaderPermutationSpace& Space() const noexcept { return m_space; }
+    const Stats& GetStats() const noexcept { return m_stats; }
+    size_t LoadedCount() const noexcept;
+
+    // Variants requested or drawn with (including counts merged by LoadUsage).
+    std::vector<Usage> UsedVariants() const;
+
+    // Text file, one "<variant name> <requests> <draws>" line per used variant.
+    // LoadUsage adds the file's counts (of this shader's valid variants) to
+    // this cache's; SaveUsage replaces the file.
+    bool LoadUsage(const std::filesystem::path& path);
+    bool SaveUsage(const std::filesystem::path& path) const;
+
+private:
+    struct Variant {
+        std::vector<uint8_t> code;
+        bool                 loaded{ false };
+        bool                 loading{ false }; // RequestFn load not published yet
+    };
+    struct Done {
+        uint32_t             key;
+        bool                 ok;
+        std::vector<uint8_t> code;
+    };
+
+    const ShaderPermutationSpace& m_space;
+    LoadFn    m_load;
+    RequestFn m_request;
+    std::unordered_map<uint32_t, Variant> m_code;
+    std::vector<uint64_t> m_requests;  // by key
+    std::vector<uint64_t> m_draws;     // by key
+    Stats m_stats;
+
+    std::mutex m_doneMutex;
+    std::condition_variable m_doneCv;
+    std::vector<Done> m_done;          // completed, not yet published
+    uint32_t m_outstanding{ 0 };       // requested, not yet completed
+};
+
+// Variants of ColorPS.hlsl. The key doubles as the draw's material id.
+namespace ColorPermutation {
+    enum class Sampler : uint32_t { LinearWrap = 0, PointWrap = 1, LinearClamp = 2, PointClamp = 3 };
+
+    inline constexpr ShaderFeature kSampler{ "SAMPLER_MODE", 0, 2, 4 };
+    inline constexpr ShaderFeature kVertexColor{ "VERTEX_COLOR_BLEND", 2, 1, 2 };
+
+    const ShaderPermutationSpace& Space();
+
+    constexpr uint32_t Key(Sampler sampler, bool vertexColor) noexcept
+    {
+        return PermutationKeyBuilder().Set(kSampler, uint32_t(sampler)).Set(kVertexColor, vertexColor).Finish();
+    }
+
+    // What ColorPS did before it had permutations.
+    inline constexpr uint32_t kDefault = Key(Sampler::LinearWrap, true);
+    constexpr Sampler SamplerOf(uint32_t key) noexcept { return Sampler((key & kSampler.Mask()) >> kSampler.shift); }
+    constexpr bool VertexColorOf(uint32_t key) noexcept { return (key & kVertexColor.Mask()) != 0; }
+}
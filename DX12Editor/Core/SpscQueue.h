@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Bounded lock-free single-producer / single-consumer ring.
+// One thread calls TryPush, one (other) thread calls TryPop; neither blocks.
+// Head and tail live on separate cache lines and each side keeps a cached
+// copy of the other's index, so the shared lines are only touched when the
+// cached view says the ring looks full / empty.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "SpscQueue stores trivially copyable items");
+
+public:
+    static constexpr size_t kCacheLine = 64;
+
+    bool TryPush(const T& item) noexcept
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity)
+                return false; // full
+        }
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(T& out) noexcept
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+                return false; // empty
+        }
+        out = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently.
+    size_t SizeApprox() const noexcept
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t CapacityOf() noexcept { return Capacity; }
+
+private:
+    // Consumer side
+    alignas(kCacheLine) std::atomic<size_t> m_head{ 0 };
+    size_t m_cachedTail{ 0 };
+
+    // Producer side
+    alignas(kCacheLine) std::atomic<size_t> m_tail{ 0 };
+    size_t m_cachedHead{ 0 };
+
+    alignas(kCacheLine) T m_items[Capacity];
+};
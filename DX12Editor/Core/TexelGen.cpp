@@ -0,0 +1,71 @@
+#include "TexelGen.h"
+#include <algorithm>
+
+namespace TexelGen {
+
+void FillChecker(uint32_t* pixels, uint32_t width, uint32_t height, uint32_t cell,
+    uint8_t dark, uint8_t light) noexcept
+{
+    const uint32_t darkPx = 0xFF000000u | (uint32_t(dark) << 16) | (uint32_t(dark) << 8) | dark;
+    const uint32_t lightPx = 0xFF000000u | (uint32_t(light) << 16) | (uint32_t(light) << 8) | light;
+
+    for (uint32_t i = 0; i < width * height; ++i)
+    {
+        const bool c = (((i % width) / cell) ^ ((i / width) / cell)) & 1u;
+        pixels[i] = c ? lightPx : darkPx;
+    }
+}
+
+uint32_t BuildMipChain(const uint32_t* pixels, uint32_t width, uint32_t height, std::vector<uint32_t>& out)
+{
+    uint32_t levels = 1;
+    size_t total = size_t(width) * height;
+    for (uint32_t w = width, h = height; w > 1 || h > 1; ++levels)
+    {
+        w = (w > 1) ? w / 2 : 1;
+        h = (h > 1) ? h / 2 : 1;
+        total += size_t(w) * h;
+    }
+
+    out.resize(total);
+    std::copy(pixels, pixels + size_t(width) * height, out.begin());
+
+    size_t srcOffset = 0;
+    size_t dstOffset = size_t(width) * height;
+    uint32_t sw = width, sh = height;
+    for (uint32_t level = 1; level < levels; ++level)
+    {
+        const uint32_t dw = (sw > 1) ? sw / 2 : 1;
+        const uint32_t dh = (sh > 1) ? sh / 2 : 1;
+        const uint32_t* src = out.data() + srcOffset;
+        uint32_t* dst = out.data() + dstOffset;
+
+        for (uint32_t y = 0; y < dh; ++y)
+        {
+            const uint32_t* row0 = src + size_t((std::min)(2 * y, sh - 1)) * sw;
+            const uint32_t* row1 = src + size_t((std::min)(2 * y + 1, sh - 1)) * sw;
+            for (uint32_t x = 0; x < dw; ++x)
+            {
+                const uint32_t x0 = (std::min)(2 * x, sw - 1);
+                const uint32_t x1 = (std::min)(2 * x + 1, sw - 1);
+                const uint32_t t[4] = { row0[x0], row0[x1], row1[x0], row1[x1] };
+
+                uint32_t texel = 0;
+                for (uint32_t shift = 0; shift < 32; shift += 8) // per channel, rounded
+                {
+                    const uint32_t sum = ((t[0] >> shift) & 0xFF) + ((t[1] >> shift) & 0xFF) +
+                                         ((t[2] >> shift) & 0xFF) + ((t[3] >> shift) & 0xFF);
+                    texel |= ((sum + 2) / 4) << shift;
+                }
+                dst[size_t(y) * dw + x] = texel;
+            }
+        }
+        srcOffset = dstOffset;
+        dstOffset += size_t(dw) * dh;
+        sw = dw;
+        sh = dh;
+    }
+    return levels;
+}
+
+}
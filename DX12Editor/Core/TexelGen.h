@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CPU-side texel generation for the renderer's built-in textures. Plain
+// RGBA8 arrays, no D3D12 and no DirectXMath, so tools (ddcbench) build it
+// with nothing but a C++ compiler.
+namespace TexelGen {
+
+    // RGBA8 checkerboard, 'cell' texels per square.
+    void FillChecker(uint32_t* pixels, uint32_t width, uint32_t height, uint32_t cell,
+        uint8_t dark, uint8_t light) noexcept;
+
+    // Mip chain of an RGBA8 image, 2x2 box filter (edge texels repeat on odd
+    // sizes): level 0 (a copy), then each half-size level down to 1x1, packed
+    // into 'out'. Returns the level count.
+    uint32_t BuildMipChain(const uint32_t* pixels, uint32_t width, uint32_t height, std::vector<uint32_t>& out);
+}
@@ -14,20 +14,11 @@ bool DXMesh::InitializeQuad(ID3D12Device* device)
 
     // 2x2 quad centered at origin, in the XY plane.
     // Z = 0; we will place/rotate it with a world matrix in the renderer.
-    Vertex vertices[] =
-    {
-        //  position               color                uv
-        { XMFLOAT3(-1.0f,  1.0f, 0.0f), XMFLOAT3(1.0f, 0.0f, 0.0f), XMFLOAT2(0.0f, 0.0f) }, // top-left
-        { XMFLOAT3(1.0f,  1.0f, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT2(1.0f, 0.0f) }, // top-right
-        { XMFLOAT3(-1.0f, -1.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT2(0.0f, 1.0f) }, // bottom-left
-
-        { XMFLOAT3(-1.0f, -1.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT2(0.0f, 1.0f) }, // bottom-left
-        { XMFLOAT3(1.0f, -1.0f, 0.0f), XMFLOAT3(1.0f, 1.0f, 1.0f), XMFLOAT2(1.0f, 1.0f) }, // bottom-right
-        { XMFLOAT3(1.0f,  1.0f, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT2(1.0f, 0.0f) }, // top-right
-    };
+    Vertex vertices[MeshGen::kQuadVertexCount];
+    MeshGen::BuildQuadVertices(1.0f, vertices);
 
     const UINT vbSize = static_cast<UINT>(sizeof(vertices));
-    m_vertexCount = 6;
+    m_vertexCount = MeshGen::kQuadVertexCount;
 
     // Create an upload-heap vertex buffer.
     CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
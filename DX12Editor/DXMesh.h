@@ -3,17 +3,14 @@
 #include <d3d12.h>
 #include <wrl.h>
 #include <DirectXMath.h>
+#include "Core/MeshGen.h"
 
 // Simple mesh class that owns a vertex buffer for a textured quad.
 class DXMesh
 {
 public:
-    struct Vertex
-    {
-        DirectX::XMFLOAT3 position; // Comment in English: Vertex position in object space.
-        DirectX::XMFLOAT3 color;    // Comment in English: Vertex color for gradient.
-        DirectX::XMFLOAT2 uv;       // Comment in English: Texture coordinates.
-    };
+    // Comment in English: Position / color / uv, shared with the renderer.
+    using Vertex = MeshGen::Vertex;
 
     DXMesh() = default;
 
@@ -0,0 +1,193 @@
+#include "MathBatch.h"
+#include "SimdBackend.h"
+
+namespace Math {
+namespace {
+    // Runs kernel(backend, begin, end) over whole registers, then the rest one at a time.
+    template <typename Kernel>
+    void Run(size_t count, Kernel&& kernel)
+    {
+        const size_t simdEnd = count - count % SimdBackend::kWidth;
+        kernel(SimdBackend{}, size_t(0), simdEnd);
+        if (simdEnd < count) kernel(ScalarBackend{}, simdEnd, count);
+    }
+
+    template <typename B>
+    void TransformPointsKernel(const Mat4& m, const SoaFloat3& in, const SoaFloat3& out, size_t begin, size_t end) noexcept
+    {
+        using V = typename B::V;
+        const V m00 = B::Splat(m.m[0][0]), m01 = B::Splat(m.m[0][1]), m02 = B::Splat(m.m[0][2]);
+        const V m10 = B::Splat(m.m[1][0]), m11 = B::Splat(m.m[1][1]), m12 = B::Splat(m.m[1][2]);
+        const V m20 = B::Splat(m.m[2][0]), m21 = B::Splat(m.m[2][1]), m22 = B::Splat(m.m[2][2]);
+        const V m30 = B::Splat(m.m[3][0]), m31 = B::Splat(m.m[3][1]), m32 = B::Splat(m.m[3][2]);
+
+        for (size_t i = begin; i < end; i += B::kWidth)
+        {
+            const V x = B::Load(in.x + i), y = B::Load(in.y + i), z = B::Load(in.z + i);
+            B::Store(out.x + i, B::MulAdd(x, m00, B::MulAdd(y, m10, B::MulAdd(z, m20, m30))));
+            B::Store(out.y + i, B::MulAdd(x, m01, B::MulAdd(y, m11, B::MulAdd(z, m21, m31))));
+            B::Store(out.z + i, B::MulAdd(x, m02, B::MulAdd(y, m12, B::MulAdd(z, m22, m32))));
+        }
+    }
+
+    template <typename B>
+    void MultiplyMatricesKernel(const SoaMat4& in, const Mat4& right, const SoaMat4& out, size_t begin, size_t end) noexcept
+    {
+        using V = typename B::V;
+        V r[4][4];
+        for (int k = 0; k < 4; ++k)
+            for (int c = 0; c < 4; ++c)
+                r[k][c] = B::Splat(right.m[k][c]);
+
+        for (size_t i = begin; i < end; i += B::kWidth)
+        {
+            // Row by row: out row 'row' only reads in row 'row', so in == out works.
+            for (int row = 0; row < 4; ++row)
+            {
+                const V a0 = B::Load(in.m[row * 4 + 0] + i);
+                const V a1 = B::Load(in.m[row * 4 + 1] + i);
+                const V a2 = B::Load(in.m[row * 4 + 2] + i);
+                const V a3 = B::Load(in.m[row * 4 + 3] + i);
+                for (int c = 0; c < 4; ++c)
+                    B::Store(out.m[row * 4 + c] + i,
+                        B::MulAdd(a0, r[0][c], B::MulAdd(a1, r[1][c], B::MulAdd(a2, r[2][c], B::Mul(a3, r[3][c])))));
+            }
+        }
+    }
+
+    // Writes the visible flags of one register from its 'outside' mask, returns how many are visible.
+    template <typename B>
+    size_t StoreVisible(typename B::Mask outside, uint8_t* visible) noexcept
+    {
+        const uint32_t bits = B::Bits(outside);
+        size_t n = 0;
+        for (size_t lane = 0; lane < B::kWidth; ++lane)
+        {
+            const uint8_t v = uint8_t(((bits >> lane) & 1u) ^ 1u);
+            visible[lane] = v;
+            n += v;
+        }
+        return n;
+    }
+
+    template <typename B>
+    size_t CullSpheresKernel(const Plane* planes, uint32_t planeCount,
+        const SoaFloat3& centers, const float* radii, uint8_t* visible, size_t begin, size_t end) noexcept
+    {
+        size_t visibleCount = 0;
+        for (size_t i = begin; i < end; i += B::kWidth)
+        {
+            const typename B::V x = B::Load(centers.x + i), y = B::Load(centers.y + i), z = B::Load(centers.z + i);
+            const typename B::V negR = B::Neg(B::Load(radii + i));
+            typename B::Mask outside = B::None();
+            for (uint32_t p = 0; p < planeCount; ++p)
+            {
+                const Plane& pl = planes[p];
+                const typename B::V d = B::MulAdd(x, B::Splat(pl.nx),
+                    B::MulAdd(y, B::Splat(pl.ny), B::MulAdd(z, B::Splat(pl.nz), B::Splat(pl.d))));
+                outside = B::Or(outside, B::Less(d, negR));
+            }
+            visibleCount += StoreVisible<B>(outside, visible + i);
+        }
+        return visibleCount;
+    }
+
+    template <typename B>
+    size_t CullBoxesKernel(const Plane* planes, uint32_t planeCount,
+        const SoaAabb& boxes, uint8_t* visible, size_t begin, size_t end) noexcept
+    {
+        size_t visibleCount = 0;
+        for (size_t i = begin; i < end; i += B::kWidth)
+        {
+            const typename B::V cx = B::Load(boxes.center.x + i), cy = B::Load(boxes.center.y + i), cz = B::Load(boxes.center.z + i);
+            const typename B::V ex = B::Load(boxes.extents.x + i), ey = B::Load(boxes.extents.y + i), ez = B::Load(boxes.extents.z + i);
+            typename B::Mask outside = B::None();
+            for (uint32_t p = 0; p < planeCount; ++p)
+            {
+                const Plane& pl = planes[p];
+                // Center distance vs. the box's projected radius on the normal.
+                const typename B::V d = B::MulAdd(cx, B::Splat(pl.nx),
+                    B::MulAdd(cy, B::Splat(pl.ny), B::MulAdd(cz, B::Splat(pl.nz), B::Splat(pl.d))));
+                const typename B::V r = B::MulAdd(ex, B::Splat(std::fabs(pl.nx)),
+                    B::MulAdd(ey, B::Splat(std::fabs(pl.ny)), B::Mul(ez, B::Splat(std::fabs(pl.nz)))));
+                outside = B::Or(outside, B::Less(d, B::Neg(r)));
+            }
+            visibleCount += StoreVisible<B>(outside, visible + i);
+        }
+        return visibleCount;
+    }
+
+    template <typename B>
+    void TransformAabbsKernel(const SoaMat4& m, const SoaAabb& in, const SoaAabb& out, size_t begin, size_t end) noexcept
+    {
+        using V = typename B::V;
+        for (size_t i = begin; i < end; i += B::kWidth)
+        {
+            const V cx = B::Load(in.center.x + i), cy = B::Load(in.center.y + i), cz = B::Load(in.center.z + i);
+            const V ex = B::Load(in.extents.x + i), ey = B::Load(in.extents.y + i), ez = B::Load(in.extents.z + i);
+
+            V c[3], e[3];
+            for (int col = 0; col < 3; ++col)
+            {
+                const V m0 = B::Load(m.m[0 * 4 + col] + i);
+                const V m1 = B::Load(m.m[1 * 4 + col] + i);
+                const V m2 = B::Load(m.m[2 * 4 + col] + i);
+                const V t  = B::Load(m.m[3 * 4 + col] + i);
+                // Center transforms as a point; extents by |M| (Arvo).
+                c[col] = B::MulAdd(cx, m0, B::MulAdd(cy, m1, B::MulAdd(cz, m2, t)));
+                e[col] = B::MulAdd(ex, B::Abs(m0), B::MulAdd(ey, B::Abs(m1), B::Mul(ez, B::Abs(m2))));
+            }
+            B::Store(out.center.x + i, c[0]);
+            B::Store(out.center.y + i, c[1]);
+            B::Store(out.center.z + i, c[2]);
+            B::Store(out.extents.x + i, e[0]);
+            B::Store(out.extents.y + i, e[1]);
+            B::Store(out.extents.z + i, e[2]);
+        }
+    }
+}
+
+const char* SimdBackendName() noexcept { return SimdBackend::kName; }
+size_t      SimdWidth() noexcept { return SimdBackend::kWidth; }
+
+void TransformPoints(const Mat4& m, const SoaFloat3& in, const SoaFloat3& out, size_t count) noexcept
+{
+    Run(count, [&](auto backend, size_t begin, size_t end) {
+        TransformPointsKernel<decltype(backend)>(m, in, out, begin, end);
+    });
+}
+
+void MultiplyMatrices(const SoaMat4& in, const Mat4& right, const SoaMat4& out, size_t count) noexcept
+{
+    Run(count, [&](auto backend, size_t begin, size_t end) {
+        MultiplyMatricesKernel<decltype(backend)>(in, right, out, begin, end);
+    });
+}
+
+size_t CullSpheres(const Plane* planes, uint32_t planeCount,
+    const SoaFloat3& centers, const float* radii, uint8_t* visible, size_t count) noexcept
+{
+    size_t visibleCount = 0;
+    Run(count, [&](auto backend, size_t begin, size_t end) {
+        visibleCount += CullSpheresKernel<decltype(backend)>(planes, planeCount, centers, radii, visible, begin, end);
+    });
+    return visibleCount;
+}
+
+size_t CullBoxes(const Plane* planes, uint32_t planeCount,
+    const SoaAabb& boxes, uint8_t* visible, size_t count) noexcept
+{
+    size_t visibleCount = 0;
+    Run(count, [&](auto backend, size_t begin, size_t end) {
+        visibleCount += CullBoxesKernel<decltype(backend)>(planes, planeCount, boxes, visible, begin, end);
+    });
+    return visibleCount;
+}
+
+void TransformAabbs(const SoaMat4& m, const SoaAabb& in, const SoaAabb& out, size_t count) noexcept
+{
+    Run(count, [&](auto backend, size_t begin, size_t end) {
+        TransformAabbsKernel<decltype(backend)>(m, in, out, begin, end);
+    });
+}
+}
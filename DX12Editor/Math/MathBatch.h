@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "MathTypes.h"
+
+// Batch math over structure-of-arrays data, vectorized with the backend
+// chosen at compile time (SimdBackend.h): each call processes 'count'
+// elements, SimdWidth() at a time, the remainder one by one. Output views may
+// alias the input views of the same call.
+namespace Math {
+
+    const char* SimdBackendName() noexcept;
+    size_t      SimdWidth() noexcept;
+
+    // out[i] = (in[i], 1) * m, affine part only (for world/view transforms,
+    // not projections).
+    void TransformPoints(const Mat4& m, const SoaFloat3& in, const SoaFloat3& out, size_t count) noexcept;
+
+    // out[i] = in[i] * right, e.g. world matrices times one view-projection.
+    void MultiplyMatrices(const SoaMat4& in, const Mat4& right, const SoaMat4& out, size_t count) noexcept;
+
+    // visible[i] = 1 unless the sphere / box is fully outside one of the
+    // planes (conservative, as usual for frustum culling). Returns the number
+    // of visible elements.
+    size_t CullSpheres(const Plane* planes, uint32_t planeCount,
+        const SoaFloat3& centers, const float* radii, uint8_t* visible, size_t count) noexcept;
+    size_t CullBoxes(const Plane* planes, uint32_t planeCount,
+        const SoaAabb& boxes, uint8_t* visible, size_t count) noexcept;
+
+    // Axis-aligned bounds of in[i] transformed by m[i] (affine part).
+    void TransformAabbs(const SoaMat4& m, const SoaAabb& in, const SoaAabb& out, size_t count) noexcept;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+
+// Portable math types: plain floats, no platform headers. Conventions match
+// DirectXMath so data converts with a memcpy: row vectors (p' = p * M),
+// row-major storage, translation in the last row.
+namespace Math {
+
+    struct Float3 {
+        float x, y, z;
+    };
+
+    struct Mat4 {
+        float m[4][4];
+
+        static constexpr Mat4 Identity() noexcept
+        {
+            return { { { 1.0f, 0.0f, 0.0f, 0.0f },
+                       { 0.0f, 1.0f, 0.0f, 0.0f },
+                       { 0.0f, 0.0f, 1.0f, 0.0f },
+                       { 0.0f, 0.0f, 0.0f, 1.0f } } };
+        }
+    };
+
+    inline Mat4 Multiply(const Mat4& a, const Mat4& b) noexcept
+    {
+        Mat4 r;
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                r.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j]
+                          + a.m[i][2] * b.m[2][j] + a.m[i][3] * b.m[3][j];
+        return r;
+    }
+
+    // n . p + d >= 0 is the inside (frustum planes, normals pointing inward).
+    struct Plane {
+        float nx, ny, nz, d;
+    };
+
+    // Structure-of-arrays views: one array per component, 'count' elements
+    // each (the count is passed to whatever consumes the view). As inputs they
+    // are only read.
+    struct SoaFloat3 {
+        float* x;
+        float* y;
+        float* z;
+    };
+
+    // m[r * 4 + c] holds element (r, c) of every matrix.
+    struct SoaMat4 {
+        float* m[16];
+    };
+
+    // Boxes as center + half extents.
+    struct SoaAabb {
+        SoaFloat3 center;
+        SoaFloat3 extents;
+    };
+}
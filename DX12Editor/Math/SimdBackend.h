@@ -0,0 +1,137 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Compile-time SIMD backend of the batch math (MathBatch.h), picked from the
+// compiler's target flags. Define MATH_FORCE_SCALAR to get the scalar path
+// everywhere (for comparison, or to rule the SIMD code out of a bug).
+//
+//   AVX2    8 lanes   /arch:AVX2, -mavx2 (-mfma for fused multiply-add)
+//   SSE     4 lanes   any x64 target
+//   NEON    4 lanes   ARM64
+//   Scalar  1 lane    anything else
+//
+// A backend is a struct of static functions over its register type, so each
+// kernel is written once as a template. ScalarBackend is always available: it
+// also finishes the elements that do not fill a whole register.
+
+#if defined(MATH_FORCE_SCALAR)
+    #define MATH_SIMD_SCALAR 1
+#elif defined(__AVX2__)
+    #define MATH_SIMD_AVX2 1
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MATH_SIMD_SSE 1
+    #include <emmintrin.h>
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+    #define MATH_SIMD_NEON 1
+    #include <arm_neon.h>
+#else
+    #define MATH_SIMD_SCALAR 1
+#endif
+
+namespace Math {
+
+    struct ScalarBackend {
+        using V = float;
+        using Mask = bool;
+        static constexpr size_t kWidth = 1;
+        static constexpr const char* kName = "scalar";
+
+        static V Load(const float* p) noexcept { return *p; }
+        static void Store(float* p, V v) noexcept { *p = v; }
+        static V Splat(float f) noexcept { return f; }
+        static V Add(V a, V b) noexcept { return a + b; }
+        static V Mul(V a, V b) noexcept { return a * b; }
+        static V MulAdd(V a, V b, V c) noexcept { return a * b + c; }
+        static V Abs(V a) noexcept { return std::fabs(a); }
+        static V Neg(V a) noexcept { return -a; }
+
+        static Mask None() noexcept { return false; }
+        static Mask Less(V a, V b) noexcept { return a < b; }
+        static Mask Or(Mask a, Mask b) noexcept { return a || b; }
+        static uint32_t Bits(Mask m) noexcept { return m ? 1u : 0u; } // bit i = lane i
+    };
+
+#if defined(MATH_SIMD_AVX2)
+    struct Avx2Backend {
+        using V = __m256;
+        using Mask = __m256;
+        static constexpr size_t kWidth = 8;
+        static constexpr const char* kName = "AVX2";
+
+        static V Load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+        static void Store(float* p, V v) noexcept { _mm256_storeu_ps(p, v); }
+        static V Splat(float f) noexcept { return _mm256_set1_ps(f); }
+        static V Add(V a, V b) noexcept { return _mm256_add_ps(a, b); }
+        static V Mul(V a, V b) noexcept { return _mm256_mul_ps(a, b); }
+#if defined(__FMA__) || defined(_MSC_VER) // MSVC's /arch:AVX2 includes FMA3
+        static V MulAdd(V a, V b, V c) noexcept { return _mm256_fmadd_ps(a, b, c); }
+#else
+        static V MulAdd(V a, V b, V c) noexcept { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+        static V Abs(V a) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+        static V Neg(V a) noexcept { return _mm256_xor_ps(_mm256_set1_ps(-0.0f), a); }
+
+        static Mask None() noexcept { return _mm256_setzero_ps(); }
+        static Mask Less(V a, V b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static Mask Or(Mask a, Mask b) noexcept { return _mm256_or_ps(a, b); }
+        static uint32_t Bits(Mask m) noexcept { return uint32_t(_mm256_movemask_ps(m)); }
+    };
+    using SimdBackend = Avx2Backend;
+
+#elif defined(MATH_SIMD_SSE)
+    struct SseBackend {
+        using V = __m128;
+        using Mask = __m128;
+        static constexpr size_t kWidth = 4;
+        static constexpr const char* kName = "SSE";
+
+        static V Load(const float* p) noexcept { return _mm_loadu_ps(p); }
+        static void Store(float* p, V v) noexcept { _mm_storeu_ps(p, v); }
+        static V Splat(float f) noexcept { return _mm_set1_ps(f); }
+        static V Add(V a, V b) noexcept { return _mm_add_ps(a, b); }
+        static V Mul(V a, V b) noexcept { return _mm_mul_ps(a, b); }
+        static V MulAdd(V a, V b, V c) noexcept { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        static V Abs(V a) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+        static V Neg(V a) noexcept { return _mm_xor_ps(_mm_set1_ps(-0.0f), a); }
+
+        static Mask None() noexcept { return _mm_setzero_ps(); }
+        static Mask Less(V a, V b) noexcept { return _mm_cmplt_ps(a, b); }
+        static Mask Or(Mask a, Mask b) noexcept { return _mm_or_ps(a, b); }
+        static uint32_t Bits(Mask m) noexcept { return uint32_t(_mm_movemask_ps(m)); }
+    };
+    using SimdBackend = SseBackend;
+
+#elif defined(MATH_SIMD_NEON)
+    struct NeonBackend {
+        using V = float32x4_t;
+        using Mask = uint32x4_t;
+        static constexpr size_t kWidth = 4;
+        static constexpr const char* kName = "NEON";
+
+        static V Load(const float* p) noexcept { return vld1q_f32(p); }
+        static void Store(float* p, V v) noexcept { vst1q_f32(p, v); }
+        static V Splat(float f) noexcept { return vdupq_n_f32(f); }
+        static V Add(V a, V b) noexcept { return vaddq_f32(a, b); }
+        static V Mul(V a, V b) noexcept { return vmulq_f32(a, b); }
+        static V MulAdd(V a, V b, V c) noexcept { return vfmaq_f32(c, a, b); }
+        static V Abs(V a) noexcept { return vabsq_f32(a); }
+        static V Neg(V a) noexcept { return vnegq_f32(a); }
+
+        static Mask None() noexcept { return vdupq_n_u32(0); }
+        static Mask Less(V a, V b) noexcept { return vcltq_f32(a, b); }
+        static Mask Or(Mask a, Mask b) noexcept { return vorrq_u32(a, b); }
+        static uint32_t Bits(Mask m) noexcept
+        {
+            static const uint32_t kLaneBits[4] = { 1u, 2u, 4u, 8u };
+            return vaddvq_u32(vandq_u32(m, vld1q_u32(kLaneBits)));
+        }
+    };
+    using SimdBackend = NeonBackend;
+
+#else
+    using SimdBackend = ScalarBackend;
+#endif
+}
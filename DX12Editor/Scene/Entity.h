@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+// Handle to an entity of a World: slot index + generation. A destroyed
+// entity's slot is reused with the next generation, so a stale handle is
+// detected (World::Alive) instead of silently naming the new occupant.
+struct Entity {
+    static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index{ kInvalidIndex };
+    uint32_t generation{ 0 };
+
+    bool Valid() const noexcept { return index != kInvalidIndex; }
+
+    bool operator==(const Entity& other) const noexcept { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const noexcept { return !(*this == other); }
+};
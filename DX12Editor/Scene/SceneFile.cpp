@@ -0,0 +1,500 @@
+#include "SceneFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+#include <unordered_map>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "../Core/Hash.h"
+
+using namespace SceneFormat;
+
+namespace {
+    bool Fail(std::string* error, std::string message)
+    {
+        if (error) *error = std::move(message);
+        return false;
+    }
+
+    constexpr uint64_t AlignUp(uint64_t v, uint64_t a) noexcept { return (v + a - 1) & ~(a - 1); }
+
+    bool KnownType(ChunkType type) noexcept { return RecordSize(type) != 0; }
+
+    // Bytes reserved for a chunk. Chunks are never rewritten in place (an
+    // edit goes to free space, see SaveIncremental), so no room to grow.
+    uint64_t Capacity(uint64_t size) noexcept { return AlignUp(size, kChunkAlign); }
+
+    // ----------------------------------------------------
+    // Files with 64-bit offsets
+    // ----------------------------------------------------
+    std::FILE* OpenFile(const std::filesystem::path& path, const char* mode)
+    {
+#if defined(_WIN32)
+        wchar_t wmode[8] = {};
+        for (size_t i = 0; mode[i] && i < 7; ++i) wmode[i] = wchar_t(mode[i]);
+        std::FILE* f = nullptr;
+        return (_wfopen_s(&f, path.c_str(), wmode) == 0) ? f : nullptr;
+#else
+        return std::fopen(path.c_str(), mode);
+#endif
+    }
+
+    bool Seek(std::FILE* f, uint64_t offset)
+    {
+#if defined(_WIN32)
+        return _fseeki64(f, int64_t(offset), SEEK_SET) == 0;
+#else
+        return fseeko(f, off_t(offset), SEEK_SET) == 0;
+#endif
+    }
+
+    bool WriteAt(std::FILE* f, uint64_t offset, const void* data, uint64_t size)
+    {
+        return Seek(f, offset) && (size == 0 || std::fwrite(data, 1, size_t(size), f) == size);
+    }
+
+    bool ReadAt(std::FILE* f, uint64_t offset, void* data, uint64_t size)
+    {
+        return Seek(f, offset) && std::fread(data, 1, size_t(size), f) == size;
+    }
+
+    // Flushes and waits until the data is on the disk, so that nothing
+    // written afterwards (the header) can reach the disk before it.
+    bool Sync(std::FILE* f)
+    {
+        if (std::fflush(f) != 0) return false;
+#if defined(_WIN32)
+        return _commit(_fileno(f)) == 0;
+#else
+        return fsync(fileno(f)) == 0;
+#endif
+    }
+
+    // Free space of an existing file: the gaps between the header, the
+    // chunks and the chunk table its header references, then the end of the
+    // file. Nothing written there can damage the scene the old header
+    // describes.
+    class FreeSpace {
+    public:
+        FreeSpace(const SceneHeader& h, const std::vector<SceneChunk>& table)
+        {
+            std::vector<std::pair<uint64_t, uint64_t>> used; // [begin, end)
+            used.reserve(table.size() + 2);
+            used.push_back({ 0, AlignUp(sizeof(SceneHeader), kChunkAlign) });
+            used.push_back({ h.chunkTableOffset, h.chunkTableOffset + table.size() * sizeof(SceneChunk) });
+            for (const SceneChunk& c : table) used.push_back({ c.offset, c.offset + c.capacity });
+            std::sort(used.begin(), used.end());
+
+            uint64_t at = 0;
+            for (const auto& u : used)
+            {
+                if (u.first > at) m_gaps.push_back({ at, u.first });
+                at = (std::max)(at, u.second);
+            }
+            m_end = AlignUp((std::max)(at, h.fileSize), kChunkAlign);
+        }
+
+        // First fit; 'size' is a multiple of kChunkAlign.
+        uint64_t Take(uint64_t size)
+        {
+            for (auto& gap : m_gaps)
+            {
+                const uint64_t begin = AlignUp(gap.first, kChunkAlign);
+                if (begin <= gap.second && size <= gap.second - begin)
+                {
+                    gap.first = begin + size;
+                    return begin;
+                }
+            }
+            const uint64_t at = m_end;
+            m_end += size;
+            return at;
+        }
+
+        uint64_t End() const noexcept { return m_end; }
+
+    private:
+        std::vector<std::pair<uint64_t, uint64_t>> m_gaps;
+        uint64_t m_end{ 0 };
+    };
+
+    // A chunk to write: its descriptor (offset/capacity still to assign) and payload.
+    struct PendingChunk {
+        SceneChunk     desc;
+        const uint8_t* data;
+    };
+
+    template <typename T>
+    void AddChunks(std::vector<PendingChunk>& out, ChunkType type, const T* records, size_t count)
+    {
+        for (size_t first = 0; first < count; first += kChunkElements)
+        {
+            const size_t n = (std::min)(size_t(kChunkElements), count - first);
+            PendingChunk c{};
+            c.desc.type = type;
+            c.desc.first = uint32_t(first);
+            c.desc.count = uint32_t(n);
+            c.desc.size = uint64_t(n) * sizeof(T);
+            c.data = reinterpret_cast<const uint8_t*>(records + first);
+            c.desc.hash = Hash64(c.data, size_t(c.desc.size));
+            out.push_back(c);
+        }
+    }
+
+    std::vector<PendingChunk> BuildChunks(const SceneData& data)
+    {
+        std::vector<PendingChunk> chunks;
+        AddChunks(chunks, ChunkType::Entities, data.entities.data(), data.entities.size());
+        AddChunks(chunks, ChunkType::Transforms, data.transforms.data(), data.transforms.size());
+        AddChunks(chunks, ChunkType::Renderables, data.renderables.data(), data.renderables.size());
+        AddChunks(chunks, ChunkType::Assets, data.assets.data(), data.assets.size());
+        if (!data.strings.empty())
+        {
+            PendingChunk c{};
+            c.desc.type = ChunkType::Strings;
+            c.desc.count = uint32_t(data.strings.size());
+            c.desc.size = data.strings.size();
+            c.data = reinterpret_cast<const uint8_t*>(data.strings.data());
+            c.desc.hash = Hash64(c.data, data.strings.size());
+            chunks.push_back(c);
+        }
+        return chunks;
+    }
+
+    SceneHeader MakeHeader(const SceneData& data, const std::vector<SceneChunk>& table,
+        uint64_t tableOffset, uint64_t fileSize, uint64_t liveBytes)
+    {
+        SceneHeader h{};
+        h.magic = kMagic;
+        h.version = kVersion;
+        h.headerSize = sizeof(SceneHeader);
+        h.chunkCount = uint32_t(table.size());
+        h.chunkTableOffset = tableOffset;
+        h.fileSize = fileSize;
+        h.entityCount = uint32_t(data.entities.size());
+        h.renderableCount = uint32_t(data.renderables.size());
+        h.assetCount = uint32_t(data.assets.size());
+        h.tableHash = Hash64(table.data(), table.size() * sizeof(SceneChunk));
+        h.liveBytes = liveBytes;
+        return h;
+    }
+
+    bool SaveFull(const std::filesystem::path& path, const SceneData& data,
+        std::vector<PendingChunk>& chunks, SceneSaveStats& stats, std::string* error)
+    {
+        std::filesystem::path tmp = path;
+        tmp += ".tmp";
+        std::FILE* f = OpenFile(tmp, "wb");
+        if (!f) return Fail(error, "cannot create " + tmp.string());
+
+        std::vector<SceneChunk> table;
+        table.reserve(chunks.size());
+        uint64_t end = AlignUp(sizeof(SceneHeader), kChunkAlign);
+        bool ok = true;
+        for (PendingChunk& c : chunks)
+        {
+            c.desc.offset = end;
+            c.desc.capacity = Capacity(c.desc.size);
+            ok = ok && WriteAt(f, c.desc.offset, c.data, c.desc.size);
+            end += c.desc.capacity;
+            table.push_back(c.desc);
+            stats.bytesWritten += c.desc.size;
+        }
+        const uint64_t tableOffset = end;
+        const uint64_t tableSize = table.size() * sizeof(SceneChunk);
+        end += tableSize;
+
+        const SceneHeader header = MakeHeader(data, table, tableOffset, end, end);
+        ok = ok && WriteAt(f, tableOffset, table.data(), tableSize)
+                && WriteAt(f, 0, &header, sizeof(header)) && Sync(f); // on disk before the rename
+        ok = (std::fclose(f) == 0) && ok;
+        stats.chunksWritten = uint32_t(chunks.size());
+        stats.bytesWritten += tableSize + sizeof(header);
+        stats.fullRewrite = true;
+        if (!ok)
+        {
+            std::error_code ec;
+            std::filesystem::remove(tmp, ec);
+            return Fail(error, "write failed: " + tmp.string());
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec); // replaces an existing file
+        if (ec) return Fail(error, "cannot replace " + path.string() + ": " + ec.message());
+        return true;
+    }
+
+    // Returns false (without touching the file) when the file is missing, not
+    // a valid scene or due for compaction: the caller then saves in full.
+    bool SaveIncremental(const std::filesystem::path& path, const SceneData& data,
+        std::vector<PendingChunk>& chunks, SceneSaveStats& stats, bool& written)
+    {
+        written = false;
+        std::FILE* f = OpenFile(path, "r+b");
+        if (!f) return false;
+
+        SceneHeader old{};
+        std::vector<SceneChunk> oldTable;
+        bool usable = ReadAt(f, 0, &old, sizeof(old))
+            && old.magic == kMagic && old.version == kVersion && old.headerSize == sizeof(SceneHeader)
+            && old.fileSize - old.liveBytes <= old.liveBytes; // else compact
+        usable = usable && old.chunkTableOffset <= old.fileSize
+            && uint64_t(old.chunkCount) * sizeof(SceneChunk) <= old.fileSize - old.chunkTableOffset;
+        if (usable)
+        {
+            oldTable.resize(old.chunkCount);
+            usable = ReadAt(f, old.chunkTableOffset, oldTable.data(), oldTable.size() * sizeof(SceneChunk))
+                && Hash64(oldTable.data(), oldTable.size() * sizeof(SceneChunk)) == old.tableHash;
+        }
+        if (!usable)
+        {
+            std::fclose(f);
+            return false;
+        }
+
+        auto key = [](ChunkType type, uint32_t first) { return (uint64_t(type) << 32) | first; };
+        std::unordered_map<uint64_t, const SceneChunk*> previous;
+        for (const SceneChunk& c : oldTable) previous[key(c.type, c.first)] = &c;
+
+        // Changed chunks never overwrite what the old table references: they
+        // go to free space, so a crash before the header switch leaves the
+        // old scene intact.
+        FreeSpace free(old, oldTable);
+        std::vector<SceneChunk> table;
+        table.reserve(chunks.size());
+        uint64_t live = AlignUp(sizeof(SceneHeader), kChunkAlign);
+        bool ok = true;
+        for (PendingChunk& c : chunks)
+        {
+            auto it = previous.find(key(c.desc.type, c.desc.first));
+            const SceneChunk* prev = (it != previous.end()) ? it->second : nullptr;
+            if (prev && prev->hash == c.desc.hash && prev->size == c.desc.size && prev->count == c.desc.count)
+            {
+                c.desc.offset = prev->offset;
+                c.desc.capacity = prev->capacity;
+                ++stats.chunksSkipped;
+            }
+            else
+            {
+                c.desc.capacity = Capacity(c.desc.size);
+                c.desc.offset = free.Take(c.desc.capacity);
+                ok = ok && WriteAt(f, c.desc.offset, c.data, c.desc.size);
+                ++stats.chunksWritten;
+                stats.bytesWritten += c.desc.size;
+            }
+            live += c.desc.capacity;
+            table.push_back(c.desc);
+        }
+
+        // New table after everything, header last: until the header is
+        // written the old table stays in effect. Both syncs order the
+        // writes on disk, not just in the file cache.
+        const uint64_t tableOffset = free.End();
+        const uint64_t tableSize = table.size() * sizeof(SceneChunk);
+        const uint64_t end = tableOffset + tableSize;
+        live += tableSize;
+        ok = ok && WriteAt(f, tableOffset, table.data(), tableSize) && Sync(f);
+
+        const SceneHeader header = MakeHeader(data, table, tableOffset, end, live);
+        ok = ok && WriteAt(f, 0, &header, sizeof(header)) && Sync(f);
+        ok = (std::fclose(f) == 0) && ok;
+        stats.bytesWritten += tableSize + sizeof(header);
+        written = true;
+        return ok;
+    }
+}
+
+uint32_t SceneData::AddAsset(AssetRecord::Kind kind, std::string_view name)
+{
+    for (uint32_t i = 0; i < assets.size(); ++i)
+    {
+        const AssetRecord& a = assets[i];
+        if (a.kind == kind && std::string_view(strings).substr(a.nameOffset, a.nameLength) == name)
+            return i;
+    }
+    AssetRecord a{};
+    a.kind = kind;
+    a.nameOffset = uint32_t(strings.size());
+    a.nameLength = uint32_t(name.size());
+    strings.append(name);
+    assets.push_back(a);
+    return uint32_t(assets.size() - 1);
+}
+
+// ========================================================
+// Reader
+// ========================================================
+bool SceneFileReader::Open(const std::filesystem::path& path, std::string* error) noexcept
+{
+    Close();
+    if (!m_file.Open(path)) return Fail(error, "cannot map " + path.string());
+
+    const uint8_t* base = m_file.Data();
+    const uint64_t fileSize = m_file.Size();
+    if (fileSize < sizeof(SceneHeader)) return Close(), Fail(error, "file too small");
+
+    const SceneHeader* h = reinterpret_cast<const SceneHeader*>(base);
+    if (h->magic != kMagic) return Close(), Fail(error, "not a scene file");
+    if (h->version != kVersion || h->headerSize != sizeof(SceneHeader))
+        return Close(), Fail(error, "unsupported scene version " + std::to_string(h->version));
+    if (h->fileSize > fileSize) return Close(), Fail(error, "truncated file");
+
+    const uint64_t tableSize = uint64_t(h->chunkCount) * sizeof(SceneChunk);
+    if (h->chunkTableOffset % alignof(SceneChunk) != 0 || h->chunkTableOffset > h->fileSize ||
+        tableSize > h->fileSize - h->chunkTableOffset)
+        return Close(), Fail(error, "chunk table out of bounds");
+
+    const SceneChunk* chunks = reinterpret_cast<const SceneChunk*>(base + h->chunkTableOffset);
+    if (Hash64(chunks, size_t(tableSize)) != h->tableHash) return Close(), Fail(error, "chunk table hash mismatch");
+
+    // Cheap per-chunk checks, so Records() never points outside the mapping.
+    for (uint32_t i = 0; i < h->chunkCount; ++i)
+    {
+        const SceneChunk& c = chunks[i];
+        if (!KnownType(c.type)) return Close(), Fail(error, "chunk " + std::to_string(i) + ": unknown type");
+        if (c.offset % kChunkAlign != 0 || c.offset > h->fileSize || c.size > h->fileSize - c.offset ||
+            c.size != uint64_t(c.count) * RecordSize(c.type) || c.size > c.capacity)
+            return Close(), Fail(error, "chunk " + std::to_string(i) + ": bad bounds");
+
+        if (c.type == ChunkType::Assets) m_assetChunks.push_back(i);
+        if (c.type == ChunkType::Strings)
+        {
+            m_strings = reinterpret_cast<const char*>(base + c.offset);
+            m_stringsSize = c.size;
+        }
+    }
+
+    m_header = h;
+    m_chunks = chunks;
+    return true;
+}
+
+void SceneFileReader::Close() noexcept
+{
+    m_file.Close();
+    m_header = nullptr;
+    m_chunks = nullptr;
+    m_assetChunks.clear();
+    m_strings = nullptr;
+    m_stringsSize = 0;
+}
+
+const AssetRecord* SceneFileReader::Asset(uint32_t index) const noexcept
+{
+    for (uint32_t ci : m_assetChunks)
+    {
+        const SceneChunk& c = m_chunks[ci];
+        if (index >= c.first && index - c.first < c.count)
+            return Records<AssetRecord>(c) + (index - c.first);
+    }
+    return nullptr;
+}
+
+std::string_view SceneFileReader::AssetName(const AssetRecord& asset) const noexcept
+{
+    if (!m_strings || asset.nameOffset > m_stringsSize || asset.nameLength > m_stringsSize - asset.nameOffset)
+        return {};
+    return std::string_view(m_strings + asset.nameOffset, asset.nameLength);
+}
+
+bool SceneFileReader::VerifyPayloads(std::string* error) const noexcept
+{
+    if (!m_header) return Fail(error, "not open");
+    for (uint32_t i = 0; i < m_header->chunkCount; ++i)
+    {
+        const SceneChunk& c = m_chunks[i];
+        if (Hash64(m_file.Data() + c.offset, size_t(c.size)) != c.hash)
+            return Fail(error, "chunk " + std::to_string(i) + ": payload hash mismatch");
+    }
+    return true;
+}
+
+bool SceneFileReader::Validate(std::string* error) const noexcept
+{
+    if (!VerifyPayloads(error)) return false;
+    const SceneHeader& h = *m_header;
+
+    // Every element of every record type covered exactly once.
+    struct Coverage { uint64_t expected; uint64_t seen; const char* name; };
+    Coverage coverage[6] = {};
+    coverage[uint32_t(ChunkType::Entities)] = { h.entityCount, 0, "entities" };
+    coverage[uint32_t(ChunkType::Transforms)] = { h.entityCount, 0, "transforms" };
+    coverage[uint32_t(ChunkType::Renderables)] = { h.renderableCount, 0, "renderables" };
+    coverage[uint32_t(ChunkType::Assets)] = { h.assetCount, 0, "assets" };
+    coverage[uint32_t(ChunkType::Strings)] = { m_stringsSize, 0, "strings" };
+
+    for (uint32_t i = 0; i < h.chunkCount; ++i)
+    {
+        const SceneChunk& c = m_chunks[i];
+        const std::string where = "chunk " + std::to_string(i) + ": ";
+        for (uint32_t j = 0; j < i; ++j)
+        {
+            const SceneChunk& o = m_chunks[j];
+            if (c.offset < o.offset + o.capacity && o.offset < c.offset + c.capacity)
+                return Fail(error, where + "overlaps chunk " + std::to_string(j));
+        }
+
+        Coverage& cov = coverage[uint32_t(c.type)];
+        if (c.type != ChunkType::Strings && c.first != cov.seen)
+            return Fail(error, where + "chunks out of order");
+        if (c.type != ChunkType::Strings && uint64_t(c.first) + c.count > cov.expected)
+            return Fail(error, where + "elements past the header count");
+        cov.seen += c.count;
+
+        if (c.type == ChunkType::Entities)
+        {
+            const EntityRecord* e = Records<EntityRecord>(c);
+            for (uint32_t k = 0; k < c.count; ++k)
+                if (e[k].parent != kNone && (e[k].parent >= h.entityCount || e[k].parent == c.first + k))
+                    return Fail(error, where + "bad parent of entity " + std::to_string(c.first + k));
+        }
+        else if (c.type == ChunkType::Renderables)
+        {
+            const RenderableRecord* r = Records<RenderableRecord>(c);
+            for (uint32_t k = 0; k < c.count; ++k)
+                if (r[k].entity >= h.entityCount || r[k].meshAsset >= h.assetCount || r[k].materialAsset >= h.assetCount)
+                    return Fail(error, where + "bad reference in renderable " + std::to_string(c.first + k));
+        }
+        else if (c.type == ChunkType::Assets)
+        {
+            const AssetRecord* a = Records<AssetRecord>(c);
+            for (uint32_t k = 0; k < c.count; ++k)
+                if (uint64_t(a[k].nameOffset) + a[k].nameLength > m_stringsSize)
+                    return Fail(error, where + "asset name out of range");
+        }
+    }
+
+    for (uint32_t t = 1; t < 6; ++t)
+        if (coverage[t].seen != coverage[t].expected)
+            return Fail(error, std::string("incomplete ") + coverage[t].name);
+    return true;
+}
+
+// ========================================================
+// Writer
+// ========================================================
+bool SaveSceneFile(const std::filesystem::path& path, const SceneData& data, SceneSaveMode mode,
+    SceneSaveStats* stats, std::string* error)
+{
+    if (data.transforms.size() != data.entities.size())
+        return Fail(error, "one transform record per entity expected");
+
+    std::vector<PendingChunk> chunks = BuildChunks(data);
+    SceneSaveStats local;
+    SceneSaveStats& s = stats ? *stats : local;
+    s = SceneSaveStats{};
+
+    if (mode == SceneSaveMode::Incremental)
+    {
+        bool written = false;
+        const bool ok = SaveIncremental(path, data, chunks, s, written);
+        if (written) return ok ? true : Fail(error, "write failed: " + path.string());
+        s = SceneSaveStats{};
+    }
+    return SaveFull(path, data, chunks, s, error);
+}
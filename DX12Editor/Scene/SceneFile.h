@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SceneFormat.h"
+#include "../Core/MappedFile.h"
+
+// Scene content in file layout: what the writer takes and, record for
+// record, what the reader hands back. Platform-neutral (no World, no
+// DirectXMath), so tools can produce and check scene files headlessly.
+struct SceneData {
+    std::vector<SceneFormat::EntityRecord>     entities;
+    std::vector<SceneFormat::TransformRecord>  transforms;  // one per entity
+    std::vector<SceneFormat::RenderableRecord> renderables;
+    std::vector<SceneFormat::AssetRecord>      assets;
+    std::string                                strings;
+
+    // Index of the asset (kind, name), added on first use.
+    uint32_t AddAsset(SceneFormat::AssetRecord::Kind kind, std::string_view name);
+};
+
+// Zero-parse reader: maps the file, checks the header and the chunk table,
+// and hands out pointers into the mapping. Opening costs the same for any
+// scene size; record pages are only read when touched.
+class SceneFileReader {
+public:
+    bool Open(const std::filesystem::path& path, std::string* error = nullptr) noexcept;
+    void Close() noexcept;
+
+    // Payload hashes of every chunk, e.g. against a torn write. Reads the
+    // whole file; LoadScene does this before using any record.
+    bool VerifyPayloads(std::string* error = nullptr) const noexcept;
+
+    // Full check: payload hashes, record counts, and every index and name
+    // range in the records. Reads the whole file.
+    bool Validate(std::string* error = nullptr) const noexcept;
+
+    const SceneFormat::SceneHeader& Header() const noexcept { return *m_header; }
+    uint32_t ChunkCount() const noexcept { return m_header->chunkCount; }
+    const SceneFormat::SceneChunk& Chunk(uint32_t i) const noexcept { return m_chunks[i]; }
+
+    // Payload of a chunk as its records (Open checked bounds and sizes).
+    template <typename T>
+    const T* Records(const SceneFormat::SceneChunk& chunk) const noexcept
+    {
+        return reinterpret_cast<const T*>(m_file.Data() + chunk.offset);
+    }
+
+    // Asset by index (asset chunks are read in order).
+    const SceneFormat::AssetRecord* Asset(uint32_t index) const noexcept;
+    std::string_view AssetName(const SceneFormat::AssetRecord& asset) const noexcept;
+
+private:
+    MappedFile m_file;
+    const SceneFormat::SceneHeader* m_header{ nullptr };
+    const SceneFormat::SceneChunk*  m_chunks{ nullptr };
+    std::vector<uint32_t> m_assetChunks; // chunk indices of type Assets
+    const char* m_strings{ nullptr };
+    uint64_t    m_stringsSize{ 0 };
+};
+
+struct SceneSaveStats {
+    uint32_t chunksWritten{ 0 };
+    uint32_t chunksSkipped{ 0 };  // unchanged since the file on disk
+    uint64_t bytesWritten{ 0 };
+    bool     fullRewrite{ false };
+};
+
+enum class SceneSaveMode {
+    Full,        // write a fresh file next to it, then replace
+    Incremental, // write only changed chunks (falls back to Full if needed)
+};
+
+// Writes 'data' to 'path'. Incremental saves compare chunk hashes with the
+// file on disk: unchanged chunks are skipped, changed ones are written to
+// space the current table does not reference (gaps, or the end of the file),
+// then a new chunk table is appended, synced, and the header switched over
+// last. A crash at any point leaves either the old or the new scene. Once
+// dead space exceeds the live data the file is compacted by a full rewrite.
+// Close any SceneFileReader on 'path' first.
+bool SaveSceneFile(const std::filesystem::path& path, const SceneData& data, SceneSaveMode mode,
+    SceneSaveStats* stats = nullptr, std::string* error = nullptr);
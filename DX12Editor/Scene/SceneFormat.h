@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+
+// On-disk layout of a binary scene (.dxscene). Little-endian, every struct
+// is plain data with explicit padding so the file can be used straight from a
+// memory mapping: no parsing, no pointer fix-ups. All references are offsets
+// or indices (file offsets for chunks, offsets into the string chunk for
+// names, entity/asset indices in records), never pointers.
+//
+//   SceneHeader                          at 0
+//   chunk payloads                       each at a kChunkAlign offset
+//   SceneChunk[header.chunkCount]        at header.chunkTableOffset
+//
+// Entity data is split per component into chunks of up to kChunkElements
+// records. A chunk is the unit of incremental save: it carries the hash of
+// its payload, so an unchanged chunk is not written at all and an edited one
+// is written to free space while the old copy stays valid.
+namespace SceneFormat {
+
+    constexpr uint32_t kMagic = 0x43535844u; // "DXSC"
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kChunkAlign = 64;
+    constexpr uint32_t kChunkElements = 16 * 1024;
+    constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+    enum class ChunkType : uint32_t {
+        Entities = 1,    // EntityRecord per entity
+        Transforms = 2,  // TransformRecord per entity
+        Renderables = 3, // RenderableRecord, sparse (only entities that draw)
+        Assets = 4,      // AssetRecord per referenced asset
+        Strings = 5,     // UTF-8 bytes, names are (offset, length) into it
+    };
+
+    struct SceneHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerSize;      // sizeof(SceneHeader), for forward compatibility checks
+        uint32_t chunkCount;
+        uint64_t chunkTableOffset;
+        uint64_t fileSize;        // bytes in use (the file may be longer after a failed save)
+        uint32_t entityCount;
+        uint32_t renderableCount;
+        uint32_t assetCount;
+        uint32_t reserved;
+        uint64_t tableHash;       // Hash64 of the chunk table
+        uint64_t liveBytes;       // sum of chunk capacities + table; the rest is dead space
+    };
+    static_assert(sizeof(SceneHeader) == 64, "SceneHeader layout");
+
+    struct SceneChunk {
+        ChunkType type;
+        uint32_t  first;          // index of the first element
+        uint32_t  count;          // elements in the chunk
+        uint32_t  reserved;
+        uint64_t  offset;         // file offset of the payload
+        uint64_t  size;           // payload bytes
+        uint64_t  capacity;       // bytes reserved at offset (>= size)
+        uint64_t  hash;           // Hash64 of the payload
+    };
+    static_assert(sizeof(SceneChunk) == 48, "SceneChunk layout");
+
+    struct EntityRecord {
+        enum : uint32_t { kHasTransform = 1, kHasRenderable = 2 };
+
+        uint32_t parent;          // entity index in the file, kNone for roots
+        uint32_t flags;
+    };
+    static_assert(sizeof(EntityRecord) == 8, "EntityRecord layout");
+
+    // Local transform; identity when the entity has none.
+    struct TransformRecord {
+        float position[3];
+        float rotation[4];        // quaternion x, y, z, w
+        float scale[3];
+    };
+    static_assert(sizeof(TransformRecord) == 40, "TransformRecord layout");
+
+    struct RenderableRecord {
+        uint32_t entity;
+        uint32_t pipeline;
+        uint32_t meshAsset;       // index into the asset records
+        uint32_t materialAsset;
+        uint32_t firstVertex;
+        uint32_t vertexCount;
+        uint32_t flags;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(RenderableRecord) == 32, "RenderableRecord layout");
+
+    struct AssetRecord {
+        enum Kind : uint32_t { Mesh = 1, Material = 2 };
+
+        Kind     kind;
+        uint32_t nameOffset;      // into the string chunk
+        uint32_t nameLength;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(AssetRecord) == 16, "AssetRecord layout");
+
+    // Fixed record size of a chunk type (1 for the string bytes).
+    constexpr uint32_t RecordSize(ChunkType type) noexcept
+    {
+        switch (type)
+        {
+        case ChunkType::Entities:    return sizeof(EntityRecord);
+        case ChunkType::Transforms:  return sizeof(TransformRecord);
+        case ChunkType::Renderables: return sizeof(RenderableRecord);
+        case ChunkType::Assets:      return sizeof(AssetRecord);
+        case ChunkType::Strings:     return 1;
+        }
+        return 0;
+    }
+}
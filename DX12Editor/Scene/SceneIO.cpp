@@ -0,0 +1,173 @@
+#include "SceneIO.h"
+#include <algorithm>
+
+#include "World.h"
+
+using namespace SceneFormat;
+
+namespace {
+    constexpr uint32_t kUnknownAsset = 0xFFFFFFFFu;
+
+    std::string_view NameOf(const std::vector<std::string>& names, uint32_t id)
+    {
+        return id < names.size() ? std::string_view(names[id]) : std::string_view("unknown");
+    }
+
+    uint32_t IdOf(const std::vector<std::string>& names, std::string_view name)
+    {
+        const auto it = std::find(names.begin(), names.end(), name);
+        return it != names.end() ? uint32_t(it - names.begin()) : kUnknownAsset;
+    }
+}
+
+SceneData BuildSceneData(const World& world, const SceneAssetNames& names)
+{
+    const TransformStore& transforms = world.Transforms();
+    const SparseSet<Renderable>& renderables = world.Renderables();
+
+    auto editorOnly = [&](uint32_t entity) {
+        const Renderable* r = renderables.TryGet(entity);
+        return r && (r->draw.flags & ProxyDraw::kEditorOnly) != 0;
+    };
+
+    // World entity index -> file index. Transforms first, in dense order
+    // (parents before children once the hierarchy is sorted), then entities
+    // that only draw.
+    uint32_t maxIndex = 0;
+    for (uint32_t i = 0; i < transforms.Size(); ++i) maxIndex = (std::max)(maxIndex, transforms.Entities()[i] + 1);
+    for (uint32_t i = 0; i < renderables.Size(); ++i) maxIndex = (std::max)(maxIndex, renderables.Entities()[i] + 1);
+    std::vector<uint32_t> fileIndex(maxIndex, kNone);
+    std::vector<uint32_t> order;
+    order.reserve(maxIndex);
+    auto assign = [&](uint32_t entity) {
+        if (fileIndex[entity] != kNone || editorOnly(entity)) return;
+        fileIndex[entity] = uint32_t(order.size());
+        order.push_back(entity);
+    };
+    for (uint32_t i = 0; i < transforms.Size(); ++i) assign(transforms.Entities()[i]);
+    for (uint32_t i = 0; i < renderables.Size(); ++i) assign(renderables.Entities()[i]);
+
+    SceneData data;
+    data.entities.resize(order.size());
+    data.transforms.resize(order.size());
+    for (uint32_t f = 0; f < order.size(); ++f)
+    {
+        EntityRecord& e = data.entities[f];
+        TransformRecord& t = data.transforms[f];
+        e.parent = kNone;
+        e.flags = 0;
+        t = TransformRecord{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f } };
+
+        const uint32_t slot = transforms.Slot(order[f]);
+        if (slot != SparseIndex::kNone)
+        {
+            const Transform tr = transforms.Get(slot);
+            t = TransformRecord{ { tr.position.x, tr.position.y, tr.position.z },
+                                 { tr.rotation.x, tr.rotation.y, tr.rotation.z, tr.rotation.w },
+                                 { tr.scale.x, tr.scale.y, tr.scale.z } };
+            e.flags |= EntityRecord::kHasTransform;
+            const uint32_t parent = transforms.Parent(slot);
+            if (parent != TransformStore::kNoParent && parent < maxIndex) e.parent = fileIndex[parent];
+        }
+
+        if (const Renderable* r = renderables.TryGet(order[f]))
+        {
+            RenderableRecord rec{};
+            rec.entity = f;
+            rec.pipeline = r->draw.pipeline;
+            rec.meshAsset = data.AddAsset(AssetRecord::Mesh, NameOf(names.meshes, r->draw.mesh));
+            rec.materialAsset = data.AddAsset(AssetRecord::Material, NameOf(names.materials, r->draw.material));
+            rec.firstVertex = r->draw.firstVertex;
+            rec.vertexCount = r->draw.vertexCount;
+            rec.flags = r->draw.flags;
+            data.renderables.push_back(rec);
+            e.flags |= EntityRecord::kHasRenderable;
+        }
+    }
+    return data;
+}
+
+bool SaveScene(const World& world, const SceneAssetNames& names, const std::filesystem::path& path,
+    SceneSaveMode mode, SceneSaveStats* stats, std::string* error)
+{
+    return SaveSceneFile(path, BuildSceneData(world, names), mode, stats, error);
+}
+
+bool LoadScene(const std::filesystem::path& path, const SceneAssetNames& names, World& world,
+    std::vector<Entity>* created, std::string* error)
+{
+    SceneFileReader reader;
+    if (!reader.Open(path, error) || !reader.VerifyPayloads(error)) return false;
+    const SceneHeader& h = reader.Header();
+
+    // File asset index -> runtime id.
+    std::vector<uint32_t> assetIds(h.assetCount, kUnknownAsset);
+    for (uint32_t i = 0; i < h.assetCount; ++i)
+        if (const AssetRecord* a = reader.Asset(i))
+            assetIds[i] = IdOf(a->kind == AssetRecord::Mesh ? names.meshes : names.materials, reader.AssetName(*a));
+
+    std::vector<Entity> handles(h.entityCount);
+    world.Reserve(world.AliveCount() + h.entityCount);
+    for (Entity& e : handles) e = world.Create();
+
+    // Components straight from the mapped records. Parents are linked after
+    // all transforms exist, since a parent's record may come later.
+    for (uint32_t i = 0; i < reader.ChunkCount(); ++i)
+    {
+        const SceneChunk& ec = reader.Chunk(i);
+        if (ec.type != ChunkType::Entities || uint64_t(ec.first) + ec.count > h.entityCount) continue;
+        const EntityRecord* e = reader.Records<EntityRecord>(ec);
+
+        // The transform chunk covering the same entities.
+        const TransformRecord* t = nullptr;
+        for (uint32_t j = 0; j < reader.ChunkCount() && !t; ++j)
+        {
+            const SceneChunk& tc = reader.Chunk(j);
+            if (tc.type == ChunkType::Transforms && tc.first == ec.first && tc.count == ec.count)
+                t = reader.Records<TransformRecord>(tc);
+        }
+        if (!t) continue;
+
+        for (uint32_t k = 0; k < ec.count; ++k)
+        {
+            if (!(e[k].flags & EntityRecord::kHasTransform)) continue;
+            Transform tr;
+            tr.position = { t[k].position[0], t[k].position[1], t[k].position[2] };
+            tr.rotation = { t[k].rotation[0], t[k].rotation[1], t[k].rotation[2], t[k].rotation[3] };
+            tr.scale = { t[k].scale[0], t[k].scale[1], t[k].scale[2] };
+            world.SetTransform(handles[ec.first + k], tr);
+        }
+    }
+    for (uint32_t i = 0; i < reader.ChunkCount(); ++i)
+    {
+        const SceneChunk& c = reader.Chunk(i);
+        if (c.type == ChunkType::Entities && uint64_t(c.first) + c.count <= h.entityCount)
+        {
+            const EntityRecord* e = reader.Records<EntityRecord>(c);
+            for (uint32_t k = 0; k < c.count; ++k)
+                if (e[k].parent < h.entityCount)
+                    world.SetParent(handles[c.first + k], handles[e[k].parent]);
+        }
+        else if (c.type == ChunkType::Renderables)
+        {
+            const RenderableRecord* r = reader.Records<RenderableRecord>(c);
+            for (uint32_t k = 0; k < c.count; ++k)
+            {
+                if (r[k].entity >= h.entityCount || r[k].meshAsset >= h.assetCount || r[k].materialAsset >= h.assetCount)
+                    continue;
+                ProxyDraw draw{};
+                draw.pipeline = r[k].pipeline;
+                draw.mesh = assetIds[r[k].meshAsset];
+                draw.material = assetIds[r[k].materialAsset];
+                draw.firstVertex = r[k].firstVertex;
+                draw.vertexCount = r[k].vertexCount;
+                draw.flags = r[k].flags;
+                if (draw.mesh != kUnknownAsset && draw.material != kUnknownAsset)
+                    world.SetRenderable(handles[r[k].entity], draw);
+            }
+        }
+    }
+
+    if (created) *created = std::move(handles);
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Entity.h"
+#include "SceneFile.h"
+
+class World;
+
+// Asset names of the runtime mesh / material ids (index = id). Scene files
+// reference assets by name, so ids can change between builds.
+struct SceneAssetNames {
+    std::vector<std::string> meshes;
+    std::vector<std::string> materials;
+};
+
+// World <-> scene file. Saved: every entity with a transform or renderable,
+// except renderables flagged ProxyDraw::kEditorOnly (grid, gizmos).
+SceneData BuildSceneData(const World& world, const SceneAssetNames& names);
+bool SaveScene(const World& world, const SceneAssetNames& names, const std::filesystem::path& path,
+    SceneSaveMode mode, SceneSaveStats* stats = nullptr, std::string* error = nullptr);
+
+// Adds the file's entities to 'world' (existing entities are kept), in file
+// order into 'created' when given. Renderables naming an unknown asset are
+// dropped; the entity itself is still created.
+bool LoadScene(const std::filesystem::path& path, const SceneAssetNames& names, World& world,
+    std::vector<Entity>* created = nullptr, std::string* error = nullptr);
@@ -0,0 +1,113 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Sparse-set index: entity index -> dense slot. Dense slots are packed
+// (0..Size()-1) so component data can live in plain arrays and be iterated
+// without holes; removal moves the last element into the freed slot.
+class SparseIndex {
+public:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+    uint32_t Find(uint32_t entity) const noexcept
+    {
+        return entity < m_sparse.size() ? m_sparse[entity] : kNone;
+    }
+    bool Has(uint32_t entity) const noexcept { return Find(entity) != kNone; }
+
+    // Appends 'entity' (must not be present), returns its dense slot.
+    uint32_t Insert(uint32_t entity)
+    {
+        assert(!Has(entity));
+        if (entity >= m_sparse.size()) m_sparse.resize(size_t(entity) + 1, kNone);
+        const uint32_t slot = uint32_t(m_dense.size());
+        m_sparse[entity] = slot;
+        m_dense.push_back(entity);
+        return slot;
+    }
+
+    // Removes 'entity' and returns the slot it had (kNone if absent). The
+    // element that was last now belongs in that slot: the caller moves its
+    // data from index Size() (the old last slot) unless the two are equal.
+    uint32_t Erase(uint32_t entity) noexcept
+    {
+        const uint32_t slot = Find(entity);
+        if (slot == kNone) return kNone;
+
+        const uint32_t last = m_dense.back();
+        m_dense[slot] = last;
+        m_sparse[last] = slot;
+        m_dense.pop_back();
+        m_sparse[entity] = kNone;
+        return slot;
+    }
+
+    // Reorders the dense slots: new slot i holds the entity of old slot order[i].
+    void Permute(const uint32_t* order)
+    {
+        std::vector<uint32_t> dense(m_dense.size());
+        for (uint32_t slot = 0; slot < dense.size(); ++slot)
+        {
+            dense[slot] = m_dense[order[slot]];
+            m_sparse[dense[slot]] = slot;
+        }
+        m_dense.swap(dense);
+    }
+
+    uint32_t Size() const noexcept { return uint32_t(m_dense.size()); }
+    const uint32_t* Entities() const noexcept { return m_dense.data(); } // dense order
+
+    void Reserve(size_t entities) { m_sparse.reserve(entities); m_dense.reserve(entities); }
+    void Clear() noexcept { m_sparse.clear(); m_dense.clear(); }
+
+private:
+    std::vector<uint32_t> m_sparse; // by entity index
+    std::vector<uint32_t> m_dense;  // entity index of each slot
+};
+
+// Component pool on a sparse-set index (AoS: one T per slot).
+template <typename T>
+class SparseSet {
+public:
+    bool Has(uint32_t entity) const noexcept { return m_index.Has(entity); }
+
+    // Adds or replaces the component of 'entity'.
+    T& Add(uint32_t entity, const T& value)
+    {
+        const uint32_t slot = m_index.Find(entity);
+        if (slot != SparseIndex::kNone) return m_data[slot] = value;
+        m_index.Insert(entity);
+        m_data.push_back(value);
+        return m_data.back();
+    }
+
+    void Remove(uint32_t entity) noexcept
+    {
+        const uint32_t slot = m_index.Erase(entity);
+        if (slot == SparseIndex::kNone) return;
+        if (slot != m_index.Size()) m_data[slot] = std::move(m_data.back());
+        m_data.pop_back();
+    }
+
+    T* TryGet(uint32_t entity) noexcept
+    {
+        const uint32_t slot = m_index.Find(entity);
+        return slot != SparseIndex::kNone ? &m_data[slot] : nullptr;
+    }
+    const T* TryGet(uint32_t entity) const noexcept { return const_cast<SparseSet*>(this)->TryGet(entity); }
+
+    uint32_t Size() const noexcept { return m_index.Size(); }
+    T* Data() noexcept { return m_data.data(); }
+    const T* Data() const noexcept { return m_data.data(); }
+    const uint32_t* Entities() const noexcept { return m_index.Entities(); }
+
+    void Reserve(size_t count) { m_index.Reserve(count); m_data.reserve(count); }
+    void Clear() noexcept { m_index.Clear(); m_data.clear(); }
+
+private:
+    SparseIndex    m_index;
+    std::vector<T> m_data;
+};
@@ -0,0 +1,340 @@
+#include "TransformStore.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "../Core/JobSystem.h"
+
+using namespace DirectX;
+
+namespace {
+    // Applies a slot permutation to one column: new[i] = old[order[i]].
+    template <typename T>
+    void Permute(std::vector<T>& column, const std::vector<uint32_t>& order)
+    {
+        std::vector<T> sorted(column.size());
+        for (size_t i = 0; i < order.size(); ++i) sorted[i] = column[order[i]];
+        column.swap(sorted);
+    }
+
+    template <typename T>
+    void SwapRemove(std::vector<T>& column, uint32_t slot)
+    {
+        if (slot + 1 != column.size()) column[slot] = column.back();
+        column.pop_back();
+    }
+}
+
+void TransformStore::Add(uint32_t entity, const Transform& transform)
+{
+    uint32_t slot = m_index.Find(entity);
+    if (slot == SparseIndex::kNone)
+    {
+        slot = m_index.Insert(entity);
+        for (std::vector<float>& column : m_columns) column.push_back(0.0f);
+        m_parent.push_back(kNoParent);
+        m_childCount.push_back(0);
+        m_local.emplace_back();
+        m_world.emplace_back();
+        m_dirty.push_back(1);
+        m_worldChanged.push_back(0);
+        if (m_links > 0) m_unsorted = true; // a new root behind deeper levels
+    }
+    Set(slot, transform);
+}
+
+void TransformStore::Remove(uint32_t entity) noexcept
+{
+    const uint32_t slot = m_index.Find(entity);
+    if (slot == SparseIndex::kNone) return;
+
+    // Orphan the children (rare: scans every slot, leaves skip this).
+    if (m_childCount[slot] > 0)
+    {
+        for (uint32_t i = 0; i < Size(); ++i)
+        {
+            if (m_parent[i] != entity) continue;
+            m_parent[i] = kNoParent;
+            m_dirty[i] = 1;
+            --m_links;
+        }
+    }
+    if (m_parent[slot] != kNoParent)
+    {
+        --m_childCount[m_index.Find(m_parent[slot])];
+        --m_links;
+    }
+
+    m_index.Erase(entity);
+    for (std::vector<float>& column : m_columns) SwapRemove(column, slot);
+    SwapRemove(m_parent, slot);
+    SwapRemove(m_childCount, slot);
+    SwapRemove(m_local, slot);
+    SwapRemove(m_world, slot);
+    SwapRemove(m_dirty, slot);
+    SwapRemove(m_worldChanged, slot);
+    if (slot < Size() && m_worldChanged[slot]) MarkChunkChanged(slot); // the moved slot's change
+    if (m_links > 0) m_unsorted = true; // the moved slot may now precede its parent
+}
+
+Transform TransformStore::Get(uint32_t slot) const noexcept
+{
+    Transform t;
+    t.position = { m_columns[PosX][slot], m_columns[PosY][slot], m_columns[PosZ][slot] };
+    t.rotation = { m_columns[RotX][slot], m_columns[RotY][slot], m_columns[RotZ][slot], m_columns[RotW][slot] };
+    t.scale = { m_columns[ScaleX][slot], m_columns[ScaleY][slot], m_columns[ScaleZ][slot] };
+    return t;
+}
+
+void TransformStore::Set(uint32_t slot, const Transform& t) noexcept
+{
+    m_columns[PosX][slot] = t.position.x;
+    m_columns[PosY][slot] = t.position.y;
+    m_columns[PosZ][slot] = t.position.z;
+    m_columns[RotX][slot] = t.rotation.x;
+    m_columns[RotY][slot] = t.rotation.y;
+    m_columns[RotZ][slot] = t.rotation.z;
+    m_columns[RotW][slot] = t.rotation.w;
+    m_columns[ScaleX][slot] = t.scale.x;
+    m_columns[ScaleY][slot] = t.scale.y;
+    m_columns[ScaleZ][slot] = t.scale.z;
+    m_dirty[slot] = 1;
+}
+
+bool TransformStore::SetParent(uint32_t entity, uint32_t parentEntity) noexcept
+{
+    const uint32_t slot = m_index.Find(entity);
+    if (slot == SparseIndex::kNone) return false;
+    if (m_parent[slot] == parentEntity) return true;
+
+    uint32_t parentSlot = SparseIndex::kNone;
+    if (parentEntity != kNoParent)
+    {
+        parentSlot = m_index.Find(parentEntity);
+        if (parentSlot == SparseIndex::kNone) return false;
+
+        // The new parent must not be the entity itself or below it.
+        for (uint32_t e = parentEntity; e != kNoParent; e = m_parent[m_index.Find(e)])
+            if (e == entity) return false;
+    }
+
+    if (m_parent[slot] != kNoParent)
+    {
+        --m_childCount[m_index.Find(m_parent[slot])];
+        --m_links;
+    }
+    m_parent[slot] = parentEntity;
+    if (parentSlot != SparseIndex::kNone)
+    {
+        ++m_childCount[parentSlot];
+        ++m_links;
+    }
+
+    m_dirty[slot] = 1;
+    m_unsorted = true;
+    return true;
+}
+
+void TransformStore::MarkDirty(uint32_t begin, uint32_t end) noexcept
+{
+    if (begin < end) std::memset(m_dirty.data() + begin, 1, end - begin);
+}
+
+void TransformStore::ForRange(JobSystem* jobs, uint32_t begin, uint32_t end, const ChunkFn& fn)
+{
+    if (begin >= end) return;
+    if (!jobs || end - begin <= kChunkSize)
+    {
+        fn(begin, end);
+        return;
+    }
+    jobs->ParallelFor(end - begin, kChunkSize, [&](size_t b, size_t e) {
+        fn(begin + uint32_t(b), begin + uint32_t(e));
+    });
+}
+
+void TransformStore::SortByDepth()
+{
+    constexpr uint32_t kUnknown = 0xFFFFFFFFu;
+    const uint32_t count = Size();
+
+    // Depth per slot; each chain is walked once, then filled in on the way down.
+    std::vector<uint32_t> depth(count, kUnknown);
+    std::vector<uint32_t> chain;
+    uint32_t maxDepth = 0;
+    for (uint32_t s = 0; s < count; ++s)
+    {
+        uint32_t cur = s;
+        while (depth[cur] == kUnknown && m_parent[cur] != kNoParent)
+        {
+            chain.push_back(cur);
+            cur = m_index.Find(m_parent[cur]);
+        }
+        if (depth[cur] == kUnknown) depth[cur] = 0;
+        uint32_t d = depth[cur];
+        while (!chain.empty())
+        {
+            depth[chain.back()] = ++d;
+            chain.pop_back();
+        }
+        maxDepth = (std::max)(maxDepth, d);
+    }
+
+    // Stable counting sort by depth.
+    m_levelBegin.assign(size_t(maxDepth) + 2, 0);
+    for (uint32_t s = 0; s < count; ++s) ++m_levelBegin[depth[s] + 1];
+    for (uint32_t d = 1; d < m_levelBegin.size(); ++d) m_levelBegin[d] += m_levelBegin[d - 1];
+
+    std::vector<uint32_t> order(count);
+    std::vector<uint32_t> next(m_levelBegin.begin(), m_levelBegin.end() - 1);
+    for (uint32_t s = 0; s < count; ++s) order[next[depth[s]]++] = s;
+
+    m_index.Permute(order.data());
+    for (std::vector<float>& column : m_columns) Permute(column, order);
+    Permute(m_parent, order);
+    Permute(m_childCount, order);
+    Permute(m_local, order);
+    Permute(m_world, order);
+    Permute(m_dirty, order);
+    Permute(m_worldChanged, order);
+    m_changedChunks.assign((size_t(count) + kChunkSize - 1) / kChunkSize, 1); // pending changes moved anywhere
+
+    m_parentSlot.resize(count);
+    for (uint32_t s = 0; s < count; ++s)
+        m_parentSlot[s] = (m_parent[s] == kNoParent) ? SparseIndex::kNone : m_index.Find(m_parent[s]);
+
+    m_unsorted = false;
+}
+
+void TransformStore::MarkChunkChanged(uint32_t slot) noexcept
+{
+    // Neighbouring jobs may share a chunk; read first so a set flag stays a
+    // shared cache line.
+    std::atomic_ref<uint8_t> flag(m_changedChunks[slot / kChunkSize]);
+    if (!flag.load(std::memory_order_relaxed)) flag.store(1, std::memory_order_relaxed);
+}
+
+void TransformStore::UpdateWorld(JobSystem* jobs)
+{
+    if (m_links == 0)
+        m_levelBegin.assign({ 0u, Size() }); // flat: one level, any order
+    else if (m_unsorted)
+        SortByDepth();
+    m_changedChunks.resize((size_t(Size()) + kChunkSize - 1) / kChunkSize, 0);
+
+    // 1) Local matrices of the slots whose own transform changed.
+    ForRange(jobs, 0, Size(), [this](uint32_t begin, uint32_t end) {
+        const float* px = m_columns[PosX].data();
+        const float* py = m_columns[PosY].data();
+        const float* pz = m_columns[PosZ].data();
+        const float* qx = m_columns[RotX].data();
+        const float* qy = m_columns[RotY].data();
+        const float* qz = m_columns[RotZ].data();
+        const float* qw = m_columns[RotW].data();
+        const float* sx = m_columns[ScaleX].data();
+        const float* sy = m_columns[ScaleY].data();
+        const float* sz = m_columns[ScaleZ].data();
+
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            if (!m_dirty[i]) continue;
+
+            // Rotation rows from the quaternion (row vectors, as XMMatrixRotationQuaternion),
+            // each scaled by its axis: S * R, then T in the last row.
+            const float x = qx[i], y = qy[i], z = qz[i], w = qw[i];
+            const float xx = x * x, yy = y * y, zz = z * z;
+            const float xy = x * y, xz = x * z, yz = y * z;
+            const float wx = w * x, wy = w * y, wz = w * z;
+
+            XMFLOAT4X4& m = m_local[i];
+            m._11 = (1.0f - 2.0f * (yy + zz)) * sx[i];
+            m._12 = 2.0f * (xy + wz) * sx[i];
+            m._13 = 2.0f * (xz - wy) * sx[i];
+            m._14 = 0.0f;
+            m._21 = 2.0f * (xy - wz) * sy[i];
+            m._22 = (1.0f - 2.0f * (xx + zz)) * sy[i];
+            m._23 = 2.0f * (yz + wx) * sy[i];
+            m._24 = 0.0f;
+            m._31 = 2.0f * (xz + wy) * sz[i];
+            m._32 = 2.0f * (yz - wx) * sz[i];
+            m._33 = (1.0f - 2.0f * (xx + yy)) * sz[i];
+            m._34 = 0.0f;
+            m._41 = px[i];
+            m._42 = py[i];
+            m._43 = pz[i];
+            m._44 = 1.0f;
+        }
+    });
+
+    // 2) World matrices, one depth level at a time. A slot is recomputed when
+    //    it or its parent is dirty; the flag is passed on down, so a moved
+    //    node recomputes exactly its subtree.
+    ForRange(jobs, m_levelBegin[0], m_levelBegin[1], [this](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            if (!m_dirty[i]) continue;
+            m_world[i] = m_local[i];
+            m_worldChanged[i] = 1;
+            MarkChunkChanged(i);
+        }
+    });
+    for (size_t level = 1; level + 1 < m_levelBegin.size(); ++level)
+    {
+        ForRange(jobs, m_levelBegin[level], m_levelBegin[level + 1], [this](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const uint32_t parent = m_parentSlot[i];
+                if (m_dirty[parent]) m_dirty[i] = 1;
+                if (!m_dirty[i]) continue;
+
+                XMStoreFloat4x4(&m_world[i],
+                    XMMatrixMultiply(XMLoadFloat4x4(&m_local[i]), XMLoadFloat4x4(&m_world[parent])));
+                m_worldChanged[i] = 1;
+                MarkChunkChanged(i);
+            }
+        });
+    }
+
+    if (!m_dirty.empty()) std::memset(m_dirty.data(), 0, m_dirty.size());
+}
+
+void TransformStore::ClearWorldChanged() noexcept
+{
+    for (size_t c = 0; c < m_changedChunks.size(); ++c)
+    {
+        if (!m_changedChunks[c]) continue;
+        const size_t begin = c * kChunkSize;
+        if (begin < m_worldChanged.size())
+            std::memset(m_worldChanged.data() + begin, 0, (std::min)(size_t(kChunkSize), m_worldChanged.size() - begin));
+        m_changedChunks[c] = 0;
+    }
+}
+
+void TransformStore::Reserve(size_t count)
+{
+    m_index.Reserve(count);
+    for (std::vector<float>& column : m_columns) column.reserve(count);
+    m_parent.reserve(count);
+    m_childCount.reserve(count);
+    m_local.reserve(count);
+    m_world.reserve(count);
+    m_dirty.reserve(count);
+    m_worldChanged.reserve(count);
+}
+
+void TransformStore::Clear() noexcept
+{
+    m_index.Clear();
+    for (std::vector<float>& column : m_columns) column.clear();
+    m_parent.clear();
+    m_childCount.clear();
+    m_local.clear();
+    m_world.clear();
+    m_dirty.clear();
+    m_worldChanged.clear();
+    m_changedChunks.clear();
+    m_parentSlot.clear();
+    m_levelBegin.assign({ 0u, 0u });
+    m_links = 0;
+    m_unsorted = false;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "SparseSet.h"
+
+class JobSystem;
+
+// Local transform of an entity (relative to its parent, if any):
+// translation, rotation quaternion, scale.
+struct Transform {
+    DirectX::XMFLOAT3 position{ 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT4 rotation{ 0.0f, 0.0f, 0.0f, 1.0f };
+    DirectX::XMFLOAT3 scale{ 1.0f, 1.0f, 1.0f };
+};
+
+// Transform component pool, stored as structure of arrays: one float column
+// per field, packed by dense slot. Systems touch only the columns they use and
+// walk them linearly.
+//
+// Hierarchy: an entity may have a parent (world = local * parent world). Once
+// any parent link exists, dense slots are kept sorted by depth - all roots,
+// then depth 1, ... - so every parent precedes its children and one linear
+// pass updates the whole tree. Each depth level only reads the level above,
+// so its range is split across the job system. Structural changes (add,
+// remove, reparent) re-sort lazily at the next UpdateWorld.
+class TransformStore {
+public:
+    enum Field : uint32_t {
+        PosX, PosY, PosZ,
+        RotX, RotY, RotZ, RotW,
+        ScaleX, ScaleY, ScaleZ,
+        kFieldCount
+    };
+
+    static constexpr uint32_t kNoParent = SparseIndex::kNone;
+
+    // Dense slots per job when iterating in parallel.
+    static constexpr uint32_t kChunkSize = 4096;
+
+    using ChunkFn = std::function<void(uint32_t begin, uint32_t end)>;
+
+    void Add(uint32_t entity, const Transform& transform);
+    // Children of a removed entity become roots, keeping their local transform.
+    void Remove(uint32_t entity) noexcept;
+    bool Has(uint32_t entity) const noexcept { return m_index.Has(entity); }
+
+    // Dense slot of 'entity' (SparseIndex::kNone if it has no transform).
+    // Slots move when the hierarchy is re-sorted: don't keep them across UpdateWorld.
+    uint32_t Slot(uint32_t entity) const noexcept { return m_index.Find(entity); }
+
+    Transform Get(uint32_t slot) const noexcept;
+    void      Set(uint32_t slot, const Transform& transform) noexcept;
+
+    // Parent link by entity index (kNoParent = root). Fails if either entity
+    // has no transform or the link would make a cycle.
+    bool     SetParent(uint32_t entity, uint32_t parentEntity) noexcept;
+    uint32_t Parent(uint32_t slot) const noexcept { return m_parent[slot]; }
+
+    // Raw columns for systems. Whoever writes them marks the slots dirty.
+    float*       Column(Field field) noexcept { return m_columns[field].data(); }
+    const float* Column(Field field) const noexcept { return m_columns[field].data(); }
+    void MarkDirty(uint32_t begin, uint32_t end) noexcept;
+
+    // Runs fn over [begin, end) in chunks, on the job system when given.
+    void ForEachChunk(JobSystem* jobs, const ChunkFn& fn) const { ForRange(jobs, 0, Size(), fn); }
+
+    // Rebuilds the local matrix (scale, then rotation, then translation) of
+    // every dirty slot and the world matrix of every dirty slot and of
+    // everything below one, and flags those world matrices as changed.
+    void UpdateWorld(JobSystem* jobs);
+
+    const DirectX::XMFLOAT4X4& World(uint32_t slot) const noexcept { return m_world[slot]; }
+
+    // Set by UpdateWorld, cleared by whoever consumed the new matrices.
+    bool WorldChanged(uint32_t slot) const noexcept { return m_worldChanged[slot] != 0; }
+    void ClearWorldChanged() noexcept;
+
+    // Calls fn(slot) for every slot whose world matrix changed. Chunks of
+    // kChunkSize slots without a change are skipped whole, so a mostly static
+    // scene costs one flag per chunk rather than one lookup per entity.
+    template <typename Fn>
+    void ForEachWorldChanged(Fn&& fn) const
+    {
+        for (uint32_t c = 0; c < uint32_t(m_changedChunks.size()); ++c)
+        {
+            if (!m_changedChunks[c]) continue;
+            const uint32_t begin = c * kChunkSize;
+            const uint32_t end = (Size() - begin < kChunkSize) ? Size() : begin + kChunkSize;
+            for (uint32_t i = begin; i < end; ++i)
+                if (m_worldChanged[i]) fn(i);
+        }
+    }
+
+    uint32_t Size() const noexcept { return m_index.Size(); }
+    const uint32_t* Entities() const noexcept { return m_index.Entities(); }
+    uint32_t Depth() const noexcept { return uint32_t(m_levelBegin.size()) - 1; } // levels after the last UpdateWorld
+
+    void Reserve(size_t count);
+    void Clear() noexcept;
+
+private:
+    static void ForRange(JobSystem* jobs, uint32_t begin, uint32_t end, const ChunkFn& fn);
+    void SortByDepth();
+    void MarkChunkChanged(uint32_t slot) noexcept; // safe from concurrent jobs
+
+private:
+    SparseIndex m_index;
+    std::vector<float> m_columns[kFieldCount];
+    std::vector<uint32_t> m_parent;      // parent entity index, kNoParent for roots
+    std::vector<uint32_t> m_childCount;
+    std::vector<DirectX::XMFLOAT4X4> m_local;
+    std::vector<DirectX::XMFLOAT4X4> m_world;
+    std::vector<uint8_t> m_dirty;        // local changed, matrices stale
+    std::vector<uint8_t> m_worldChanged; // world matrix rebuilt, not consumed yet
+    std::vector<uint8_t> m_changedChunks; // per kChunkSize slots: any m_worldChanged set
+
+    // Valid after SortByDepth: parent slot per slot, first slot of each depth level (+ end).
+    std::vector<uint32_t> m_parentSlot;
+    std::vector<uint32_t> m_levelBegin{ 0u, 0u };
+    uint32_t m_links{ 0 };      // entities with a parent; 0 = flat, order irrelevant
+    bool     m_unsorted{ false };
+};
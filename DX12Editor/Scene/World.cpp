@@ -0,0 +1,128 @@
+#include "World.h"
+#include <cstring>
+
+using namespace DirectX;
+
+Entity World::Create()
+{
+    Entity e;
+    if (!m_freeSlots.empty())
+    {
+        e.index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        e.index = uint32_t(m_generations.size());
+        m_generations.push_back(0);
+    }
+    e.generation = m_generations[e.index];
+    ++m_alive;
+    return e;
+}
+
+void World::Destroy(Entity entity)
+{
+    if (!Alive(entity)) return;
+
+    if (const Renderable* r = m_renderables.TryGet(entity.index))
+        if (r->proxy != Renderable::kNoProxy)
+            m_removedProxies.push_back(r->proxy);
+
+    m_transforms.Remove(entity.index);
+    m_renderables.Remove(entity.index);
+
+    ++m_generations[entity.index]; // invalidates outstanding handles
+    m_freeSlots.push_back(entity.index);
+    --m_alive;
+}
+
+bool World::Alive(Entity entity) const noexcept
+{
+    return entity.index < m_generations.size() && m_generations[entity.index] == entity.generation;
+}
+
+void World::Reserve(uint32_t entities)
+{
+    m_generations.reserve(entities);
+    m_transforms.Reserve(entities);
+}
+
+void World::SetTransform(Entity entity, const Transform& transform)
+{
+    if (!Alive(entity)) return;
+    const uint32_t slot = m_transforms.Slot(entity.index);
+    if (slot == SparseIndex::kNone) m_transforms.Add(entity.index, transform);
+    else                            m_transforms.Set(slot, transform);
+}
+
+bool World::SetParent(Entity child, Entity parent)
+{
+    if (!Alive(child)) return false;
+    if (!parent.Valid()) return m_transforms.SetParent(child.index, TransformStore::kNoParent);
+    if (!Alive(parent)) return false;
+    return m_transforms.SetParent(child.index, parent.index);
+}
+
+void World::SetRenderable(Entity entity, const ProxyDraw& draw)
+{
+    if (!Alive(entity)) return;
+    if (Renderable* r = m_renderables.TryGet(entity.index))
+    {
+        if (std::memcmp(&r->draw, &draw, sizeof(ProxyDraw)) == 0) return;
+        r->draw = draw;
+    }
+    else
+    {
+        Renderable added;
+        added.draw = draw;
+        m_renderables.Add(entity.index, added);
+    }
+    m_drawDirty.push_back(entity.index);
+}
+
+const Renderable* World::GetRenderable(Entity entity) const noexcept
+{
+    return Alive(entity) ? m_renderables.TryGet(entity.index) : nullptr;
+}
+
+void World::SyncRenderScene(RenderScene& scene, bool snap)
+{
+    for (ProxyId id : m_removedProxies)
+        scene.Remove(id);
+    m_removedProxies.clear();
+
+    const XMFLOAT4X4 identity(
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f);
+
+    // Slot reused by a new entity since, or destroyed: the lookup tells.
+    for (uint32_t index : m_drawDirty)
+    {
+        Renderable* r = m_renderables.TryGet(index);
+        if (!r) continue;
+
+        if (r->proxy == Renderable::kNoProxy)
+        {
+            const uint32_t slot = m_transforms.Slot(index);
+            r->proxy = scene.Add(r->draw, slot != SparseIndex::kNone ? m_transforms.World(slot) : identity);
+        }
+        else
+        {
+            scene.SetDraw(r->proxy, r->draw);
+        }
+    }
+    m_drawDirty.clear();
+
+    // Only the transforms that changed; static renderables cost nothing.
+    const uint32_t* entities = m_transforms.Entities();
+    m_transforms.ForEachWorldChanged([&](uint32_t slot) {
+        const Renderable* r = m_renderables.TryGet(entities[slot]);
+        if (!r) return;
+        if (snap) scene.SnapTransform(r->proxy, m_transforms.World(slot));
+        else      scene.SetTransform(r->proxy, m_transforms.World(slot));
+    });
+    m_transforms.ClearWorldChanged();
+}
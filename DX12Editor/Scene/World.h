@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Entity.h"
+#include "SparseSet.h"
+#include "TransformStore.h"
+#include "../Core/RenderProxy.h"
+
+class JobSystem;
+
+// Something the renderer draws: what to draw, plus the render proxy it has
+// been mirrored to (assigned by World::SyncRenderScene).
+struct Renderable {
+    static constexpr ProxyId kNoProxy = 0xFFFFFFFFu;
+
+    ProxyDraw draw;
+    ProxyId   proxy{ kNoProxy };
+};
+
+// Entity/component store of the editor scene. Entities are generational
+// handles; each component type lives in its own sparse set (transforms as
+// SoA columns, see TransformStore), so systems iterate packed arrays and can
+// split them into chunks for the job system.
+//
+// The renderer never reads the World: SyncRenderScene() mirrors renderables
+// into the RenderScene, whose snapshots are what frames are recorded from.
+class World {
+public:
+    Entity Create();
+    void   Destroy(Entity entity);
+    bool   Alive(Entity entity) const noexcept;
+    uint32_t AliveCount() const noexcept { return m_alive; }
+
+    // Handle of a live entity index, e.g. one taken from a component store.
+    Entity Handle(uint32_t index) const noexcept { return Entity{ index, m_generations[index] }; }
+
+    void Reserve(uint32_t entities);
+
+    // Components
+    void SetTransform(Entity entity, const Transform& transform);
+    TransformStore& Transforms() noexcept { return m_transforms; }
+    const TransformStore& Transforms() const noexcept { return m_transforms; }
+
+    // Attaches 'child' under 'parent' (Entity{} detaches it). Both need a
+    // transform; the child's transform is then relative to the parent.
+    // Destroying a parent turns its children into roots.
+    bool SetParent(Entity child, Entity parent);
+
+    void SetRenderable(Entity entity, const ProxyDraw& draw);
+    const Renderable* GetRenderable(Entity entity) const noexcept;
+    const SparseSet<Renderable>& Renderables() const noexcept { return m_renderables; }
+
+    // Systems
+    void UpdateTransforms(JobSystem* jobs) { m_transforms.UpdateWorld(jobs); }
+
+    // Pushes what changed since the last call into 'scene': new renderables
+    // get a proxy, edited ones their draw, moved ones their world matrix, and
+    // the proxies of destroyed entities are removed. 'snap' = the moves were
+    // made outside a simulation step (editor, load) and are not interpolated.
+    void SyncRenderScene(RenderScene& scene, bool snap = false);
+
+private:
+    std::vector<uint32_t> m_generations; // per entity slot
+    std::vector<uint32_t> m_freeSlots;
+    uint32_t m_alive{ 0 };
+
+    TransformStore        m_transforms;
+    SparseSet<Renderable> m_renderables;
+
+    std::vector<uint32_t> m_drawDirty;      // entity indices with a new / edited draw
+    std::vector<ProxyId>  m_removedProxies; // of destroyed renderables
+};
@@ -0,0 +1,181 @@
+// ddcbench: headless import startup against the derived-data cache. Every
+// source image goes through the expensive path the editor would run once per
+// unique input - mip chain (TexelGen::BuildMipChain) + LZ4 (standing in for
+// texture compression) - through DerivedDataCache::GetOrBuild. Portable (no
+// D3D, no DirectXMath):
+//
+//   g++ -std=c++20 -O2 -pthread -o ddcbench Tools/DdcBench.cpp
+//       Core/DerivedDataCache.cpp Core/TexelGen.cpp Core/Lz4.cpp Core/Hash.cpp Core/JobSystem.cpp
+//
+//   ddcbench <dir> [images=64] [size=512] [budgetMB=1024]
+//
+// Passes: cold (empty cache: everything processed), warm (a fresh cache
+// object, as after a restart: nothing processed), one source edited (one
+// rebuild), warm on the job system, then a budget of half the cache (LRU
+// eviction).
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../Core/DerivedDataCache.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Lz4.h"
+#include "../Core/TexelGen.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr uint32_t kToolVersion = 1;
+
+    double NowMs()
+    {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    struct ImportParams {
+        uint32_t width;
+        uint32_t height;
+    };
+
+    bool ReadWholeFile(const fs::path& path, std::vector<uint8_t>& data)
+    {
+        std::FILE* f = std::fopen(path.string().c_str(), "rb");
+        if (!f) return false;
+        std::fseek(f, 0, SEEK_END);
+        data.resize(size_t(std::ftell(f)));
+        std::fseek(f, 0, SEEK_SET);
+        const bool ok = std::fread(data.data(), 1, data.size(), f) == data.size();
+        std::fclose(f);
+        return ok;
+    }
+
+    bool WriteWholeFile(const fs::path& path, const std::vector<uint8_t>& data)
+    {
+        std::FILE* f = std::fopen(path.string().c_str(), "wb");
+        if (!f) return false;
+        const bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+        return (std::fclose(f) == 0) && ok;
+    }
+
+    // Synthetic RGBA gradient pattern, different per seed.
+    std::vector<uint8_t> MakeImage(uint32_t size, uint32_t seed)
+    {
+        std::vector<uint8_t> data(size_t(size) * size * 4);
+        uint32_t* px = reinterpret_cast<uint32_t*>(data.data());
+        for (uint32_t y = 0; y < size; ++y)
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                const uint32_t r = (x * (seed + 3) / 7) & 0xFF, g = (y * (seed + 5) / 9) & 0xFF, b = ((x ^ y) >> 3) & 0xFF;
+                px[size_t(y) * size + x] = 0xFF000000u | (b << 16) | (g << 8) | r;
+            }
+        return data;
+    }
+
+    // The expensive import step.
+    bool Process(const std::vector<uint8_t>& source, const ImportParams& params, std::vector<uint8_t>& out)
+    {
+        std::vector<uint32_t> chain;
+        TexelGen::BuildMipChain(reinterpret_cast<const uint32_t*>(source.data()), params.width, params.height, chain);
+        const size_t bytes = chain.size() * sizeof(uint32_t);
+        out.resize(Lz4CompressBound(bytes));
+        out.resize(Lz4Compress(reinterpret_cast<const uint8_t*>(chain.data()), bytes, out.data(), out.size()));
+        return !out.empty();
+    }
+
+    struct PassResult {
+        double   ms{ 0 };
+        uint32_t processed{ 0 };
+    };
+
+    // Editor startup: read every source, key it, get its derived data.
+    PassResult Import(DerivedDataCache& cache, const std::vector<fs::path>& sources, const ImportParams& params, JobSystem* jobs)
+    {
+        std::atomic<uint32_t> processed{ 0 };
+        auto importOne = [&](size_t i) {
+            std::vector<uint8_t> source, derived;
+            if (!ReadWholeFile(sources[i], source)) return;
+            const DerivedDataCache::Key key = DerivedDataCache::KeyBuilder("mipchain-lz4", kToolVersion)
+                .Add(source.data(), source.size()).AddValue(params).Finish();
+            cache.GetOrBuild(key, derived, [&](std::vector<uint8_t>& out) {
+                processed.fetch_add(1, std::memory_order_relaxed);
+                return Process(source, params, out);
+            });
+        };
+
+        const double t0 = NowMs();
+        if (jobs) jobs->ParallelFor(sources.size(), 1, [&](size_t b, size_t e) { for (size_t i = b; i < e; ++i) importOne(i); });
+        else      for (size_t i = 0; i < sources.size(); ++i) importOne(i);
+        return { NowMs() - t0, processed.load() };
+    }
+
+    void Report(const char* pass, const PassResult& r, const DerivedDataCache& cache, size_t total)
+    {
+        const DerivedDataCache::Stats s = cache.GetStats();
+        std::printf("  %-22s %9.2f ms  processed %4u / %zu  hits %4llu  evictions %4llu  cache %7.1f MB\n",
+            pass, r.ms, r.processed, total, (unsigned long long)s.hits, (unsigned long long)s.evictions,
+            cache.SizeBytes() / 1048576.0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::printf("usage: ddcbench <dir> [images=64] [size=512] [budgetMB=1024]\n");
+        return 2;
+    }
+    const fs::path dir = argv[1];
+    const uint32_t images = argc > 2 ? uint32_t(std::atoi(argv[2])) : 64;
+    const uint32_t size = argc > 3 ? uint32_t(std::atoi(argv[3])) : 512;
+    const uint64_t budget = (argc > 4 ? uint64_t(std::atoi(argv[4])) : 1024) << 20;
+    const ImportParams params{ size, size };
+
+    std::error_code ec;
+    const fs::path sourceDir = dir / "sources";
+    const fs::path cacheDir = dir / "cache";
+    fs::create_directories(sourceDir, ec);
+    fs::remove_all(cacheDir, ec);
+
+    std::vector<fs::path> sources;
+    for (uint32_t i = 0; i < images; ++i)
+    {
+        sources.push_back(sourceDir / ("image" + std::to_string(i) + ".rgba"));
+        if (!WriteWholeFile(sources.back(), MakeImage(size, i)))
+        {
+            std::printf("cannot write %s\n", sources.back().string().c_str());
+            return 1;
+        }
+    }
+
+    JobSystem jobs;
+    jobs.Initialize();
+    std::printf("%u images of %ux%u, %u threads\n", images, size, size, jobs.ThreadCount());
+
+    {
+        DerivedDataCache cache;
+        if (!cache.Open(cacheDir, budget)) { std::printf("cannot open cache\n"); return 1; }
+        Report("cold", Import(cache, sources, params, nullptr), cache, sources.size());
+    }
+    {
+        DerivedDataCache cache; // restart
+        cache.Open(cacheDir, budget);
+        Report("warm", Import(cache, sources, params, nullptr), cache, sources.size());
+
+        WriteWholeFile(sources[0], MakeImage(size, 1000));
+        Report("warm, 1 source edited", Import(cache, sources, params, nullptr), cache, sources.size());
+        Report("warm, job system", Import(cache, sources, params, &jobs), cache, sources.size());
+    }
+    {
+        DerivedDataCache cache;
+        cache.Open(cacheDir, budget);
+        const uint64_t half = cache.SizeBytes() / 2;
+        cache.Trim(half);
+        Report("trimmed to half", Import(cache, sources, params, nullptr), cache, sources.size());
+    }
+    return 0;
+}
@@ -0,0 +1,253 @@
+// descriptortool: the bindless heap's index allocator (DescriptorAllocator)
+// outside the editor - a self test of exhaustion, double / out-of-range frees,
+// the per-frame transient regions and a multi-threaded churn that checks no
+// index is ever handed out twice, plus a throughput benchmark. Portable (no D3D):
+//
+//   g++ -std=c++20 -O2 -pthread -o descriptortool Tools/DescriptorTool.cpp Core/DescriptorAllocator.cpp
+//
+//   descriptortool selftest [threads=4]              exit code 1 on failure
+//   descriptortool bench [allocations=10000000] [threads=4]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Core/DescriptorAllocator.h"
+
+namespace {
+    constexpr uint32_t kCapacity = 1024;  // DXRenderer::kSrvDescriptors
+    constexpr uint32_t kTransient = 16;   // DXRenderer::kTransientSrvsPerFrame
+    constexpr uint32_t kFrames = 2;       // DXRenderer::kBufferCount
+
+    int Usage()
+    {
+        std::printf("usage: descriptortool selftest [threads]\n"
+                    "       descriptortool bench [allocations] [threads]\n");
+        return 2;
+    }
+
+    double NowMs()
+    {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // ------------------------------------------------------------
+    // Self test
+    // ------------------------------------------------------------
+    int g_failures = 0;
+
+    void Check(bool ok, const char* what)
+    {
+        if (!ok)
+        {
+            std::printf("  FAIL: %s\n", what);
+            ++g_failures;
+        }
+    }
+
+    void TestSingleThread()
+    {
+        DescriptorAllocator a;
+        Check(!a.Initialize(0), "zero capacity rejected");
+        Check(a.Initialize(kCapacity), "initialize");
+
+        std::vector<uint8_t> seen(kCapacity, 0);
+        bool unique = true, inRange = true;
+        for (uint32_t i = 0; i < kCapacity; ++i)
+        {
+            const uint32_t index = a.Allocate();
+            if (index >= kCapacity) { inRange = false; continue; }
+            if (seen[index]++) unique = false;
+        }
+        Check(inRange && unique, "every slot handed out exactly once");
+        Check(a.InUse() == kCapacity, "in use after filling");
+        Check(a.Allocate() == DescriptorAllocator::kInvalidIndex, "exhausted heap returns kInvalidIndex");
+
+        Check(a.Free(7), "free");
+        Check(!a.Free(7), "double free rejected");
+        Check(!a.Free(kCapacity), "out-of-range free rejected");
+        Check(!a.Free(DescriptorAllocator::kInvalidIndex), "kInvalidIndex free rejected");
+        Check(a.RejectedFrees() == 3, "rejected frees counted");
+        Check(a.InUse() == kCapacity - 1, "in use unchanged by rejected frees");
+
+        // The double free must not have pushed slot 7 twice.
+        Check(a.Allocate() == 7, "freed slot reused");
+        Check(a.Allocate() == DescriptorAllocator::kInvalidIndex, "slot reused only once");
+
+        for (uint32_t i = 0; i < kCapacity; ++i) a.Free(i);
+        Check(a.InUse() == 0, "all freed");
+    }
+
+    // Every thread repeatedly grabs a batch and frees it. An owner table
+    // catches an index held by two threads at once.
+    void TestThreads(uint32_t threadCount)
+    {
+        DescriptorAllocator a;
+        a.Initialize(kCapacity);
+        std::vector<std::atomic<uint32_t>> owner(kCapacity);
+        for (std::atomic<uint32_t>& o : owner) o.store(0);
+        std::atomic<bool> duplicate{ false }, exhausted{ false };
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 1; t <= threadCount; ++t)
+        {
+            threads.emplace_back([&, t] {
+                std::vector<uint32_t> held;
+                const uint32_t batch = kCapacity / threadCount;
+                for (int round = 0; round < 2000; ++round)
+                {
+                    for (uint32_t i = 0; i < batch; ++i)
+                    {
+                        const uint32_t index = a.Allocate();
+                        if (index == DescriptorAllocator::kInvalidIndex) { exhausted = true; continue; }
+                        uint32_t expected = 0;
+                        if (!owner[index].compare_exchange_strong(expected, t)) duplicate = true;
+                        held.push_back(index);
+                    }
+                    for (uint32_t index : held)
+                    {
+                        owner[index].store(0);
+                        a.Free(index);
+                    }
+                    held.clear();
+                    if ((round & 63) == 0) std::this_thread::yield(); // interleave on few cores
+                }
+            });
+        }
+        for (std::thread& th : threads) th.join();
+
+        Check(!duplicate, "no index held by two threads");
+        Check(!exhausted, "batches that fit never see an exhausted heap");
+        Check(a.InUse() == 0 && a.RejectedFrees() == 0, "balanced after churn");
+    }
+
+    void TestTransient(uint32_t threadCount)
+    {
+        DescriptorAllocator a;
+        Check(!a.Initialize(kCapacity, kTransient, 0), "zero frames rejected");
+        Check(a.Initialize(kCapacity - kTransient * kFrames, kTransient, kFrames), "initialize with transient regions");
+        Check(a.Capacity() == kCapacity && a.PersistentCount() == kCapacity - kTransient * kFrames, "layout");
+
+        // Each frame's region lies after the persistent slots, disjoint from the other frame's.
+        bool inRegion = true;
+        uint32_t first[kFrames]{};
+        for (uint32_t frame = 0; frame < kFrames; ++frame)
+        {
+            a.BeginFrame(frame);
+            first[frame] = a.AllocateTransient();
+            const uint32_t base = a.PersistentCount() + frame * kTransient;
+            inRegion &= first[frame] == base;
+            const uint32_t range = a.AllocateTransient(4);
+            inRegion &= range == base + 1;
+        }
+        Check(inRegion, "frame regions follow the persistent slots, contiguous ranges");
+        Check(a.TransientInUse() == 5, "transient in use");
+
+        a.BeginFrame(0);
+        Check(a.TransientInUse() == 0, "BeginFrame resets the region");
+        Check(a.AllocateTransient(kTransient) == a.PersistentCount(), "whole region in one range");
+        Check(a.AllocateTransient() == DescriptorAllocator::kInvalidIndex, "full region returns kInvalidIndex");
+        Check(a.AllocateTransient(0) == DescriptorAllocator::kInvalidIndex &&
+              a.AllocateTransient(kTransient + 1) == DescriptorAllocator::kInvalidIndex, "bad counts rejected");
+        Check(a.TransientInUse() == kTransient, "in use capped at the region size");
+
+        a.BeginFrame(kFrames + 1); // frame slots wrap like the back buffer index
+        Check(a.AllocateTransient() == a.PersistentCount() + kTransient, "frame slot wraps");
+
+        // Transient frees go nowhere: the persistent free list only takes its own slots.
+        Check(!a.Free(a.PersistentCount()), "transient index is not freed into the persistent list");
+
+        // Several threads filling one frame's region: every index once, none past it.
+        a.BeginFrame(1);
+        std::vector<std::atomic<uint32_t>> hits(kTransient);
+        for (std::atomic<uint32_t>& h : hits) h.store(0);
+        std::atomic<uint32_t> outside{ 0 };
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 64; ++i)
+                {
+                    const uint32_t index = a.AllocateTransient();
+                    if (index == DescriptorAllocator::kInvalidIndex) continue;
+                    const uint32_t base = a.PersistentCount() + kTransient;
+                    if (index < base || index >= base + kTransient) ++outside;
+                    else ++hits[index - base];
+                }
+            });
+        }
+        for (std::thread& th : threads) th.join();
+        bool once = true;
+        for (std::atomic<uint32_t>& h : hits) once &= h.load() == 1;
+        Check(once && outside == 0, "concurrent transient allocation: each index once, inside the region");
+    }
+
+    int SelfTest(uint32_t threads)
+    {
+        TestSingleThread();
+        TestThreads(threads);
+        TestTransient(threads);
+        std::printf("selftest: %s (%d failures)\n", g_failures ? "FAILED" : "ok", g_failures);
+        return g_failures ? 1 : 0;
+    }
+
+    // ------------------------------------------------------------
+    // Benchmark
+    // ------------------------------------------------------------
+    // Allocate + free pairs; each thread keeps a few slots live so the free
+    // list head is contended the way texture streaming would contend it.
+    double Churn(uint64_t allocations, uint32_t threadCount)
+    {
+        DescriptorAllocator a;
+        a.Initialize(kCapacity);
+        const uint64_t perThread = allocations / threadCount;
+
+        const double start = NowMs();
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&a, perThread] {
+                uint32_t ring[8];
+                for (uint32_t& r : ring) r = a.Allocate();
+                for (uint64_t i = 0; i < perThread; ++i)
+                {
+                    uint32_t& slot = ring[i & 7];
+                    a.Free(slot);
+                    slot = a.Allocate();
+                }
+                for (uint32_t r : ring) a.Free(r);
+            });
+        }
+        for (std::thread& th : threads) th.join();
+        return NowMs() - start;
+    }
+
+    int Bench(uint64_t allocations, uint32_t threads)
+    {
+        for (uint32_t t : { 1u, threads })
+        {
+            const double ms = Churn(allocations, t);
+            std::printf("%2u thread(s): %llu alloc+free in %8.1f ms  (%.1f ns each)\n", t,
+                (unsigned long long)allocations, ms, ms * 1e6 / double(allocations));
+            if (t == threads) break;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) return Usage();
+    const std::string cmd = argv[1];
+
+    if (cmd == "selftest") return SelfTest(argc > 2 ? uint32_t(std::max(1, std::atoi(argv[2]))) : 4u);
+    if (cmd == "bench")
+        return Bench(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000ull,
+                     argc > 3 ? uint32_t(std::max(1, std::atoi(argv[3]))) : 4u);
+    return Usage();
+}
@@ -0,0 +1,216 @@
+// dynrestrace: DynamicResolution driven by frame-time traces, without a GPU.
+// A trace gives the cost of each frame at full resolution; the cost at the
+// controller's scale is modelled as fixed + pixel-bound work, the latter
+// proportional to scale^2:
+//
+//   cost(scale) = full * (fixedShare + (1 - fixedShare) * scale^2)
+//
+// Portable (no D3D):
+//
+//   g++ -std=c++20 -O2 -o dynrestrace Tools/DynResTrace.cpp Core/DynamicResolution.cpp
+//
+//   dynrestrace selftest                               synthetic scenarios; exit code 1 on failure
+//   dynrestrace <trace.txt> [budget ms=16] [fixed share=0.3] [csv out]
+//
+// A trace file holds one full-resolution frame time in ms per line (e.g. a
+// column of FrameStats::WriteCsv). The csv output has frame,fullMs,scale,costMs.
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Core/DynamicResolution.h"
+
+namespace {
+    int Usage()
+    {
+        std::printf("usage: dynrestrace selftest\n"
+                    "       dynrestrace <trace.txt> [budget ms] [fixed share] [csv out]\n");
+        return 2;
+    }
+
+    struct Result {
+        uint32_t frames{ 0 };
+        uint32_t overBudget{ 0 };   // frames whose modelled cost exceeded the budget
+        uint32_t reversals{ 0 };    // scale changes that reverse the previous direction
+        uint64_t adjustments{ 0 };
+        float    minScale{ 1.0f };
+        float    finalScale{ 1.0f };
+        std::vector<float> scales;  // scale each frame was rendered at
+        std::vector<double> costs;
+    };
+
+    double CostAt(double fullMs, float scale, double fixedShare)
+    {
+        return fullMs * (fixedShare + (1.0 - fixedShare) * double(scale) * double(scale));
+    }
+
+    Result Run(const std::vector<double>& fullMs, double budgetMs, double fixedShare)
+    {
+        DynamicResolution::Config config;
+        config.targetMs = budgetMs;
+        DynamicResolution dr;
+        dr.SetConfig(config);
+
+        Result r;
+        int lastDir = 0;
+        for (double full : fullMs)
+        {
+            const float scale = dr.Scale();
+            const double cost = CostAt(full, scale, fixedShare);
+            r.scales.push_back(scale);
+            r.costs.push_back(cost);
+            if (cost > budgetMs) ++r.overBudget;
+
+            const float next = dr.Update(cost);
+            const int dir = next > scale ? 1 : (next < scale ? -1 : 0);
+            if (dir != 0)
+            {
+                if (lastDir != 0 && dir != lastDir) ++r.reversals;
+                lastDir = dir;
+            }
+            r.minScale = std::fmin(r.minScale, next);
+        }
+        r.frames = uint32_t(fullMs.size());
+        r.adjustments = dr.Adjustments();
+        r.finalScale = dr.Scale();
+        return r;
+    }
+
+    void Print(const char* name, const Result& r)
+    {
+        std::printf("%-28s %6u frames  over budget %5u  adjustments %5llu  reversals %4u  min %.3f  final %.3f\n",
+            name, r.frames, r.overBudget, (unsigned long long)r.adjustments, r.reversals, r.minScale, r.finalScale);
+    }
+
+    // ------------------------------------------------------------
+    // Self test
+    // ------------------------------------------------------------
+    int g_failures = 0;
+
+    void Check(bool ok, const char* what)
+    {
+        if (!ok)
+        {
+            std::printf("  FAIL: %s\n", what);
+            ++g_failures;
+        }
+    }
+
+    std::vector<double> Noisy(uint32_t frames, double meanMs, double sigmaMs, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<double> noise(0.0, sigmaMs);
+        std::vector<double> trace(frames);
+        for (double& ms : trace) ms = std::fmax(0.1, meanMs + noise(rng));
+        return trace;
+    }
+
+    int SelfTest()
+    {
+        constexpr double kBudget = 16.0, kFixed = 0.3;
+
+        // Light scene: fits at full resolution, nothing to do.
+        const Result light = Run(Noisy(2000, 10.0, 0.5, 1), kBudget, kFixed);
+        Print("light (10 ms)", light);
+        Check(light.adjustments == 0 && light.finalScale == 1.0f, "light scene stays at full resolution");
+
+        // Heavy scene (24 ms at full res): settles under budget, then holds.
+        // With this much noise (~0.5 ms at the settled scale) a few percent of
+        // frames over budget is the floor; steering onto the budget itself
+        // would put ~20% over.
+        const Result heavy = Run(Noisy(2000, 24.0, 0.8, 2), kBudget, kFixed);
+        Print("heavy (24 ms)", heavy);
+        Check(heavy.finalScale < 1.0f && heavy.finalScale >= 0.5f, "heavy scene scales down");
+        uint32_t lateOver = 0;
+        for (size_t i = 500; i < heavy.costs.size(); ++i) lateOver += heavy.costs[i] > kBudget;
+        Check(lateOver < 150, "settled: under 10% of frames over budget after 500 frames");
+        Check(heavy.reversals < heavy.frames / 50, "no sustained oscillation");
+
+        // Same scene without noise: settles strictly inside the budget.
+        const Result clean = Run(std::vector<double>(2000, 24.0), kBudget, kFixed);
+        Print("heavy, noiseless", clean);
+        Check(clean.costs.back() < kBudget && clean.reversals == 0, "noiseless: settles under budget, monotonic");
+
+        // Load step 10 -> 24 -> 10 ms: scales down, then comes back to full.
+        std::vector<double> step = Noisy(600, 10.0, 0.5, 3);
+        const std::vector<double> mid = Noisy(1200, 24.0, 0.8, 4), tail = Noisy(1200, 10.0, 0.5, 5);
+        step.insert(step.end(), mid.begin(), mid.end());
+        step.insert(step.end(), tail.begin(), tail.end());
+        const Result stepped = Run(step, kBudget, kFixed);
+        Print("step 10 -> 24 -> 10 ms", stepped);
+        Check(stepped.scales[1799] < 1.0f, "scaled down during the heavy section");
+        Check(stepped.finalScale == 1.0f, "back to full resolution after the load drops");
+
+        // Lone hitches in a light scene: the median filter ignores them.
+        std::vector<double> hitches = Noisy(2000, 10.0, 0.2, 6);
+        for (size_t i = 100; i < hitches.size(); i += 250) hitches[i] = 60.0;
+        const Result spiky = Run(hitches, kBudget, kFixed);
+        Print("light + lone 60 ms hitches", spiky);
+        Check(spiky.adjustments == 0, "single-frame hitches do not change the scale");
+
+        // Near the budget (inside the hysteresis band): holds still.
+        const Result edge = Run(Noisy(2000, 15.2, 0.3, 7), kBudget, kFixed);
+        Print("edge (15.2 ms)", edge);
+        Check(edge.adjustments <= 2, "no flip-flopping inside the hysteresis band");
+
+        std::printf("selftest: %s (%d failures)\n", g_failures ? "FAILED" : "ok", g_failures);
+        return g_failures ? 1 : 0;
+    }
+
+    int Replay(const char* path, double budgetMs, double fixedShare, const char* csvPath)
+    {
+        std::FILE* f = std::fopen(path, "rb");
+        if (!f)
+        {
+            std::printf("cannot read %s\n", path);
+            return 1;
+        }
+        std::vector<double> trace;
+        char line[256];
+        while (std::fgets(line, sizeof(line), f))
+        {
+            char* end = nullptr;
+            const double ms = std::strtod(line, &end);
+            if (end != line && ms > 0.0) trace.push_back(ms); // skips headers and blank lines
+        }
+        std::fclose(f);
+        if (trace.empty())
+        {
+            std::printf("%s: no frame times\n", path);
+            return 1;
+        }
+
+        const Result r = Run(trace, budgetMs, fixedShare);
+        Print(path, r);
+
+        if (csvPath)
+        {
+            std::FILE* out = std::fopen(csvPath, "wb");
+            if (!out)
+            {
+                std::printf("cannot write %s\n", csvPath);
+                return 1;
+            }
+            std::fprintf(out, "frame,fullMs,scale,costMs\n");
+            for (size_t i = 0; i < trace.size(); ++i)
+                std::fprintf(out, "%zu,%.4f,%.4f,%.4f\n", i, trace[i], r.scales[i], r.costs[i]);
+            std::fclose(out);
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) return Usage();
+    if (std::strcmp(argv[1], "selftest") == 0) return SelfTest();
+
+    const double budget = argc > 2 ? std::atof(argv[2]) : 16.0;
+    const double fixedShare = argc > 3 ? std::atof(argv[3]) : 0.3;
+    if (!(budget > 0.0) || !(fixedShare >= 0.0 && fixedShare < 1.0)) return Usage();
+    return Replay(argv[1], budget, fixedShare, argc > 4 ? argv[4] : nullptr);
+}
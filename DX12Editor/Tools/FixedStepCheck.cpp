@@ -0,0 +1,139 @@
+// fixedstepcheck: FixedStepScheduler against a fake clock, without a window.
+// The simulation is only reproducible (replays, --bench, network lockstep)
+// if the same frame deltas always give the same step counts, so this feeds
+// recorded-style jittered deltas and checks that:
+//   - two runs of the same delta sequence step identically, frame by frame;
+//   - splitting the same total time into different frames gives the same
+//     total step count (time is integer nanoseconds, nothing drifts);
+//   - alpha stays in [0, 1) and the catch-up limit drops exactly the excess;
+//   - double deltas (InputSession's float dt) round the same every time.
+// Portable (no D3D):
+//
+//   g++ -std=c++20 -O2 -o fixedstepcheck Tools/FixedStepCheck.cpp Core/FixedStepScheduler.cpp
+//
+//   fixedstepcheck [frames=1000000]      exit code 1 on failure
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../Core/FixedStepScheduler.h"
+
+namespace {
+    int g_failures = 0;
+
+    void Check(bool ok, const char* what)
+    {
+        if (!ok)
+        {
+            std::printf("  FAIL: %s\n", what);
+            ++g_failures;
+        }
+    }
+
+    // Frame times around 60 Hz with vsync-style jitter and the odd hitch.
+    std::vector<uint64_t> FakeClock(uint32_t frames, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::normal_distribution<double> jitter(0.0, 400000.0);
+        std::uniform_int_distribution<int> hitch(0, 499);
+        std::vector<uint64_t> deltas(frames);
+        for (uint64_t& d : deltas)
+        {
+            const double ns = 16666667.0 + jitter(rng) + (hitch(rng) == 0 ? 80e6 : 0.0);
+            d = uint64_t(ns > 0.0 ? ns : 0.0);
+        }
+        return deltas;
+    }
+
+    void TestReplayIdentical(const std::vector<uint64_t>& deltas)
+    {
+        FixedStepScheduler a, b;
+        bool same = true, alphaInRange = true;
+        for (uint64_t d : deltas)
+        {
+            same &= a.AdvanceNs(d) == b.AdvanceNs(d);
+            same &= a.Alpha() == b.Alpha();
+            alphaInRange &= a.Alpha() >= 0.0f && a.Alpha() < 1.0f;
+        }
+        Check(same, "identical delta sequences step identically");
+        Check(alphaInRange, "alpha in [0, 1)");
+        Check(a.TotalSteps() == b.TotalSteps() && a.DroppedNs() == b.DroppedNs(), "identical totals");
+    }
+
+    void TestPartitioning(const std::vector<uint64_t>& deltas)
+    {
+        // Same wall time as one frame per delta, as halves, and as 1 ms ticks;
+        // no catch-up limit so nothing is dropped.
+        FixedStepScheduler::Config config;
+        config.maxCatchUpSteps = 1u << 30;
+        FixedStepScheduler whole, halves, ticks;
+        whole.SetConfig(config);
+        halves.SetConfig(config);
+        ticks.SetConfig(config);
+
+        uint64_t total = 0;
+        for (uint64_t d : deltas)
+        {
+            whole.AdvanceNs(d);
+            halves.AdvanceNs(d / 2);
+            halves.AdvanceNs(d - d / 2);
+            total += d;
+        }
+        for (uint64_t t = 0; t < total; t += 1000000)
+            ticks.AdvanceNs(total - t < 1000000 ? total - t : 1000000);
+
+        const uint64_t expected = total / whole.StepNs();
+        Check(whole.TotalSteps() == expected, "steps = total time / step length");
+        Check(halves.TotalSteps() == expected, "frame split does not change the step count");
+        Check(ticks.TotalSteps() == expected, "1 ms ticks give the same step count");
+        Check(whole.Alpha() == halves.Alpha() && whole.Alpha() == ticks.Alpha(), "same remainder");
+    }
+
+    void TestCatchUp()
+    {
+        FixedStepScheduler::Config config;
+        config.hz = 100.0;             // 10 ms steps
+        config.maxCatchUpSteps = 4;
+        FixedStepScheduler s;
+        s.SetConfig(config);
+
+        Check(s.AdvanceNs(25000000) == 2, "25 ms = 2 steps");
+        Check(s.AdvanceNs(1000000000) == 4, "1 s hitch clamped to 4 steps");
+        Check(s.DroppedNs() == 96ull * 10000000, "the excess 96 steps are dropped");
+        Check(s.Alpha() == 0.5f, "remainder kept across the clamp");
+        Check(s.TotalSteps() == 6, "total steps");
+    }
+
+    void TestSeconds(const std::vector<uint64_t>& deltas)
+    {
+        // InputSession records dt as float; both runs must see the same steps.
+        FixedStepScheduler a, b;
+        bool same = true;
+        for (uint64_t d : deltas)
+        {
+            const float dt = float(double(d) / 1e9);
+            same &= a.Advance(double(dt)) == b.Advance(double(dt));
+        }
+        Check(same && a.TotalSteps() == b.TotalSteps(), "float dt replay steps identically");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t frames = argc > 1 ? uint32_t(std::strtoul(argv[1], nullptr, 10)) : 1000000u;
+    if (frames == 0)
+    {
+        std::printf("usage: fixedstepcheck [frames]\n");
+        return 2;
+    }
+
+    const std::vector<uint64_t> deltas = FakeClock(frames, 2024);
+    TestReplayIdentical(deltas);
+    TestPartitioning(deltas);
+    TestCatchUp();
+    TestSeconds(deltas);
+
+    std::printf("fixedstepcheck: %s (%u frames, %d failures)\n", g_failures ? "FAILED" : "ok", frames, g_failures);
+    return g_failures ? 1 : 0;
+}
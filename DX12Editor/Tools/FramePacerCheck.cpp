@@ -0,0 +1,78 @@
+// framepacercheck: FramePacer accuracy without a window or swap chain. Runs
+// the TargetFps wait for a number of simulated frames (optionally with a
+// busy "frame" of CPU work in between) and reports how precisely frames
+// start: the frame-to-frame period against 1/fps, the wake error against each
+// deadline, and the learned sleep estimate. Portable (no D3D):
+//
+//   g++ -std=c++20 -O2 -o framepacercheck Tools/FramePacerCheck.cpp Core/FramePacer.cpp Core/FrameStats.cpp
+//
+//   framepacercheck [fps=240] [frames=1000] [work ms=0]
+//
+// Fails (exit code 1) when the median period or the median wake error is off
+// by more than 0.5 ms. Mean and p99 are reported for inspection only: a
+// loaded machine can always preempt a frame, and a miss of more than a frame
+// restarts the cadence by design (the lost time is not caught up).
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../Core/FramePacer.h"
+#include "../Core/FrameStats.h"
+
+namespace {
+    using Clock = FramePacer::Clock;
+
+    double Ms(Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); }
+
+    // Busy CPU work standing in for recording a frame.
+    void Work(double ms)
+    {
+        const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>(ms));
+        while (Clock::now() < end) {}
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const double fps = argc > 1 ? std::atof(argv[1]) : 240.0;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const double workMs = argc > 3 ? std::atof(argv[3]) : 0.0;
+    const double targetMs = 1000.0 / fps;
+    if (!(fps > 1.0) || frames < 10 || workMs < 0.0 || workMs >= targetMs)
+    {
+        std::printf("usage: framepacercheck [fps > 1] [frames >= 10] [work ms < 1000/fps]\n");
+        return 2;
+    }
+
+    FramePacer pacer;
+    pacer.SetConfig({ FramePacer::Mode::TargetFps, fps });
+
+    FrameStats period;
+    pacer.WaitForNextFrame(); // first frame starts at once and sets the cadence
+    Clock::time_point last = Clock::now();
+    const Clock::time_point first = last;
+    for (int i = 0; i < frames; ++i)
+    {
+        Work(workMs);
+        pacer.WaitForNextFrame();
+        const Clock::time_point now = Clock::now();
+        period.AddSample(Ms(now - last));
+        last = now;
+    }
+
+    const double meanMs = Ms(last - first) / double(frames);
+    const FrameStats::Summary p = period.Summarize();
+    const FrameStats::Summary w = pacer.WakeError().Summarize();
+    std::printf("target %.3f ms (%.1f fps), %d frames, %.2f ms work\n", targetMs, fps, frames, workMs);
+    std::printf("  period      mean %.4f  p50 %.4f  p99 %.4f  max %.4f ms\n", meanMs, p.p50Ms, p.p99Ms, p.maxMs);
+    std::printf("  wake error  p50 %.4f  p99 %.4f  max %.4f ms  (%u samples)\n", w.p50Ms, w.p99Ms, w.maxMs, w.count);
+    std::printf("  sleep estimate %.3f ms\n", pacer.SleepEstimateMs());
+
+    bool ok = true;
+    if (std::fabs(p.p50Ms - targetMs) > 0.5) { std::printf("  FAIL: median period off\n"); ok = false; }
+    if (w.p50Ms > 0.5)                       { std::printf("  FAIL: median wake error\n"); ok = false; }
+    std::printf("framepacercheck: %s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,328 @@
+// inputrecordingcheck: InputRecording save -> load -> replay without a
+// window. A session recorded on one build has to replay identically on the
+// next, so this writes a synthetic session laid out the way InputSession
+// records one and checks that:
+//   - every event type comes back with its payload, frame and timestamp;
+//   - Frame markers keep their dt bit for bit, and their UI capture flag;
+//   - the replay cursor splits each frame at its Latch marker (the Frame
+//     marker, recorded last, stays with the early events);
+//   - version 1 files (no Latch) still load, and a Latch in one is rejected;
+//   - truncated files and unknown versions are rejected.
+// Portable (no D3D):
+//
+//   g++ -std=c++20 -O2 -o inputrecordingcheck Tools/InputRecordingCheck.cpp Core/InputRecording.cpp
+//
+//   inputrecordingcheck [dir]            exit code 1 on failure
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Core/InputRecording.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    int g_failures = 0;
+
+    void Check(bool ok, const char* what)
+    {
+        if (!ok)
+        {
+            std::printf("  FAIL: %s\n", what);
+            ++g_failures;
+        }
+    }
+
+    bool SameBits(float a, float b)
+    {
+        return std::memcmp(&a, &b, sizeof(float)) == 0;
+    }
+
+    // Equal in everything the file stores for the event's type.
+    bool Same(const InputEvent& a, const InputEvent& b)
+    {
+        if (a.type != b.type || a.frame != b.frame || a.timeNs != b.timeNs) return false;
+        switch (a.type)
+        {
+        case InputEvent::Type::MouseMove:  return SameBits(a.x, b.x) && SameBits(a.y, b.y);
+        case InputEvent::Type::MouseWheel: return SameBits(a.x, b.x);
+        case InputEvent::Type::ButtonDown:
+        case InputEvent::Type::ButtonUp:   return a.button == b.button;
+        case InputEvent::Type::KeyDown:
+        case InputEvent::Type::KeyUp:      return a.key == b.key;
+        case InputEvent::Type::Frame:      return SameBits(a.x, b.x) && a.flags == b.flags;
+        case InputEvent::Type::Latch:      return true;
+        }
+        return false;
+    }
+
+    InputEvent Event(InputEvent::Type type, uint32_t frame, uint64_t timeNs)
+    {
+        InputEvent e;
+        e.type = type;
+        e.frame = frame;
+        e.timeNs = timeNs;
+        return e;
+    }
+
+    // One session as InputSession writes it: per frame the early events,
+    // then (some frames) a Latch marker and the late events, then the Frame
+    // marker. A few frames are skipped entirely (a dropped frame).
+    std::vector<InputEvent> Session(uint32_t frames, bool withLatch, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> delta(-40.0f, 40.0f);
+        std::uniform_int_distribution<int> pick(0, 5);
+        std::vector<InputEvent> events;
+        uint64_t t = 1234567890123ull;
+        auto input = [&](uint32_t frame) {
+            t += 1000 + (rng() & 0xFFFFF);
+            InputEvent e = Event(InputEvent::Type(pick(rng)), frame, t);
+            e.x = delta(rng);
+            e.y = delta(rng);
+            e.button = uint8_t(rng() % 3);
+            e.key = uint16_t(rng() % 3 == 0 ? InputKey::Shift : 0x41 + rng() % 26);
+            if (rng() % 50 == 0) e.key = 0xFFFF;          // multi-byte varint
+            switch (e.type)                                // clear what the type does not store
+            {
+            case InputEvent::Type::MouseMove:  e.button = 0; e.key = 0; break;
+            case InputEvent::Type::MouseWheel: e.y = 0.0f; e.button = 0; e.key = 0; break;
+            case InputEvent::Type::ButtonDown:
+            case InputEvent::Type::ButtonUp:   e.x = e.y = 0.0f; e.key = 0; break;
+            default:                           e.x = e.y = 0.0f; e.button = 0; break;
+            }
+            events.push_back(e);
+        };
+
+        for (uint32_t frame = 0; frame < frames; ++frame)
+        {
+            if (frame % 97 == 50) frame += 300;            // frame gap > 127: multi-byte delta
+            const uint32_t early = rng() % 4;
+            for (uint32_t i = 0; i < early; ++i) input(frame);
+            if (withLatch && frame % 3 == 1)
+            {
+                t += 500;
+                events.push_back(Event(InputEvent::Type::Latch, frame, t));
+                const uint32_t late = 1 + rng() % 3;
+                for (uint32_t i = 0; i < late; ++i) input(frame);
+            }
+            t += 16000000;
+            InputEvent marker = Event(InputEvent::Type::Frame, frame, t);
+            marker.x = (frame % 7 == 0) ? 1.0f / 60.0f : 0.0166f + float(rng() % 1000) * 1e-7f;
+            marker.flags = (frame % 5 == 0) ? InputEvent::kUiCapturedMouse : 0;
+            events.push_back(marker);
+        }
+        return events;
+    }
+
+    bool SaveLoad(const std::vector<InputEvent>& events, const fs::path& path, InputRecording& loaded)
+    {
+        InputRecording rec;
+        for (const InputEvent& e : events) rec.Append(e);
+        return rec.Save(path.string().c_str()) && loaded.Load(path.string().c_str());
+    }
+
+    bool SameAll(const InputRecording& rec, const std::vector<InputEvent>& events)
+    {
+        if (rec.Size() != events.size()) return false;
+        for (size_t i = 0; i < events.size(); ++i)
+            if (!Same(rec[i], events[i])) return false;
+        return true;
+    }
+
+    void TestRoundTrip(const fs::path& dir)
+    {
+        const std::vector<InputEvent> events = Session(2000, true, 7);
+        InputRecording loaded;
+        Check(SaveLoad(events, dir / "session.dxei", loaded), "save + load");
+        Check(SameAll(loaded, events), "every event back with its payload, frame and time");
+        Check(loaded.FrameCount() == events.back().frame + 1, "frame count");
+
+        bool types[8]{};
+        for (size_t i = 0; i < loaded.Size(); ++i) types[uint8_t(loaded[i].type)] = true;
+        bool all = true;
+        for (bool t : types) all &= t;
+        Check(all, "session covers every event type");
+
+        // A clock hiccup (time going back) is stored as no time passing.
+        std::vector<InputEvent> hiccup = events;
+        hiccup[10].timeNs = hiccup[9].timeNs - 5;
+        InputRecording clamped;
+        SaveLoad(hiccup, dir / "hiccup.dxei", clamped);
+        Check(clamped.Size() == hiccup.size() && clamped[10].timeNs == hiccup[9].timeNs &&
+              clamped[11].timeNs == hiccup[11].timeNs, "backwards timestamp clamped, later ones exact");
+    }
+
+    // Replay the loaded session the way InputSession does and compare each
+    // frame's early / late events with what was recorded around the Latch.
+    void TestReplaySplit(const fs::path& dir)
+    {
+        const std::vector<InputEvent> events = Session(2000, true, 11);
+        InputRecording loaded;
+        Check(SaveLoad(events, dir / "split.dxei", loaded), "save + load");
+
+        loaded.Rewind();
+        size_t next = 0;
+        bool split = true, frameEarly = true, latchDropped = true;
+        std::vector<InputEvent> early, late;
+        for (uint32_t frame = 0; frame < loaded.FrameCount(); ++frame)
+        {
+            early.clear();
+            late.clear();
+            loaded.Fetch(frame, early, late);
+
+            std::vector<InputEvent> wantEarly, wantLate;
+            bool latched = false;
+            for (; next < events.size() && events[next].frame == frame; ++next)
+            {
+                const InputEvent& e = events[next];
+                if (e.type == InputEvent::Type::Latch) { latched = true; continue; }
+                (latched && e.type != InputEvent::Type::Frame ? wantLate : wantEarly).push_back(e);
+            }
+            split &= early.size() == wantEarly.size() && late.size() == wantLate.size();
+            for (size_t i = 0; split && i < early.size(); ++i) split &= Same(early[i], wantEarly[i]);
+            for (size_t i = 0; split && i < late.size(); ++i) split &= Same(late[i], wantLate[i]);
+            if (!wantEarly.empty()) frameEarly &= early.back().type == InputEvent::Type::Frame;
+            for (const InputEvent& e : late) frameEarly &= e.type != InputEvent::Type::Frame;
+            for (const InputEvent& e : early) latchDropped &= e.type != InputEvent::Type::Latch;
+            for (const InputEvent& e : late) latchDropped &= e.type != InputEvent::Type::Latch;
+        }
+        Check(split, "each frame splits into the recorded early and late events");
+        Check(frameEarly, "Frame marker (dt, capture) goes with the early events");
+        Check(latchDropped, "Latch markers are not handed out");
+        Check(loaded.Finished(), "replay consumed every event");
+    }
+
+    // The version 1 encoding: same events, no Latch, version 1 in the header.
+    void PutVarint(std::vector<uint8_t>& out, uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back(uint8_t(v) | 0x80);
+            v >>= 7;
+        }
+        out.push_back(uint8_t(v));
+    }
+
+    template <typename T>
+    void PutRaw(std::vector<uint8_t>& out, const T& v)
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&v);
+        out.insert(out.end(), p, p + sizeof(T));
+    }
+
+    std::vector<uint8_t> EncodeV1(const std::vector<InputEvent>& events, uint16_t version = 1)
+    {
+        std::vector<uint8_t> buf = { 'D', 'X', 'E', 'I' };
+        PutRaw(buf, version);
+        PutRaw(buf, uint16_t(0));
+        PutRaw(buf, events.front().timeNs);
+        uint32_t prevFrame = 0;
+        uint64_t prevTime = events.front().timeNs;
+        for (const InputEvent& e : events)
+        {
+            PutVarint(buf, e.frame - prevFrame);
+            buf.push_back(uint8_t(e.type));
+            PutVarint(buf, e.timeNs - prevTime);
+            prevFrame = e.frame;
+            prevTime = e.timeNs;
+            switch (e.type)
+            {
+            case InputEvent::Type::MouseMove:  PutRaw(buf, e.x); PutRaw(buf, e.y); break;
+            case InputEvent::Type::MouseWheel: PutRaw(buf, e.x); break;
+            case InputEvent::Type::ButtonDown:
+            case InputEvent::Type::ButtonUp:   buf.push_back(e.button); break;
+            case InputEvent::Type::KeyDown:
+            case InputEvent::Type::KeyUp:      PutVarint(buf, e.key); break;
+            case InputEvent::Type::Frame:      PutRaw(buf, e.x); buf.push_back(e.flags); break;
+            case InputEvent::Type::Latch:      break;
+            }
+        }
+        return buf;
+    }
+
+    bool WriteFile(const fs::path& path, const std::vector<uint8_t>& data, size_t size)
+    {
+        std::FILE* f = std::fopen(path.string().c_str(), "wb");
+        if (!f) return false;
+        const bool ok = std::fwrite(data.data(), 1, size, f) == size;
+        return (std::fclose(f) == 0) && ok;
+    }
+
+    void TestVersion1(const fs::path& dir)
+    {
+        const std::vector<InputEvent> events = Session(500, false, 13);
+        const std::vector<uint8_t> v1 = EncodeV1(events);
+        const fs::path path = dir / "v1.dxei";
+        InputRecording loaded;
+        Check(WriteFile(path, v1, v1.size()) && loaded.Load(path.string().c_str()), "version 1 file loads");
+        Check(SameAll(loaded, events), "version 1 events intact");
+
+        std::vector<InputEvent> late, early;
+        loaded.Rewind();
+        bool noLate = true;
+        for (uint32_t frame = 0; frame < loaded.FrameCount(); ++frame)
+        {
+            loaded.Fetch(frame, early, late);
+            noLate &= late.empty();
+        }
+        Check(noLate && early.size() == events.size(), "version 1 replays everything at frame start");
+
+        // Latch did not exist in version 1.
+        std::vector<InputEvent> withLatch = events;
+        withLatch.insert(withLatch.begin() + 5, Event(InputEvent::Type::Latch, withLatch[4].frame, withLatch[4].timeNs));
+        const std::vector<uint8_t> bad = EncodeV1(withLatch);
+        Check(WriteFile(path, bad, bad.size()) && !loaded.Load(path.string().c_str()), "Latch in a version 1 file rejected");
+    }
+
+    void TestRejects(const fs::path& dir)
+    {
+        const std::vector<InputEvent> events = Session(50, true, 17);
+        InputRecording rec;
+        for (const InputEvent& e : events) rec.Append(e);
+        const fs::path path = dir / "bad.dxei";
+        rec.Save(path.string().c_str());
+
+        std::vector<uint8_t> data(fs::file_size(path));
+        if (std::FILE* f = std::fopen(path.string().c_str(), "rb"))
+        {
+            data.resize(std::fread(data.data(), 1, data.size(), f));
+            std::fclose(f);
+        }
+
+        InputRecording loaded;
+        Check(WriteFile(path, data, data.size() - 1) && !loaded.Load(path.string().c_str()), "truncated file rejected");
+        Check(WriteFile(path, data, 10) && !loaded.Load(path.string().c_str()), "truncated header rejected");
+
+        const std::vector<uint8_t> future = EncodeV1({ events.front() }, 3);
+        Check(WriteFile(path, future, future.size()) && !loaded.Load(path.string().c_str()), "unknown version rejected");
+
+        std::vector<uint8_t> badMagic = data;
+        badMagic[0] = 'X';
+        Check(WriteFile(path, badMagic, badMagic.size()) && !loaded.Load(path.string().c_str()), "bad magic rejected");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const fs::path dir = argc > 1 ? fs::path(argv[1]) : fs::temp_directory_path() / "inputrecordingcheck";
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec)
+    {
+        std::printf("usage: inputrecordingcheck [dir]\n");
+        return 2;
+    }
+
+    TestRoundTrip(dir);
+    TestReplaySplit(dir);
+    TestVersion1(dir);
+    TestRejects(dir);
+    fs::remove_all(dir, ec);
+
+    std::printf("inputrecordingcheck: %s (%d failures)\n", g_failures ? "FAILED" : "ok", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,234 @@
+// packtool: build, inspect and benchmark asset packs (.pack). Portable:
+//
+//   g++ -std=c++20 -O2 -pthread -o packtool Tools/PackTool.cpp Core/PackFile.cpp
+//       Core/Lz4.cpp Core/Hash.cpp Core/MappedFile.cpp Core/JobSystem.cpp
+//
+//   packtool build <out.pack> <dir> [--raw] [--block KB]   pack every file under dir
+//   packtool list <pack>                                   entries, sizes, ratio
+//   packtool verify <pack>                                 decode all, check hashes; exit code 1 on failure
+//   packtool extract <pack> <dir>                          write the entries back out
+//   packtool bench <pack> <dir> [runs]                     startup load: loose files vs the pack
+//
+// Names are the paths relative to <dir> with '/' separators, e.g. the editor
+// looks up "Shaders/ColorVS.cso" in Assets.pack next to the executable.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../Core/JobSystem.h"
+#include "../Core/PackFile.h"
+
+namespace fs = std::filesystem;
+using namespace PackFormat;
+
+namespace {
+    double NowMs()
+    {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool ReadWholeFile(const fs::path& path, std::vector<uint8_t>& data)
+    {
+        std::FILE* f = std::fopen(path.string().c_str(), "rb");
+        if (!f) return false;
+        std::fseek(f, 0, SEEK_END);
+        data.resize(size_t(std::ftell(f)));
+        std::fseek(f, 0, SEEK_SET);
+        const bool ok = std::fread(data.data(), 1, data.size(), f) == data.size();
+        std::fclose(f);
+        return ok;
+    }
+
+    std::vector<fs::path> ListFiles(const fs::path& dir)
+    {
+        std::vector<fs::path> files;
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+            if (it->is_regular_file(ec)) files.push_back(it->path());
+        return files;
+    }
+
+    int Build(const char* out, const char* dir, bool raw, uint32_t blockKb)
+    {
+        JobSystem jobs;
+        jobs.Initialize();
+
+        std::vector<PackSource> sources;
+        for (const fs::path& file : ListFiles(dir))
+        {
+            PackSource s;
+            s.name = fs::relative(file, dir).generic_string();
+            if (!ReadWholeFile(file, s.data))
+            {
+                std::printf("cannot read %s\n", file.string().c_str());
+                return 1;
+            }
+            sources.push_back(std::move(s));
+        }
+
+        PackWriteOptions options;
+        options.compress = !raw;
+        if (blockKb) options.blockSize = blockKb * 1024;
+
+        PackWriteStats stats;
+        std::string error;
+        const double t0 = NowMs();
+        if (!WritePackFile(out, sources, options, &jobs, &stats, &error))
+        {
+            std::printf("%s\n", error.c_str());
+            return 1;
+        }
+        std::printf("%u entries, %u blocks (%u raw), %.2f MB -> %.2f MB (%.1f%%) in %.1f ms on %u threads\n",
+            stats.entries, stats.blocks, stats.rawBlocks, stats.rawBytes / 1048576.0, stats.storedBytes / 1048576.0,
+            stats.rawBytes ? 100.0 * double(stats.storedBytes) / double(stats.rawBytes) : 0.0, NowMs() - t0, jobs.ThreadCount());
+        return 0;
+    }
+
+    bool OpenPack(PackReader& pack, const char* path)
+    {
+        std::string error;
+        if (pack.Open(path, &error)) return true;
+        std::printf("%s\n", error.c_str());
+        return false;
+    }
+
+    int List(const char* path)
+    {
+        PackReader pack;
+        if (!OpenPack(pack, path)) return 1;
+        const PackHeader& h = pack.Header();
+        std::printf("%u entries, %u blocks of %u KB, %.2f MB\n", h.entryCount, h.blockCount, h.blockSize / 1024, h.fileSize / 1048576.0);
+        for (uint32_t i = 0; i < pack.EntryCount(); ++i)
+        {
+            const PackEntry& e = pack.Entry(i);
+            uint64_t stored = 0;
+            for (uint32_t b = 0; b < e.blockCount; ++b) stored += pack.Block(e.firstBlock + b).storedSize;
+            std::printf("  %10llu %10llu %5.1f%%  %.*s\n", (unsigned long long)e.size, (unsigned long long)stored,
+                e.size ? 100.0 * double(stored) / double(e.size) : 0.0, int(e.nameLength), pack.Name(e).data());
+        }
+        return 0;
+    }
+
+    int Verify(const char* path)
+    {
+        JobSystem jobs;
+        jobs.Initialize();
+        PackReader pack;
+        if (!OpenPack(pack, path)) return 1;
+        std::string error;
+        if (!pack.Validate(&jobs, &error))
+        {
+            std::printf("INVALID: %s\n", error.c_str());
+            return 1;
+        }
+        std::printf("ok: %u entries\n", pack.EntryCount());
+        return 0;
+    }
+
+    int Extract(const char* path, const char* dir)
+    {
+        PackReader pack;
+        if (!OpenPack(pack, path)) return 1;
+        std::vector<uint8_t> data;
+        for (uint32_t i = 0; i < pack.EntryCount(); ++i)
+        {
+            const PackEntry& e = pack.Entry(i);
+            const fs::path out = fs::path(dir) / fs::path(std::string(pack.Name(e)));
+            std::error_code ec;
+            fs::create_directories(out.parent_path(), ec);
+            std::FILE* f = std::fopen(out.string().c_str(), "wb");
+            if (!pack.Read(e, data) || !f || std::fwrite(data.data(), 1, data.size(), f) != data.size())
+            {
+                if (f) std::fclose(f);
+                std::printf("cannot extract %s\n", out.string().c_str());
+                return 1;
+            }
+            std::fclose(f);
+        }
+        return 0;
+    }
+
+    // What startup does with every asset: loose = open and read each file,
+    // pack = open + map once, then decode everything (serial / on the jobs).
+    int Bench(const char* path, const char* dir, int runs)
+    {
+        JobSystem jobs;
+        jobs.Initialize();
+        const std::vector<fs::path> files = ListFiles(dir);
+
+        double loose = 1e30, serial = 1e30, parallel = 1e30;
+        uint64_t bytes = 0;
+        std::vector<std::vector<uint8_t>> data(files.size());
+        for (int run = 0; run < runs; ++run)
+        {
+            double t0 = NowMs();
+            bytes = 0;
+            for (size_t i = 0; i < files.size(); ++i)
+            {
+                ReadWholeFile(files[i], data[i]);
+                bytes += data[i].size();
+            }
+            loose = (std::min)(loose, NowMs() - t0);
+
+            for (JobSystem* j : { (JobSystem*)nullptr, &jobs })
+            {
+                t0 = NowMs();
+                PackReader pack;
+                if (!OpenPack(pack, path)) return 1;
+                std::vector<const PackEntry*> entries(pack.EntryCount());
+                std::vector<uint8_t*> dsts(pack.EntryCount());
+                std::vector<std::vector<uint8_t>> out(pack.EntryCount());
+                for (uint32_t i = 0; i < pack.EntryCount(); ++i)
+                {
+                    entries[i] = &pack.Entry(i);
+                    out[i].resize(size_t(entries[i]->size));
+                    dsts[i] = out[i].data();
+                }
+                if (!pack.ReadMany(entries.data(), dsts.data(), entries.size(), j))
+                {
+                    std::printf("corrupt pack\n");
+                    return 1;
+                }
+                double& best = j ? parallel : serial;
+                best = (std::min)(best, NowMs() - t0);
+            }
+        }
+
+        std::printf("%zu files, %.2f MB, best of %d (page cache warm)\n", files.size(), bytes / 1048576.0, runs);
+        std::printf("  loose files      %9.2f ms\n", loose);
+        std::printf("  pack, 1 thread   %9.2f ms  %5.2fx\n", serial, loose / serial);
+        std::printf("  pack, %2u threads %9.2f ms  %5.2fx\n", jobs.ThreadCount(), parallel, loose / parallel);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* cmd = argc > 1 ? argv[1] : "";
+    if (std::strcmp(cmd, "build") == 0 && argc >= 4)
+    {
+        bool raw = false;
+        uint32_t blockKb = 0;
+        for (int i = 4; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--raw") == 0) raw = true;
+            else if (std::strcmp(argv[i], "--block") == 0 && i + 1 < argc) blockKb = uint32_t(std::atoi(argv[++i]));
+        }
+        return Build(argv[2], argv[3], raw, blockKb);
+    }
+    if (std::strcmp(cmd, "list") == 0 && argc >= 3)    return List(argv[2]);
+    if (std::strcmp(cmd, "verify") == 0 && argc >= 3)  return Verify(argv[2]);
+    if (std::strcmp(cmd, "extract") == 0 && argc >= 4) return Extract(argv[2], argv[3]);
+    if (std::strcmp(cmd, "bench") == 0 && argc >= 4)   return Bench(argv[2], argv[3], argc >= 5 ? std::atoi(argv[4]) : 5);
+
+    std::printf("usage: packtool build <out.pack> <dir> [--raw] [--block KB]\n"
+                "       packtool list <pack>\n"
+                "       packtool verify <pack>\n"
+                "       packtool extract <pack> <dir>\n"
+                "       packtool bench <pack> <dir> [runs]\n");
+    return 2;
+}
@@ -0,0 +1,373 @@
+// pipelinecache: headless check of the pipeline cache's hashing, lookup and
+// scheduling layers (PipelineKeyBuilder, PipelineCache, AsyncPipelineCache).
+// Runs an editor-like startup that requests pipelines for many materials -
+// most of them sharing a description - against a simulated driver: a
+// "compile" burns a fixed time, the persistent library is a
+// DerivedDataCache directory.
+//
+//   g++ -std=c++20 -O2 -pthread -o pipelinecache Tools/PipelineCacheTool.cpp
+//       Core/DerivedDataCache.cpp Core/Hash.cpp Core/JobSystem.cpp
+//
+//   pipelinecache <dir> [materials=2000] [shaders=40] [compileUs=2000] [perFrame=25]
+//
+// Passes: cold (empty library: every unique description compiled once),
+// warm (restart: everything loaded from the library), one shader edited
+// (only the pipelines using it compile). Then materials streaming in,
+// 'perFrame' new ones per frame, compiled on the render thread vs. on the
+// job system with a fallback: worst render-thread time per frame, draws
+// that used the fallback, frames until everything was ready, and compiles
+// that ran on the render thread (the async pass does frame jobs with
+// ParallelFor as the renderer does; none may pick up a compile). Last a key
+// check: identical descriptions must share a key and any changed field
+// must change it.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "../Core/AsyncPipelineCache.h"
+#include "../Core/JobSystem.h"
+#include "../Core/PipelineCache.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr uint32_t kKeyVersion = 1;
+
+    double NowMs()
+    {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // API-neutral stand-in for a graphics pipeline description: what
+    // DXPipelineCache hashes, minus the D3D12 types.
+    struct InputElement {
+        const char* semantic;
+        uint32_t    format;
+        uint32_t    offset;
+    };
+    struct RasterState {
+        uint32_t fill{ 3 }, cull{ 3 }, depthBias{ 0 };
+        float    slopeBias{ 0.0f };
+    };
+    struct BlendState {
+        uint32_t enable{ 0 }, src{ 2 }, dst{ 1 }, op{ 1 }, writeMask{ 0xF };
+    };
+    struct DepthState {
+        uint32_t enable{ 1 }, write{ 1 }, func{ 2 };
+    };
+    struct PipelineDesc {
+        const std::vector<uint8_t>* vs{ nullptr };
+        const std::vector<uint8_t>* ps{ nullptr };
+        std::vector<InputElement> layout;
+        RasterState raster;
+        BlendState  blend;
+        DepthState  depth;
+        uint32_t topology{ 3 };
+        uint32_t rtvFormat{ 28 };
+        uint32_t dsvFormat{ 40 };
+    };
+
+    PipelineKey HashDesc(const PipelineDesc& d)
+    {
+        PipelineKeyBuilder key("fake-graphics-pipeline", kKeyVersion);
+        key.Add(d.vs->data(), d.vs->size()).Add(d.ps->data(), d.ps->size());
+        key.AddValue(uint32_t(d.layout.size()));
+        for (const InputElement& e : d.layout)
+            key.AddString(e.semantic).AddValue(e.format).AddValue(e.offset);
+        key.AddValue(d.raster).AddValue(d.blend).AddValue(d.depth)
+           .AddValue(d.topology).AddValue(d.rtvFormat).AddValue(d.dsvFormat);
+        return key.Finish();
+    }
+
+    // Fake bytecode, different per seed.
+    std::vector<uint8_t> MakeShader(uint32_t seed, size_t size)
+    {
+        std::vector<uint8_t> code(size);
+        uint32_t x = seed * 2654435761u + 1;
+        for (uint8_t& b : code) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; b = uint8_t(x); }
+        return code;
+    }
+
+    struct FakePipeline {
+        PipelineKey key;
+    };
+
+    // Simulated driver: compiling spins for 'compileUs', the library is a
+    // derived-data cache whose entries are the "compiled" blobs.
+    struct FakeDriver {
+        DerivedDataCache library;
+        uint32_t compileUs{ 2000 };
+        std::thread::id renderThread{ std::this_thread::get_id() };
+        std::atomic<uint32_t> onRenderThread{ 0 }; // builds the render thread ran
+
+        PipelineSource Build(const PipelineKey& key, FakePipeline& out)
+        {
+            if (std::this_thread::get_id() == renderThread) ++onRenderThread;
+            std::vector<uint8_t> blob;
+            if (library.Get(key, blob) && blob.size() == sizeof(PipelineKey) &&
+                std::memcmp(blob.data(), &key, sizeof(key)) == 0)
+            {
+                out.key = key;
+                return PipelineSource::Library;
+            }
+            const double until = NowMs() + compileUs / 1000.0;
+            while (NowMs() < until) {}
+            out.key = key;
+            library.Put(key, &key, sizeof(key));
+            return PipelineSource::Created;
+        }
+    };
+
+    struct Workload {
+        std::vector<std::vector<uint8_t>> shaders; // [vs, ps] per shader pair
+        std::vector<PipelineDesc> requests;        // one per material
+    };
+
+    // Materials pick one of 'shaderPairs' shader pairs and one of a few
+    // blend / cull variants, so many share a description.
+    Workload MakeWorkload(uint32_t materials, uint32_t shaderPairs)
+    {
+        Workload w;
+        for (uint32_t i = 0; i < shaderPairs * 2; ++i)
+            w.shaders.push_back(MakeShader(i, 2048 + (i % 7) * 512));
+
+        const std::vector<InputElement> layout = { { "POSITION", 6, 0 }, { "COLOR", 6, 12 }, { "TEXCOORD", 16, 24 } };
+        uint32_t x = 12345;
+        for (uint32_t m = 0; m < materials; ++m)
+        {
+            x = x * 1664525u + 1013904223u;
+            const uint32_t pair = (x >> 8) % shaderPairs;
+            PipelineDesc d;
+            d.vs = &w.shaders[pair * 2];
+            d.ps = &w.shaders[pair * 2 + 1];
+            d.layout = layout;
+            d.blend.enable = (x >> 20) & 1;            // opaque / translucent
+            d.raster.cull = ((x >> 21) & 1) ? 1 : 3;   // two-sided / back
+            w.requests.push_back(d);
+        }
+        return w;
+    }
+
+    size_t UniqueDescriptions(const Workload& w)
+    {
+        std::unordered_set<PipelineKey, DerivedDataCache::KeyHash> keys;
+        for (const PipelineDesc& d : w.requests) keys.insert(HashDesc(d));
+        return keys.size();
+    }
+
+    void Run(const char* pass, FakeDriver& driver, const Workload& w)
+    {
+        PipelineCache<FakePipeline> cache; // in-memory level starts empty, as after a restart
+        const double t0 = NowMs();
+        for (const PipelineDesc& d : w.requests)
+        {
+            const PipelineKey key = HashDesc(d);
+            FakePipeline p;
+            cache.Get(key, p, [&](FakePipeline& out) { return driver.Build(key, out); });
+        }
+        const double ms = NowMs() - t0;
+        const PipelineCacheStats& s = cache.GetStats();
+        std::printf("  %-22s %9.2f ms  %5llu requests  %5llu memory  %4llu library  %4llu compiled  hit rate %5.1f%%\n",
+            pass, ms, (unsigned long long)s.requests, (unsigned long long)s.memoryHits,
+            (unsigned long long)s.libraryHits, (unsigned long long)s.created, s.HitRate() * 100.0);
+    }
+
+    struct StreamResult {
+        double   maxFrameMs{ 0 };   // render-thread time of the worst frame
+        double   totalMs{ 0 };
+        uint32_t frames{ 0 };       // until every material drew with its own pipeline
+        uint64_t fallbackDraws{ 0 };
+        uint64_t compiled{ 0 };
+        uint32_t onRenderThread{ 0 }; // builds run by the render thread
+    };
+
+    void Report(const char* pass, const StreamResult& r)
+    {
+        std::printf("  %-22s %9.2f ms  worst frame %7.2f ms  %4u frames  %6llu fallback draws  %4llu compiled  %4u on render thread\n",
+            pass, r.totalMs, r.maxFrameMs, r.frames, (unsigned long long)r.fallbackDraws, (unsigned long long)r.compiled,
+            r.onRenderThread);
+    }
+
+    // Materials appear 'perFrame' at a time; every frame draws all that
+    // appeared so far. Synchronous: a new pipeline compiles inside the frame.
+    StreamResult StreamSync(FakeDriver& driver, const Workload& w, uint32_t perFrame)
+    {
+        PipelineCache<FakePipeline> cache;
+        StreamResult r;
+        for (size_t appeared = 0; appeared < w.requests.size(); ++r.frames)
+        {
+            const double t0 = NowMs();
+            const size_t first = appeared;
+            appeared = (std::min)(w.requests.size(), appeared + perFrame);
+            for (size_t m = first; m < appeared; ++m)
+            {
+                const PipelineKey key = HashDesc(w.requests[m]);
+                FakePipeline p;
+                cache.Get(key, p, [&](FakePipeline& out) { return driver.Build(key, out); });
+            }
+            const double ms = NowMs() - t0;
+            r.maxFrameMs = (std::max)(r.maxFrameMs, ms);
+            r.totalMs += ms;
+        }
+        r.compiled = cache.GetStats().created;
+        r.onRenderThread = driver.onRenderThread.load();
+        return r;
+    }
+
+    // Asynchronous: requests go to the job system, draws use the first
+    // material's pipeline (built up front) until theirs is ready.
+    StreamResult StreamAsync(FakeDriver& driver, const Workload& w, uint32_t perFrame, JobSystem& jobs)
+    {
+        AsyncPipelineCache<FakePipeline> cache;
+        const unsigned workers = (jobs.ThreadCount() > 1) ? jobs.ThreadCount() - 1 : 0;
+        cache.Initialize(&jobs, (std::max)(1u, workers / 2));
+        auto request = [&](size_t m) {
+            const PipelineKey key = HashDesc(w.requests[m]);
+            return cache.Request(key, [&driver, key](FakePipeline& out) { return driver.Build(key, out); });
+        };
+
+        StreamResult r;
+        const PipelineHandle fallback = request(0);
+        cache.Wait(fallback);
+
+        std::vector<PipelineHandle> handles;
+        bool allReady = false;
+        while (!allReady)
+        {
+            const double t0 = NowMs();
+            cache.Update();
+            for (size_t m = handles.size(); m < w.requests.size() && m < handles.size() + perFrame; )
+                handles.push_back(request(m++));
+            allReady = handles.size() == w.requests.size();
+            for (PipelineHandle h : handles)
+            {
+                cache.Resolve(h, fallback);
+                allReady &= cache.Ready(h);
+            }
+            // Frame jobs (draw sort, culling): the render thread helps out
+            // while it waits for them, but must not take a compile.
+            std::atomic<uint64_t> sum{ 0 };
+            jobs.ParallelFor(handles.size(), 16, [&](size_t begin, size_t end) {
+                uint64_t s = 0;
+                for (size_t i = begin; i < end; ++i) s += handles[i] * 2654435761u;
+                sum.fetch_add(s, std::memory_order_relaxed);
+            });
+            const double ms = NowMs() - t0;
+            r.maxFrameMs = (std::max)(r.maxFrameMs, ms);
+            r.totalMs += ms;
+            ++r.frames;
+
+            // Rest of the frame (GPU work, present): the workers keep compiling.
+            const double until = NowMs() + 4.0;
+            while (!allReady && NowMs() < until) std::this_thread::yield();
+        }
+        const AsyncPipelineStats s = cache.GetStats();
+        r.fallbackDraws = s.fallbacks;
+        r.compiled = s.lookups.created;
+        r.onRenderThread = driver.onRenderThread.load();
+        return r;
+    }
+
+    // Identical descriptions (built separately) share a key; changing any
+    // one field changes it.
+    bool CheckKeys(const Workload& w)
+    {
+        PipelineDesc base = w.requests[0];
+        std::vector<uint8_t> vsCopy = *base.vs;
+        PipelineDesc same = base;
+        same.vs = &vsCopy;
+        same.layout = { { "POSITION", 6, 0 }, { "COLOR", 6, 12 }, { "TEXCOORD", 16, 24 } };
+        if (!(HashDesc(base) == HashDesc(same))) { std::printf("  identical descriptions differ\n"); return false; }
+
+        std::vector<PipelineDesc> variants(9, base);
+        std::vector<uint8_t> vsEdited = *base.vs;
+        vsEdited[vsEdited.size() / 2] ^= 1;
+        variants[0].vs = &vsEdited;
+        variants[1].ps = base.vs;
+        variants[2].layout[1].offset = 16;
+        variants[3].layout[2].semantic = "NORMAL";
+        variants[4].raster.slopeBias = 1.0f;
+        variants[5].blend.writeMask = 0x7;
+        variants[6].depth.func = 4;
+        variants[7].topology = 2;
+        variants[8].dsvFormat = 20;
+
+        std::unordered_set<PipelineKey, DerivedDataCache::KeyHash> keys = { HashDesc(base) };
+        for (const PipelineDesc& v : variants) keys.insert(HashDesc(v));
+        const bool ok = keys.size() == variants.size() + 1;
+        std::printf("  key check: %zu variants, %zu distinct keys -> %s\n",
+            variants.size() + 1, keys.size(), ok ? "ok" : "COLLISION");
+        return ok;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::printf("usage: pipelinecache <dir> [materials=2000] [shaders=40] [compileUs=2000]\n");
+        return 2;
+    }
+    const fs::path dir = argv[1];
+    const uint32_t materials = argc > 2 ? uint32_t(std::atoi(argv[2])) : 2000;
+    const uint32_t shaderPairs = argc > 3 ? (std::max)(1u, uint32_t(std::atoi(argv[3]))) : 40;
+    const uint32_t compileUs = argc > 4 ? uint32_t(std::atoi(argv[4])) : 2000;
+    const uint32_t perFrame = argc > 5 ? (std::max)(1u, uint32_t(std::atoi(argv[5]))) : 25;
+
+    std::error_code ec;
+    const fs::path libraryDir = dir / "library";
+    fs::remove_all(libraryDir, ec);
+
+    Workload w = MakeWorkload(materials, shaderPairs);
+    std::printf("%u materials, %zu unique pipelines, simulated compile %u us\n",
+        materials, UniqueDescriptions(w), compileUs);
+
+    {
+        FakeDriver driver;
+        driver.compileUs = compileUs;
+        if (!driver.library.Open(libraryDir, 1ull << 30)) { std::printf("cannot open library\n"); return 1; }
+        Run("cold", driver, w);
+    }
+    {
+        FakeDriver driver; // restart
+        driver.compileUs = compileUs;
+        driver.library.Open(libraryDir, 1ull << 30);
+        Run("warm", driver, w);
+
+        w.shaders[0] = MakeShader(1000, w.shaders[0].size());
+        Run("warm, 1 shader edited", driver, w);
+    }
+
+    JobSystem jobs;
+    jobs.Initialize();
+    std::printf("streaming %u materials per frame, %u threads\n", perFrame, jobs.ThreadCount());
+    bool ok = true;
+    for (int async = 0; async < 2; ++async)
+    {
+        fs::remove_all(libraryDir, ec);
+        FakeDriver driver;
+        driver.compileUs = compileUs;
+        driver.library.Open(libraryDir, 1ull << 30);
+        if (!async)
+        {
+            Report("render thread", StreamSync(driver, w, perFrame));
+            continue;
+        }
+        const StreamResult r = StreamAsync(driver, w, perFrame, jobs);
+        Report("async + fallback", r);
+        if (r.onRenderThread > 0)
+        {
+            std::printf("  FAIL: %u compiles ran on the render thread\n", r.onRenderThread);
+            ok = false;
+        }
+    }
+    return (CheckKeys(w) && ok) ? 0 : 1;
+}
@@ -0,0 +1,334 @@
+// scenetool: inspect, check and benchmark binary scene files (.dxscene)
+// without the editor. Portable (no D3D, no DirectXMath):
+//
+//   g++ -std=c++20 -O2 -o scenetool Tools/SceneTool.cpp Scene/SceneFile.cpp
+//       Core/MappedFile.cpp Core/Hash.cpp
+//
+//   scenetool dump <file> [records]    header, chunk table, assets, first records
+//   scenetool validate <file>          full check (hashes, indices); exit code 1 on failure
+//   scenetool gen <file> <entities>    write a synthetic scene
+//   scenetool bench <file> <entities>  save / open / read / incremental save timings
+//   scenetool crash <file> <entities>  incremental saves cut off before the header
+//                                      switch must leave the old scene; exit code 1 on failure
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "../Scene/SceneFile.h"
+
+using namespace SceneFormat;
+
+namespace {
+    double NowMs()
+    {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    const char* TypeName(ChunkType type)
+    {
+        switch (type)
+        {
+        case ChunkType::Entities:    return "entities";
+        case ChunkType::Transforms:  return "transforms";
+        case ChunkType::Renderables: return "renderables";
+        case ChunkType::Assets:      return "assets";
+        case ChunkType::Strings:     return "strings";
+        }
+        return "?";
+    }
+
+    // Forest of 1000-entity trees (a root and its children, every tenth
+    // child with a grandchild), all drawing the quad.
+    SceneData Generate(uint32_t entityCount)
+    {
+        SceneData d;
+        const uint32_t mesh = d.AddAsset(AssetRecord::Mesh, "builtin/quad");
+        const uint32_t material = d.AddAsset(AssetRecord::Material, "sampler/linear_wrap");
+
+        d.entities.resize(entityCount);
+        d.transforms.resize(entityCount);
+        d.renderables.resize(entityCount);
+        for (uint32_t i = 0; i < entityCount; ++i)
+        {
+            const uint32_t local = i % 1000;
+            EntityRecord& e = d.entities[i];
+            e.parent = (local == 0) ? kNone : (local % 10 == 0 ? i - 1 : i - local);
+            e.flags = EntityRecord::kHasTransform | EntityRecord::kHasRenderable;
+
+            TransformRecord& t = d.transforms[i];
+            t = TransformRecord{ { float(local % 32), 0.0f, float(local / 32) }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f } };
+
+            RenderableRecord& r = d.renderables[i];
+            r = RenderableRecord{};
+            r.entity = i;
+            r.meshAsset = mesh;
+            r.materialAsset = material;
+            r.vertexCount = 6;
+            r.flags = 1;
+        }
+        return d;
+    }
+
+    int Dump(const char* path, uint32_t records)
+    {
+        SceneFileReader reader;
+        std::string error;
+        if (!reader.Open(path, &error))
+        {
+            std::fprintf(stderr, "%s: %s\n", path, error.c_str());
+            return 1;
+        }
+        const SceneHeader& h = reader.Header();
+        std::printf("version %u, %u entities, %u renderables, %u assets\n",
+            h.version, h.entityCount, h.renderableCount, h.assetCount);
+        std::printf("file %llu bytes, live %llu, %u chunks, table at %llu\n",
+            (unsigned long long)h.fileSize, (unsigned long long)h.liveBytes, h.chunkCount,
+            (unsigned long long)h.chunkTableOffset);
+
+        std::printf("\n%-5s %-12s %10s %8s %12s %10s %10s  %s\n", "chunk", "type", "first", "count", "offset", "size", "capacity", "hash");
+        for (uint32_t i = 0; i < reader.ChunkCount(); ++i)
+        {
+            const SceneChunk& c = reader.Chunk(i);
+            std::printf("%-5u %-12s %10u %8u %12llu %10llu %10llu  %016llx\n", i, TypeName(c.type), c.first, c.count,
+                (unsigned long long)c.offset, (unsigned long long)c.size, (unsigned long long)c.capacity,
+                (unsigned long long)c.hash);
+        }
+
+        std::printf("\nassets:\n");
+        for (uint32_t i = 0; i < h.assetCount; ++i)
+        {
+            const AssetRecord* a = reader.Asset(i);
+            const std::string name(reader.AssetName(*a));
+            std::printf("  %u %-8s %s\n", i, a->kind == AssetRecord::Mesh ? "mesh" : "material", name.c_str());
+        }
+
+        std::printf("\nentities (first %u):\n", records);
+        for (uint32_t i = 0; i < reader.ChunkCount(); ++i)
+        {
+            const SceneChunk& c = reader.Chunk(i);
+            if (c.type != ChunkType::Transforms || c.first >= records) continue;
+            const TransformRecord* t = reader.Records<TransformRecord>(c);
+            for (uint32_t k = 0; k < c.count && c.first + k < records; ++k)
+                std::printf("  %u pos (%g %g %g) rot (%g %g %g %g) scale (%g %g %g)\n", c.first + k,
+                    t[k].position[0], t[k].position[1], t[k].position[2],
+                    t[k].rotation[0], t[k].rotation[1], t[k].rotation[2], t[k].rotation[3],
+                    t[k].scale[0], t[k].scale[1], t[k].scale[2]);
+        }
+        return 0;
+    }
+
+    int Validate(const char* path)
+    {
+        SceneFileReader reader;
+        std::string error;
+        const double t0 = NowMs();
+        if (!reader.Open(path, &error) || !reader.Validate(&error))
+        {
+            std::fprintf(stderr, "%s: INVALID: %s\n", path, error.c_str());
+            return 1;
+        }
+        std::printf("%s: OK (%u entities, %u chunks, %.1f ms)\n", path,
+            reader.Header().entityCount, reader.ChunkCount(), NowMs() - t0);
+        return 0;
+    }
+
+    int Gen(const char* path, uint32_t entities)
+    {
+        std::string error;
+        if (!SaveSceneFile(path, Generate(entities), SceneSaveMode::Full, nullptr, &error))
+        {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        return 0;
+    }
+
+    int Bench(const char* path, uint32_t entities)
+    {
+        SceneData data = Generate(entities);
+        std::string error;
+        SceneSaveStats stats;
+
+        double t0 = NowMs();
+        if (!SaveSceneFile(path, data, SceneSaveMode::Full, &stats, &error))
+        {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        std::printf("full save:        %8.2f ms  (%u chunks, %.1f MB)\n", NowMs() - t0,
+            stats.chunksWritten, double(stats.bytesWritten) / (1024.0 * 1024.0));
+
+        {
+            SceneFileReader reader;
+            t0 = NowMs();
+            if (!reader.Open(path, &error))
+            {
+                std::fprintf(stderr, "%s\n", error.c_str());
+                return 1;
+            }
+            std::printf("open (map):       %8.3f ms\n", NowMs() - t0);
+
+            // Touch every transform, as instantiating the scene would.
+            t0 = NowMs();
+            double sum = 0.0;
+            for (uint32_t i = 0; i < reader.ChunkCount(); ++i)
+            {
+                const SceneChunk& c = reader.Chunk(i);
+                if (c.type != ChunkType::Transforms) continue;
+                const TransformRecord* t = reader.Records<TransformRecord>(c);
+                for (uint32_t k = 0; k < c.count; ++k) sum += t[k].position[0] + t[k].scale[1];
+            }
+            std::printf("read transforms:  %8.2f ms  (checksum %.0f)\n", NowMs() - t0, sum);
+
+            t0 = NowMs();
+            const bool valid = reader.Validate(&error);
+            std::printf("validate:         %8.2f ms  (%s)\n", NowMs() - t0, valid ? "ok" : error.c_str());
+        }
+
+        // Move one entity: one transform chunk changes.
+        data.transforms[entities / 2].position[1] += 1.0f;
+        t0 = NowMs();
+        if (!SaveSceneFile(path, data, SceneSaveMode::Incremental, &stats, &error))
+        {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        std::printf("incremental save: %8.2f ms  (%u written, %u skipped, %.1f KB)\n", NowMs() - t0,
+            stats.chunksWritten, stats.chunksSkipped, double(stats.bytesWritten) / 1024.0);
+
+        SceneFileReader reader;
+        if (!reader.Open(path, &error) || !reader.Validate(&error))
+        {
+            std::fprintf(stderr, "after incremental save: %s\n", error.c_str());
+            return 1;
+        }
+        return 0;
+    }
+
+    // Transform 'index' as the file at 'path' has it (NaN if unreadable).
+    float StoredY(const char* path, uint32_t index)
+    {
+        SceneFileReader reader;
+        if (!reader.Open(path) || !reader.Validate()) return std::nanf("");
+        for (uint32_t i = 0; i < reader.ChunkCount(); ++i)
+        {
+            const SceneChunk& c = reader.Chunk(i);
+            if (c.type == ChunkType::Transforms && index >= c.first && index - c.first < c.count)
+                return reader.Records<TransformRecord>(c)[index - c.first].position[1];
+        }
+        return std::nanf("");
+    }
+
+    bool ReadHeader(const char* path, SceneHeader& h)
+    {
+        std::FILE* f = std::fopen(path, "rb");
+        const bool ok = f && std::fread(&h, sizeof(h), 1, f) == 1;
+        if (f) std::fclose(f);
+        return ok;
+    }
+
+    bool WriteHeader(const char* path, const SceneHeader& h)
+    {
+        std::FILE* f = std::fopen(path, "r+b");
+        const bool ok = f && std::fwrite(&h, sizeof(h), 1, f) == 1;
+        if (f) std::fclose(f);
+        return ok;
+    }
+
+    // Each round edits one entity and saves incrementally, then puts the old
+    // header back - the state a crash just before the header write leaves.
+    // The file must still hold the old scene, intact, and the next save must
+    // work from it.
+    int Crash(const char* path, uint32_t entities)
+    {
+        SceneData data = Generate(entities);
+        std::string error;
+        if (!SaveSceneFile(path, data, SceneSaveMode::Full, nullptr, &error))
+        {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+
+        int failures = 0;
+        for (uint32_t round = 0; round < 32; ++round)
+        {
+            const uint32_t index = uint32_t((uint64_t(round) * 2654435761u) % entities);
+            const float before = data.transforms[index].position[1];
+            data.transforms[index].position[1] += 1.0f;
+
+            SceneHeader old{};
+            SceneSaveStats stats;
+            if (!ReadHeader(path, old) || !SaveSceneFile(path, data, SceneSaveMode::Incremental, &stats, &error))
+            {
+                std::fprintf(stderr, "round %u: %s\n", round, error.c_str());
+                return 1;
+            }
+            if (stats.fullRewrite) continue; // compaction: nothing of the old file is reused
+
+            if (!WriteHeader(path, old) || StoredY(path, index) != before)
+            {
+                std::printf("  FAIL: round %u: old scene damaged by the cut-off save\n", round);
+                ++failures;
+            }
+            if (!SaveSceneFile(path, data, SceneSaveMode::Incremental, nullptr, &error) ||
+                StoredY(path, index) != data.transforms[index].position[1])
+            {
+                std::printf("  FAIL: round %u: save after the cut-off\n", round);
+                ++failures;
+            }
+        }
+
+        // A torn payload must be caught before use.
+        {
+            SceneFileReader reader;
+            SceneChunk chunk{};
+            if (reader.Open(path)) chunk = reader.Chunk(0);
+            reader.Close();
+            std::FILE* f = std::fopen(path, "r+b");
+            if (f && std::fseek(f, long(chunk.offset), SEEK_SET) == 0)
+            {
+                const uint8_t garbage[8] = { 0xde, 0xad, 0xbe, 0xef, 0xde, 0xad, 0xbe, 0xef };
+                std::fwrite(garbage, 1, sizeof(garbage), f);
+            }
+            if (f) std::fclose(f);
+            if (!reader.Open(path) || reader.VerifyPayloads())
+            {
+                std::printf("  FAIL: torn payload not detected\n");
+                ++failures;
+            }
+        }
+
+        std::printf("crash: %s (%d failures)\n", failures ? "FAILED" : "ok", failures);
+        return failures ? 1 : 0;
+    }
+
+    int Usage()
+    {
+        std::fprintf(stderr,
+            "usage: scenetool dump <file> [records]\n"
+            "       scenetool validate <file>\n"
+            "       scenetool gen <file> <entities>\n"
+            "       scenetool bench <file> <entities>\n"
+            "       scenetool crash <file> <entities>\n");
+        return 2;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) return Usage();
+    const std::string cmd = argv[1];
+    const char* path = argv[2];
+    const uint32_t n = (argc > 3) ? uint32_t(std::strtoul(argv[3], nullptr, 10)) : 0;
+
+    if (cmd == "dump")     return Dump(path, argc > 3 ? n : 8);
+    if (cmd == "validate") return Validate(path);
+    if (cmd == "gen")      return argc > 3 ? Gen(path, n) : Usage();
+    if (cmd == "bench")    return Bench(path, argc > 3 ? n : 1000000);
+    if (cmd == "crash")    return Crash(path, argc > 3 && n > 0 ? n : 100000);
+    return Usage();
+}
@@ -0,0 +1,272 @@
+// shadervariants: the ColorPS permutation space outside the editor -
+// which variants exist, which a run used (ShaderUsage.txt, written by the
+// editor on exit), the dxc command lines that build them, and a self test
+// of the key / variant cache machinery. Portable (no D3D):
+//
+//   g++ -std=c++20 -O2 -pthread -o shadervariants Tools/ShaderVariantTool.cpp Core/ShaderPermutation.cpp
+//
+//   shadervariants list                           every variant and its defines
+//   shadervariants commands <out dir> [usage]     dxc lines for the used variants (all without usage)
+//   shadervariants selftest [dir]                 key / cache / usage checks; exit code 1 on failure
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Core/ShaderPermutation.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    int Usage()
+    {
+        std::printf("usage: shadervariants list\n"
+                    "       shadervariants commands <out dir> [ShaderUsage.txt]\n"
+                    "       shadervariants selftest [dir]\n");
+        return 2;
+    }
+
+    std::string DefineList(const ShaderPermutationSpace& space, uint32_t key, const char* prefix)
+    {
+        std::string out;
+        for (const auto& [name, value] : space.Defines(key))
+            out += std::string(prefix) + name + "=" + std::to_string(value) + (prefix[0] ? " " : ", ");
+        if (!out.empty()) out.resize(out.size() - (prefix[0] ? 1 : 2));
+        return out;
+    }
+
+    int List()
+    {
+        const ShaderPermutationSpace& space = ColorPermutation::Space();
+        std::printf("%s: %zu features, %u variants (%u key bits)\n",
+            space.Shader().c_str(), space.Features().size(), space.VariantCount(), space.KeyBits());
+        for (uint32_t key : space.Keys())
+            std::printf("  %-12s %s%s\n", space.VariantName(key).c_str(), DefineList(space, key, "").c_str(),
+                key == ColorPermutation::kDefault ? "  (default)" : "");
+        return 0;
+    }
+
+    int Commands(const char* outDir, const char* usagePath)
+    {
+        const ShaderPermutationSpace& space = ColorPermutation::Space();
+        std::vector<uint32_t> keys;
+        if (usagePath)
+        {
+            ShaderVariantCache usage(space, ShaderVariantCache::LoadFn{});
+            if (!usage.LoadUsage(usagePath))
+            {
+                std::printf("cannot read %s\n", usagePath);
+                return 1;
+            }
+            for (const ShaderVariantCache::Usage& u : usage.UsedVariants()) keys.push_back(u.key);
+            // The default is the fallback of everything else: always built.
+            if (std::find(keys.begin(), keys.end(), ColorPermutation::kDefault) == keys.end())
+                keys.insert(keys.begin(), ColorPermutation::kDefault);
+        }
+        else keys = space.Keys();
+
+        for (uint32_t key : keys)
+            std::printf("dxc -T ps_6_0 -E main %s -Fo \"%s/%s.cso\" %s.hlsl\n", DefineList(space, key, "-D ").c_str(),
+                outDir, space.VariantName(key).c_str(), space.Shader().c_str());
+        std::fprintf(stderr, "%zu of %u variants\n", keys.size(), space.VariantCount());
+        return 0;
+    }
+
+    // ------------------------------------------------------------
+    // Self test
+    // ------------------------------------------------------------
+    int g_failures = 0;
+
+    void Check(bool ok, const char* what)
+    {
+        if (!ok)
+        {
+            std::printf("  FAIL: %s\n", what);
+            ++g_failures;
+        }
+    }
+
+    void TestKeys()
+    {
+        using namespace ColorPermutation;
+        const ShaderPermutationSpace& space = Space();
+        Check(space.VariantCount() == 8 && space.KeyBits() == 3, "variant count / key bits");
+        Check(space.Keys().size() == space.VariantCount(), "Keys() enumerates every variant");
+
+        // Round trip of every feature combination.
+        for (uint32_t s = 0; s < 4; ++s)
+            for (uint32_t v = 0; v < 2; ++v)
+            {
+                const uint32_t key = Key(Sampler(s), v != 0);
+                Check(space.IsValid(key), "built key is valid");
+                Check(uint32_t(SamplerOf(key)) == s && VertexColorOf(key) == (v != 0), "key round trip");
+                Check(space.Value(key, kSampler) == s && space.Value(key, kVertexColor) == v, "Value()");
+
+                uint32_t parsed = ~0u;
+                Check(space.ParseVariantName(space.VariantName(key), parsed) && parsed == key, "variant name round trip");
+            }
+
+        Check(kDefault == Key(Sampler::LinearWrap, true), "default permutation");
+        Check(PermutationKeyBuilder().Set(kSampler, 99).Finish() == 3, "out of range value clamps");
+        Check(PermutationKeyBuilder().Set(kSampler, 2).Set(kSampler, 1).Finish() == 1, "Set replaces the field");
+        Check(!space.IsValid(1u << 3), "bits outside the features are invalid");
+
+        // A feature with fewer values than its bits hold.
+        const ShaderFeature kTri{ "TRI", 0, 2, 3 };
+        const ShaderFeature kFlag{ "FLAG", 2, 1, 2 };
+        const ShaderPermutationSpace sparse("Sparse", { kTri, kFlag });
+        Check(sparse.VariantCount() == 6 && sparse.Keys().size() == 6, "sparse variant count");
+        Check(!sparse.IsValid(3) && !sparse.IsValid(7), "unused value is invalid");
+
+        uint32_t key = 0;
+        Check(!space.ParseVariantName("ColorPS_08", key), "name of an invalid key");
+        Check(!space.ParseVariantName("ColorVS_00", key), "name of another shader");
+        Check(!space.ParseVariantName("ColorPS_", key) && !space.ParseVariantName("ColorPS_0g", key), "malformed name");
+
+        const auto defines = space.Defines(Key(Sampler::PointClamp, false));
+        Check(defines.size() == 2 && defines[0].first == "SAMPLER_MODE" && defines[0].second == 3 &&
+              defines[1].first == "VERTEX_COLOR_BLEND" && defines[1].second == 0, "Defines()");
+    }
+
+    void TestCache(const fs::path& dir)
+    {
+        using namespace ColorPermutation;
+        const ShaderPermutationSpace& space = Space();
+        std::vector<std::string> loads;
+        auto load = [&](const std::string& name, std::vector<uint8_t>& code) {
+            loads.push_back(name);
+            if (name == space.VariantName(Key(Sampler::PointClamp, true))) return false; // "not built"
+            code.assign(name.begin(), name.end());
+            return true;
+        };
+
+        ShaderVariantCache cache(space, load);
+        cache.Insert(kDefault, { 1, 2, 3 });
+        const std::vector<uint8_t>* def = cache.Get(kDefault);
+        Check(def && def->size() == 3 && loads.empty(), "inserted variant is not loaded again");
+
+        const uint32_t pw = Key(Sampler::PointWrap, false);
+        const std::vector<uint8_t>* a = cache.Get(pw);
+        const std::vector<uint8_t>* b = cache.Get(pw);
+        Check(a && a == b && loads.size() == 1 && loads[0] == space.VariantName(pw), "variant loaded once, on first use");
+
+        const uint32_t missing = Key(Sampler::PointClamp, true);
+        Check(!cache.Get(missing) && !cache.Get(missing) && loads.size() == 2, "missing variant: null, not retried");
+        Check(!cache.Get(1u << 3) && loads.size() == 2, "invalid key: null, nothing loaded");
+
+        const ShaderVariantCache::Stats& s = cache.GetStats();
+        Check(s.requests == 6 && s.loads == 2 && s.loadFailures == 1, "stats");
+        Check(cache.LoadedCount() == 2, "loaded count");
+
+        cache.NoteDraws(pw, 10);
+        cache.NoteDraws(kDefault);
+        std::vector<ShaderVariantCache::Usage> used = cache.UsedVariants();
+        Check(used.size() == 3, "used = requested or drawn");
+
+        // Usage survives a save / load and accumulates over runs.
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        const fs::path usagePath = dir / "ShaderUsage.txt";
+        Check(cache.SaveUsage(usagePath), "SaveUsage");
+
+        ShaderVariantCache next(space, load);
+        Check(next.LoadUsage(usagePath), "LoadUsage");
+        next.NoteDraws(pw, 5);
+        used = next.UsedVariants();
+        bool found = false;
+        for (const ShaderVariantCache::Usage& u : used)
+            if (u.key == pw) found = (u.requests == 2 && u.draws == 15);
+        Check(used.size() == 3 && found, "usage accumulates over runs");
+
+        // Lines of other shaders and unknown variants are skipped.
+        if (std::FILE* f = std::fopen(usagePath.string().c_str(), "a"))
+        {
+            std::fprintf(f, "ColorVS_00 5 5\nColorPS_1f 5 5\nColorPS_02 1 2\n");
+            std::fclose(f);
+        }
+        ShaderVariantCache third(space, load);
+        third.LoadUsage(usagePath);
+        Check(third.UsedVariants().size() == 4, "foreign lines ignored, valid ones merged");
+        fs::remove(usagePath, ec);
+    }
+
+    // Background loads, as the editor does them: the loader thread finishes
+    // only when released, so Get() must have returned without the binary.
+    void TestAsyncCache()
+    {
+        using namespace ColorPermutation;
+        const ShaderPermutationSpace& space = Space();
+        const uint32_t pw = Key(Sampler::PointWrap, false);
+        const uint32_t missing = Key(Sampler::PointClamp, true);
+        std::atomic<bool> release{ false };
+        std::atomic<uint32_t> completed{ 0 };
+        std::vector<std::thread> loaders;
+        uint32_t started = 0;
+
+        {
+            ShaderVariantCache cache(space, ShaderVariantCache::RequestFn(
+                [&](uint32_t key, const std::string& name) {
+                    ++started;
+                    loaders.emplace_back([&cache, &release, &completed, key, name, missing] {
+                        while (!release) std::this_thread::yield();
+                        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                        std::vector<uint8_t> code(name.begin(), name.end());
+                        ++completed;
+                        cache.Complete(key, key != missing, std::move(code));
+                    });
+                }));
+
+            Check(!cache.Get(pw) && cache.IsLoading(pw) && started == 1, "first use starts a load, returns at once");
+            Check(!cache.Get(missing) && started == 2, "second variant loads alongside");
+            Check(cache.Update() == 0 && cache.IsLoading(pw), "nothing published before the load completes");
+
+            release = true;
+            uint32_t published = 0;
+            for (int i = 0; published < 2 && i < 10000; ++i)
+            {
+                published += cache.Update();
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            Check(published == 2, "completed loads published by Update");
+
+            const std::vector<uint8_t>* code = cache.Get(pw);
+            Check(code && !cache.IsLoading(pw) && code->size() == space.VariantName(pw).size(), "published binary returned");
+            Check(!cache.Get(missing) && !cache.IsLoading(missing) && started == 2, "failed load: null, not retried");
+            const ShaderVariantCache::Stats& s = cache.GetStats();
+            Check(s.loads == 2 && s.loadFailures == 1, "async stats");
+
+            // A load still out when the cache goes away completes into it
+            // before the destructor returns.
+            release = false;
+            cache.Get(Key(Sampler::LinearClamp, true));
+            release = true;
+        }
+        Check(completed == 3, "destructor waited for the outstanding load");
+        for (std::thread& t : loaders) t.join();
+    }
+
+    int SelfTest(const fs::path& dir)
+    {
+        TestKeys();
+        TestCache(dir);
+        TestAsyncCache();
+        std::printf("selftest: %s (%d failures)\n", g_failures ? "FAILED" : "ok", g_failures);
+        return g_failures ? 1 : 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) return Usage();
+    const std::string cmd = argv[1];
+
+    if (cmd == "list")     return List();
+    if (cmd == "commands") return argc > 2 ? Commands(argv[2], argc > 3 ? argv[3] : nullptr) : Usage();
+    if (cmd == "selftest") return SelfTest(argc > 2 ? fs::path(argv[2]) : fs::temp_directory_path() / "shadervariants");
+    return Usage();
+}
@@ -0,0 +1,76 @@
+// spscstress: the message thread -> render thread channel (SpscQueue of
+// InputEvent, as RenderThread uses it) under load, without Windows. One
+// producer pushes sequence-numbered events, one consumer checks that they
+// arrive complete and in order; tiny rings exercise the full/empty paths.
+// Portable (no Win32 / D3D), meant to run under -fsanitize=thread too:
+//
+//   g++ -std=c++20 -O2 -pthread -o spscstress Tools/SpscStress.cpp
+//
+//   spscstress [events per ring=2000000]          exit code 1 on failure
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "../Core/InputEvents.h"
+#include "../Core/SpscQueue.h"
+
+namespace {
+    double NowMs()
+    {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Returns the number of events that arrived out of order or corrupted.
+    template <size_t Capacity>
+    uint64_t Run(uint64_t count)
+    {
+        static SpscQueue<InputEvent, Capacity> queue; // 4096-entry rings are too big for the stack
+        const double start = NowMs();
+
+        std::thread producer([count] {
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                InputEvent e = InputEvent::MouseMove(float(i & 0xFFFF), -float(i & 0xFFFF));
+                e.timeNs = i;
+                while (!queue.TryPush(e))
+                    std::this_thread::yield(); // full: let the consumer run (matters on 1 core)
+            }
+        });
+
+        uint64_t errors = 0;
+        InputEvent e;
+        for (uint64_t i = 0; i < count; )
+        {
+            if (!queue.TryPop(e)) { std::this_thread::yield(); continue; }
+            if (e.timeNs != i || e.x != float(i & 0xFFFF) || e.y != -float(i & 0xFFFF))
+                ++errors;
+            ++i;
+        }
+        producer.join();
+        if (queue.TryPop(e)) ++errors; // nothing may be left over
+
+        const double ms = NowMs() - start;
+        std::printf("ring %5zu: %llu events in %8.1f ms (%.1f ns each), %llu errors\n", Capacity,
+            (unsigned long long)count, ms, ms * 1e6 / double(count), (unsigned long long)errors);
+        return errors;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000ull;
+    if (count == 0)
+    {
+        std::printf("usage: spscstress [events per ring]\n");
+        return 2;
+    }
+
+    uint64_t errors = 0;
+    errors += Run<2>(count / 8); // always full or empty
+    errors += Run<64>(count);
+    errors += Run<4096>(count);  // RenderThread's size
+    std::printf("spscstress: %s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,26 @@
+// Whole global descriptor heap, indexed with gTextureIndex (bindless).
+Texture2D gTextures[] : register(t0);
+
+// Static sampler 2 of the shared root signature.
+SamplerState gSamplerLinearClamp : register(s2);
+
+// Constant buffer shared with C++ (CbUpscale).
+cbuffer CbUpscale : register(b0)
+{
+    float2 gUvScale; // Part of the scene target that was rendered this frame.
+    float2 gUvMax; // Half a texel inside that part: no bleed from stale texels.
+    uint gTextureIndex; // Bindless SRV index of the scene target.
+    uint3 _padding;
+};
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD;
+};
+
+float4 main(PSInput i) : SV_Target
+{
+    const float2 uv = min(i.uv * gUvScale, gUvMax);
+    return gTextures[gTextureIndex].SampleLevel(gSamplerLinearClamp, uv, 0.0f);
+}
@@ -0,0 +1,17 @@
+// Fullscreen triangle generated from SV_VertexID (no vertex buffer).
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD;
+};
+
+PSInput main(uint id : SV_VertexID)
+{
+    // id 0,1,2 -> uv (0,0), (2,0), (0,2): one triangle covering the viewport.
+    const float2 uv = float2((id << 1) & 2, id & 2);
+
+    PSInput o;
+    o.position = float4(uv * float2(2.0f, -2.0f) + float2(-1.0f, 1.0f), 0.0f, 1.0f);
+    o.uv = uv;
+    return o;
+}